@@ -0,0 +1,38 @@
+#include <string.h>
+#include "arena.h"
+#include "platform.h"
+
+#define ALIGN_UP(n) (((n) + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1))
+
+void ArenaMeasure(Arena* arena) {
+    arena->base = NULL;
+    arena->size = 0;
+    arena->used = 0;
+}
+
+// 一次性清零：所有页面在开局前就已映射，游戏过程中不会再触发缺页
+int ArenaCreate(Arena* arena, size_t size) {
+    arena->base = (unsigned char*)PlatformAlignedAlloc(ARENA_ALIGN, size);
+    arena->size = arena->base != NULL ? size : 0;
+    arena->used = 0;
+    if (arena->base != NULL) memset(arena->base, 0, size);
+    return arena->base != NULL;
+}
+
+void ArenaFree(Arena* arena) {
+    PlatformAlignedFree(arena->base);
+    arena->base = NULL;
+    arena->size = 0;
+    arena->used = 0;
+}
+
+void* ArenaAlloc(Arena* arena, size_t bytes) {
+    size_t offset = ALIGN_UP(arena->used);
+    if (arena->base == NULL) {
+        arena->used = offset + bytes;
+        return NULL;
+    }
+    if (offset + bytes > arena->size) return NULL;
+    arena->used = offset + bytes;
+    return arena->base + offset;
+}
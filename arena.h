@@ -0,0 +1,25 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+// 线性分配器：一局游戏的全部存储 (GameState、子弹道、对象池、碰撞网格、渲染缓冲) 从同一块内存中按顺序切出。
+// CreateGame 时分配一次，DestroyGame 时整体释放，游戏过程中不再向堆申请内存。
+//
+// 布局函数对同一个配置执行两遍：第一遍 base 为 NULL，只累计所需字节数 (ArenaAlloc 返回 NULL)；
+// 第二遍在 ArenaCreate 分配好的内存上真正切分。两遍的调用顺序必须相同。
+
+#define ARENA_ALIGN 64   // 每块都从新的缓存行开始，SIMD 内核需要的 32 字节对齐随之满足
+
+typedef struct {
+    unsigned char* base;   // NULL 表示只计算大小
+    size_t size;
+    size_t used;
+} Arena;
+
+void ArenaMeasure(Arena* arena);                    // 开始第一遍 (只计算大小)
+int ArenaCreate(Arena* arena, size_t size);         // 按 ARENA_ALIGN 对齐分配并清零，失败返回 0
+void ArenaFree(Arena* arena);
+void* ArenaAlloc(Arena* arena, size_t bytes);       // 切出一块；只计算大小或空间不足时返回 NULL
+
+#endif
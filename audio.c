@@ -0,0 +1,199 @@
+#include <stdio.h>
+#include <string.h>
+#include "audio.h"
+#include "platform.h"
+#include "spsc.h"
+
+#define VOICE_AMPLITUDE 4000
+#define BUFFER_SECONDS ((double)AUDIO_BUFFER_FRAMES / AUDIO_SAMPLE_RATE)
+
+typedef struct {
+    int frequency;
+    int duration_ms;
+} ToneEvent;
+
+// 方波音色：32 位相位累加器，最高位决定正负半周
+typedef struct {
+    unsigned phase;
+    unsigned step;
+    int remaining;  // 剩余采样数，0 表示空闲
+} Voice;
+
+static SpscRing queue;
+static ToneEvent queue_storage[AUDIO_QUEUE_CAPACITY];
+static atomic_int running;
+static PlatformThread* audio_thread = NULL;
+
+static AudioSink active_sink;
+static FILE* wav_file = NULL;
+static long long wav_samples = 0;
+
+static Voice voices[AUDIO_MAX_VOICES];
+static short mix_buffer[AUDIO_BUFFER_FRAMES];
+static AudioStats stats;
+
+// --- WAV 输出 ---
+
+static void PutLe(unsigned char* p, unsigned v, int bytes) {
+    for (int i = 0; i < bytes; i++) p[i] = (unsigned char)(v >> (8 * i));
+}
+
+// 16 位单声道 PCM 头；数据长度在关闭时回填
+static void WriteWavHeader(FILE* file, unsigned data_bytes) {
+    unsigned char h[44];
+    memcpy(h, "RIFF", 4);
+    PutLe(h + 4, 36 + data_bytes, 4);
+    memcpy(h + 8, "WAVEfmt ", 8);
+    PutLe(h + 16, 16, 4);                     // fmt 块长度
+    PutLe(h + 20, 1, 2);                      // PCM
+    PutLe(h + 22, 1, 2);                      // 单声道
+    PutLe(h + 24, AUDIO_SAMPLE_RATE, 4);
+    PutLe(h + 28, AUDIO_SAMPLE_RATE * 2, 4);  // 每秒字节数
+    PutLe(h + 32, 2, 2);                      // 每帧字节数
+    PutLe(h + 34, 16, 2);                     // 位深
+    memcpy(h + 36, "data", 4);
+    PutLe(h + 40, data_bytes, 4);
+    fwrite(h, 1, sizeof(h), file);
+}
+
+// --- 混音 ---
+
+static void StartVoice(const ToneEvent* event) {
+    // 优先用空闲音色，否则抢占剩余时间最短的
+    int slot = 0;
+    for (int v = 0; v < AUDIO_MAX_VOICES; v++) {
+        if (voices[v].remaining < voices[slot].remaining) slot = v;
+        if (voices[v].remaining == 0) break;
+    }
+    voices[slot].phase = 0;
+    voices[slot].step = (unsigned)((double)event->frequency * 4294967296.0 / AUDIO_SAMPLE_RATE);
+    voices[slot].remaining = event->duration_ms * AUDIO_SAMPLE_RATE / 1000;
+}
+
+static void MixBuffer() {
+    int mix[AUDIO_BUFFER_FRAMES] = {0};
+    for (int v = 0; v < AUDIO_MAX_VOICES; v++) {
+        Voice* voice = &voices[v];
+        int n = voice->remaining < AUDIO_BUFFER_FRAMES ? voice->remaining : AUDIO_BUFFER_FRAMES;
+        for (int i = 0; i < n; i++) {
+            mix[i] += (voice->phase & 0x80000000u) ? VOICE_AMPLITUDE : -VOICE_AMPLITUDE;
+            voice->phase += voice->step;
+        }
+        voice->remaining -= n;
+    }
+    for (int i = 0; i < AUDIO_BUFFER_FRAMES; i++) {
+        int s = mix[i];
+        if (s > 32767) s = 32767;
+        if (s < -32768) s = -32768;
+        mix_buffer[i] = (short)s;
+    }
+}
+
+// --- 音频线程 ---
+
+static void PcmLoop() {
+    double next = PlatformNow();
+    while (atomic_load(&running)) {
+        ToneEvent event;
+        while (SpscPop(&queue, &event)) StartVoice(&event);
+
+        MixBuffer();
+        if (wav_file != NULL) {
+            unsigned char bytes[AUDIO_BUFFER_FRAMES * 2];
+            for (int i = 0; i < AUDIO_BUFFER_FRAMES; i++) PutLe(bytes + i * 2, (unsigned short)mix_buffer[i], 2);
+            fwrite(bytes, 1, sizeof(bytes), wav_file);
+            wav_samples += AUDIO_BUFFER_FRAMES;
+        }
+        stats.buffers++;
+
+        // 按实时节奏输出；落后超过一个缓冲就放弃追赶
+        next += BUFFER_SECONDS;
+        double now = PlatformNow();
+        if (now > next + BUFFER_SECONDS) {
+            stats.underruns++;
+            next = now;
+        } else {
+            PlatformSleep(next - now);
+        }
+    }
+}
+
+// 蜂鸣器一次只能发一个音：播放期间积压的事件只保留最新一个
+static void BeepLoop() {
+    while (atomic_load(&running)) {
+        ToneEvent event, latest;
+        int pending = 0;
+        while (SpscPop(&queue, &event)) {
+            latest = event;
+            pending = 1;
+        }
+        if (pending) {
+            PlatformBeep(latest.frequency, latest.duration_ms);
+        } else {
+            PlatformSleep(0.002);
+        }
+    }
+}
+
+static void AudioThreadMain(void* arg) {
+    (void)arg;
+    if (active_sink == AUDIO_SINK_BEEP) BeepLoop();
+    else PcmLoop();
+}
+
+// --- 游戏线程接口 ---
+
+int AudioStart(AudioSink sink, const char* wav_path) {
+    memset(&stats, 0, sizeof(stats));
+    memset(voices, 0, sizeof(voices));
+    SpscInit(&queue, queue_storage, AUDIO_QUEUE_CAPACITY, sizeof(ToneEvent));
+    active_sink = sink;
+
+    if (sink == AUDIO_SINK_WAV) {
+        wav_file = fopen(wav_path, "wb");
+        if (wav_file == NULL) return 0;
+        WriteWavHeader(wav_file, 0);
+        wav_samples = 0;
+    }
+
+    atomic_store(&running, 1);
+    audio_thread = PlatformThreadStart(AudioThreadMain, NULL);
+    if (audio_thread == NULL) {
+        if (wav_file != NULL) fclose(wav_file);
+        wav_file = NULL;
+        return 0;
+    }
+    return 1;
+}
+
+void AudioPlayTone(int frequency, int duration_ms) {
+    if (audio_thread == NULL) return;
+
+    double start = PlatformNow();
+    ToneEvent event = {frequency, duration_ms};
+    if (SpscPush(&queue, &event)) stats.events++;
+    else stats.dropped++;
+
+    double elapsed = PlatformNow() - start;
+    stats.post_seconds += elapsed;
+    if (elapsed > stats.post_max) stats.post_max = elapsed;
+}
+
+void AudioStop() {
+    if (audio_thread == NULL) return;
+
+    atomic_store(&running, 0);
+    PlatformThreadJoin(audio_thread);
+    audio_thread = NULL;
+
+    if (wav_file != NULL) {
+        fseek(wav_file, 0, SEEK_SET);
+        WriteWavHeader(wav_file, (unsigned)(wav_samples * 2));
+        fclose(wav_file);
+        wav_file = NULL;
+    }
+}
+
+AudioStats AudioGetStats() {
+    return stats;
+}
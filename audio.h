@@ -0,0 +1,35 @@
+#ifndef AUDIO_H
+#define AUDIO_H
+
+// 音频线程：游戏线程只把音效事件写进无锁队列 (spsc.h)，合成和输出都在独立线程完成，
+// Update() 不会再被 Beep() 阻塞几十毫秒。
+//
+// PCM 输出 (WAV 文件 / 空输出) 在音频线程中把方波音色混合成 16 位单声道缓冲区，
+// 按实时节奏每 AUDIO_BUFFER_FRAMES 个采样输出一次；蜂鸣器输出直接在音频线程调用 PlatformBeep。
+
+#define AUDIO_SAMPLE_RATE 22050
+#define AUDIO_BUFFER_FRAMES 256     // 每个混音缓冲约 11.6ms
+#define AUDIO_MAX_VOICES 16         // 同时发声的音色数，超出时抢占剩余时间最短的
+#define AUDIO_QUEUE_CAPACITY 256    // 事件队列容量 (2 的幂)
+
+typedef enum {
+    AUDIO_SINK_NULL,   // 只混音不输出 (测试/测量用)
+    AUDIO_SINK_WAV,    // 混音结果写入 WAV 文件
+    AUDIO_SINK_BEEP    // 平台蜂鸣器 (Windows Beep)，不混音
+} AudioSink;
+
+typedef struct {
+    long long events;       // 成功投递的音效事件
+    long long dropped;      // 队列满被丢弃的事件
+    double post_seconds;    // 游戏线程花在投递事件上的总时间
+    double post_max;        // 单次投递最长耗时
+    long long buffers;      // 音频线程输出的混音缓冲数
+    long long underruns;    // 没能按时完成的缓冲数
+} AudioStats;
+
+int AudioStart(AudioSink sink, const char* wav_path);  // 成功返回 1
+void AudioPlayTone(int frequency, int duration_ms);     // 游戏线程调用，从不阻塞
+void AudioStop();                                       // 结束音频线程并关闭输出
+AudioStats AudioGetStats();
+
+#endif
@@ -0,0 +1,164 @@
+#include <math.h>
+#include "autopilot.h"
+
+#define NORMAL_SPEED 0.8            // 与 Update() 中的移动速度一致
+#define SLOW_SPEED 0.25
+#define HIT_RADIUS_SQ 0.25          // 敌弹判定半径 0.5
+#define CRASH_RANGE 0.8             // 敌机本体判定
+#define NEAR_RADIUS_SQ 4.0          // 2 格以内的敌弹计入压力
+#define HIT_COST 1000.0
+#define CHASE_WEIGHT 0.05           // 向目标敌机下方靠拢的倾向
+#define MAX_THREATS 256
+
+// 危险场查询：以自机所在小格为中心的方块 (小格边长 1/DANGER_SUBDIV)
+#define FIELD_HIT_RADIUS 1          // 3x3 小格，覆盖判定半径 0.5 内的所有敌弹
+#define FIELD_NEAR_RADIUS 3         // 7x7 小格，约 1.75 格以内计入压力
+#define FIELD_NEAR_COST 0.5
+
+typedef struct {
+    double x, y, vx, vy;
+} Threat;
+
+typedef struct {
+    const Threat* threats;
+    int num_threats;
+} ScanContext;
+
+// 给定按键按住 AUTOPILOT_LOOKAHEAD 帧的代价
+typedef double (*ScoreFunc)(const GameState* game, const void* context, unsigned keys, double target_x);
+
+// 把一帧的按键作用到位置上 (含边界限制，与 Update() 相同)
+static void MovePoint(const GameConfig* config, double* x, double* y, unsigned keys) {
+    double speed = (keys & KEY_SLOW) ? SLOW_SPEED : NORMAL_SPEED;
+    if ((keys & KEY_UP) && *y > 1) *y -= speed;
+    if ((keys & KEY_DOWN) && *y < config->height - 2) *y += speed;
+    if ((keys & KEY_LEFT) && *x > 1) *x -= speed;
+    if ((keys & KEY_RIGHT) && *x < config->width - 2) *x += speed;
+}
+
+// 只保留前瞻时间内可能接近自机的敌弹和敌机
+static int CollectThreats(const GameState* game, Threat* threats) {
+    double reach = AUTOPILOT_LOOKAHEAD * (NORMAL_SPEED + 1.0) + 2.0;
+    double px = RToDouble(game->player.pos.x);
+    double py = RToDouble(game->player.pos.y);
+    int n = 0;
+
+    const BulletLane* lane = &game->enemy_bullets;
+    for (int i = 0; i < lane->count && n < MAX_THREATS; i++) {
+        double x = RToDouble(lane->x[i]);
+        double y = RToDouble(lane->y[i]);
+        if (fabs(x - px) < reach && fabs(y - py) < reach) {
+            threats[n].x = x;
+            threats[n].y = y;
+            threats[n].vx = RToDouble(lane->vx[i]);
+            threats[n].vy = RToDouble(lane->vy[i]);
+            n++;
+        }
+    }
+    return n;
+}
+
+static double ScoreKeysScan(const GameState* game, const void* context, unsigned keys, double target_x) {
+    const ScanContext* scan = (const ScanContext*)context;
+    double x = RToDouble(game->player.pos.x);
+    double y = RToDouble(game->player.pos.y);
+    double cost = 0;
+
+    for (int k = 1; k <= AUTOPILOT_LOOKAHEAD; k++) {
+        MovePoint(&game->config, &x, &y, keys);
+
+        for (int t = 0; t < scan->num_threats; t++) {
+            const Threat* threat = &scan->threats[t];
+            double dx = threat->x + threat->vx * k - x;
+            double dy = threat->y + threat->vy * k - y;
+            double d2 = dx * dx + dy * dy;
+            if (d2 < HIT_RADIUS_SQ) {
+                cost += HIT_COST / k; // 越早撞上越糟
+            } else if (d2 < NEAR_RADIUS_SQ) {
+                cost += 1.0 / (d2 * k);
+            }
+        }
+
+        const EnemyGroups* enemies = &game->enemies;
+        for (int t = 0; t < ENEMY_TYPE_COUNT; t++) {
+            double fall = RToDouble(game->archetypes[t].speed) * k;
+            for (int m = enemies->start[t]; m < enemies->start[t + 1]; m++) {
+                double ey = RToDouble(enemies->y[m]) + fall;
+                if (fabs(RToDouble(enemies->x[m]) - x) < CRASH_RANGE + 0.5 && fabs(ey - y) < CRASH_RANGE + 0.5) {
+                    cost += HIT_COST / k;
+                }
+            }
+        }
+    }
+
+    return cost + CHASE_WEIGHT * fabs(x - target_x);
+}
+
+// 危险场已包含敌弹和敌机本体，每种按键固定读 AUTOPILOT_LOOKAHEAD 个方块
+static double ScoreKeysField(const GameState* game, const void* context, unsigned keys, double target_x) {
+    const DangerField* field = (const DangerField*)context;
+    double x = RToDouble(game->player.pos.x);
+    double y = RToDouble(game->player.pos.y);
+    double cost = 0;
+
+    for (int k = 1; k <= AUTOPILOT_LOOKAHEAD; k++) {
+        MovePoint(&game->config, &x, &y, keys);
+        int hit, near;
+        DangerFieldSums(field, k, x, y, FIELD_HIT_RADIUS, FIELD_NEAR_RADIUS, &hit, &near);
+        cost += (HIT_COST * hit + FIELD_NEAR_COST * (near - hit)) / k;
+    }
+
+    return cost + CHASE_WEIGHT * fabs(x - target_x);
+}
+
+// 目标：最靠下 (最近) 的敌机正下方，没有敌机时回到中间
+static double ChooseTarget(const GameState* game) {
+    double target_x = game->config.width / 2;
+    double lowest = -1;
+    double player_y = RToDouble(game->player.pos.y);
+    for (int m = 0; m < game->enemies.count; m++) {
+        double ey = RToDouble(game->enemies.y[m]);
+        if (ey > lowest && ey < player_y - 2) {
+            lowest = ey;
+            target_x = RToDouble(game->enemies.x[m]);
+        }
+    }
+    return target_x;
+}
+
+static unsigned ChooseKeys(const GameState* game, ScoreFunc score, const void* context) {
+    static const unsigned directions[9] = {
+        0, KEY_UP, KEY_DOWN, KEY_LEFT, KEY_RIGHT,
+        KEY_UP | KEY_LEFT, KEY_UP | KEY_RIGHT, KEY_DOWN | KEY_LEFT, KEY_DOWN | KEY_RIGHT,
+    };
+
+    double target_x = ChooseTarget(game);
+    unsigned best_keys = 0;
+    double best_cost = 1e300;
+    for (int slow = 0; slow < 2; slow++) {
+        for (int d = 0; d < 9; d++) {
+            unsigned keys = directions[d] | (slow ? KEY_SLOW : 0);
+            double cost = score(game, context, keys, target_x);
+            if (cost < best_cost) {
+                best_cost = cost;
+                best_keys = keys;
+            }
+        }
+    }
+    return best_keys;
+}
+
+unsigned AutopilotScanKeys(const GameState* game) {
+    Threat threats[MAX_THREATS];
+    ScanContext scan = {threats, CollectThreats(game, threats)};
+    return ChooseKeys(game, ScoreKeysScan, &scan);
+}
+
+unsigned AutopilotFieldKeys(const GameState* game) {
+    return ChooseKeys(game, ScoreKeysField, game->danger);
+}
+
+unsigned AutopilotKeys(const GameState* game) {
+    if (DangerFieldReady(game->danger, game)) return AutopilotFieldKeys(game);
+    return AutopilotScanKeys(game);
+}
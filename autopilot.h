@@ -0,0 +1,23 @@
+#ifndef AUTOPILOT_H
+#define AUTOPILOT_H
+
+// 自动驾驶：根据当前局面选择本帧按键，供批量平衡性模拟使用
+//
+// 只读取 GameState，不消耗 game->rng，不影响模拟的确定性；同一局面总是给出同一组按键。
+// 每帧枚举 9 个方向 x 正常/慢速共 18 种按键 (慢速即 player.slow_mode 的 0.25 速度)，
+// 假设按住 AUTOPILOT_LOOKAHEAD 帧，按这段时间内自机附近的危险打分，
+// 再加上向敌机下方靠拢的倾向，取分数最低者。危险有两种来源：
+//   扫描：逐颗检查自机附近的敌弹 (最多 256 颗)，每帧代价随子弹数增长；
+//   危险场：game->danger 开启时 (AttachDangerField) 只读前瞻网格里固定数量的格子，
+//           网格由 Update() 增量维护 (见 danger.h)，每帧代价与子弹数无关。
+
+#include "game.h"
+#include "danger.h"
+
+#define AUTOPILOT_LOOKAHEAD DANGER_LOOKAHEAD
+
+unsigned AutopilotKeys(const GameState* game);      // 危险场可用时用危险场，否则扫描
+unsigned AutopilotScanKeys(const GameState* game);
+unsigned AutopilotFieldKeys(const GameState* game); // 要求 DangerFieldReady(game->danger, game)
+
+#endif
@@ -0,0 +1,364 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <stdatomic.h>
+#include "autopilot.h"
+#include "config.h"
+#include "eventlog.h"
+#include "game.h"
+#include "leaderboard.h"
+#include "platform.h"
+
+// 蒙特卡洛平衡性模拟：balance [--games N] [--threads T] [--seed S] [--max-frames F] [--danger-field] [--steps K] [难度参数] [配置参数]
+// 用自动驾驶并行跑 N 局互相独立的游戏 (第 i 局种子为 seed + i)，汇总存活时间、分数分布、
+// 擦弹数和各类敌机造成的死亡，用来调整 SpawnEnemy() 的分数阈值和生成间隔公式。
+// --steps K 用粗时间步快进 (UpdateSteps，自动驾驶每 K 帧决策一次)，统计结果与逐帧模拟相符；
+// 粗时间步不维护危险场，此时自动驾驶总是逐颗扫描敌弹。
+// --events FILE 把各局的事件追加到事件日志 (见 eventlog.h)：每个工作线程一个写入环，共用一个日志，
+// 记录的 source 为线程编号；局在日志中的先后与调度顺序有关，但每局的事件序列本身是确定的。
+// --leaderboard FILE 在全部跑完后把各局成绩按局编号一次追加到排行榜 (见 leaderboard.h)，
+// 多个 balance 进程可以同时写同一个排行榜。
+//
+// 每个工作线程有自己的 GameState，从共享计数器领取下一局的编号；结果按局编号写入数组，
+// 汇总与线程数和调度顺序无关，同样的参数总是得到同样的报告。
+
+#define SIM_HZ 62.5                  // 16ms 一步
+#define DEFAULT_GAMES 1000
+#define DEFAULT_MAX_FRAMES 37500     // 10 分钟
+#define MAX_THREADS 256
+#define SCORE_BUCKETS 10
+
+typedef struct {
+    int score;
+    int graze;
+    int frames;                          // 存活帧数 (到达 max_frames 仍未死亡则为 max_frames)
+    int killer_type;                     // -1 表示跑满 max_frames
+    int hits_by_type[ENEMY_TYPE_COUNT];
+    int kills_by_type[ENEMY_TYPE_COUNT];
+} GameResult;
+
+typedef struct {
+    int games;
+    int max_frames;
+    unsigned long long seed;
+    int danger_field;                    // 自动驾驶使用危险场 (否则逐颗扫描敌弹)
+    int steps;                           // 每次 UpdateSteps 前进的帧数
+    GameConfig config;                   // 区域大小和容量 (见 config.h)
+    GameTuning tuning;
+    GameResult* results;
+    EventLog* events;                    // 为 NULL 时不记录事件
+    atomic_int next_game;                // 下一局待领取的编号
+    atomic_int next_worker;              // 工作线程编号 (事件日志的 source)
+} BatchJob;
+
+static void RunOneGame(GameState* game, BatchJob* job, int index) {
+    RngSeed(&game->rng, job->seed + (unsigned long long)index);
+    game->tuning = job->tuning;
+    InitGame(game);
+
+    GameInput input;
+    while (game->player.lives > 0 && game->frame_count < job->max_frames) {
+        int steps = job->max_frames - game->frame_count;
+        if (steps > job->steps) steps = job->steps;
+        input.keys = AutopilotKeys(game);
+        UpdateSteps(game, &input, steps);
+    }
+
+    GameResult* r = &job->results[index];
+    r->score = game->player.score;
+    r->graze = game->player.graze_count;
+    r->frames = game->frame_count;
+    r->killer_type = game->player.lives > 0 ? -1 : game->stats.killer_type;
+    memcpy(r->hits_by_type, game->stats.hits_by_type, sizeof(r->hits_by_type));
+    memcpy(r->kills_by_type, game->stats.kills_by_type, sizeof(r->kills_by_type));
+}
+
+static void WorkerMain(void* arg) {
+    BatchJob* job = (BatchJob*)arg;
+    GameState* game = CreateGame(&job->config, job->seed);
+    if (game == NULL) return; // 剩下的局由其他线程领取
+    int worker = atomic_fetch_add_explicit(&job->next_worker, 1, memory_order_relaxed);
+    if ((job->danger_field && !AttachDangerField(game)) ||
+        (job->events != NULL && !AttachEventRing(game, job->events, worker, 0))) {
+        DestroyGame(game);
+        return;
+    }
+
+    for (;;) {
+        int index = atomic_fetch_add_explicit(&job->next_game, 1, memory_order_relaxed);
+        if (index >= job->games) break;
+        RunOneGame(game, job, index);
+    }
+    DestroyGame(game);
+}
+
+// 用 threads 个线程跑完整个批次，返回耗时 (秒)
+static double RunBatch(BatchJob* job, int threads) {
+    PlatformThread* workers[MAX_THREADS];
+    atomic_store(&job->next_game, 0);
+    atomic_store(&job->next_worker, 0);
+    memset(job->results, 0, sizeof(GameResult) * job->games);
+
+    double start = PlatformNow();
+    int started = 0;
+    for (int t = 0; t < threads; t++) {
+        workers[t] = PlatformThreadStart(WorkerMain, job);
+        if (workers[t] != NULL) started++;
+    }
+    if (started == 0) WorkerMain(job); // 无法创建线程时在当前线程运行
+    for (int t = 0; t < threads; t++) PlatformThreadJoin(workers[t]);
+    return PlatformNow() - start;
+}
+
+static int CompareInt(const void* a, const void* b) {
+    int x = *(const int*)a, y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+// 排好序的数组的百分位数 (最近秩)
+static int Percentile(const int* sorted, int n, double p) {
+    int rank = (int)(p * n);
+    if (rank >= n) rank = n - 1;
+    return sorted[rank];
+}
+
+static void PrintReport(const BatchJob* job, int threads, double elapsed) {
+    int n = job->games;
+    int* frames = (int*)malloc(sizeof(int) * n);
+    int* scores = (int*)malloc(sizeof(int) * n);
+    if (frames == NULL || scores == NULL) {
+        free(frames);
+        free(scores);
+        return;
+    }
+
+    long long total_frames = 0, score_sum = 0, graze_sum = 0;
+    int survived = 0;
+    int deaths[ENEMY_TYPE_COUNT + 1] = {0}; // 最后一项：死因未知
+    long long hits[ENEMY_TYPE_COUNT] = {0}, kills[ENEMY_TYPE_COUNT] = {0};
+    for (int i = 0; i < n; i++) {
+        const GameResult* r = &job->results[i];
+        frames[i] = r->frames;
+        scores[i] = r->score;
+        total_frames += r->frames;
+        score_sum += r->score;
+        graze_sum += r->graze;
+        if (r->killer_type < 0 && r->frames >= job->max_frames) survived++;
+        else if (r->killer_type >= 0 && r->killer_type < ENEMY_TYPE_COUNT) deaths[r->killer_type]++;
+        else deaths[ENEMY_TYPE_COUNT]++;
+        for (int t = 0; t < ENEMY_TYPE_COUNT; t++) {
+            hits[t] += r->hits_by_type[t];
+            kills[t] += r->kills_by_type[t];
+        }
+    }
+    qsort(frames, n, sizeof(int), CompareInt);
+    qsort(scores, n, sizeof(int), CompareInt);
+
+    const GameTuning* t = &job->tuning;
+    printf("games: %d  threads: %d  seed: %llu  max frames: %d  steps: %d  autopilot: %s\n", n, threads,
+           job->seed, job->max_frames, job->steps, job->danger_field && job->steps == 1 ? "danger field" : "scan");
+    printf("tuning: tier1 %d  tier2 %d  spawn interval max(%d - score/%d, %d)\n",
+           t->tier1_score, t->tier2_score, t->spawn_base, t->spawn_score_div, t->spawn_min);
+    ConfigPrint(&job->config, stdout);
+    printf("elapsed: %.3f s  games/sec: %.1f  frames/sec: %.0f\n", elapsed,
+           elapsed > 0 ? n / elapsed : 0.0, elapsed > 0 ? (double)total_frames / elapsed : 0.0);
+
+    printf("\nsurvival (s): mean %.1f  p10 %.1f  p50 %.1f  p90 %.1f  max %.1f  (%d reached the limit)\n",
+           (double)total_frames / n / SIM_HZ, Percentile(frames, n, 0.1) / SIM_HZ,
+           Percentile(frames, n, 0.5) / SIM_HZ, Percentile(frames, n, 0.9) / SIM_HZ,
+           frames[n - 1] / SIM_HZ, survived);
+    printf("score: mean %.1f  p10 %d  p50 %d  p90 %d  max %d\n", (double)score_sum / n,
+           Percentile(scores, n, 0.1), Percentile(scores, n, 0.5), Percentile(scores, n, 0.9), scores[n - 1]);
+    printf("graze: mean %.2f per game\n", (double)graze_sum / n);
+
+    // 分数分布：0 到最高分等分成 SCORE_BUCKETS 段
+    int width = scores[n - 1] / SCORE_BUCKETS + 1;
+    int buckets[SCORE_BUCKETS] = {0};
+    for (int i = 0; i < n; i++) buckets[scores[i] / width]++;
+    printf("\n%-15s %7s\n", "score", "games");
+    for (int b = 0; b < SCORE_BUCKETS; b++) {
+        char range[32];
+        snprintf(range, sizeof(range), "%d-%d", b * width, (b + 1) * width - 1);
+        printf("%-15s %7d  ", range, buckets[b]);
+        for (int k = 0; k < buckets[b] * 50 / n; k++) putchar('#');
+        putchar('\n');
+    }
+
+    const EnemyArchetype* archetypes = DefaultEnemyArchetypes();
+    printf("\n%-8s %8s %10s %10s\n", "enemy", "deaths", "hits/game", "kills/game");
+    for (int k = 0; k < ENEMY_TYPE_COUNT; k++) {
+        printf("%-8s %8d %10.2f %10.2f\n", archetypes[k].name, deaths[k], (double)hits[k] / n, (double)kills[k] / n);
+    }
+    if (deaths[ENEMY_TYPE_COUNT] > 0) printf("%-8s %8d\n", "unknown", deaths[ENEMY_TYPE_COUNT]);
+
+    free(frames);
+    free(scores);
+}
+
+// 各局成绩一次追加到排行榜 (一次加锁、一次写入)，成功返回 1
+static int RecordResults(const BatchJob* job, const char* path) {
+    const char* error = "write failed";
+    LeaderboardRecord* records = (LeaderboardRecord*)calloc((size_t)job->games, sizeof(LeaderboardRecord));
+    Leaderboard* board = records != NULL ? LeaderboardOpen(path, 1, &error) : NULL;
+    int64_t now = (int64_t)time(NULL);
+    for (int i = 0; board != NULL && i < job->games; i++) {
+        records[i].score = job->results[i].score;
+        records[i].graze = job->results[i].graze;
+        records[i].frames = job->results[i].frames;
+        records[i].seed = job->seed + (unsigned long long)i;
+        records[i].timestamp = now;
+    }
+    int ok = board != NULL && LeaderboardAdd(board, records, job->games);
+    if (ok) {
+        LeaderboardStats stats = LeaderboardGetStats(board);
+        printf("\nleaderboard: %s, %d games added, %lld records, best %d, median %d\n", path, job->games,
+               stats.records, LeaderboardBest(board), LeaderboardScoreAtPercentile(board, 50));
+    } else {
+        fprintf(stderr, "failed to record scores in %s: %s\n", path, records == NULL ? "out of memory" : error);
+    }
+    LeaderboardClose(board);
+    free(records);
+    return ok;
+}
+
+static void PrintUsage(const char* program) {
+    printf("usage: %s [--games N] [--threads T] [--seed S] [--max-frames F] [--scaling] [--danger-field] [--steps K]\n"
+           "       [--tier1 SCORE] [--tier2 SCORE] [--spawn-base N] [--spawn-div N] [--spawn-min N]\n"
+           "       [--width N] [--height N] [--max-bullets N] [--max-enemies N] [--max-items N]\n"
+           "       [--max-explosions N] [--config FILE] [--events FILE] [--leaderboard FILE]\n",
+           program);
+}
+
+int main(int argc, char** argv) {
+    static BatchJob job;
+    int threads = PlatformCpuCount();
+    int scaling = 0;
+    const char* events_path = NULL;
+    const char* leaderboard_path = NULL;
+
+    job.games = DEFAULT_GAMES;
+    job.max_frames = DEFAULT_MAX_FRAMES;
+    job.seed = 1;
+    job.steps = 1;
+    job.config = DefaultGameConfig();
+    argc = ConfigParseArgs(&job.config, argc, argv);
+    if (argc < 0) return 1;
+    {
+        // 默认难度参数以 CreateGame 为准
+        GameState* defaults = CreateGame(&job.config, 0);
+        if (defaults == NULL) {
+            fprintf(stderr, "out of memory\n");
+            return 1;
+        }
+        job.tuning = defaults->tuning;
+        DestroyGame(defaults);
+    }
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--games") == 0 && i + 1 < argc) {
+            job.games = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            job.seed = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--max-frames") == 0 && i + 1 < argc) {
+            job.max_frames = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--scaling") == 0) {
+            scaling = 1;
+        } else if (strcmp(argv[i], "--danger-field") == 0) {
+            job.danger_field = 1;
+        } else if (strcmp(argv[i], "--steps") == 0 && i + 1 < argc) {
+            job.steps = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--tier1") == 0 && i + 1 < argc) {
+            job.tuning.tier1_score = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--tier2") == 0 && i + 1 < argc) {
+            job.tuning.tier2_score = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--spawn-base") == 0 && i + 1 < argc) {
+            job.tuning.spawn_base = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--spawn-div") == 0 && i + 1 < argc) {
+            job.tuning.spawn_score_div = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--spawn-min") == 0 && i + 1 < argc) {
+            job.tuning.spawn_min = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--events") == 0 && i + 1 < argc) {
+            events_path = argv[++i];
+        } else if (strcmp(argv[i], "--leaderboard") == 0 && i + 1 < argc) {
+            leaderboard_path = argv[++i];
+        } else {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (job.games < 1 || job.max_frames < 1 || job.steps < 1 || job.steps > UPDATE_MAX_STEPS || job.tuning.spawn_score_div < 1 || job.tuning.spawn_min < 1 ||
+        (scaling && (events_path != NULL || leaderboard_path != NULL))) { // 扩展性测试会把同一批局重复跑多次，不记录事件和成绩
+        PrintUsage(argv[0]);
+        return 1;
+    }
+    if (threads < 1) threads = 1;
+    if (threads > MAX_THREADS) threads = MAX_THREADS;
+
+    job.results = (GameResult*)malloc(sizeof(GameResult) * job.games);
+    if (job.results == NULL) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    BulletActiveKernel(); // 子弹内核在启动线程前选好
+
+    if (scaling) {
+        // 线程数从 1 翻倍到 threads，比较吞吐量；各次运行的结果应完全相同
+        GameResult* reference = (GameResult*)malloc(sizeof(GameResult) * job.games);
+        if (reference == NULL) {
+            fprintf(stderr, "out of memory\n");
+            free(job.results);
+            return 1;
+        }
+        printf("%8s %10s %12s %9s %11s %6s\n", "threads", "games/sec", "frames/sec", "speedup", "efficiency",
+               "match");
+        double base = 0;
+        int mismatches = 0;
+        for (int t = 1;; t *= 2) {
+            if (t > threads) t = threads;
+            double elapsed = RunBatch(&job, t);
+            long long total_frames = 0;
+            for (int i = 0; i < job.games; i++) total_frames += job.results[i].frames;
+            double rate = (double)job.games / elapsed;
+            if (t == 1) {
+                base = rate;
+                memcpy(reference, job.results, sizeof(GameResult) * job.games);
+            }
+            int match = memcmp(reference, job.results, sizeof(GameResult) * job.games) == 0;
+            if (!match) mismatches++;
+            printf("%8d %10.1f %12.0f %8.2fx %10.0f%% %6s\n", t, rate, (double)total_frames / elapsed,
+                   rate / base, rate / base / t * 100.0, match ? "yes" : "NO");
+            if (t == threads) break;
+        }
+        free(reference);
+        free(job.results);
+        return mismatches == 0 ? 0 : 1;
+    } else {
+        if (events_path != NULL) {
+            const char* error;
+            job.events = EventLogOpen(events_path, job.config.width, job.config.height, &error);
+            if (job.events == NULL) {
+                fprintf(stderr, "failed to open event log %s: %s\n", events_path, error);
+                free(job.results);
+                return 1;
+            }
+        }
+        double elapsed = RunBatch(&job, threads);
+        PrintReport(&job, threads, elapsed);
+        if (job.events != NULL) {
+            EventLogStats stats = EventLogGetStats(job.events);
+            printf("\nevents: %s run %u, %lld records, %lld flushes (%.3f ms max), %lld dropped\n", events_path,
+                   EventLogRun(job.events), stats.records, stats.flushes, stats.flush_max * 1e3, stats.dropped);
+            EventLogClose(job.events);
+        }
+        if (leaderboard_path != NULL && !RecordResults(&job, leaderboard_path)) {
+            free(job.results);
+            return 1;
+        }
+    }
+
+    free(job.results);
+    return 0;
+}
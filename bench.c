@@ -0,0 +1,1789 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "audio.h"
+#include "autopilot.h"
+#include "game.h"
+#include "collision.h"
+#include "config.h"
+#include "env.h"
+#include "eventlog.h"
+#include "jobs.h"
+#include "frameclock.h"
+#include "render.h"
+#include "renderthread.h"
+#include "screen.h"
+#include "platform.h"
+#include "snapshot.h"
+#include "spectator.h"
+
+// 基准测试工具：bench <模式> [参数] [配置参数]
+// 每个模式构造合成数据并多次计时，输出每帧耗时，方便比较不同实现。
+// 区域大小和容量来自配置参数 (--width --max-bullets 等，见 config.h)，默认为编译时的默认配置。
+// 需要大量实体的模式请加大容量运行，或者用更大的默认容量编译，例如：
+//   -DMAX_BULLETS=200000 -DMAX_ENEMIES=20000 -DMAX_ITEMS=20000 -DMAX_EXPLOSIONS=20000
+
+// 所有模式共用的游戏配置 (main 中解析)
+static GameConfig bench_config;
+
+static float RandomRange(float lo, float hi) {
+    return lo + (hi - lo) * ((float)rand() / (float)RAND_MAX);
+}
+
+// --- 子弹积分 + 边界剔除 ---
+
+// 在场内随机放置一颗慢速子弹
+static void SpawnRandomBullet(BulletLane* lane) {
+    BulletLanePush(lane, R(RandomRange(1, bench_config.width - 1)), R(RandomRange(1, bench_config.height - 1)),
+                   R(RandomRange(-0.05f, 0.05f)), R(RandomRange(-0.05f, 0.05f)), BULLET_OWNER_ENEMY);
+}
+
+static void BenchBulletKernel(BulletKernel kernel, int count, int frames) {
+    void* storage = PlatformAlignedAlloc(32, BULLET_LANE_BYTES(count));
+    BulletLane lane;
+    BulletLaneInit(&lane, storage, count);
+
+    srand(12345);
+    for (int i = 0; i < count; i++) SpawnRandomBullet(&lane);
+    BulletSelectKernel(kernel);
+
+    double total = 0, best = 1e9;
+    for (int frame = 0; frame < frames; frame++) {
+        double start = PlatformNow();
+        BulletLaneStep(&lane, R(bench_config.width), R(bench_config.height));
+        double elapsed = PlatformNow() - start;
+        total += elapsed;
+        if (elapsed < best) best = elapsed;
+
+        // 补充被剔除的子弹，保持数量稳定 (不计时)
+        while (lane.count < count) SpawnRandomBullet(&lane);
+    }
+
+    double mean = total / frames;
+    printf("%-8s %9d %12.4f %12.4f %10.2f\n", BulletKernelName(kernel), count,
+           mean * 1e3, best * 1e3, mean * 1e9 / count);
+    PlatformAlignedFree(storage);
+}
+
+static int BenchBullets(int argc, char** argv) {
+    int counts[] = {1000, 10000, 100000, 1000000};
+    int num_counts = 4;
+    int frames = 200;
+
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "--count") == 0 && i + 1 < argc) {
+            counts[0] = atoi(argv[++i]);
+            num_counts = 1;
+        } else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frames = atoi(argv[++i]);
+        }
+    }
+
+    printf("bullet integrate + cull (%d frames, field %dx%d)\n", frames, bench_config.width, bench_config.height);
+    printf("%-8s %9s %12s %12s %10s\n", "kernel", "bullets", "mean ms", "best ms", "ns/bullet");
+    for (int c = 0; c < num_counts; c++) {
+        for (int k = 0; k < BULLET_KERNEL_COUNT; k++) {
+            if (BulletKernelSupported((BulletKernel)k)) {
+                BenchBulletKernel((BulletKernel)k, counts[c], frames);
+            }
+        }
+    }
+    return 0;
+}
+
+// --- 碰撞检测：网格粗检测 vs 逐对检测 ---
+
+// 逐对检测超过这个配对数就跳过 (耗时过长)
+#define BRUTE_FORCE_PAIR_LIMIT 2e8
+
+typedef struct {
+    int score, lives, graze;
+    int player_bullets, enemy_bullets, enemies, items;
+} CollisionOutcome;
+
+// 按种子在全场随机放置实体，两种实现使用完全相同的场景
+static void BuildCollisionScenario(GameState* game, int bullets, int enemy_count, unsigned seed) {
+    InitGame(game);
+    srand(seed);
+    RngSeed(&game->rng, seed); // 掉落道具的随机数，两种实现必须一致
+    game->player.invincible_timer = 0;
+
+    for (int k = 0; k < enemy_count; k++) {
+        Real x = R(RandomRange(1, bench_config.width - 1));
+        Real y = R(RandomRange(1, bench_config.height - 1));
+        if (PlaceEnemy(game, rand() % 3, x, y, 10) < 0) break;
+    }
+    for (int k = 0; k < bullets; k++) {
+        SpawnBullet(game, R(RandomRange(1, bench_config.width - 1)), R(RandomRange(1, bench_config.height - 1)), 0, R(-1.0), 0);
+        SpawnBullet(game, R(RandomRange(1, bench_config.width - 1)), R(RandomRange(1, bench_config.height - 1)), 0, R(0.5), 1);
+    }
+    for (int k = 0; k < enemy_count / 10; k++) {
+        SpawnItem(game, R(RandomRange(1, bench_config.width - 1)), R(RandomRange(1, bench_config.height - 1)), rand() % 2);
+    }
+}
+
+static CollisionOutcome CaptureOutcome(const GameState* game) {
+    CollisionOutcome o;
+    o.score = game->player.score;
+    o.lives = game->player.lives;
+    o.graze = game->player.graze_count;
+    o.player_bullets = game->player_bullets.count;
+    o.enemy_bullets = game->enemy_bullets.count;
+    o.enemies = game->enemies.count;
+    o.items = game->item_pool.count;
+    return o;
+}
+
+// 多次运行取平均耗时 (毫秒)，场景重建不计时
+static double TimeCollisions(GameState* game, void (*resolve)(GameState*), int bullets, int enemy_count,
+                             int runs, CollisionOutcome* outcome) {
+    double total = 0;
+    for (int r = 0; r < runs; r++) {
+        BuildCollisionScenario(game, bullets, enemy_count, 1000 + r);
+        double start = PlatformNow();
+        resolve(game);
+        total += PlatformNow() - start;
+        if (r == 0) *outcome = CaptureOutcome(game);
+    }
+    return total / runs * 1e3;
+}
+
+static int BenchCollide(int argc, char** argv) {
+    int counts[] = {100, 1000, 10000, 100000};
+    int num_counts = 4;
+    int runs = 5;
+
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "--count") == 0 && i + 1 < argc) {
+            counts[0] = atoi(argv[++i]);
+            num_counts = 1;
+        } else if (strcmp(argv[i], "--runs") == 0 && i + 1 < argc) {
+            runs = atoi(argv[++i]);
+        }
+    }
+
+    printf("collision passes 7A-7D (bullets per side = N, enemies = N/10, items = N/100)\n");
+    printf("capacity: bullets %d, enemies %d, items %d\n", bench_config.max_bullets, bench_config.max_enemies, bench_config.max_items);
+    printf("%9s %9s %12s %12s %9s %6s\n", "bullets", "enemies", "grid ms", "brute ms", "speedup", "match");
+    GameState* game = CreateGame(&bench_config, 1);
+    if (game == NULL) return 1;
+    int mismatches = 0;
+    for (int c = 0; c < num_counts; c++) {
+        int bullets = counts[c] < bench_config.max_bullets ? counts[c] : bench_config.max_bullets;
+        int enemy_count = bullets / 10 < bench_config.max_enemies ? bullets / 10 : bench_config.max_enemies;
+        if (enemy_count < 1) enemy_count = 1;
+
+        CollisionOutcome grid_outcome, brute_outcome;
+        double grid_ms = TimeCollisions(game, ResolveCollisions, bullets, enemy_count, runs, &grid_outcome);
+
+        if ((double)bullets * enemy_count > BRUTE_FORCE_PAIR_LIMIT) {
+            printf("%9d %9d %12.4f %12s %9s %6s\n", bullets, enemy_count, grid_ms, "-", "-", "-");
+            continue;
+        }
+        double brute_ms = TimeCollisions(game, ResolveCollisionsBruteForce, bullets, enemy_count, runs, &brute_outcome);
+        int match = memcmp(&grid_outcome, &brute_outcome, sizeof(CollisionOutcome)) == 0;
+        if (!match) mismatches++;
+        printf("%9d %9d %12.4f %12.4f %8.1fx %6s\n", bullets, enemy_count, grid_ms, brute_ms,
+               grid_ms > 0 ? brute_ms / grid_ms : 0.0, match ? "yes" : "NO");
+    }
+    DestroyGame(game);
+    return mismatches == 0 ? 0 : 1;
+}
+
+// --- 物理数值模式：double vs Q16.16 定点 ---
+
+// 密集弹幕场景：敌机 (自机狙 / 散射) 和敌弹铺满全场，计时完整的 Update()。
+// 结束时输出 GameHash：定点模式下不同编译器、优化选项和机器的哈希应完全相同。
+// 用同样的参数分别以默认选项和 -DUSE_FIXED_POINT 编译运行，对比两条路径。
+static int BenchPhysics(int argc, char** argv) {
+    int enemy_count = 2000;
+    int frames = 200;
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "--enemies") == 0 && i + 1 < argc) {
+            enemy_count = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frames = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--kernel") == 0 && i + 1 < argc) {
+            const char* name = argv[++i];
+            for (int k = 0; k < BULLET_KERNEL_COUNT; k++) {
+                if (strcmp(name, BulletKernelName((BulletKernel)k)) == 0) BulletSelectKernel((BulletKernel)k);
+            }
+        }
+    }
+    if (enemy_count > bench_config.max_enemies) enemy_count = bench_config.max_enemies;
+
+    GameState* game = CreateGame(&bench_config, 1);
+    if (game == NULL) return 1;
+    srand(1);
+    game->player.lives = 1 << 30; // 只测开销，不让游戏结束
+    for (int k = 0; k < enemy_count; k++) {
+        // 坐标取 1/256 的整数倍，两种模式都能精确表示，场景构造不受浮点选项影响
+        Real x = R(1) + RMUL(RFromInt(rand() % ((bench_config.width - 2) * 256)), R(1.0 / 256));
+        Real y = R(1) + RMUL(RFromInt(rand() % (bench_config.height / 2 * 256)), R(1.0 / 256));
+        int cooldown = 1 + rand() % 40;
+        if (PlaceEnemy(game, (rand() % 2) * 2, x, y, cooldown) < 0) break;
+    }
+
+    double total = 0;
+    long long bullet_frames = 0;
+    for (int f = 0; f < frames; f++) {
+        double start = PlatformNow();
+        Update(game, &(GameInput){(f / 30) % 2 ? KEY_LEFT : KEY_RIGHT});
+        total += PlatformNow() - start;
+        bullet_frames += game->enemy_bullets.count + game->player_bullets.count;
+    }
+
+    // 整数倒数平方根与 1/sqrt 的误差和耗时 (两种模式下都可运行)
+    const int samples = 1000000;
+    double max_error = 0;
+    volatile int32_t sink = 0;
+    double isqrt_start = PlatformNow();
+    for (int k = 1; k <= samples; k++) {
+        sink += FixedInvSqrt((uint64_t)k * 97 * 65536);
+    }
+    double isqrt_ns = (PlatformNow() - isqrt_start) * 1e9 / samples;
+    for (int k = 1; k <= samples; k += 97) {
+        double d = sqrt((double)k * 97 / 65536.0);
+        double error = fabs(FixedInvSqrt((uint64_t)k * 97 * 65536) / 65536.0 * d - 1.0);
+        if (error > max_error) max_error = error;
+    }
+    (void)sink;
+
+    printf("physics: %s\n", PHYSICS_FIXED_POINT ? "Q16.16 fixed point" : "double");
+    printf("sizeof: Vec2 %d  enemy %d  Item %d  Explosion %d  Player %d  bullet %d bytes\n",
+           (int)sizeof(Vec2), (int)(2 * sizeof(Real) + 2 * sizeof(int) + 1), (int)sizeof(Item), (int)sizeof(Explosion),
+           (int)sizeof(Player), (int)(4 * sizeof(LaneReal) + 1));
+    printf("update: %d enemies, %d frames, %.0f bullets/frame, %.4f ms/frame (kernel %s)\n",
+           enemy_count, frames, (double)bullet_frames / frames, total / frames * 1e3,
+           BulletKernelName(BulletActiveKernel()));
+    printf("inverse sqrt: %.2f ns/call, max relative error %.5f\n", isqrt_ns, max_error);
+    printf("state hash: %016llx\n", GameHash(game));
+    DestroyGame(game);
+    return 0;
+}
+
+// --- 弹幕模式：批量发射 vs 逐颗发射 ---
+
+#define PATTERN_BENCH_SPEED 0.3
+#define PATTERN_BENCH_PERIOD 30   // 每个发射器每 30 帧发射一次，各发射器错开
+
+typedef struct {
+    Real x, y;
+    int phase;
+    int shot;
+} BenchEmitter;
+
+static int CompareDouble(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// 原来的写法：每颗子弹现算 sin/cos，逐颗 BulletLanePush
+static int EmitRingNaive(BulletLane* lane, const BenchEmitter* e, int ring, int spin) {
+    int written = 0;
+    for (int k = 0; k < ring; k++) {
+        double angle = 2.0 * 3.14159265358979323846 * (k * PATTERN_ANGLES / ring + e->shot * spin) / PATTERN_ANGLES;
+        if (BulletLanePush(lane, (LaneReal)e->x, (LaneReal)e->y, (LaneReal)R(PATTERN_BENCH_SPEED * cos(angle)),
+                           (LaneReal)R(PATTERN_BENCH_SPEED * sin(angle)), BULLET_OWNER_ENEMY) >= 0) {
+            written++;
+        }
+    }
+    return written;
+}
+
+// 返回发射耗时 (毫秒)，frame_ms 写入每帧 (发射 + 积分剔除) 耗时
+static double RunPatternFrames(int batched, int emitter_count, int ring, int frames, double* frame_ms,
+                               long long* emitted, int* peak) {
+    void* storage = PlatformAlignedAlloc(32, BULLET_LANE_BYTES(bench_config.max_bullets));
+    BenchEmitter* emitters = (BenchEmitter*)malloc(sizeof(BenchEmitter) * emitter_count);
+    if (storage == NULL || emitters == NULL) {
+        PlatformAlignedFree(storage);
+        free(emitters);
+        return -1;
+    }
+    BulletLane lane;
+    BulletLaneInit(&lane, storage, bench_config.max_bullets);
+
+    PatternDef def = {.kind = PATTERN_SPIRAL, .count = ring, .speed = PATTERN_BENCH_SPEED, .spin = 3};
+    PatternProgram program;
+    PatternCompile(&def, &program);
+
+    srand(7);
+    for (int i = 0; i < emitter_count; i++) {
+        emitters[i].x = R(RandomRange(2, bench_config.width - 2));
+        emitters[i].y = R(RandomRange(2, bench_config.height / 2));
+        emitters[i].phase = i % PATTERN_BENCH_PERIOD;
+        emitters[i].shot = 0;
+    }
+
+    double emit_total = 0;
+    *emitted = 0;
+    *peak = 0;
+    for (int f = 0; f < frames; f++) {
+        double start = PlatformNow();
+        for (int i = 0; i < emitter_count; i++) {
+            BenchEmitter* e = &emitters[i];
+            if ((f + e->phase) % PATTERN_BENCH_PERIOD != 0) continue;
+            if (batched) {
+                *emitted += PatternEmit(&program, &lane, e->x, e->y, 0, 0, e->shot, BULLET_OWNER_ENEMY);
+            } else {
+                *emitted += EmitRingNaive(&lane, e, ring, def.spin);
+            }
+            e->shot++;
+        }
+        double emitted_at = PlatformNow();
+        BulletLaneStep(&lane, R(bench_config.width), R(bench_config.height));
+        double end = PlatformNow();
+
+        emit_total += emitted_at - start;
+        frame_ms[f] = (end - start) * 1e3;
+        if (lane.count > *peak) *peak = lane.count;
+    }
+
+    PlatformAlignedFree(storage);
+    free(emitters);
+    return emit_total * 1e3;
+}
+
+// 几百个发射器各自发射 32-64 颗的旋转环，比较两种发射方式的帧时间分布
+static int BenchPatterns(int argc, char** argv) {
+    int emitter_counts[] = {100, 300, 600};
+    int num_emitter_counts = 3;
+    int rings[] = {32, 64};
+    int frames = 600;
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "--emitters") == 0 && i + 1 < argc) {
+            emitter_counts[0] = atoi(argv[++i]);
+            num_emitter_counts = 1;
+        } else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frames = atoi(argv[++i]);
+        }
+    }
+
+    double* frame_ms = (double*)malloc(sizeof(double) * frames);
+    if (frame_ms == NULL) return 1;
+
+    printf("spiral rings, one volley per emitter every %d frames (%d frames, capacity %d)\n",
+           PATTERN_BENCH_PERIOD, frames, bench_config.max_bullets);
+    printf("%8s %5s %-8s %10s %11s %10s %10s %10s\n", "emitters", "ring", "emit", "peak live",
+           "ns/bullet", "mean ms", "p99 ms", "max ms");
+    for (int c = 0; c < num_emitter_counts; c++) {
+        for (int r = 0; r < 2; r++) {
+            for (int batched = 0; batched < 2; batched++) {
+                long long emitted;
+                int peak;
+                double emit_ms = RunPatternFrames(batched, emitter_counts[c], rings[r], frames, frame_ms,
+                                                  &emitted, &peak);
+                if (emit_ms < 0) {
+                    free(frame_ms);
+                    return 1;
+                }
+                double sum = 0;
+                for (int f = 0; f < frames; f++) sum += frame_ms[f];
+                qsort(frame_ms, frames, sizeof(double), CompareDouble);
+                printf("%8d %5d %-8s %10d %11.2f %10.4f %10.4f %10.4f\n", emitter_counts[c], rings[r],
+                       batched ? "pattern" : "per-shot", peak, emitted > 0 ? emit_ms * 1e6 / emitted : 0.0,
+                       sum / frames, frame_ms[(int)(frames * 0.99)], frame_ms[frames - 1]);
+            }
+        }
+    }
+    free(frame_ms);
+    return 0;
+}
+
+// --- 自动驾驶：危险场 vs 逐颗扫描 ---
+
+#define AUTOPILOT_BENCH_LIVES 1000000
+
+// [lo, hi) 内的随机坐标，取 1/1024 的整数倍 (两种数值模式都能精确表示)
+static Real RandomReal(Rng* rng, double lo, double hi) {
+    return R(lo) + RMUL(RFromInt(RngRange(rng, (int)((hi - lo) * 1024))), R(1.0 / 1024));
+}
+
+// 缓慢下落、略微横向漂移的敌弹；top 为 1 时只在顶部几行出现 (补充被剔除的子弹)
+static void SpawnFallingBullet(GameState* game, Rng* rng, int top) {
+    Real x = RandomReal(rng, 1, bench_config.width - 1);
+    Real y = top ? RandomReal(rng, 1, 3) : RandomReal(rng, 1, bench_config.height - 1);
+    SpawnEnemyBullet(game, x, y, RandomReal(rng, -0.1, 0.1), RandomReal(rng, 0.1, 0.4), 0);
+}
+
+static GameState* CreateAutopilotScenario(int bullets, int field) {
+    GameState* game = CreateGame(&bench_config, 7);
+    if (game == NULL) return NULL;
+    if (field && !AttachDangerField(game)) {
+        DestroyGame(game);
+        return NULL;
+    }
+    game->player.lives = AUTOPILOT_BENCH_LIVES;
+    Rng rng;
+    RngSeed(&rng, 99);
+    for (int k = 0; k < bullets; k++) SpawnFallingBullet(game, &rng, 0);
+    return game;
+}
+
+typedef struct {
+    double bot_seconds;
+    double update_seconds;
+    int hits;
+} AutopilotRun;
+
+// 用 keys 选择按键跑 frames 帧；keys 为 NULL 时重放 script。每帧把敌弹补到 bullets 颗 (不计时)
+static AutopilotRun RunAutopilot(GameState* game, unsigned (*keys)(const GameState*), unsigned* script,
+                                 int bullets, int frames) {
+    AutopilotRun run = {0, 0, 0};
+    Rng rng;
+    RngSeed(&rng, 100);
+    for (int f = 0; f < frames; f++) {
+        GameInput input;
+        if (keys != NULL) {
+            double start = PlatformNow();
+            input.keys = keys(game);
+            run.bot_seconds += PlatformNow() - start;
+            if (script != NULL) script[f] = input.keys;
+        } else {
+            input.keys = script[f];
+        }
+
+        double start = PlatformNow();
+        Update(game, &input);
+        run.update_seconds += PlatformNow() - start;
+
+        // 关掉擦弹无敌，hits 才能反映躲避效果 (三局都一样处理)
+        game->player.invincible_timer = 0;
+        while (game->enemy_bullets.count < bullets) SpawnFallingBullet(game, &rng, 1);
+    }
+    run.hits = AUTOPILOT_BENCH_LIVES - game->player.lives;
+    return run;
+}
+
+static int BenchAutopilot(int argc, char** argv) {
+    int counts[] = {100, 1000, 10000, 100000};
+    int num_counts = 4;
+    int frames = 300;
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "--count") == 0 && i + 1 < argc) {
+            counts[0] = atoi(argv[++i]);
+            num_counts = 1;
+        } else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frames = atoi(argv[++i]);
+        }
+    }
+    unsigned* script = (unsigned*)malloc(sizeof(unsigned) * frames);
+    if (script == NULL) return 1;
+
+    printf("autopilot: %d frames, lookahead %d, danger field %dx%d cells\n", frames, AUTOPILOT_LOOKAHEAD,
+           bench_config.width * DANGER_SUBDIV, bench_config.height * DANGER_SUBDIV);
+    printf("%9s %11s %11s %12s %12s %10s %10s %6s\n", "bullets", "scan us", "field us", "update us",
+           "upd+field us", "scan hits", "field hits", "hash");
+    int all_match = 1;
+    for (int c = 0; c < num_counts; c++) {
+        int bullets = counts[c] < bench_config.max_bullets ? counts[c] : bench_config.max_bullets;
+        GameState* scan = CreateAutopilotScenario(bullets, 0);
+        GameState* field = CreateAutopilotScenario(bullets, 1);
+        GameState* plain = CreateAutopilotScenario(bullets, 0);
+        if (scan == NULL || field == NULL || plain == NULL) {
+            DestroyGame(scan);
+            DestroyGame(field);
+            DestroyGame(plain);
+            free(script);
+            return 1;
+        }
+
+        // 同一场景：扫描版和危险场版各自驾驶；plain 不开危险场，重放危险场版的按键，
+        // 用来计算维护危险场的额外开销，并校验危险场不影响模拟结果
+        AutopilotRun scan_run = RunAutopilot(scan, AutopilotScanKeys, NULL, bullets, frames);
+        AutopilotRun field_run = RunAutopilot(field, AutopilotKeys, script, bullets, frames);
+        AutopilotRun plain_run = RunAutopilot(plain, NULL, script, bullets, frames);
+        int match = GameHash(field) == GameHash(plain);
+        all_match &= match;
+
+        printf("%9d %11.2f %11.2f %12.2f %12.2f %10d %10d %6s\n", bullets,
+               scan_run.bot_seconds / frames * 1e6, field_run.bot_seconds / frames * 1e6,
+               plain_run.update_seconds / frames * 1e6, field_run.update_seconds / frames * 1e6,
+               scan_run.hits, field_run.hits, match ? "match" : "DIFF");
+        DestroyGame(scan);
+        DestroyGame(field);
+        DestroyGame(plain);
+    }
+    free(script);
+    return all_match ? 0 : 1;
+}
+
+// --- 粗时间步：连续碰撞检测 vs 逐帧参考 ---
+
+#define SWEEP_BENCH_DECISION 8      // 自动驾驶每 8 帧决策一次，各种步长看到同样的输入策略
+#define SWEEP_BENCH_LIVES 1000000   // 弹幕场景中被击中不会结束 (撞上敌机本体仍会)
+#define SWEEP_BENCH_SIGMAS 3.0      // 允许的统计误差：均值之差的标准误的倍数
+
+enum { SWEEP_FRAMES, SWEEP_SCORE, SWEEP_KILLS, SWEEP_GRAZES, SWEEP_HITS, SWEEP_METRICS };
+
+typedef struct {
+    double seconds;                 // 只计 UpdateSteps
+    int games;
+    double sum[SWEEP_METRICS];      // 每局结果的和与平方和
+    double sum_sq[SWEEP_METRICS];
+} SweepTotals;
+
+// 跑 games 局 (种子 1..games)，每局最多 max_frames 帧；bullets > 0 时为弹幕场景：
+// 被击中不扣命，每次决策前把下落的敌弹补到 bullets 颗
+static SweepTotals RunSweepBatch(int games, int max_frames, int bullets, int steps) {
+    SweepTotals totals;
+    memset(&totals, 0, sizeof(totals));
+    GameState* game = CreateGame(&bench_config, 1);
+    if (game == NULL) return totals;
+
+    for (int g = 0; g < games; g++) {
+        RngSeed(&game->rng, (unsigned long long)g + 1);
+        InitGame(game);
+        Rng rng;
+        RngSeed(&rng, (unsigned long long)g + 1000);
+        if (bullets > 0) game->player.lives = SWEEP_BENCH_LIVES;
+
+        while (game->player.lives > 0 && game->frame_count < max_frames) {
+            while (game->enemy_bullets.count < bullets) SpawnFallingBullet(game, &rng, 0);
+            GameInput input;
+            input.keys = AutopilotScanKeys(game);
+
+            double start = PlatformNow();
+            int end = game->frame_count + SWEEP_BENCH_DECISION;
+            if (end > max_frames) end = max_frames;
+            while (game->player.lives > 0 && game->frame_count < end) {
+                int n = end - game->frame_count;
+                UpdateSteps(game, &input, n < steps ? n : steps);
+            }
+            totals.seconds += PlatformNow() - start;
+        }
+
+        double v[SWEEP_METRICS] = {game->frame_count, game->player.score, 0, game->player.graze_count, 0};
+        for (int t = 0; t < ENEMY_TYPE_COUNT; t++) {
+            v[SWEEP_KILLS] += game->stats.kills_by_type[t];
+            v[SWEEP_HITS] += game->stats.hits_by_type[t];
+        }
+        for (int k = 0; k < SWEEP_METRICS; k++) {
+            totals.sum[k] += v[k];
+            totals.sum_sq[k] += v[k] * v[k];
+        }
+        totals.games++;
+    }
+    DestroyGame(game);
+    return totals;
+}
+
+static double SweepMean(const SweepTotals* t, int k) {
+    return t->games > 0 ? t->sum[k] / t->games : 0.0;
+}
+
+static double SweepVariance(const SweepTotals* t, int k) {
+    if (t->games < 2) return 0.0;
+    double mean = SweepMean(t, k);
+    return (t->sum_sq[k] - t->games * mean * mean) / (t->games - 1);
+}
+
+// 每局均值与逐帧参考之差不超过 tolerance * 参考均值 + SWEEP_BENCH_SIGMAS 倍标准误
+static int SweepMatches(const SweepTotals* t, const SweepTotals* reference, double tolerance) {
+    for (int k = 0; k < SWEEP_METRICS; k++) {
+        double diff = fabs(SweepMean(t, k) - SweepMean(reference, k));
+        double se = sqrt(SweepVariance(t, k) / t->games + SweepVariance(reference, k) / reference->games);
+        if (diff > tolerance * fabs(SweepMean(reference, k)) + SWEEP_BENCH_SIGMAS * se) return 0;
+    }
+    return 1;
+}
+
+static int BenchSweep(int argc, char** argv) {
+    int games = 100;
+    int max_frames = 5000;
+    int bullets = 2000;
+    double tolerance = 0.05;
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "--games") == 0 && i + 1 < argc) {
+            games = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            max_frames = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--bullets") == 0 && i + 1 < argc) {
+            bullets = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc) {
+            tolerance = atof(argv[++i]);
+        }
+    }
+    if (games < 2 || max_frames < 1) return 1;
+    if (bullets > bench_config.max_bullets) {
+        fprintf(stderr, "warning: --bullets %d exceeds --max-bullets %d, the barrage keeps the lane full with %d\n",
+                bullets, bench_config.max_bullets, bench_config.max_bullets);
+        bullets = bench_config.max_bullets;
+    }
+
+    // 正常对局和弹幕场景 (bullets 为 0 时跳过)，各步长的每局均值都要与逐帧模拟相符
+    int all_ok = 1;
+    for (int sc = 0; sc < 2; sc++) {
+        int scenario_bullets = sc == 0 ? 0 : bullets;
+        if (sc == 1 && bullets <= 0) break;
+        if (sc == 0) {
+            printf("game: %d games x %d frames\n", games, max_frames);
+        } else {
+            printf("barrage: %d games x %d frames, %d falling enemy bullets topped up every decision (max-bullets %d)\n",
+                   games, max_frames, bullets, bench_config.max_bullets);
+        }
+        printf("%6s %10s %8s %9s %9s %8s %9s %7s %6s\n", "steps", "us/frame", "speedup", "frames",
+               "score", "kills", "grazes", "hits", "match");
+
+        SweepTotals reference;
+        for (int steps = 1; steps <= UPDATE_MAX_STEPS; steps *= 2) {
+            SweepTotals t = RunSweepBatch(games, max_frames, scenario_bullets, steps);
+            if (steps == 1) reference = t;
+            int ok = SweepMatches(&t, &reference, tolerance);
+            all_ok &= ok;
+
+            double per_frame = t.seconds / t.sum[SWEEP_FRAMES] * 1e6;
+            double reference_per_frame = reference.seconds / reference.sum[SWEEP_FRAMES] * 1e6;
+            printf("%6d %10.3f %7.2fx %9.1f %9.1f %8.2f %9.2f %7.3f %6s\n", steps, per_frame,
+                   reference_per_frame / per_frame, SweepMean(&t, SWEEP_FRAMES), SweepMean(&t, SWEEP_SCORE),
+                   SweepMean(&t, SWEEP_KILLS), SweepMean(&t, SWEEP_GRAZES), SweepMean(&t, SWEEP_HITS),
+                   ok ? "ok" : "DIFF");
+        }
+        printf("\n");
+    }
+    printf("per-game means; match = within %.0f%% + %.0f standard errors of the steps=1 reference\n",
+           tolerance * 100, SWEEP_BENCH_SIGMAS);
+    return all_ok ? 0 : 1;
+}
+
+// --- 快照：捕获 / 恢复 / 快照环的开销与实体数量的关系 ---
+
+#define SNAPSHOT_BENCH_KEYFRAME 30
+
+// 把 block 恢复到另一局游戏里，比较状态哈希
+static int SnapshotMatches(GameState* scratch, const void* block, unsigned long long expected) {
+    return SnapshotRestore(scratch, block) && GameHash(scratch) == expected;
+}
+
+static int BenchSnapshot(int argc, char** argv) {
+    int counts[] = {10, 100, 1000, 10000, 100000};
+    int num_counts = 5;
+    int frames = 60;
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "--count") == 0 && i + 1 < argc) {
+            counts[0] = atoi(argv[++i]);
+            num_counts = 1;
+        } else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frames = atoi(argv[++i]);
+        }
+    }
+    if (frames < 2) frames = 2;
+
+    GameState* game = CreateGame(&bench_config, 1);
+    GameState* scratch = CreateGame(&bench_config, 1);
+    void* block = PlatformAlignedAlloc(64, SnapshotMaxBytes(&bench_config));
+    unsigned long long* hashes = (unsigned long long*)malloc(sizeof(unsigned long long) * frames);
+    SnapshotRing* ring = CreateSnapshotRing(&bench_config, frames, SNAPSHOT_BENCH_KEYFRAME, 4 * SnapshotMaxBytes(&bench_config));
+    if (game == NULL || scratch == NULL || block == NULL || hashes == NULL || ring == NULL) return 1;
+
+    printf("snapshot (bullets per side = N, enemies = N/10, items = N/100), ring of %d frames, keyframe every %d\n",
+           frames, SNAPSHOT_BENCH_KEYFRAME);
+    printf("capacity: bullets %d, enemies %d, items %d, max snapshot %d bytes\n",
+           bench_config.max_bullets, bench_config.max_enemies, bench_config.max_items, (int)SnapshotMaxBytes(&bench_config));
+    printf("%8s %7s %10s %11s %11s %9s %11s %7s %10s %6s\n", "bullets", "enemies", "bytes", "capture us",
+           "restore us", "push us", "bytes/frame", "ratio", "rewind us", "match");
+
+    int mismatches = 0;
+    for (int c = 0; c < num_counts; c++) {
+        int bullets = counts[c] < bench_config.max_bullets ? counts[c] : bench_config.max_bullets;
+        int enemy_count = bullets / 10 < bench_config.max_enemies ? bullets / 10 : bench_config.max_enemies;
+        if (enemy_count < 1) enemy_count = 1;
+        BuildCollisionScenario(game, bullets, enemy_count, 1000);
+        game->player.lives = 1 << 30;
+
+        // 单次捕获 / 恢复：小场景重复多次取平均
+        int reps = 2000000 / (bullets + 100) + 1;
+        double start = PlatformNow();
+        size_t bytes = 0;
+        for (int r = 0; r < reps; r++) bytes = SnapshotCapture(game, block);
+        double capture_us = (PlatformNow() - start) * 1e6 / reps;
+        start = PlatformNow();
+        for (int r = 0; r < reps; r++) SnapshotRestore(scratch, block);
+        double restore_us = (PlatformNow() - start) * 1e6 / reps;
+        int match = GameHash(scratch) == GameHash(game);
+
+        // 快照环：每帧 Update 之后压入，再逐帧校验解码结果
+        SnapshotRingClear(ring);
+        double push_total = 0;
+        for (int f = 0; f < frames; f++) {
+            Update(game, &(GameInput){(f / 20) % 2 ? KEY_LEFT : KEY_RIGHT});
+            start = PlatformNow();
+            SnapshotRingPush(ring, game);
+            push_total += PlatformNow() - start;
+            hashes[f] = GameHash(game);
+        }
+        SnapshotRingStats stats = SnapshotRingGetStats(ring);
+        for (int back = 0; back < stats.frames && match; back++) {
+            match = SnapshotRingLoad(ring, back, block) > 0
+                 && SnapshotMatches(scratch, block, hashes[frames - 1 - back]);
+        }
+
+        // 倒带到最旧的一帧 (最长的差分链)，重新模拟到最后一帧，结果必须相同
+        int back = stats.frames - 1;
+        start = PlatformNow();
+        match = match && SnapshotRingRewind(ring, back, game);
+        double rewind_us = (PlatformNow() - start) * 1e6;
+        for (int f = frames - back; f < frames; f++) {
+            Update(game, &(GameInput){(f / 20) % 2 ? KEY_LEFT : KEY_RIGHT});
+        }
+        match = match && GameHash(game) == hashes[frames - 1];
+        if (!match) mismatches++;
+
+        printf("%8d %7d %10d %11.2f %11.2f %9.2f %11.0f %6.1fx %10.2f %6s\n", bullets, enemy_count, (int)bytes,
+               capture_us, restore_us, push_total * 1e6 / frames, (double)stats.stored_bytes / stats.frames,
+               stats.stored_bytes > 0 ? (double)stats.raw_bytes / stats.stored_bytes : 0.0, rewind_us,
+               match ? "yes" : "NO");
+    }
+
+    DestroySnapshotRing(ring);
+    free(hashes);
+    PlatformAlignedFree(block);
+    DestroyGame(scratch);
+    DestroyGame(game);
+    return mismatches == 0 ? 0 : 1;
+}
+
+// --- 观战流：多个观众 (其中一个故意读得很慢) 的带宽、延迟和跳帧 ---
+
+#define SPECTATOR_BENCH_PATH "bench_spectator.sock"
+#define SPECTATOR_BENCH_MAX_VIEWERS 16
+#define SPECTATOR_BENCH_SAMPLES 65536
+
+typedef struct {
+    double read_delay;        // 每收到一帧后停顿的时间 (模拟慢观众)
+    SpectatorClient client;
+    double* latencies;
+    int num_latencies;
+    int connected;
+    double seconds;
+} BenchViewer;
+
+static void BenchViewerMain(void* arg) {
+    BenchViewer* viewer = (BenchViewer*)arg;
+    viewer->connected = SpectatorConnect(&viewer->client, SPECTATOR_BENCH_PATH);
+    if (!viewer->connected) return;
+
+    double start = PlatformNow();
+    SpectatorPacket packet;
+    int result;
+    while ((result = SpectatorReceive(&viewer->client, &packet, 0.1)) >= 0) {
+        if (result == 0) continue;
+        if (viewer->num_latencies < SPECTATOR_BENCH_SAMPLES) {
+            viewer->latencies[viewer->num_latencies++] = PlatformNow() - packet.published;
+        }
+        if (viewer->read_delay > 0) PlatformSleep(viewer->read_delay);
+    }
+    viewer->seconds = PlatformNow() - start;
+}
+
+static int BenchSpectator(int argc, char** argv) {
+    int num_fast = 2;
+    int frames = 600;
+    double fps = 62.5;
+    double slow_delay = 0.1;
+    int keyframe = SPECTATOR_DEFAULT_KEYFRAME;
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "--viewers") == 0 && i + 1 < argc) {
+            num_fast = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frames = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc) {
+            fps = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--slow-delay") == 0 && i + 1 < argc) {
+            slow_delay = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--keyframe") == 0 && i + 1 < argc) {
+            keyframe = atoi(argv[++i]);
+        }
+    }
+    if (num_fast < 0) num_fast = 0;
+    if (num_fast > SPECTATOR_BENCH_MAX_VIEWERS - 1) num_fast = SPECTATOR_BENCH_MAX_VIEWERS - 1;
+    int num_viewers = num_fast + (slow_delay > 0 ? 1 : 0);
+
+    if (!SpectatorStart(SPECTATOR_BENCH_PATH, keyframe, bench_config.width, bench_config.height)) {
+        fprintf(stderr, "failed to listen on %s\n", SPECTATOR_BENCH_PATH);
+        return 1;
+    }
+    BenchViewer viewers[SPECTATOR_BENCH_MAX_VIEWERS];
+    PlatformThread* threads[SPECTATOR_BENCH_MAX_VIEWERS];
+    memset(viewers, 0, sizeof(viewers));
+    for (int v = 0; v < num_viewers; v++) {
+        viewers[v].read_delay = v < num_fast ? 0 : slow_delay;
+        viewers[v].latencies = (double*)malloc(sizeof(double) * SPECTATOR_BENCH_SAMPLES);
+        threads[v] = PlatformThreadStart(BenchViewerMain, &viewers[v]);
+    }
+    PlatformSleep(0.05); // 等观众连上
+
+    // 按固定帧率模拟 + 绘制 + 发布，与 plane_game 的渲染路径相同
+    GameState* game = CreateGame(&bench_config, 1);
+    if (game == NULL) return 1;
+    char* buffer = game->render_buffer;
+    double start = PlatformNow();
+    for (int f = 0; f < frames; f++) {
+        Update(game, &(GameInput){(f / 40) % 2 ? KEY_LEFT : KEY_RIGHT});
+        if (game->player.lives <= 0) InitGame(game);
+        RenderWorld(game, buffer);
+        SpectatorPublish(game, buffer);
+        if (fps > 0) {
+            double next = start + (f + 1) / fps;
+            double now = PlatformNow();
+            if (next > now) PlatformSleep(next - now);
+        }
+    }
+    double elapsed = PlatformNow() - start;
+    SpectatorStop(); // 断开所有观众，观众线程随之结束
+    for (int v = 0; v < num_viewers; v++) PlatformThreadJoin(threads[v]);
+    DestroyGame(game);
+
+    SpectatorStats stats = SpectatorGetStats();
+    printf("spectator: %d frames in %.2f s, keyframe every %d, %d viewers (%d fast, %d reading every %.0f ms)\n",
+           frames, elapsed, keyframe, num_viewers, num_fast, num_viewers - num_fast, slow_delay * 1e3);
+    printf("publisher: %lld published, %lld dropped, game thread %.2f us/frame (%.2f us max)\n",
+           stats.published, stats.dropped, stats.published > 0 ? stats.post_seconds * 1e6 / stats.published : 0.0,
+           stats.post_max * 1e6);
+    printf("writer: %lld keyframes, %lld deltas, %.1f bytes/frame encoded (raw %d), %lld bytes sent, "
+           "%lld frames skipped, %lld resyncs\n",
+           stats.keyframes, stats.deltas,
+           stats.published > 0 ? (double)stats.encoded_bytes / stats.published : 0.0,
+           (int)(sizeof(SpectatorPacket) + SPECTATOR_VIEW_BYTES(bench_config.width, bench_config.height)), stats.sent_bytes, stats.skipped, stats.resyncs);
+    printf("%6s %8s %8s %9s %8s %7s %10s %9s %9s %9s\n", "viewer", "delay ms", "frames", "keyframes", "skipped",
+           "errors", "KB/s", "p50 ms", "p99 ms", "max ms");
+
+    int failures = 0;
+    for (int v = 0; v < num_viewers; v++) {
+        BenchViewer* viewer = &viewers[v];
+        const SpectatorClient* c = &viewer->client;
+        if (!viewer->connected || c->errors > 0 || (viewer->read_delay == 0 && c->skipped > 0)) failures++;
+        double p50 = 0, p99 = 0, max = 0;
+        if (viewer->num_latencies > 0) {
+            qsort(viewer->latencies, (size_t)viewer->num_latencies, sizeof(double), CompareDouble);
+            p50 = viewer->latencies[viewer->num_latencies / 2];
+            p99 = viewer->latencies[(int)(viewer->num_latencies * 0.99)];
+            max = viewer->latencies[viewer->num_latencies - 1];
+        }
+        printf("%6d %8.0f %8lld %9lld %8lld %7lld %10.2f %9.3f %9.3f %9.3f\n", v, viewer->read_delay * 1e3,
+               c->frames, c->keyframes, c->skipped, c->errors,
+               viewer->seconds > 0 ? c->received_bytes / viewer->seconds / 1024 : 0.0, p50 * 1e3, p99 * 1e3,
+               max * 1e3);
+        if (viewer->connected) SpectatorDisconnect(&viewer->client);
+        free(viewer->latencies);
+    }
+    return failures == 0 ? 0 : 1;
+}
+
+// --- 渲染线程：终端卡顿时模拟步的抖动 ---
+
+// 模拟的终端：每 every 次输出卡住 stall 秒，其余输出立即完成
+typedef struct {
+    int every;
+    double stall;
+    long long writes;
+    char* buffer;                   // 游戏区域的字符缓冲
+    char hud[HUD_WIDTH + 1];
+} BenchTerminal;
+
+static void BenchTerminalWrite(BenchTerminal* terminal) {
+    if (++terminal->writes % terminal->every == 0) PlatformSleep(terminal->stall);
+}
+
+static void BenchPresentSnapshot(const RenderSnapshot* snapshot, void* context) {
+    BenchTerminal* terminal = (BenchTerminal*)context;
+    RenderSnapshotWorld(snapshot, terminal->buffer);
+    RenderSnapshotHud(snapshot, terminal->hud, sizeof(terminal->hud));
+    BenchTerminalWrite(terminal);
+}
+
+typedef struct {
+    FrameClock clock;
+    RenderThreadStats thread;
+} RenderBenchResult;
+
+// 按 62.5 Hz 实时运行 seconds 秒；threaded 为 0 时在游戏线程绘制和输出 (与 plane_game 默认相同)
+static RenderBenchResult RunRenderBench(int threaded, double seconds, double fps, BenchTerminal* terminal) {
+    RenderBenchResult result;
+    memset(&result, 0, sizeof(result));
+    GameState* game = CreateGame(&bench_config, 1);
+    if (game == NULL || (threaded && !RenderThreadStart(&bench_config, fps, BenchPresentSnapshot, terminal))) {
+        DestroyGame(game);
+        result.clock.frames = -1;
+        return result;
+    }
+    terminal->writes = 0;
+
+    FrameClock* clock = &result.clock;
+    double start = PlatformNow();
+    FrameClockInit(clock, SIM_TICK_SECONDS, fps, DEFAULT_MAX_CATCHUP, start);
+    GameInput input = {0};
+    while (PlatformNow() - start < seconds) {
+        double frame_start = PlatformNow();
+        int ticks = FrameClockAdvance(clock, frame_start);
+        for (int t = 0; t < ticks; t++) {
+            input.keys = (game->frame_count / 60) % 2 ? KEY_LEFT : KEY_RIGHT;
+            Update(game, &input);
+            if (game->player.lives <= 0) InitGame(game);
+        }
+
+        double sim_end = PlatformNow();
+        double render_end = sim_end;
+        if (ticks > 0 && threaded) {
+            RenderThreadPublish(game, 0);
+            render_end = PlatformNow();
+        } else if (ticks > 0 && FrameClockShouldRender(clock, sim_end)) {
+            RenderWorld(game, terminal->buffer);
+            RenderHud(game, terminal->hud, sizeof(terminal->hud));
+            BenchTerminalWrite(terminal);
+            render_end = PlatformNow();
+        }
+        FrameClockEndFrame(clock, ticks, sim_end - frame_start, render_end - sim_end, render_end);
+        FrameClockWait(clock);
+    }
+    if (threaded) {
+        RenderThreadStop();
+        result.thread = RenderThreadGetStats();
+    }
+    DestroyGame(game);
+    return result;
+}
+
+static int BenchRender(int argc, char** argv) {
+    double seconds = 4;
+    double fps = DEFAULT_RENDER_HZ;
+    double stall_ms = 50;
+    int stall_every = 20;
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) {
+            seconds = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc) {
+            fps = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--stall-ms") == 0 && i + 1 < argc) {
+            stall_ms = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--stall-every") == 0 && i + 1 < argc) {
+            stall_every = atoi(argv[++i]);
+        }
+    }
+    if (stall_every < 1) stall_every = 1;
+
+    BenchTerminal terminal;
+    memset(&terminal, 0, sizeof(terminal));
+    terminal.every = stall_every;
+    terminal.stall = stall_ms * 1e-3;
+    terminal.buffer = (char*)malloc((size_t)bench_config.height * (bench_config.width + 1));
+    RenderSnapshot* snapshot = (RenderSnapshot*)malloc(RenderSnapshotBytes(&bench_config));
+    char* reference = (char*)malloc((size_t)bench_config.height * (bench_config.width + 1));
+    GameState* game = CreateGame(&bench_config, 1);
+    if (terminal.buffer == NULL || snapshot == NULL || reference == NULL || game == NULL) return 1;
+
+    // 快照画出的画面必须与直接绘制逐字节相同
+    RenderSnapshotInit(snapshot, &bench_config);
+    size_t field_bytes = (size_t)bench_config.height * (bench_config.width + 1);
+    int checked = 0, mismatched = 0;
+    GameInput input = {0};
+    for (int f = 0; f < 3000; f++) {
+        input.keys = ((f / 45) % 2 ? KEY_LEFT : KEY_RIGHT) | ((f / 100) % 2 ? KEY_SLOW : 0);
+        Update(game, &input);
+        if (game->player.lives <= 0) InitGame(game);
+        if (f % 10 != 0) continue;
+        char hud[HUD_WIDTH + 1], snapshot_hud[HUD_WIDTH + 1];
+        RenderWorld(game, reference);
+        RenderHud(game, hud, sizeof(hud));
+        CaptureRenderSnapshot(game, snapshot);
+        RenderSnapshotWorld(snapshot, terminal.buffer);
+        RenderSnapshotHud(snapshot, snapshot_hud, sizeof(snapshot_hud));
+        checked++;
+        mismatched += memcmp(reference, terminal.buffer, field_bytes) != 0 || strcmp(hud, snapshot_hud) != 0;
+    }
+    DestroyGame(game);
+    free(reference);
+    free(snapshot);
+
+    printf("render: %.1f s per mode at %.1f Hz sim / %.0f Hz render, terminal stalls %.0f ms every %d writes\n",
+           seconds, 1.0 / SIM_TICK_SECONDS, fps, stall_ms, stall_every);
+    printf("snapshot: %d bytes for this config, picture %s (%d frames compared)\n",
+           (int)RenderSnapshotBytes(&bench_config), mismatched == 0 ? "identical" : "DIFFERS", checked);
+    printf("%-14s %7s %12s %12s %8s %8s %9s %8s %10s\n", "mode", "ticks", "jitter rms", "jitter max", "missed",
+           "dropped", "presented", "dropped", "duplicated");
+    printf("%-14s %7s %12s %12s %8s %8s %9s %8s %10s\n", "", "", "", "", "deadline", "ticks", "frames", "frames",
+           "frames");
+    for (int threaded = 0; threaded < 2; threaded++) {
+        RenderBenchResult r = RunRenderBench(threaded, seconds, fps, &terminal);
+        if (r.clock.frames < 0) return 1;
+        const FrameClock* c = &r.clock;
+        if (threaded) {
+            printf("%-14s %7lld %9.3f ms %9.3f ms %8lld %8lld %9lld %8lld %10lld\n", "render thread", c->ticks,
+                   FrameClockJitterRms(c) * 1e3, c->jitter_max * 1e3, c->missed, c->dropped_ticks,
+                   r.thread.presented, r.thread.dropped, r.thread.duplicated);
+            printf("               publish %.2f us avg / %.2f us max on the game thread, snapshot age max %.2f ms\n",
+                   r.thread.published > 0 ? r.thread.publish_seconds * 1e6 / r.thread.published : 0.0,
+                   r.thread.publish_max * 1e6, r.thread.age_max * 1e3);
+        } else {
+            printf("%-14s %7lld %9.3f ms %9.3f ms %8lld %8lld %9lld %8s %10s\n", "inline Draw", c->ticks,
+                   FrameClockJitterRms(c) * 1e3, c->jitter_max * 1e3, c->missed, c->dropped_ticks, c->renders, "-",
+                   "-");
+        }
+    }
+    free(terminal.buffer);
+    return mismatched == 0 ? 0 : 1;
+}
+
+// --- 差分输出：最大区域上的稀疏变化 ---
+
+#define SCREEN_BENCH_STRIDES 4
+
+// 按 ScreenEncode 的输出 ("\033[2J"、"\033[行;列H" 和文本) 更新模拟终端，格式不对时返回 0
+static int ApplyScreenOutput(char* terminal, int cols, int rows, const char* out, int len) {
+    int x = 0, y = 0;
+    for (int i = 0; i < len;) {
+        if (out[i] != '\033') {
+            if (x >= cols || y >= rows) return 0;
+            terminal[(size_t)y * cols + x++] = out[i++];
+            continue;
+        }
+        if (i + 3 < len && memcmp(out + i, "\033[2J", 4) == 0) {
+            memset(terminal, ' ', (size_t)cols * rows);
+            i += 4;
+            continue;
+        }
+        int row = 0, col = 0;
+        for (i += 2; i < len && out[i] >= '0' && out[i] <= '9'; i++) row = row * 10 + out[i] - '0';
+        if (i >= len || out[i++] != ';') return 0;
+        for (; i < len && out[i] >= '0' && out[i] <= '9'; i++) col = col * 10 + out[i] - '0';
+        if (i >= len || out[i++] != 'H' || row < 1 || col < 1) return 0;
+        y = row - 1;
+        x = col - 1;
+    }
+    return 1;
+}
+
+// 在允许的最大区域 (加一行状态栏) 上交替输出空白帧和每隔 stride 列一个字符的稀疏帧，
+// stride 为 RUN_MERGE_GAP + 2 = 8 时每个变化的字符都单独成段，是输出缓冲区的最坏情况。
+// 校验每帧的输出不超过缓冲区、解码后与新一帧逐字节相同。用 -fsanitize=address 编译可以检查越界写
+static int BenchScreen(int argc, char** argv) {
+    int frames = 64;
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) frames = atoi(argv[++i]);
+    }
+    static const int strides[SCREEN_BENCH_STRIDES] = {1, 2, 7, 8};
+    int cols = MAX_FIELD_WIDTH, rows = MAX_FIELD_HEIGHT + 1;
+
+    Screen screen;
+    char* terminal = (char*)malloc((size_t)cols * rows);
+    if (terminal == NULL || !ScreenInit(&screen, cols, rows)) {
+        fprintf(stderr, "failed to allocate %dx%d screen\n", cols, rows);
+        return 1;
+    }
+    memset(terminal, ' ', (size_t)cols * rows);
+
+    printf("screen: %dx%d, output buffer %zu bytes\n", cols, rows, screen.out_capacity);
+    printf("%-8s %12s %12s %10s\n", "stride", "bytes/frame", "max bytes", "mismatch");
+    int failed = 0;
+    for (int s = 0; s < SCREEN_BENCH_STRIDES; s++) {
+        int stride = strides[s];
+        long long bytes = 0;
+        int max_bytes = 0, mismatched = 0;
+        for (int f = 0; f < frames; f++) {
+            // 偶数帧为空白，奇数帧每隔 stride 列一个字符 (起始列逐帧错开)
+            for (int y = 0; y < rows; y++) {
+                char* row = ScreenRow(&screen, y);
+                for (int x = 0; x < cols; x++) row[x] = f % 2 && (x + f / 2) % stride == 0 ? '*' : ' ';
+            }
+            int len = ScreenEncode(&screen);
+            bytes += len;
+            if (len > max_bytes) max_bytes = len;
+            if ((size_t)len > screen.out_capacity || !ApplyScreenOutput(terminal, cols, rows, screen.out, len)) {
+                mismatched++;
+                continue;
+            }
+            for (int y = 0; y < rows; y++) {
+                mismatched += memcmp(terminal + (size_t)y * cols, ScreenRow(&screen, y), cols) != 0;
+            }
+        }
+        printf("%-8d %12.0f %12d %10d\n", stride, frames > 0 ? (double)bytes / frames : 0.0, max_bytes, mismatched);
+        failed |= mismatched != 0;
+    }
+    ScreenFree(&screen);
+    free(terminal);
+    return failed;
+}
+
+// --- 音效投递：游戏线程的音频开销 ---
+
+static void BenchSoundHook(SoundId id) {
+    static const int tones[4][2] = {{1200, 30}, {800, 50}, {300, 100}, {200, 150}};
+    AudioPlayTone(tones[id][0], tones[id][1]);
+}
+
+// 按固定 62.5 Hz 运行默认游戏 (无输入)，音效投递到音频线程的空输出或 WAV 文件
+static int BenchAudio(int argc, char** argv) {
+    int frames = 1000;
+    const char* wav_path = NULL;
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frames = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--wav") == 0 && i + 1 < argc) {
+            wav_path = argv[++i];
+        }
+    }
+
+    if (!AudioStart(wav_path != NULL ? AUDIO_SINK_WAV : AUDIO_SINK_NULL, wav_path)) {
+        fprintf(stderr, "failed to start audio\n");
+        return 1;
+    }
+    GameState* game = CreateGame(&bench_config, 1);
+    if (game == NULL) return 1;
+    game->sound_hook = BenchSoundHook;
+
+    GameInput input = {0};
+    double start = PlatformNow();
+    for (int f = 0; f < frames; f++) {
+        Update(game, &input);
+        if (game->player.lives <= 0) InitGame(game);
+        double next = start + (f + 1) * 0.016;
+        double now = PlatformNow();
+        if (next > now) PlatformSleep(next - now);
+    }
+    DestroyGame(game);
+    AudioStop();
+
+    AudioStats stats = AudioGetStats();
+    printf("audio: %d frames, %lld events, %lld dropped\n", frames, stats.events, stats.dropped);
+    printf("game thread: %.4f ms total, %.1f ns/event, %.2f us max\n", stats.post_seconds * 1e3,
+           stats.events > 0 ? stats.post_seconds * 1e9 / stats.events : 0.0, stats.post_max * 1e6);
+    printf("audio thread: %lld buffers, %lld underruns\n", stats.buffers, stats.underruns);
+    return stats.dropped == 0 ? 0 : 1;
+}
+
+// --- 运行时配置：区域大小和容量 ---
+
+#define ARENA_BENCH_PRESETS 3
+
+// 不同区域大小和容量下的一整块内存大小、CreateGame 耗时，以及敌弹填满半条子弹道时 Update() 的开销。
+// 最后一行是命令行配置参数给出的配置 (未指定时为默认配置)，不需要重新编译
+static int BenchArena(int argc, char** argv) {
+    int frames = 200;
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frames = atoi(argv[++i]);
+        }
+    }
+    if (frames < 1) frames = 1;
+
+    GameConfig configs[ARENA_BENCH_PRESETS + 1] = {
+        {DEFAULT_WIDTH, DEFAULT_HEIGHT, 1000, 100, 100, 100},
+        {200, 100, 50000, 2000, 1000, 1000},
+        {MAX_FIELD_WIDTH, MAX_FIELD_HEIGHT, 200000, 20000, 20000, 20000},
+        bench_config,
+    };
+    const char* names[ARENA_BENCH_PRESETS + 1] = {"small", "large", "max", "flags"};
+
+    printf("arena: %d frames per config, enemy bullets fill half a lane, one Update per frame\n", frames);
+    printf("%-6s %9s %9s %9s %11s %11s %12s %10s\n", "config", "field", "bullets", "enemies", "arena KB",
+           "create ms", "bullets/frm", "update us");
+    for (int c = 0; c < ARENA_BENCH_PRESETS + 1; c++) {
+        GameConfig saved = bench_config; // SpawnFallingBullet 按 bench_config 的区域取坐标
+        bench_config = configs[c];
+        double create_start = PlatformNow();
+        GameState* game = CreateGame(&configs[c], 7);
+        double create_ms = (PlatformNow() - create_start) * 1e3;
+        if (game == NULL) {
+            printf("%-6s failed: %s\n", names[c], GameConfigError(&configs[c]) ? GameConfigError(&configs[c]) : "out of memory");
+            bench_config = saved;
+            continue;
+        }
+        game->player.lives = AUTOPILOT_BENCH_LIVES;
+        Rng rng;
+        RngSeed(&rng, 99);
+        int bullets = configs[c].max_bullets / 2;
+        for (int k = 0; k < bullets; k++) SpawnFallingBullet(game, &rng, 0);
+
+        double total = 0;
+        long long bullet_frames = 0;
+        for (int f = 0; f < frames; f++) {
+            double start = PlatformNow();
+            Update(game, &(GameInput){(f / 30) % 2 ? KEY_LEFT : KEY_RIGHT});
+            total += PlatformNow() - start;
+            bullet_frames += game->enemy_bullets.count;
+            while (game->enemy_bullets.count < bullets) SpawnFallingBullet(game, &rng, 1); // 不计时
+        }
+        char field[16];
+        snprintf(field, sizeof(field), "%dx%d", configs[c].width, configs[c].height);
+        printf("%-6s %9s %9d %9d %11.0f %11.3f %12.0f %10.2f\n", names[c], field, configs[c].max_bullets,
+               configs[c].max_enemies, game->arena_bytes / 1024.0, create_ms, (double)bullet_frames / frames,
+               total / frames * 1e6);
+        DestroyGame(game);
+        bench_config = saved;
+    }
+    return 0;
+}
+
+// --- 敌机原型：按原型分组的 SoA vs 分组之前的结构体数组 ---
+
+#define ENEMY_BENCH_SIZES 4
+#define ENEMY_BENCH_KILL_PERCENT 5   // 每帧计分的敌机比例
+
+// 分组之前的存储和更新 (对照组)：结构体数组 + 对象池，按 dense 倒序逐架查类型，
+// 计分用 if 链；与改动前的 UpdateEnemies / DestroyEnemy 相同 (不含危险场和粗时间步)
+typedef struct {
+    Vec2 pos;
+    int cooldown;
+    int type;
+    int shot;
+} LegacyEnemy;
+
+typedef struct {
+    LegacyEnemy* enemies;
+    int* link;
+    Pool pool;
+} LegacyEnemies;
+
+static void LegacyUpdate(GameState* game, LegacyEnemies* legacy) {
+    Real floor_y = RFromInt(game->config.height - 1);
+    for (int k = legacy->pool.count - 1; k >= 0; k--) {
+        int i = legacy->pool.dense[k];
+        LegacyEnemy* e = &legacy->enemies[i];
+        e->pos.y += game->archetypes[e->type].speed;
+        if (e->pos.y >= floor_y) {
+            PoolRelease(&legacy->pool, i);
+            continue;
+        }
+        const PatternProgram* pattern = &game->enemy_patterns[e->type];
+        e->cooldown--;
+        if (e->cooldown <= 0 && pattern->count > 0) {
+            PatternEmit(pattern, &game->enemy_bullets, e->pos.x, e->pos.y, game->player.pos.x, game->player.pos.y,
+                        e->shot, BULLET_OWNER_ENEMY | BULLET_SHOOTER(e->type));
+            e->cooldown = PatternNextCooldown(pattern, e->shot, &game->rng);
+            e->shot++;
+        }
+    }
+}
+
+static int LegacyScore(GameState* game, const LegacyEnemies* legacy, const int* kills, int num_kills) {
+    int score = 0;
+    for (int k = 0; k < num_kills; k++) {
+        int type = legacy->enemies[legacy->pool.dense[kills[k]]].type;
+        game->stats.kills_by_type[type]++;
+        if (type == 0) score += 10;
+        else if (type == 1) score += 15;
+        else score += 20;
+    }
+    return score;
+}
+
+// 与 game.c 的 UpdateEnemies 相同 (不含生成、危险场和粗时间步)
+static void GroupedUpdate(GameState* game) {
+    EnemyGroups* enemies = &game->enemies;
+    Real speeds[ENEMY_TYPE_COUNT];
+    for (int t = 0; t < ENEMY_TYPE_COUNT; t++) speeds[t] = game->archetypes[t].speed;
+    EnemyGroupsStep(enemies, speeds, 0);
+
+    Real floor_y = RFromInt(game->config.height - 1);
+    for (int t = 0; t < ENEMY_TYPE_COUNT; t++) {
+        const PatternProgram* pattern = &game->enemy_patterns[t];
+        if (pattern->count == 0) continue;
+        BulletFlags shooter = BULLET_OWNER_ENEMY | BULLET_SHOOTER(t);
+        for (int i = enemies->start[t]; i < enemies->start[t + 1]; i++) {
+            if (enemies->y[i] >= floor_y || enemies->cooldown[i] > 0) continue;
+            PatternEmit(pattern, &game->enemy_bullets, enemies->x[i], enemies->y[i],
+                        game->player.pos.x, game->player.pos.y, enemies->shot[i], shooter);
+            enemies->cooldown[i] = PatternNextCooldown(pattern, enemies->shot[i], &game->rng);
+            enemies->shot[i]++;
+        }
+    }
+    for (int i = enemies->count - 1; i >= 0; i--) {
+        if (enemies->y[i] >= floor_y) EnemyGroupsRemove(enemies, i);
+    }
+}
+
+static int GroupedScore(GameState* game, const int* kills, int num_kills) {
+    int score = 0;
+    for (int k = 0; k < num_kills; k++) {
+        int type = game->enemies.type[kills[k]];
+        game->stats.kills_by_type[type]++;
+        score += game->archetypes[type].score;
+    }
+    return score;
+}
+
+// 补满 count 架敌机 (不计时)：两种存储用同一个种子，补进来的敌机完全相同
+static void TopUpEnemies(GameState* game, LegacyEnemies* legacy, int count) {
+    int current = legacy != NULL ? legacy->pool.count : game->enemies.count;
+    for (int k = current; k < count; k++) {
+        Real x = R(1) + RMUL(RFromInt(rand() % ((game->config.width - 2) * 256)), R(1.0 / 256));
+        Real y = R(1) + RMUL(RFromInt(rand() % (game->config.height / 2 * 256)), R(1.0 / 256));
+        int type = rand() % ENEMY_TYPE_COUNT;
+        int cooldown = 1 + rand() % 40;
+        if (legacy == NULL) {
+            PlaceEnemy(game, type, x, y, cooldown);
+            continue;
+        }
+        int i = PoolAcquire(&legacy->pool);
+        legacy->enemies[i] = (LegacyEnemy){{x, y}, cooldown, type, 0};
+    }
+}
+
+typedef struct {
+    double update_ns, score_ns;   // 每架敌机的更新耗时、每次计分的耗时
+    double bullets;               // 每帧发射的敌弹
+    long long score;
+} EnemyBenchResult;
+
+// legacy 为 NULL 时测分组存储
+static EnemyBenchResult RunEnemyBench(GameState* game, LegacyEnemies* legacy, int count, int frames) {
+    InitGame(game);
+    RngSeed(&game->rng, 5);
+    if (legacy != NULL) PoolInit(&legacy->pool, legacy->link, legacy->link + count, count);
+    srand(77);
+    TopUpEnemies(game, legacy, count);
+
+    int* kills = (int*)malloc(sizeof(int) * count);
+    EnemyBenchResult r = {0, 0, 0, 0};
+    double update_total = 0, score_total = 0;
+    long long bullets = 0, kill_total = 0;
+    for (int f = 0; f < frames; f++) {
+        game->enemy_bullets.count = 0;
+        double start = PlatformNow();
+        if (legacy != NULL) LegacyUpdate(game, legacy);
+        else GroupedUpdate(game);
+        update_total += PlatformNow() - start;
+        bullets += game->enemy_bullets.count;
+
+        // 随机抽取一部分在场敌机计分 (只计分，不回收)
+        int alive = legacy != NULL ? legacy->pool.count : game->enemies.count;
+        int num_kills = alive * ENEMY_BENCH_KILL_PERCENT / 100;
+        for (int k = 0; k < num_kills; k++) kills[k] = rand() % alive;
+        start = PlatformNow();
+        r.score += legacy != NULL ? LegacyScore(game, legacy, kills, num_kills) : GroupedScore(game, kills, num_kills);
+        score_total += PlatformNow() - start;
+        kill_total += num_kills;
+
+        TopUpEnemies(game, legacy, count);
+    }
+    free(kills);
+    r.update_ns = update_total * 1e9 / ((double)frames * count);
+    r.score_ns = kill_total > 0 ? score_total * 1e9 / kill_total : 0;
+    r.bullets = (double)bullets / frames;
+    return r;
+}
+
+// 1000 ~ 10000 架混合类型的敌机：移动 + 冷却 + 发射 + 回收，以及随机抽取的计分。
+// 区域为最大区域 (敌机停留得久一些)，每帧补满敌机、清空敌弹，两种存储的场景完全相同；
+// 发射顺序不同，冷却的随机数分配不同，所以两边的发射数量只是近似相等
+static int BenchEnemies(int argc, char** argv) {
+    int frames = 500;
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frames = atoi(argv[++i]);
+        }
+    }
+    if (frames < 1) frames = 1;
+
+    static const int sizes[ENEMY_BENCH_SIZES] = {1000, 2000, 5000, 10000};
+    int largest = sizes[ENEMY_BENCH_SIZES - 1];
+    GameConfig config = {MAX_FIELD_WIDTH, MAX_FIELD_HEIGHT, 4 * largest, largest, 100, 100};
+    GameState* game = CreateGame(&config, 1);
+    if (game == NULL) return 1;
+    game->player.pos.x = RFromInt(config.width / 2);
+
+    LegacyEnemies legacy;
+    legacy.enemies = (LegacyEnemy*)malloc(sizeof(LegacyEnemy) * largest);
+    legacy.link = (int*)malloc(2 * sizeof(int) * largest);
+
+    printf("enemies: %d frames, %dx%d field, mixed archetypes, %d%% of enemies scored per frame\n", frames,
+           config.width, config.height, ENEMY_BENCH_KILL_PERCENT);
+    printf("%8s | %11s %11s %8s | %11s %11s %8s | %11s %11s\n", "enemies", "legacy ns", "grouped ns", "speedup",
+           "legacy sc", "grouped sc", "speedup", "legacy blt", "grouped blt");
+    for (int s = 0; s < ENEMY_BENCH_SIZES; s++) {
+        int count = sizes[s];
+        EnemyBenchResult old_layout = RunEnemyBench(game, &legacy, count, frames);
+        EnemyBenchResult grouped = RunEnemyBench(game, NULL, count, frames);
+        printf("%8d | %11.2f %11.2f %7.2fx | %11.2f %11.2f %7.2fx | %11.1f %11.1f\n", count,
+               old_layout.update_ns, grouped.update_ns, old_layout.update_ns / grouped.update_ns,
+               old_layout.score_ns, grouped.score_ns, old_layout.score_ns / grouped.score_ns,
+               old_layout.bullets, grouped.bullets);
+    }
+    printf("(ns = update per enemy per frame, sc = ns per scored kill, blt = enemy bullets fired per frame)\n");
+
+    free(legacy.enemies);
+    free(legacy.link);
+    DestroyGame(game);
+    return 0;
+}
+
+// --- 事件日志 ---
+
+// 游戏线程记录一条事件的开销 (写入环 + 环满时整批拷进映射窗口)，以及跨越多个映射窗口后文件中的记录数。
+// 先跑一段真实对局看每帧的事件数，再直接调用 LogEvent 灌入 count 条合成事件
+static int BenchEvents(int argc, char** argv) {
+    long long count = 4000000;
+    int frames = 20000;
+    const char* path = "bench_events.bin";
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "--count") == 0 && i + 1 < argc) {
+            count = atoll(argv[++i]);
+        } else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frames = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--file") == 0 && i + 1 < argc) {
+            path = argv[++i];
+        }
+    }
+    if (count < 1) count = 1;
+    if (frames < 1) frames = 1;
+
+    remove(path);
+    const char* error;
+    EventLog* log = EventLogOpen(path, bench_config.width, bench_config.height, &error);
+    if (log == NULL) {
+        fprintf(stderr, "failed to open event log %s: %s\n", path, error);
+        return 1;
+    }
+
+    // 真实对局：同一种子分别不记录 / 记录事件，比较每帧耗时和最终状态
+    double update_ms[2];
+    unsigned long long hashes[2];
+    long long game_events = 0;
+    for (int logged = 0; logged < 2; logged++) {
+        GameState* game = CreateGame(&bench_config, 1);
+        if (game == NULL || (logged && !AttachEventRing(game, log, 0, 0))) return 1;
+        InitGame(game);
+        GameInput input = {0};
+        double start = PlatformNow();
+        for (int f = 0; f < frames; f++) {
+            input.keys = (f / 60) % 2 ? KEY_LEFT : KEY_RIGHT;
+            Update(game, &input);
+            if (game->player.lives <= 0) InitGame(game);
+        }
+        update_ms[logged] = (PlatformNow() - start) * 1e3 / frames;
+        hashes[logged] = GameHash(game);
+        DestroyGame(game);
+    }
+    game_events = EventLogGetStats(log).records;
+
+    // 合成事件：只测记录路径本身
+    GameState* game = CreateGame(&bench_config, 1);
+    if (game == NULL || !AttachEventRing(game, log, 1, 0)) return 1;
+    double start = PlatformNow();
+    for (long long i = 0; i < count; i++) {
+        LogEvent(game, (GameEventType)(EVENT_SPAWN + i % (EVENT_TYPE_COUNT - EVENT_SPAWN)),
+                 RFromInt((int)(i % bench_config.width)), RFromInt((int)(i / 7 % bench_config.height)),
+                 (int)(i % ENEMY_TYPE_COUNT), 1);
+    }
+    DestroyGame(game);
+    double elapsed = PlatformNow() - start;
+    EventLogStats stats = EventLogGetStats(log);
+    EventLogClose(log);
+
+    // 重新打开核对提交的记录数 (打开即追加一次运行，这里只读文件头)
+    long long expected = game_events + count, committed = -1, size = -1;
+    PlatformFile* file = PlatformFileOpen(path, 0);
+    if (file != NULL) {
+        size = PlatformFileSize(file);
+        EventLogHeader* header = (EventLogHeader*)PlatformFileMap(file, 0, sizeof(EventLogHeader), 0);
+        if (header != NULL) committed = (long long)header->records;
+        PlatformFileUnmap(header, sizeof(EventLogHeader));
+        PlatformFileClose(file);
+    }
+    remove(path);
+
+    printf("events: %d frames of play, %.2f events/frame, Update %.4f -> %.4f ms/frame, state %s\n", frames,
+           (double)game_events / frames, update_ms[0], update_ms[1], hashes[0] == hashes[1] ? "identical" : "DIFFERS");
+    printf("synthetic: %lld events in %.3f s, %.1f ns/event, %.2f GB/s into the log\n", count, elapsed,
+           elapsed * 1e9 / count, (double)count * sizeof(GameEventRecord) / elapsed / 1e9);
+    printf("flushes: %lld (%.1f us mean, %.3f ms max), %lld windows of %d MB, %lld dropped\n", stats.flushes,
+           stats.flush_seconds * 1e6 / stats.flushes, stats.flush_max * 1e3, stats.chunks,
+           EVENTLOG_CHUNK_BYTES >> 20, stats.dropped);
+    printf("file: %lld bytes, %lld / %lld records committed %s\n", size, committed, expected,
+           committed == expected && size == (long long)sizeof(EventLogHeader) + expected * (long long)sizeof(GameEventRecord)
+               ? "ok" : "MISMATCH");
+    return committed == expected && hashes[0] == hashes[1] ? 0 : 1;
+}
+
+// --- 多线程 Update：任务图 + 工作窃取 ---
+
+typedef struct {
+    double ms;                      // 每帧 Update 耗时
+    unsigned long long hash;
+    JobPoolStats stats;
+} JobsBenchResult;
+
+// 同一场景跑 frames 帧；pool 为 NULL 时单线程。每帧开始前把敌机和自机子弹补到目标数量 (不计时)，
+// 补充用 rand() 按固定种子生成，各次运行的场景完全相同
+static JobsBenchResult RunJobsBench(JobPool* pool, int enemy_count, int bullet_count, int frames) {
+    JobsBenchResult result;
+    memset(&result, 0, sizeof(result));
+    GameState* game = CreateGame(&bench_config, 1);
+    if (game == NULL || !AttachJobPool(game, pool)) {
+        DestroyGame(game);
+        result.ms = -1;
+        return result;
+    }
+    srand(1);
+    game->player.lives = 1 << 30; // 只测开销，不让游戏结束
+
+    double total = 0;
+    for (int f = 0; f < frames; f++) {
+        // 坐标取 1/256 的整数倍，两种模式都能精确表示
+        while (game->enemies.count < enemy_count) {
+            Real x = R(1) + RMUL(RFromInt(rand() % ((bench_config.width - 2) * 256)), R(1.0 / 256));
+            Real y = R(1) + RMUL(RFromInt(rand() % (bench_config.height / 2 * 256)), R(1.0 / 256));
+            if (PlaceEnemy(game, rand() % ENEMY_TYPE_COUNT, x, y, 1 + rand() % 40) < 0) break;
+        }
+        for (int k = game->player_bullets.count; k < bullet_count; k++) {
+            Real x = R(1) + RMUL(RFromInt(rand() % ((bench_config.width - 2) * 256)), R(1.0 / 256));
+            Real y = RMUL(RFromInt(rand() % ((bench_config.height - 1) * 256)), R(1.0 / 256));
+            SpawnBullet(game, x, y, 0, R(-0.5), 0);
+        }
+
+        if (f == frames / 4 && pool != NULL) JobPoolResetStats(pool); // 前 1/4 为预热
+        double start = PlatformNow();
+        Update(game, &(GameInput){(f / 30) % 2 ? KEY_LEFT : KEY_RIGHT});
+        if (f >= frames / 4) total += PlatformNow() - start;
+    }
+    result.ms = total * 1e3 / (frames - frames / 4);
+    result.hash = GameHash(game);
+    if (pool != NULL) result.stats = JobPoolGetStats(pool);
+    DestroyGame(game);
+    return result;
+}
+
+static int BenchJobs(int argc, char** argv) {
+    int enemy_count = 5000;
+    int bullet_count = 20000;
+    int frames = 200;
+    int max_threads = PlatformCpuCount();
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "--enemies") == 0 && i + 1 < argc) {
+            enemy_count = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--bullets") == 0 && i + 1 < argc) {
+            bullet_count = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frames = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            max_threads = atoi(argv[++i]);
+        }
+    }
+    if (enemy_count > bench_config.max_enemies) enemy_count = bench_config.max_enemies;
+    if (bullet_count > bench_config.max_bullets / 4) bullet_count = bench_config.max_bullets / 4; // 留出敌弹的位置
+    if (frames < 4) frames = 4;
+    if (max_threads < 1) max_threads = 1;
+    if (max_threads > JOB_MAX_WORKERS) max_threads = JOB_MAX_WORKERS;
+
+    JobsBenchResult serial = RunJobsBench(NULL, enemy_count, bullet_count, frames);
+    if (serial.ms < 0) return 1;
+    printf("jobs: %d enemies, %d player bullets, %d frames (%d warm-up), %d logical CPUs, kernel %s\n",
+           enemy_count, bullet_count, frames, frames / 4, PlatformCpuCount(), BulletKernelName(BulletActiveKernel()));
+    printf("%-8s %10s %8s %10s %12s %12s %10s\n", "threads", "ms/frame", "speedup", "efficiency", "jobs/frame",
+           "steals/frame", "state");
+    printf("%-8s %10.4f %8s %10s %12s %12s %10s\n", "serial", serial.ms, "1.00x", "-", "-", "-", "reference");
+
+    int mismatches = 0;
+    for (int threads = 1; ; threads = threads * 2 < max_threads ? threads * 2 : max_threads) {
+        JobPool* pool = JobPoolStart(threads);
+        if (pool == NULL) {
+            fprintf(stderr, "failed to start %d threads\n", threads);
+            return 1;
+        }
+        JobsBenchResult r = RunJobsBench(pool, enemy_count, bullet_count, frames);
+        JobPoolStop(pool);
+        if (r.ms < 0) return 1;
+        double runs = r.stats.runs > 0 ? (double)r.stats.runs : 1;
+        printf("%-8d %10.4f %7.2fx %9.0f%% %12.1f %12.2f %10s\n", threads, r.ms, serial.ms / r.ms,
+               serial.ms / r.ms / threads * 100, r.stats.jobs / runs, r.stats.steals / runs,
+               r.hash == serial.hash ? "identical" : "DIFFERS");
+        printf("         jobs by worker:");
+        for (int w = 0; w < threads; w++) printf(" %.0f%%", 100.0 * r.stats.jobs_by_worker[w] / (r.stats.jobs > 0 ? r.stats.jobs : 1));
+        printf("\n");
+        mismatches += r.hash != serial.hash;
+        if (threads == max_threads) break;
+    }
+    printf("state hash: %016llx\n", serial.hash);
+    return mismatches == 0 ? 0 : 1;
+}
+
+// --- 批量环境：吞吐量与确定性 ---
+
+#define ENV_BENCH_ACTIONS 4096      // 预先生成的随机动作，循环使用，不把 rand() 计入耗时
+
+// 与 arena 模式的 small 配置相同的容量，数千局也只占几百 MB
+static GameConfig EnvBenchConfig() {
+    GameConfig config = bench_config;
+    config.max_bullets = 1000;
+    config.max_enemies = 100;
+    config.max_items = 100;
+    config.max_explosions = 100;
+    return config;
+}
+
+// 校验：第 0 局当前这一局与单独 CreateGame 同一种子、同样按键的游戏状态相同 (含自动重新开始之后)，
+// 并且有线程池时的观测、奖励、结束标志与单线程逐字节相同。返回不一致的项数
+static int CheckEnv(const GameConfig* config, const EnvOptions* options, JobPool* pool) {
+    const int count = 8, steps = 700;
+    const unsigned long long seed = 11;
+    VecEnv* serial = VecEnvCreate(config, count, seed, options, NULL);
+    VecEnv* parallel = VecEnvCreate(config, count, seed, options, pool);
+    int size = serial != NULL ? VecEnvObservationSize(serial) : 0;
+    float* obs[2] = {(float*)malloc(sizeof(float) * count * size), (float*)malloc(sizeof(float) * count * size)};
+    float rewards[2][8];
+    unsigned char dones[2][8];
+    unsigned* history = (unsigned*)malloc(sizeof(unsigned) * steps);
+    if (serial == NULL || parallel == NULL || obs[0] == NULL || obs[1] == NULL || history == NULL) return 1;
+
+    int mismatches = 0, episode_start = 0, episodes = 0;
+    unsigned actions[8];
+    srand(5);
+    for (int s = 0; s < steps; s++) {
+        for (int i = 0; i < count; i++) actions[i] = VecEnvActionKeys(rand() % ENV_ACTIONS);
+        history[s] = actions[0];
+        VecEnvStep(serial, actions, obs[0], rewards[0], dones[0]);
+        VecEnvStep(parallel, actions, obs[1], rewards[1], dones[1]);
+        mismatches += memcmp(obs[0], obs[1], sizeof(float) * count * size) != 0 ||
+                      memcmp(rewards[0], rewards[1], sizeof(rewards[0])) != 0 ||
+                      memcmp(dones[0], dones[1], sizeof(dones[0])) != 0;
+        if (dones[0][0]) {
+            episode_start = s + 1;
+            episodes++;
+        }
+    }
+
+    GameState* reference = CreateGame(config, seed + (unsigned long long)episodes * count);
+    if (reference == NULL) return 1;
+    for (int s = episode_start; s < steps; s++) {
+        GameInput input = {history[s]};
+        for (int f = 0; f < options->frame_skip && reference->player.lives > 0; f++) Update(reference, &input);
+    }
+    mismatches += GameHash(reference) != GameHash(VecEnvGame(serial, 0));
+    printf("check: %d games x %d steps, game 0 in episode %d, %s\n", count, steps, episodes + 1,
+           mismatches == 0 ? "matches standalone games and threaded stepping" : "MISMATCH");
+
+    DestroyGame(reference);
+    free(history);
+    free(obs[0]);
+    free(obs[1]);
+    VecEnvDestroy(serial);
+    VecEnvDestroy(parallel);
+    return mismatches;
+}
+
+static int BenchEnv(int argc, char** argv) {
+    int max_count = 1024;
+    long long total_steps = 200000;
+    int threads = 1;
+    EnvOptions options = DefaultEnvOptions();
+    options.max_frames = 300;       // 短局，让自动重新开始也计入耗时
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "--max-count") == 0 && i + 1 < argc) {
+            max_count = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--steps") == 0 && i + 1 < argc) {
+            total_steps = atoll(argv[++i]);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--frame-skip") == 0 && i + 1 < argc) {
+            options.frame_skip = atoi(argv[++i]);
+        }
+    }
+    if (max_count < 1) max_count = 1;
+    if (total_steps < 1) total_steps = 1;
+
+    GameConfig config = EnvBenchConfig();
+    JobPool* pool = threads > 1 ? JobPoolStart(threads) : NULL;
+    if (threads > 1 && pool == NULL) {
+        fprintf(stderr, "failed to start %d threads\n", threads);
+        return 1;
+    }
+    JobPool* check_pool = pool != NULL ? pool : JobPoolStart(2);
+    int mismatches = CheckEnv(&config, &options, check_pool);
+    if (check_pool != pool) JobPoolStop(check_pool);
+
+    unsigned* table = (unsigned*)malloc(sizeof(unsigned) * ENV_BENCH_ACTIONS);
+    if (table == NULL) return 1;
+    srand(1);
+    for (int k = 0; k < ENV_BENCH_ACTIONS; k++) table[k] = VecEnvActionKeys(rand() % ENV_ACTIONS);
+
+    printf("env: %dx%d field, %dx%d grid x %d channels + %d scalars, frame skip %d, %d-frame episodes, %d thread%s\n",
+           config.width, config.height, options.grid_cols, options.grid_rows, ENV_CHANNELS, ENV_SCALARS,
+           options.frame_skip, options.max_frames, threads, threads > 1 ? "s" : "");
+    printf("%7s %10s %12s %12s %10s %11s %10s\n", "games", "steps", "steps/sec", "us/step()", "episodes", "mean score",
+           "memory MB");
+    for (int count = 1; ; count = count * 4 < max_count ? count * 4 : max_count) {
+        VecEnv* env = VecEnvCreate(&config, count, 1, &options, pool);
+        int size = env != NULL ? VecEnvObservationSize(env) : 0;
+        float* observations = (float*)malloc(sizeof(float) * count * size);
+        float* rewards = (float*)malloc(sizeof(float) * count);
+        unsigned char* dones = (unsigned char*)malloc(count);
+        unsigned* actions = (unsigned*)malloc(sizeof(unsigned) * count);
+        if (env == NULL || observations == NULL || rewards == NULL || dones == NULL || actions == NULL) {
+            fprintf(stderr, "%d games: out of memory\n", count);
+            return 1;
+        }
+
+        long long calls = (total_steps + count - 1) / count;
+        double start = PlatformNow();
+        for (long long c = 0; c < calls; c++) {
+            for (int i = 0; i < count; i++) actions[i] = table[(c * 7 + i) & (ENV_BENCH_ACTIONS - 1)];
+            VecEnvStep(env, actions, observations, rewards, dones);
+        }
+        double elapsed = PlatformNow() - start;
+        VecEnvStats stats = VecEnvGetStats(env);
+        printf("%7d %10lld %12.0f %12.2f %10lld %11.1f %10.1f\n", count, stats.steps, (double)stats.steps / elapsed,
+               elapsed * 1e6 / (double)calls, stats.episodes,
+               stats.episodes > 0 ? (double)stats.score_total / (double)stats.episodes : 0.0,
+               (double)count * VecEnvGame(env, 0)->arena_bytes / (1 << 20));
+
+        free(observations);
+        free(rewards);
+        free(dones);
+        free(actions);
+        VecEnvDestroy(env);
+        if (count == max_count) break;
+    }
+    free(table);
+    JobPoolStop(pool);
+    return mismatches == 0 ? 0 : 1;
+}
+
+// --- 模式分发 ---
+
+typedef struct {
+    const char* name;
+    int (*run)(int argc, char** argv);
+    const char* help;
+} BenchMode;
+
+static const BenchMode modes[] = {
+    {"bullets", BenchBullets, "[--count N] [--frames F]  SoA bullet integrate/cull kernels"},
+    {"collide", BenchCollide, "[--count N] [--runs R]    grid broadphase vs brute-force collision"},
+    {"physics", BenchPhysics, "[--enemies N] [--kernel K]  Update cost + state hash, build with/without -DUSE_FIXED_POINT"},
+    {"patterns", BenchPatterns, "[--emitters N] [--frames F]  batched pattern emission vs per-bullet spawning"},
+    {"autopilot", BenchAutopilot, "[--count N] [--frames F]  danger-field autopilot vs threat scan, per-frame cost vs bullet count"},
+    {"sweep", BenchSweep, "[--games N] [--frames F] [--bullets B] [--tolerance T]  coarse-timestep swept collision vs fine-timestep reference"},
+    {"snapshot", BenchSnapshot, "[--count N] [--frames F]  snapshot capture/restore and delta ring vs entity count"},
+    {"spectator", BenchSpectator, "[--viewers N] [--frames F] [--fps HZ] [--slow-delay S]  spectator feed bandwidth, latency, slow-viewer skipping"},
+    {"arena", BenchArena, "[--frames F]  arena size, CreateGame cost and Update cost across field sizes / capacities"},
+    {"enemies", BenchEnemies, "[--frames F]  archetype-grouped enemy SoA vs the old struct array, 1k-10k enemies"},
+    {"jobs", BenchJobs, "[--threads N] [--enemies N] [--bullets B] [--frames F]  work-stealing job-graph Update vs serial, speedup and state hash"},
+    {"env", BenchEnv, "[--max-count N] [--steps S] [--threads T] [--frame-skip K]  batched environment steps/sec as the game count grows"},
+    {"events", BenchEvents, "[--count N] [--frames F] [--file PATH]  event log cost per event, flushes across mapped windows"},
+    {"render", BenchRender, "[--seconds S] [--fps HZ] [--stall-ms M] [--stall-every N]  sim-tick jitter with a stalling terminal: inline Draw vs render thread"},
+    {"screen", BenchScreen, "[--frames F]  diff output of sparse changes on the largest field, checked by decoding it back"},
+    {"audio", BenchAudio, "[--frames F] [--wav FILE]  game-thread cost of posting sound events"},
+};
+
+int main(int argc, char** argv) {
+    int num_modes = (int)(sizeof(modes) / sizeof(modes[0]));
+    bench_config = DefaultGameConfig();
+    argc = ConfigParseArgs(&bench_config, argc, argv);
+    if (argc < 0) return 1;
+    if (argc >= 2) {
+        for (int i = 0; i < num_modes; i++) {
+            if (strcmp(argv[1], modes[i].name) == 0) {
+                return modes[i].run(argc - 2, argv + 2);
+            }
+        }
+    }
+
+    printf("usage: %s <mode> [options] [--width N] [--height N] [--max-bullets N] [--max-enemies N]\n"
+           "       [--max-items N] [--max-explosions N] [--config FILE]\n", argv[0]);
+    for (int i = 0; i < num_modes; i++) {
+        printf("  %-10s %s\n", modes[i].name, modes[i].help);
+    }
+    return 1;
+}
@@ -0,0 +1,399 @@
+#include <stdatomic.h>
+#include "bullets.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define BULLETS_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#else
+#define BULLETS_X86 0
+#endif
+
+// GCC/Clang 按函数开启 AVX2 指令，整个文件仍可用默认编译选项构建
+#if BULLETS_X86 && (defined(__GNUC__) || defined(__clang__))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#else
+#define TARGET_AVX2
+#define TARGET_SSE2
+#endif
+
+typedef int (*StepKernelFn)(BulletLane* lane, LaneReal width, LaneReal height);
+
+// --- 初始化与增删 ---
+
+void BulletLaneInit(BulletLane* lane, void* storage, int capacity) {
+    int stride = BULLET_LANE_STRIDE(capacity);
+    LaneReal* base = (LaneReal*)storage;
+    lane->capacity = capacity;
+    lane->count = 0;
+    lane->limit = capacity;
+    lane->retired = 0;
+    lane->x = base;
+    lane->y = base + stride;
+    lane->vx = base + stride * 2;
+    lane->vy = base + stride * 3;
+    lane->flags = (BulletFlags*)(base + stride * 4);
+}
+
+// 还能放下的子弹数
+static int LaneRoom(const BulletLane* lane) {
+    int room = lane->capacity - lane->count;
+    int live_room = lane->limit - (lane->count - lane->retired);
+    return live_room < room ? live_room : room;
+}
+
+int BulletLanePush(BulletLane* lane, LaneReal x, LaneReal y, LaneReal vx, LaneReal vy, BulletFlags flags) {
+    if (LaneRoom(lane) <= 0) return -1; // 子弹池已满
+
+    int i = lane->count++;
+    lane->x[i] = x;
+    lane->y[i] = y;
+    lane->vx[i] = vx;
+    lane->vy[i] = vy;
+    lane->flags[i] = flags;
+    return i;
+}
+
+int BulletLaneReserve(BulletLane* lane, int n, int* first) {
+    int room = LaneRoom(lane);
+    if (n > room) n = room < 0 ? 0 : room;
+    *first = lane->count;
+    lane->count += n;
+    return n;
+}
+
+void BulletLaneKill(BulletLane* lane, int i) {
+    lane->flags[i] |= BULLET_DEAD;
+}
+
+// 倒序扫描：被换到 i 的末尾元素一定已经检查过，不会是失效子弹
+int BulletLaneCompact(BulletLane* lane) {
+    int removed = 0;
+    for (int i = lane->count - 1; i >= 0; i--) {
+        if (lane->flags[i] & BULLET_DEAD) {
+            int last = --lane->count;
+            lane->x[i] = lane->x[last];
+            lane->y[i] = lane->y[last];
+            lane->vx[i] = lane->vx[last];
+            lane->vy[i] = lane->vy[last];
+            lane->flags[i] = lane->flags[last];
+            removed++;
+        }
+    }
+    return removed;
+}
+
+// --- 积分 + 边界剔除内核 ---
+// 每个内核只负责移动子弹并给越界子弹打上 BULLET_DEAD 标记，返回标记数量。
+// 默认的 double 内核每条指令处理 2 (SSE2) / 4 (AVX2) 颗子弹；定点模式下改用 int32 加法和比较，处理 4 / 8 颗。
+
+static int StepScalar(BulletLane* lane, LaneReal width, LaneReal height) {
+    int dead = 0;
+    for (int i = 0; i < lane->count; i++) {
+        LaneReal x = lane->x[i] + lane->vx[i];
+        LaneReal y = lane->y[i] + lane->vy[i];
+        lane->x[i] = x;
+        lane->y[i] = y;
+
+        // 边界检查
+        if (x <= 0 || x >= width || y <= 0 || y >= height) {
+            lane->flags[i] |= BULLET_DEAD;
+            dead++;
+        }
+    }
+    return dead;
+}
+
+#if BULLETS_X86
+
+// 根据比较掩码给不在场内的子弹打标记
+static int MarkDead(BulletFlags* flags, int alive_mask, int lanes) {
+    int dead = 0;
+    for (int b = 0; b < lanes; b++) {
+        if (!(alive_mask & (1 << b))) {
+            flags[b] |= BULLET_DEAD;
+            dead++;
+        }
+    }
+    return dead;
+}
+
+#if PHYSICS_FIXED_POINT
+
+TARGET_SSE2
+static int StepSse2(BulletLane* lane, LaneReal width, LaneReal height) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i w = _mm_set1_epi32(width);
+    const __m128i h = _mm_set1_epi32(height);
+    int n = lane->count;
+    int dead = 0;
+    int i = 0;
+
+    for (; i + 4 <= n; i += 4) {
+        __m128i x = _mm_add_epi32(_mm_load_si128((const __m128i*)(lane->x + i)),
+                                  _mm_load_si128((const __m128i*)(lane->vx + i)));
+        __m128i y = _mm_add_epi32(_mm_load_si128((const __m128i*)(lane->y + i)),
+                                  _mm_load_si128((const __m128i*)(lane->vy + i)));
+        _mm_store_si128((__m128i*)(lane->x + i), x);
+        _mm_store_si128((__m128i*)(lane->y + i), y);
+
+        __m128i in_x = _mm_and_si128(_mm_cmpgt_epi32(x, zero), _mm_cmpgt_epi32(w, x));
+        __m128i in_y = _mm_and_si128(_mm_cmpgt_epi32(y, zero), _mm_cmpgt_epi32(h, y));
+        int alive = _mm_movemask_ps(_mm_castsi128_ps(_mm_and_si128(in_x, in_y)));
+        if (alive != 0xF) {
+            dead += MarkDead(lane->flags + i, alive, 4);
+        }
+    }
+
+#else
+
+TARGET_SSE2
+static int StepSse2(BulletLane* lane, LaneReal width, LaneReal height) {
+    const __m128d zero = _mm_setzero_pd();
+    const __m128d w = _mm_set1_pd(width);
+    const __m128d h = _mm_set1_pd(height);
+    int n = lane->count;
+    int dead = 0;
+    int i = 0;
+
+    for (; i + 2 <= n; i += 2) {
+        __m128d x = _mm_add_pd(_mm_load_pd(lane->x + i), _mm_load_pd(lane->vx + i));
+        __m128d y = _mm_add_pd(_mm_load_pd(lane->y + i), _mm_load_pd(lane->vy + i));
+        _mm_store_pd(lane->x + i, x);
+        _mm_store_pd(lane->y + i, y);
+
+        __m128d in_x = _mm_and_pd(_mm_cmpgt_pd(x, zero), _mm_cmplt_pd(x, w));
+        __m128d in_y = _mm_and_pd(_mm_cmpgt_pd(y, zero), _mm_cmplt_pd(y, h));
+        int alive = _mm_movemask_pd(_mm_and_pd(in_x, in_y));
+        if (alive != 0x3) {
+            dead += MarkDead(lane->flags + i, alive, 2);
+        }
+    }
+
+#endif
+
+    // 尾部凑不满一个向量的子弹走标量路径
+    for (; i < n; i++) {
+        LaneReal x = lane->x[i] + lane->vx[i];
+        LaneReal y = lane->y[i] + lane->vy[i];
+        lane->x[i] = x;
+        lane->y[i] = y;
+        if (x <= 0 || x >= width || y <= 0 || y >= height) {
+            lane->flags[i] |= BULLET_DEAD;
+            dead++;
+        }
+    }
+    return dead;
+}
+
+#if PHYSICS_FIXED_POINT
+
+TARGET_AVX2
+static int StepAvx2(BulletLane* lane, LaneReal width, LaneReal height) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i w = _mm256_set1_epi32(width);
+    const __m256i h = _mm256_set1_epi32(height);
+    int n = lane->count;
+    int dead = 0;
+    int i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+        __m256i x = _mm256_add_epi32(_mm256_load_si256((const __m256i*)(lane->x + i)),
+                                     _mm256_load_si256((const __m256i*)(lane->vx + i)));
+        __m256i y = _mm256_add_epi32(_mm256_load_si256((const __m256i*)(lane->y + i)),
+                                     _mm256_load_si256((const __m256i*)(lane->vy + i)));
+        _mm256_store_si256((__m256i*)(lane->x + i), x);
+        _mm256_store_si256((__m256i*)(lane->y + i), y);
+
+        __m256i in_x = _mm256_and_si256(_mm256_cmpgt_epi32(x, zero), _mm256_cmpgt_epi32(w, x));
+        __m256i in_y = _mm256_and_si256(_mm256_cmpgt_epi32(y, zero), _mm256_cmpgt_epi32(h, y));
+        int alive = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_and_si256(in_x, in_y)));
+        if (alive != 0xFF) {
+            dead += MarkDead(lane->flags + i, alive, 8);
+        }
+    }
+
+#else
+
+TARGET_AVX2
+static int StepAvx2(BulletLane* lane, LaneReal width, LaneReal height) {
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d w = _mm256_set1_pd(width);
+    const __m256d h = _mm256_set1_pd(height);
+    int n = lane->count;
+    int dead = 0;
+    int i = 0;
+
+    for (; i + 4 <= n; i += 4) {
+        __m256d x = _mm256_add_pd(_mm256_load_pd(lane->x + i), _mm256_load_pd(lane->vx + i));
+        __m256d y = _mm256_add_pd(_mm256_load_pd(lane->y + i), _mm256_load_pd(lane->vy + i));
+        _mm256_store_pd(lane->x + i, x);
+        _mm256_store_pd(lane->y + i, y);
+
+        __m256d in_x = _mm256_and_pd(_mm256_cmp_pd(x, zero, _CMP_GT_OQ), _mm256_cmp_pd(x, w, _CMP_LT_OQ));
+        __m256d in_y = _mm256_and_pd(_mm256_cmp_pd(y, zero, _CMP_GT_OQ), _mm256_cmp_pd(y, h, _CMP_LT_OQ));
+        int alive = _mm256_movemask_pd(_mm256_and_pd(in_x, in_y));
+        if (alive != 0xF) {
+            dead += MarkDead(lane->flags + i, alive, 4);
+        }
+    }
+
+#endif
+
+    for (; i < n; i++) {
+        LaneReal x = lane->x[i] + lane->vx[i];
+        LaneReal y = lane->y[i] + lane->vy[i];
+        lane->x[i] = x;
+        lane->y[i] = y;
+        if (x <= 0 || x >= width || y <= 0 || y >= height) {
+            lane->flags[i] |= BULLET_DEAD;
+            dead++;
+        }
+    }
+    return dead;
+}
+
+// --- CPU 特性检测 ---
+
+static int CpuHasSse2() {
+#if defined(_M_X64) || defined(__x86_64__)
+    return 1; // x86-64 基线指令集
+#elif defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[3] >> 26) & 1;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse2");
+#endif
+}
+
+static int CpuHasAvx2() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return 0;
+    __cpuid(info, 1);
+    if (!((info[2] >> 27) & 1) || !((info[2] >> 28) & 1)) return 0; // OSXSAVE + AVX
+    if ((_xgetbv(0) & 6) != 6) return 0;                               // 系统保存 YMM 状态
+    __cpuidex(info, 7, 0);
+    return (info[1] >> 5) & 1;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif // BULLETS_X86
+
+// --- 内核选择 ---
+
+// 第一次使用时按 CPU 自动选择。balance 的工作线程和任务图的子弹阶段可能同时第一次调用，
+// 所以两者都是原子变量：先写 active_kernel 再以 release 发布 step_kernel，
+// 各线程自动选出的内核相同，同时选择也只是重复写入同一个值
+static _Atomic(StepKernelFn) step_kernel = NULL;
+static atomic_int active_kernel = BULLET_KERNEL_SCALAR;
+
+int BulletKernelSupported(BulletKernel kernel) {
+    switch (kernel) {
+        case BULLET_KERNEL_SCALAR: return 1;
+#if BULLETS_X86
+        case BULLET_KERNEL_SSE2: return CpuHasSse2();
+        case BULLET_KERNEL_AVX2: return CpuHasAvx2();
+#endif
+        default: return 0;
+    }
+}
+
+void BulletSelectKernel(BulletKernel kernel) {
+    if (!BulletKernelSupported(kernel)) kernel = BULLET_KERNEL_SCALAR;
+
+    StepKernelFn fn;
+    switch (kernel) {
+#if BULLETS_X86
+        case BULLET_KERNEL_SSE2: fn = StepSse2; break;
+        case BULLET_KERNEL_AVX2: fn = StepAvx2; break;
+#endif
+        default: fn = StepScalar; break;
+    }
+    atomic_store_explicit(&active_kernel, (int)kernel, memory_order_relaxed);
+    atomic_store_explicit(&step_kernel, fn, memory_order_release);
+}
+
+// 首次使用时选择当前 CPU 支持的最快内核
+static void AutoSelectKernel() {
+    BulletKernel best = BULLET_KERNEL_SCALAR;
+    if (BulletKernelSupported(BULLET_KERNEL_AVX2)) best = BULLET_KERNEL_AVX2;
+    else if (BulletKernelSupported(BULLET_KERNEL_SSE2)) best = BULLET_KERNEL_SSE2;
+    BulletSelectKernel(best);
+}
+
+static StepKernelFn StepKernel() {
+    StepKernelFn fn = atomic_load_explicit(&step_kernel, memory_order_acquire);
+    if (fn == NULL) {
+        AutoSelectKernel();
+        fn = atomic_load_explicit(&step_kernel, memory_order_acquire);
+    }
+    return fn;
+}
+
+BulletKernel BulletActiveKernel() {
+    StepKernel();
+    return (BulletKernel)atomic_load_explicit(&active_kernel, memory_order_relaxed);
+}
+
+const char* BulletKernelName(BulletKernel kernel) {
+    switch (kernel) {
+        case BULLET_KERNEL_SCALAR: return "scalar";
+        case BULLET_KERNEL_SSE2: return "sse2";
+        case BULLET_KERNEL_AVX2: return "avx2";
+        default: return "unknown";
+    }
+}
+
+int BulletLaneStep(BulletLane* lane, LaneReal width, LaneReal height) {
+    int dead = StepKernel()(lane, width, height);
+    if (dead > 0) {
+        BulletLaneCompact(lane);
+    }
+    return dead;
+}
+
+// 用指向 [begin, end) 的临时子弹道调用同一个内核，逐颗结果与整条处理完全相同
+int BulletLaneStepRange(BulletLane* lane, int begin, int end, LaneReal width, LaneReal height) {
+    BulletLane range;
+    range.capacity = end - begin;
+    range.count = end - begin;
+    range.x = lane->x + begin;
+    range.y = lane->y + begin;
+    range.vx = lane->vx + begin;
+    range.vy = lane->vy + begin;
+    range.flags = lane->flags + begin;
+    return StepKernel()(&range, width, height);
+}
+
+void BulletLaneAdvance(BulletLane* lane, int frames) {
+    LaneReal k = (LaneReal)frames;
+    for (int i = 0; i < lane->count; i++) {
+        lane->x[i] += k * lane->vx[i];
+        lane->y[i] += k * lane->vy[i];
+    }
+}
+
+int BulletLaneCull(BulletLane* lane, LaneReal width, LaneReal height) {
+    int dead = 0;
+    for (int i = 0; i < lane->count; i++) {
+        LaneReal x = lane->x[i], y = lane->y[i];
+        lane->flags[i] &= (BulletFlags)~BULLET_BIRTH_MASK;
+        if (x <= 0 || x >= width || y <= 0 || y >= height) {
+            lane->flags[i] |= BULLET_DEAD;
+            dead++;
+        }
+    }
+    if (dead > 0) BulletLaneCompact(lane);
+    lane->retired = 0;
+    return dead;
+}
@@ -0,0 +1,83 @@
+#ifndef BULLETS_H
+#define BULLETS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "fixed.h"
+
+// 子弹存储 (SoA)：x/y/vx/vy 分别连续存放，便于 SIMD 一次处理多颗子弹。
+// 坐标类型为 LaneReal：默认 double (与 Real 相同，每条 SSE2/AVX2 指令 2/4 颗)，
+// 定点模式下为 Q16.16 的 int32 (每条指令 4/8 颗，见 fixed.h)。
+// 自机子弹和敌机子弹各用一条 BulletLane，碰撞检测时无需再按 owner 过滤。
+// 删除采用 swap-remove，数组始终保持紧凑，遍历范围就是 [0, count)。
+
+// --- flags 位定义 ---
+// 低字节是状态位，高字节是发射者类型
+typedef uint16_t BulletFlags;
+#define BULLET_OWNER_ENEMY 0x01  // 0: 自机子弹, 1: 敌机子弹
+#define BULLET_DEAD        0x80  // 已失效，等待 BulletLaneCompact 回收
+
+// 敌机子弹的发射者类型：存为 type + 1，0 表示未知 (最多 BULLET_SHOOTER_MAX 种敌机，见 game.h)
+#define BULLET_SHOOTER_SHIFT 8
+#define BULLET_SHOOTER_MASK  0xFF00
+#define BULLET_SHOOTER_MAX   (BULLET_SHOOTER_MASK >> BULLET_SHOOTER_SHIFT)
+#define BULLET_SHOOTER(type) ((BulletFlags)(((type) + 1) << BULLET_SHOOTER_SHIFT))
+#define BULLET_SHOOTER_TYPE(flags) ((((flags) & BULLET_SHOOTER_MASK) >> BULLET_SHOOTER_SHIFT) - 1)
+
+// 粗时间步内第几帧发射 (1..UPDATE_MAX_STEPS，0 表示步前已存在)，只在 UpdateSteps() 内部使用
+#define BULLET_BIRTH_SHIFT 3
+#define BULLET_BIRTH_MASK  0x78
+#define BULLET_BIRTH(step) ((BulletFlags)((step) << BULLET_BIRTH_SHIFT))
+#define BULLET_BIRTH_STEP(flags) (((flags) & BULLET_BIRTH_MASK) >> BULLET_BIRTH_SHIFT)
+
+// 每个数组按 8 个元素 (至少 32 字节) 对齐，保证 AVX2 对齐加载
+#define BULLET_LANE_STRIDE(capacity) (((capacity) + 7) & ~7)
+#define BULLET_LANE_BYTES(capacity) \
+    ((size_t)BULLET_LANE_STRIDE(capacity) * (4 * sizeof(LaneReal) + sizeof(BulletFlags)))
+
+typedef struct {
+    int capacity;
+    int count;
+    int limit;                   // 同时在场的子弹上限 (BulletLaneInit 设为 capacity)
+    int retired;                 // 粗时间步中已飞出场外、等步末回收的子弹数：仍占位置，但不计入 limit
+    LaneReal* x;
+    LaneReal* y;
+    LaneReal* vx;
+    LaneReal* vy;
+    BulletFlags* flags;
+} BulletLane;
+
+// 积分 + 边界剔除内核的实现版本
+typedef enum {
+    BULLET_KERNEL_SCALAR,
+    BULLET_KERNEL_SSE2,
+    BULLET_KERNEL_AVX2,
+    BULLET_KERNEL_COUNT
+} BulletKernel;
+
+// storage 至少 BULLET_LANE_BYTES(capacity) 字节，且按 32 字节对齐
+void BulletLaneInit(BulletLane* lane, void* storage, int capacity);
+// 在场子弹 (count - retired) 达到 limit 或位置用完时失败，返回 -1
+int BulletLanePush(BulletLane* lane, LaneReal x, LaneReal y, LaneReal vx, LaneReal vy, BulletFlags flags);
+int BulletLaneReserve(BulletLane* lane, int n, int* first); // 在末尾预留最多 n 个位置，返回实际数量，由调用方填写
+void BulletLaneKill(BulletLane* lane, int i);     // 标记失效，稍后统一回收
+int BulletLaneCompact(BulletLane* lane);          // 回收所有已标记子弹，返回回收数量
+
+// 前进一帧并剔除离开 (0, width) x (0, height) 的子弹，返回剔除数量
+int BulletLaneStep(BulletLane* lane, LaneReal width, LaneReal height);
+// 只前进 [begin, end) 并给越界子弹打上 BULLET_DEAD 标记 (不回收)，返回标记数量。
+// begin 须为 8 的倍数 (SIMD 对齐)；不同线程可以同时处理互不重叠的范围，全部完成后再 BulletLaneCompact
+int BulletLaneStepRange(BulletLane* lane, int begin, int end, LaneReal width, LaneReal height);
+
+// 粗时间步：一次前进 frames 帧但不剔除 (碰撞检测需要子弹在步内的整条轨迹)，
+// 检测完再用 BulletLaneCull 剔除越界子弹、清除 BULLET_BIRTH 标记并把 retired 归零
+void BulletLaneAdvance(BulletLane* lane, int frames);
+int BulletLaneCull(BulletLane* lane, LaneReal width, LaneReal height);
+
+// --- 内核选择 (首次调用时按 CPU 特性自动选择) ---
+BulletKernel BulletActiveKernel();
+int BulletKernelSupported(BulletKernel kernel);
+void BulletSelectKernel(BulletKernel kernel);     // 强制使用指定内核 (用于基准测试)
+const char* BulletKernelName(BulletKernel kernel);
+
+#endif
@@ -0,0 +1,953 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "game.h"
+#include "grid.h"
+#include "collision.h"
+#include "danger.h"
+#include "profiler.h"
+
+// --- 判定范围 (优化判定精度) ---
+// 精确判定用 Real / RealSq 比较 (定点模式下为纯整数)；网格查询只需要 double 近似值
+#define BULLET_HIT_RANGE 0.8        // 子弹 vs 敌机：方形判定
+#define PLAYER_HIT_RADIUS_SQ 0.25   // 敌弹 vs 玩家：0.5*0.5
+#define GRAZE_RADIUS_SQ 1.0         // 擦弹：GRAZE_DISTANCE^2
+#define ENEMY_CRASH_RANGE 0.8       // 敌机本体 vs 玩家
+#define ITEM_PICKUP_RANGE 1.2       // 玩家 vs 道具
+
+// 格子边长至少为 2：所有判定范围都不超过 1.2，查询最多覆盖 2x2 个格子。
+// 实体容量较小时自动放大格子 (GridChooseCellSize)，存储按最小边长预留。
+#define COLLISION_CELL_SIZE 2
+
+typedef enum {
+    SWEEP_A,    // 与逐帧检测的 A-D 步骤对应，同一帧内按这个顺序生效
+    SWEEP_B,
+    SWEEP_C,
+    SWEEP_D
+} SweepPhase;
+
+typedef struct {
+    unsigned char sample;   // 逐帧模拟检测到接触的帧 (1..steps)
+    unsigned char phase;    // SweepPhase
+    unsigned char hit;      // B: 1 = 命中判定圈, 0 = 只进入擦弹圈
+    int index;              // A/B: 子弹下标，C/D: dense 位置
+    int other;              // A: 敌机的 dense 位置
+} SweepEvent;
+
+// 每个 GameState 一份，多个游戏可以在不同线程中同时做碰撞检测。数组都切自游戏的 arena
+struct CollisionScratch {
+    // 本帧已被击毁的敌机 / 已拾取的道具，按 dense 位置标记，检测结束后统一回收
+    unsigned char* enemy_dead;
+    unsigned char* item_taken;
+
+    Grid enemy_grid;
+    Grid enemy_bullet_grid;
+    Grid item_grid;
+    int max_candidates;        // 三种容量中的最大值
+    int* candidates;
+
+    // 粗时间步 (ResolveCollisionsSwept)
+    SweepLog sweep;
+    unsigned char* sweep_item_last;
+    unsigned char* bullet_hit;   // 自机子弹第一次命中的采样，0 表示没有命中
+    // 分段并行的 7A：第 k 段 [begin, end) 的筛选结果写在 scan_hits[2 * begin..]，互不重叠。
+    // 每颗筛出的子弹占两项：子弹编号，以及唯一重叠的敌机 (重叠多架或候选过多时为 -1)
+    int* scan_hits;
+    // 接触事件：每颗敌弹、每架敌机、每个道具至多一个，
+    // 自机子弹一般也只有一个 (同一帧击穿重叠的敌机时才有多个)，超出容量的接触被忽略
+    int max_events;
+    int num_events;
+    SweepEvent* events;
+};
+
+// 格子存储按最小边长预留，实际边长由 GridChooseCellSize 按容量放大
+static int* CarveGrid(Arena* arena, Grid* grid, const GameConfig* config, int capacity) {
+    int cols = GRID_DIM(config->width, COLLISION_CELL_SIZE), rows = GRID_DIM(config->height, COLLISION_CELL_SIZE);
+    int* storage = (int*)ArenaAlloc(arena, sizeof(int) * GRID_STORAGE_INTS((size_t)cols, rows, capacity));
+    if (storage != NULL) {
+        GridInit(grid, config->width, config->height,
+                 GridChooseCellSize(config->width, config->height, capacity, COLLISION_CELL_SIZE),
+                 capacity, storage);
+    }
+    return storage;
+}
+
+CollisionScratch* CarveCollisionScratch(Arena* arena, const GameConfig* config) {
+    CollisionScratch* c = (CollisionScratch*)ArenaAlloc(arena, sizeof(CollisionScratch));
+    Grid unused;
+    Grid* enemy_grid = c != NULL ? &c->enemy_grid : &unused;
+    Grid* enemy_bullet_grid = c != NULL ? &c->enemy_bullet_grid : &unused;
+    Grid* item_grid = c != NULL ? &c->item_grid : &unused;
+    int max_candidates = config->max_bullets;
+    if (config->max_enemies > max_candidates) max_candidates = config->max_enemies;
+    if (config->max_items > max_candidates) max_candidates = config->max_items;
+    int lane_capacity = BULLET_LANE_CAPACITY(config->max_bullets); // 步末的子弹道含步内飞出场外的子弹
+    int max_events = 2 * lane_capacity + config->max_enemies + config->max_items;
+
+    unsigned char* enemy_dead = (unsigned char*)ArenaAlloc(arena, config->max_enemies);
+    unsigned char* item_taken = (unsigned char*)ArenaAlloc(arena, config->max_items);
+    CarveGrid(arena, enemy_grid, config, config->max_enemies);
+    CarveGrid(arena, enemy_bullet_grid, config, config->max_bullets);
+    CarveGrid(arena, item_grid, config, config->max_items);
+    int* candidates = (int*)ArenaAlloc(arena, sizeof(int) * max_candidates);
+    unsigned char* sweep_item_last = (unsigned char*)ArenaAlloc(arena, config->max_items);
+    unsigned char* bullet_hit = (unsigned char*)ArenaAlloc(arena, lane_capacity);
+    int* scan_hits = (int*)ArenaAlloc(arena, sizeof(int) * 2 * config->max_bullets);
+    SweepEvent* events = (SweepEvent*)ArenaAlloc(arena, sizeof(SweepEvent) * max_events);
+    if (c == NULL) return NULL;
+
+    c->enemy_dead = enemy_dead;
+    c->item_taken = item_taken;
+    c->max_candidates = max_candidates;
+    c->candidates = candidates;
+    c->sweep_item_last = sweep_item_last;
+    c->bullet_hit = bullet_hit;
+    c->scan_hits = scan_hits;
+    c->max_events = max_events;
+    c->events = events;
+    return c;
+}
+
+// --- 命中效果 (两种实现共用) ---
+
+// 标记本帧回收，同时从危险场的前瞻层中移除
+static void MarkEnemyDead(GameState* game, int m) {
+    const EnemyGroups* enemies = &game->enemies;
+    game->collision->enemy_dead[m] = 1;
+    if (game->danger != NULL) {
+        DangerFieldEraseEnemy(game->danger, enemies->x[m], enemies->y[m], game->archetypes[enemies->type[m]].speed);
+    }
+}
+
+static void KillEnemyBullet(GameState* game, int i) {
+    if (game->danger != NULL) DangerFieldEraseBullet(game->danger, &game->enemy_bullets, i);
+    BulletLaneKill(&game->enemy_bullets, i);
+}
+
+// 子弹击毁敌机
+static void DestroyEnemy(GameState* game, int m) {
+    const EnemyGroups* enemies = &game->enemies;
+    int type = enemies->type[m];
+    MarkEnemyDead(game, m);
+    
+    // 生成爆炸效果
+    SpawnExplosion(game, enemies->x[m], enemies->y[m]);
+    EmitSound(game, SOUND_HIT); // 播放击中音效
+    
+    // 按原型计分
+    game->stats.kills_by_type[type]++;
+    game->player.score += game->archetypes[type].score;
+    LogEvent(game, EVENT_KILL, enemies->x[m], enemies->y[m], type, game->archetypes[type].score);
+    
+    // 10%概率掉落道具
+    unsigned drop_rand = RngNext(&game->rng);
+    if (drop_rand % 100 < 10) {
+        int item_type = (drop_rand / 100) % 2; // 0=生命, 1=火力
+        SpawnItem(game, enemies->x[m], enemies->y[m], item_type);
+    }
+}
+
+// 扣除生命，统计自机被哪类敌机击中以及最后一次 (致命) 击中的来源；
+// (x, y) 为事件日志中记录的位置，生命由正变为耗尽时另记一条游戏结束
+static void RecordHit(GameState* game, GameEventType event, int enemy_type, Real x, Real y, int damage) {
+    int alive = game->player.lives > 0;
+    game->player.lives -= damage;
+    if (enemy_type >= 0 && enemy_type < ENEMY_TYPE_COUNT) {
+        game->stats.hits_by_type[enemy_type]++;
+    }
+    if (game->player.lives <= 0) game->stats.killer_type = enemy_type;
+    LogEvent(game, event, x, y, enemy_type, 0);
+    if (alive && game->player.lives <= 0) {
+        LogEvent(game, EVENT_GAME_OVER, game->player.pos.x, game->player.pos.y, enemy_type, game->player.score);
+    }
+}
+
+static int BulletOverlapsEnemy(const GameState* game, int i, int m) {
+    Real dx = game->player_bullets.x[i] - game->enemies.x[m];
+    Real dy = game->player_bullets.y[i] - game->enemies.y[m];
+    return RABS(dx) < R(BULLET_HIT_RANGE) && RABS(dy) < R(BULLET_HIT_RANGE);
+}
+
+static RealSq EnemyBulletDistSquared(GameState* game, int i) {
+    Real dx = game->enemy_bullets.x[i] - game->player.pos.x;
+    Real dy = game->enemy_bullets.y[i] - game->player.pos.y;
+    return RSQMUL(dx, dx) + RSQMUL(dy, dy); // 使用距离平方避免sqrt计算
+}
+
+// 敌弹接近玩家：命中或擦弹
+static void ResolveEnemyBullet(GameState* game, int i) {
+    RealSq dist_squared = EnemyBulletDistSquared(game, i);
+    
+    // 直接命中判定（使用圆形判定与擦弹保持一致）
+    if (dist_squared < RSQ(PLAYER_HIT_RADIUS_SQ)) {
+        KillEnemyBullet(game, i);
+        // 如果处于无敌状态，不扣血
+        if (game->player.invincible_timer <= 0) {
+            RecordHit(game, EVENT_HIT, BULLET_SHOOTER_TYPE(game->enemy_bullets.flags[i]),
+                      game->player.pos.x, game->player.pos.y, 1);
+        }
+    }
+    // 擦弹判定：子弹极度接近但未命中
+    else if (dist_squared < RSQ(GRAZE_RADIUS_SQ) && dist_squared >= RSQ(PLAYER_HIT_RADIUS_SQ)) {
+        // 触发擦弹奖励，并移除子弹防止重复触发
+        KillEnemyBullet(game, i);
+        game->player.graze_count++;
+        game->player.score += 5; // 擦弹奖励5分
+        game->player.invincible_timer = INVINCIBLE_FRAMES; // 给予短暂无敌时间
+        LogEvent(game, EVENT_GRAZE, game->player.pos.x, game->player.pos.y,
+                 BULLET_SHOOTER_TYPE(game->enemy_bullets.flags[i]), 5);
+    }
+}
+
+static int EnemyTouchesPlayer(GameState* game, int m) {
+    Real dx = game->enemies.x[m] - game->player.pos.x;
+    Real dy = game->enemies.y[m] - game->player.pos.y;
+    return RABS(dx) < R(ENEMY_CRASH_RANGE) && RABS(dy) < R(ENEMY_CRASH_RANGE);
+}
+
+// 敌机本体撞上玩家
+static void CrashEnemy(GameState* game, int m) {
+    MarkEnemyDead(game, m);
+    SpawnExplosion(game, game->enemies.x[m], game->enemies.y[m]);
+    EmitSound(game, SOUND_EXPLOSION); // 播放爆炸音效
+    RecordHit(game, EVENT_CRASH, game->enemies.type[m], game->enemies.x[m], game->enemies.y[m],
+              game->player.lives); // 直接死亡
+}
+
+static int ItemInReach(GameState* game, int m) {
+    int i = game->item_pool.dense[m];
+    Real dx = game->items[i].pos.x - game->player.pos.x;
+    Real dy = game->items[i].pos.y - game->player.pos.y;
+    return RABS(dx) < R(ITEM_PICKUP_RANGE) && RABS(dy) < R(ITEM_PICKUP_RANGE);
+}
+
+// 玩家拾取道具
+static void PickUpItem(GameState* game, int m) {
+    int i = game->item_pool.dense[m];
+    game->collision->item_taken[m] = 1;
+    
+    if (game->items[i].type == 0) {
+        // 生命恢复
+        if (game->player.lives < 5) game->player.lives++;
+        LogEvent(game, EVENT_PICKUP_LIFE, game->items[i].pos.x, game->items[i].pos.y, -1, 0);
+    } else {
+        // 火力升级
+        if (game->player.power_level < 2) game->player.power_level++;
+        game->player.power_timer = 625; // 10秒 (625 个 16ms 模拟步，见 SIM_TICK_SECONDS)
+        LogEvent(game, EVENT_PICKUP_POWER, game->items[i].pos.x, game->items[i].pos.y, -1, 0);
+    }
+}
+
+// --- 检测前后的簿记 ---
+
+// 倒序回收：被换到 m 的末尾元素的标记已经处理过。
+// 回收时顺带清除标记，检测开始时所有标记都为 0 (包括本帧 7A 中新掉落的道具所占的位置)
+static void EndPass(GameState* game) {
+    CollisionScratch* c = game->collision;
+    BulletLaneCompact(&game->player_bullets);
+    BulletLaneCompact(&game->enemy_bullets);
+    for (int m = game->enemies.count - 1; m >= 0; m--) {
+        if (c->enemy_dead[m]) {
+            c->enemy_dead[m] = 0;
+            EnemyGroupsRemove(&game->enemies, m);
+        }
+    }
+    for (int m = game->item_pool.count - 1; m >= 0; m--) {
+        if (c->item_taken[m]) {
+            c->item_taken[m] = 0;
+            PoolRelease(&game->item_pool, game->item_pool.dense[m]);
+        }
+    }
+}
+
+// --- 网格粗检测实现 ---
+
+// 插入顺序 = dense 位置 / 子弹下标，查询结果可直接映射回实体
+void BuildEnemyGrid(GameState* game) {
+    CollisionScratch* c = game->collision;
+    GridClear(&c->enemy_grid);
+    for (int m = 0; m < game->enemies.count; m++) {
+        GridInsert(&c->enemy_grid, RToDouble(game->enemies.x[m]), RToDouble(game->enemies.y[m]));
+    }
+    GridBuild(&c->enemy_grid);
+}
+
+void BuildEnemyBulletGrid(GameState* game) {
+    CollisionScratch* c = game->collision;
+    GridClear(&c->enemy_bullet_grid);
+    for (int i = 0; i < game->enemy_bullets.count; i++) {
+        GridInsert(&c->enemy_bullet_grid, RToDouble(game->enemy_bullets.x[i]), RToDouble(game->enemy_bullets.y[i]));
+    }
+    GridBuild(&c->enemy_bullet_grid);
+}
+
+// 道具网格在 7D 之前单独构建：7A 中击毁敌机掉落的道具同一帧就能被拾取 (与逐对检测一致)
+static void BuildItemGrid(GameState* game) {
+    CollisionScratch* c = game->collision;
+    GridClear(&c->item_grid);
+    for (int m = 0; m < game->item_pool.count; m++) {
+        int i = game->item_pool.dense[m];
+        GridInsert(&c->item_grid, RToDouble(game->items[i].pos.x), RToDouble(game->items[i].pos.y));
+    }
+    GridBuild(&c->item_grid);
+}
+
+// 网格查询结果按格子排列；先做精确判定，再把 (通常极少的) 命中按编号排序，
+// 这样处理顺序与逐对检测完全一致
+static void SortIds(int* ids, int n) {
+    for (int k = 1; k < n; k++) {
+        int id = ids[k];
+        int pos = k;
+        while (pos > 0 && ids[pos - 1] > id) {
+            ids[pos] = ids[pos - 1];
+            pos--;
+        }
+        ids[pos] = id;
+    }
+}
+
+// A. 子弹 i vs 敌人 (命中按 dense 位置倒序处理)
+static void ResolvePlayerBullet(GameState* game, int i) {
+    CollisionScratch* c = game->collision;
+    int* candidates = c->candidates;
+    int n = GridQuery(&c->enemy_grid, RToDouble(game->player_bullets.x[i]), RToDouble(game->player_bullets.y[i]),
+                      BULLET_HIT_RANGE, candidates, c->max_candidates);
+    int hits = 0;
+    for (int t = 0; t < n; t++) {
+        if (!c->enemy_dead[candidates[t]] && BulletOverlapsEnemy(game, i, candidates[t])) {
+            candidates[hits++] = candidates[t];
+        }
+    }
+    if (hits == 0) return;
+
+    // 子弹命中后仍继续检测其余敌人 (同一帧可击穿重叠的敌机)
+    SortIds(candidates, hits);
+    for (int t = hits - 1; t >= 0; t--) {
+        DestroyEnemy(game, candidates[t]);
+    }
+    BulletLaneKill(&game->player_bullets, i);
+}
+
+// B-D 以及检测结束后的回收
+static void ResolvePlayerContacts(GameState* game) {
+    CollisionScratch* c = game->collision;
+    int* candidates = c->candidates;
+
+    // B. 敌机子弹 vs 玩家 (查询擦弹范围，覆盖命中范围；按子弹下标升序处理)
+    PROF_BEGIN(PROF_COLLIDE_B);
+    int n = GridQuery(&c->enemy_bullet_grid, RToDouble(game->player.pos.x), RToDouble(game->player.pos.y),
+                      GRAZE_DISTANCE, candidates, c->max_candidates);
+    int hits = 0;
+    for (int t = 0; t < n; t++) {
+        if (EnemyBulletDistSquared(game, candidates[t]) < RSQ(GRAZE_RADIUS_SQ)) candidates[hits++] = candidates[t];
+    }
+    SortIds(candidates, hits);
+    for (int t = 0; t < hits; t++) {
+        ResolveEnemyBullet(game, candidates[t]);
+    }
+    PROF_END(PROF_COLLIDE_B);
+
+    // C. 敌机本体 vs 玩家
+    PROF_BEGIN(PROF_COLLIDE_C);
+    n = GridQuery(&c->enemy_grid, RToDouble(game->player.pos.x), RToDouble(game->player.pos.y), ENEMY_CRASH_RANGE, candidates, c->max_candidates);
+    hits = 0;
+    for (int t = 0; t < n; t++) {
+        if (!c->enemy_dead[candidates[t]] && EnemyTouchesPlayer(game, candidates[t])) candidates[hits++] = candidates[t];
+    }
+    SortIds(candidates, hits);
+    for (int t = hits - 1; t >= 0; t--) {
+        CrashEnemy(game, candidates[t]);
+    }
+    PROF_END(PROF_COLLIDE_C);
+
+    // D. 玩家 vs 道具
+    PROF_BEGIN(PROF_COLLIDE_D);
+    BuildItemGrid(game);
+    n = GridQuery(&c->item_grid, RToDouble(game->player.pos.x), RToDouble(game->player.pos.y), ITEM_PICKUP_RANGE, candidates, c->max_candidates);
+    hits = 0;
+    for (int t = 0; t < n; t++) {
+        if (ItemInReach(game, candidates[t])) candidates[hits++] = candidates[t];
+    }
+    SortIds(candidates, hits);
+    for (int t = hits - 1; t >= 0; t--) {
+        PickUpItem(game, candidates[t]);
+    }
+    EndPass(game); // 延迟的释放和子弹压缩计入 D
+    PROF_END(PROF_COLLIDE_D);
+}
+
+void ResolveCollisions(GameState* game) {
+    PROF_BEGIN(PROF_COLLIDE_GRID);
+    BuildEnemyGrid(game);
+    BuildEnemyBulletGrid(game);
+    PROF_END(PROF_COLLIDE_GRID);
+
+    PROF_BEGIN(PROF_COLLIDE_A);
+    for (int i = 0; i < game->player_bullets.count; i++) {
+        ResolvePlayerBullet(game, i);
+    }
+    PROF_END(PROF_COLLIDE_A);
+
+    ResolvePlayerContacts(game);
+}
+
+// --- 分段并行的 7A ---
+
+// 只读粗筛：网格候选超过 batch 个时不再细看，直接算作可能命中，由 ResolveScannedCollisions 重新查询
+#define SCAN_BATCH 256
+
+int ScanPlayerBullets(const GameState* game, int begin, int end) {
+    const CollisionScratch* c = game->collision;
+    int* out = c->scan_hits + 2 * begin;
+    int candidates[SCAN_BATCH];
+    int found = 0;
+    for (int i = begin; i < end; i++) {
+        int n = GridQuery(&c->enemy_grid, RToDouble(game->player_bullets.x[i]), RToDouble(game->player_bullets.y[i]),
+                          BULLET_HIT_RANGE, candidates, SCAN_BATCH);
+        int overlaps = n == SCAN_BATCH ? 2 : 0, enemy = -1;
+        for (int t = 0; t < n && overlaps < 2; t++) {
+            if (BulletOverlapsEnemy(game, i, candidates[t])) {
+                enemy = candidates[t];
+                overlaps++;
+            }
+        }
+        if (overlaps > 0) {
+            out[2 * found] = i;
+            out[2 * found + 1] = overlaps == 1 ? enemy : -1;
+            found++;
+        }
+    }
+    return found;
+}
+
+// 被筛掉的子弹与任何敌机都不重叠，逐颗处理时也会直接跳过，所以只处理筛出的子弹结果不变。
+// 本步骤中敌机不移动，只重叠一架的子弹不必再查网格：那架还没被击毁就命中，否则与逐颗处理一样落空
+void ResolveScannedCollisions(GameState* game, const int* chunk_begin, const int* chunk_found, int chunks) {
+    CollisionScratch* c = game->collision;
+    PROF_BEGIN(PROF_COLLIDE_A);
+    for (int k = 0; k < chunks; k++) {
+        const int* hits = c->scan_hits + 2 * chunk_begin[k];
+        for (int h = 0; h < chunk_found[k]; h++) {
+            int i = hits[2 * h], enemy = hits[2 * h + 1];
+            if (enemy < 0) {
+                ResolvePlayerBullet(game, i);
+            } else if (!c->enemy_dead[enemy]) {
+                DestroyEnemy(game, enemy);
+                BulletLaneKill(&game->player_bullets, i);
+            }
+        }
+    }
+    PROF_END(PROF_COLLIDE_A);
+
+    ResolvePlayerContacts(game);
+}
+
+// --- 逐对检测参考实现 ---
+
+void ResolveCollisionsBruteForce(GameState* game) {
+    CollisionScratch* c = game->collision;
+
+
+    // A. 子弹 vs 敌人
+    for (int i = 0; i < game->player_bullets.count; i++) {
+        int hit = 0;
+        for (int m = game->enemies.count - 1; m >= 0; m--) {
+            if (!c->enemy_dead[m] && BulletOverlapsEnemy(game, i, m)) {
+                hit = 1;
+                DestroyEnemy(game, m);
+            }
+        }
+        if (hit) BulletLaneKill(&game->player_bullets, i);
+    }
+
+    // B. 敌机子弹 vs 玩家
+    for (int i = 0; i < game->enemy_bullets.count; i++) {
+        ResolveEnemyBullet(game, i);
+    }
+
+    // C. 敌机本体 vs 玩家
+    for (int m = game->enemies.count - 1; m >= 0; m--) {
+        if (!c->enemy_dead[m] && EnemyTouchesPlayer(game, m)) CrashEnemy(game, m);
+    }
+
+    // D. 玩家 vs 道具
+    for (int m = game->item_pool.count - 1; m >= 0; m--) {
+        if (ItemInReach(game, m)) PickUpItem(game, m);
+    }
+
+    EndPass(game);
+}
+
+// --- 粗时间步的连续检测 ---
+
+#define SWEEP_EPSILON 1e-6          // 解析区间略微放宽，边界上的取舍交给整数帧上的精确判定
+
+SweepLog* BeginSweep(GameState* game, int steps) {
+    CollisionScratch* c = game->collision;
+    SweepLog* sweep = &c->sweep;
+    sweep->steps = steps;
+    sweep->invincible_start = game->player.invincible_timer;
+    sweep->player[0] = game->player.pos;
+    sweep->enemy_first = game->enemies.first;
+    sweep->enemy_last = game->enemies.last;
+    sweep->item_last = c->sweep_item_last;
+
+    // 步前已在场的实体从第 1 帧起参与检测；本步生成的由 UpdateSteps 登记
+    for (int m = 0; m < game->enemies.count; m++) {
+        sweep->enemy_first[m] = 0;
+        sweep->enemy_last[m] = (unsigned char)steps;
+    }
+    for (int m = 0; m < game->item_pool.count; m++) {
+        sweep->item_last[game->item_pool.dense[m]] = (unsigned char)steps;
+    }
+    return sweep;
+}
+
+// 自机在步内的轨迹：速度相同的相邻帧合并成一段，撞到边界停下时才分段
+typedef struct {
+    int a, b;           // 覆盖采样 [a, b]
+    double x, y;        // 采样 a 的位置
+    double vx, vy;      // 每帧位移
+} PathPiece;
+
+static int BuildPlayerPath(const SweepLog* sweep, PathPiece* pieces) {
+    int n = 0;
+    Real last_dx = 0, last_dy = 0;
+    for (int j = 1; j <= sweep->steps; j++) {
+        Real dx = sweep->player[j].x - sweep->player[j - 1].x;
+        Real dy = sweep->player[j].y - sweep->player[j - 1].y;
+        if (n > 0 && dx == last_dx && dy == last_dy) {
+            pieces[n - 1].b = j;
+            continue;
+        }
+        pieces[n].a = j - 1;
+        pieces[n].b = j;
+        pieces[n].x = RToDouble(sweep->player[j - 1].x);
+        pieces[n].y = RToDouble(sweep->player[j - 1].y);
+        pieces[n].vx = RToDouble(dx);
+        pieces[n].vy = RToDouble(dy);
+        last_dx = dx;
+        last_dy = dy;
+        n++;
+    }
+    return n;
+}
+
+// 采样 j 时的位置：子弹在步末的位置往回退 steps - j 帧；
+// 敌机 / 道具飞出底部后停在飞出那一帧的位置上
+static LaneReal LaneAt(LaneReal end, LaneReal v, int back) {
+    return end - (LaneReal)back * v;
+}
+
+static int EnemyRef(const SweepLog* sweep, int m) {
+    int last = sweep->enemy_last[m];
+    return last < sweep->steps ? last + 1 : sweep->steps;
+}
+
+static Real EnemySpeedAt(const GameState* game, int m) {
+    return game->archetypes[game->enemies.type[m]].speed;
+}
+
+static Real EnemyYAt(const GameState* game, const SweepLog* sweep, int m, int j) {
+    return game->enemies.y[m] - (Real)(EnemyRef(sweep, m) - j) * EnemySpeedAt(game, m);
+}
+
+static Real ItemYAt(const GameState* game, const SweepLog* sweep, int slot, int j) {
+    int last = sweep->item_last[slot];
+    int ref = last < sweep->steps ? last + 1 : sweep->steps;
+    return game->items[slot].pos.y - (Real)(ref - j) * ITEM_FALL_SPEED;
+}
+
+// 与逐帧剔除相同的边界条件
+static int LaneInBounds(const GameConfig* config, LaneReal x, LaneReal y) {
+    return !(x <= 0 || x >= (LaneReal)RFromInt(config->width) || y <= 0 || y >= (LaneReal)RFromInt(config->height));
+}
+
+// 子弹参与检测的采样范围 [*lo, *hi]：从发射那一帧起，到飞出场地的前一帧为止。
+// 场地是凸的，步末还在场内的子弹整步都在场内；否则逐帧找出飞出的那一帧
+static int BulletWindow(const GameConfig* config, const BulletLane* lane, int i, int steps, int* lo, int* hi) {
+    int birth = BULLET_BIRTH_STEP(lane->flags[i]);
+    *lo = birth > 0 ? birth : 1;
+    *hi = steps;
+    if (LaneInBounds(config, lane->x[i], lane->y[i])) return 1;
+    for (int j = *lo; j <= steps; j++) {
+        if (!LaneInBounds(config, LaneAt(lane->x[i], lane->vx[i], steps - j), LaneAt(lane->y[i], lane->vy[i], steps - j))) {
+            *hi = j - 1;
+            break;
+        }
+    }
+    return *lo <= *hi;
+}
+
+// 线段 vs 方框：lo < p + t*v < hi 的 t 与 [*t0, *t1] 求交，为空返回 0
+static int ClipSlab(double p, double v, double lo, double hi, double* t0, double* t1) {
+    lo -= SWEEP_EPSILON;
+    hi += SWEEP_EPSILON;
+    if (v == 0) return p > lo && p < hi;
+    double a = (lo - p) / v, b = (hi - p) / v;
+    if (a > b) {
+        double t = a;
+        a = b;
+        b = t;
+    }
+    if (a > *t0) *t0 = a;
+    if (b < *t1) *t1 = b;
+    return *t0 <= *t1;
+}
+
+static int ClipBox(double qx, double qy, double wx, double wy, double range, double* t0, double* t1) {
+    return ClipSlab(qx, wx, -range, range, t0, t1) && ClipSlab(qy, wy, -range, range, t0, t1);
+}
+
+// 线段 vs 圆：|q + t*w| < radius 的 t 与 [*t0, *t1] 求交
+static int ClipCircle(double qx, double qy, double wx, double wy, double radius, double* t0, double* t1) {
+    radius += SWEEP_EPSILON;
+    double a = wx * wx + wy * wy;
+    double b = qx * wx + qy * wy;
+    double c = qx * qx + qy * qy - radius * radius;
+    if (a == 0) return c < 0;
+    double disc = b * b - a * c;
+    if (disc < 0) return 0;
+    double root = sqrt(disc);
+    double enter = (-b - root) / a, leave = (-b + root) / a;
+    if (enter > *t0) *t0 = enter;
+    if (leave < *t1) *t1 = leave;
+    return *t0 <= *t1;
+}
+
+// t 以采样 lo 为 0：把区间换成需要精确判定的整数帧 [*first, *last]
+static void SampleRange(int lo, int hi, double t0, double t1, int* first, int* last) {
+    *first = lo + (int)floor(t0);
+    *last = lo + (int)ceil(t1);
+    if (*first < lo) *first = lo;
+    if (*last > hi) *last = hi;
+}
+
+static int AddEvent(CollisionScratch* c, int sample, SweepPhase phase, int index, int other, int hit) {
+    if (c->num_events >= c->max_events) return 0;
+    SweepEvent* e = &c->events[c->num_events++];
+    e->sample = (unsigned char)sample;
+    e->phase = (unsigned char)phase;
+    e->hit = (unsigned char)hit;
+    e->index = index;
+    e->other = other;
+    return 1;
+}
+
+// 同一帧内与逐帧检测的处理顺序一致：A 按子弹升序、敌机倒序，B 按子弹升序，C/D 倒序
+static int CompareEvents(const void* pa, const void* pb) {
+    const SweepEvent* a = (const SweepEvent*)pa;
+    const SweepEvent* b = (const SweepEvent*)pb;
+    if (a->sample != b->sample) return a->sample - b->sample;
+    if (a->phase != b->phase) return a->phase - b->phase;
+    if (a->index != b->index) return a->phase >= SWEEP_C ? b->index - a->index : a->index - b->index;
+    return b->other - a->other;
+}
+
+// A. 自机子弹 vs 敌机：两者都匀速直线运动，整个重叠区间上的相对运动是一条线段
+static void SweepBulletsVsEnemies(GameState* game, const SweepLog* sweep) {
+    CollisionScratch* c = game->collision;
+    const BulletLane* lane = &game->player_bullets;
+    int* candidates = c->candidates;
+    int steps = sweep->steps;
+
+    double max_speed = 0;
+    for (int t = 0; t < ENEMY_TYPE_COUNT; t++) {
+        if (RToDouble(game->archetypes[t].speed) > max_speed) max_speed = RToDouble(game->archetypes[t].speed);
+    }
+    double enemy_reach = BULLET_HIT_RANGE + max_speed * steps * 0.5;
+
+    // 敌机按步中位置入网格，查询范围放宽半步的移动距离
+    GridClear(&c->enemy_grid);
+    for (int m = 0; m < game->enemies.count; m++) {
+        int mid = (sweep->enemy_first[m] + sweep->enemy_last[m] + 1) / 2;
+        GridInsert(&c->enemy_grid, RToDouble(game->enemies.x[m]), RToDouble(EnemyYAt(game, sweep, m, mid)));
+    }
+    GridBuild(&c->enemy_grid);
+
+    for (int i = 0; i < lane->count; i++) {
+        int lo, hi;
+        if (!BulletWindow(&game->config, lane, i, steps, &lo, &hi)) continue;
+
+        double x0 = RToDouble(LaneAt(lane->x[i], lane->vx[i], steps - lo));
+        double y0 = RToDouble(LaneAt(lane->y[i], lane->vy[i], steps - lo));
+        double vx = RToDouble(lane->vx[i]), vy = RToDouble(lane->vy[i]);
+        double half = 0.5 * (hi - lo) * (fabs(vx) > fabs(vy) ? fabs(vx) : fabs(vy));
+        int n = GridQuery(&c->enemy_grid, x0 + 0.5 * (hi - lo) * vx, y0 + 0.5 * (hi - lo) * vy,
+                          half + enemy_reach, candidates, c->max_candidates);
+
+        for (int t = 0; t < n; t++) {
+            int m = candidates[t];
+            int first = sweep->enemy_first[m] > lo ? sweep->enemy_first[m] : lo;
+            int last = sweep->enemy_last[m] < hi ? sweep->enemy_last[m] : hi;
+            if (first > last) continue;
+
+            Real ex = game->enemies.x[m];
+            double qx = RToDouble(LaneAt(lane->x[i], lane->vx[i], steps - first)) - RToDouble(ex);
+            double qy = RToDouble(LaneAt(lane->y[i], lane->vy[i], steps - first)) -
+                        RToDouble(EnemyYAt(game, sweep, m, first));
+            double t0 = 0, t1 = last - first;
+            if (!ClipBox(qx, qy, vx, vy - RToDouble(EnemySpeedAt(game, m)), BULLET_HIT_RANGE, &t0, &t1)) {
+                continue;
+            }
+
+            int j0, j1;
+            SampleRange(first, last, t0, t1, &j0, &j1);
+            for (int j = j0; j <= j1; j++) {
+                Real dx = LaneAt(lane->x[i], lane->vx[i], steps - j) - ex;
+                Real dy = LaneAt(lane->y[i], lane->vy[i], steps - j) - EnemyYAt(game, sweep, m, j);
+                if (RABS(dx) < R(BULLET_HIT_RANGE) && RABS(dy) < R(BULLET_HIT_RANGE)) {
+                    AddEvent(c, j, SWEEP_A, i, m, 0);
+                    break;
+                }
+            }
+        }
+    }
+}
+
+// B. 敌弹 vs 擦弹圈：自机轨迹的每一段上相对运动是线段，第一次进入擦弹圈的那一帧决定擦弹还是命中
+static void SweepEnemyBullets(GameState* game, const SweepLog* sweep, const PathPiece* path, int pieces) {
+    CollisionScratch* c = game->collision;
+    const BulletLane* lane = &game->enemy_bullets;
+    int steps = sweep->steps;
+
+    // 自机整步的包围盒，放宽擦弹距离后做粗筛
+    double min_x = 1e30, max_x = -1e30, min_y = 1e30, max_y = -1e30;
+    for (int j = 1; j <= steps; j++) {
+        double px = RToDouble(sweep->player[j].x), py = RToDouble(sweep->player[j].y);
+        if (px < min_x) min_x = px;
+        if (px > max_x) max_x = px;
+        if (py < min_y) min_y = py;
+        if (py > max_y) max_y = py;
+    }
+    min_x -= GRAZE_DISTANCE;
+    max_x += GRAZE_DISTANCE;
+    min_y -= GRAZE_DISTANCE;
+    max_y += GRAZE_DISTANCE;
+
+    for (int i = 0; i < lane->count; i++) {
+        double x1 = RToDouble(lane->x[i]), y1 = RToDouble(lane->y[i]);
+        double vx = RToDouble(lane->vx[i]), vy = RToDouble(lane->vy[i]);
+        double x0 = x1 - steps * vx, y0 = y1 - steps * vy;
+        if ((x0 < min_x && x1 < min_x) || (x0 > max_x && x1 > max_x) ||
+            (y0 < min_y && y1 < min_y) || (y0 > max_y && y1 > max_y)) {
+            continue;
+        }
+
+        int lo, hi;
+        if (!BulletWindow(&game->config, lane, i, steps, &lo, &hi)) continue;
+        for (int p = 0; p < pieces; p++) {
+            int first = path[p].a > lo ? path[p].a : lo;
+            int last = path[p].b < hi ? path[p].b : hi;
+            if (first > last) continue;
+
+            double qx = RToDouble(LaneAt(lane->x[i], lane->vx[i], steps - first)) - (path[p].x + (first - path[p].a) * path[p].vx);
+            double qy = RToDouble(LaneAt(lane->y[i], lane->vy[i], steps - first)) - (path[p].y + (first - path[p].a) * path[p].vy);
+            double t0 = 0, t1 = last - first;
+            if (!ClipCircle(qx, qy, vx - path[p].vx, vy - path[p].vy, GRAZE_DISTANCE, &t0, &t1)) continue;
+
+            int j0, j1, found = 0;
+            SampleRange(first, last, t0, t1, &j0, &j1);
+            for (int j = j0; j <= j1 && !found; j++) {
+                Real dx = LaneAt(lane->x[i], lane->vx[i], steps - j) - sweep->player[j].x;
+                Real dy = LaneAt(lane->y[i], lane->vy[i], steps - j) - sweep->player[j].y;
+                RealSq dist_squared = RSQMUL(dx, dx) + RSQMUL(dy, dy);
+                if (dist_squared < RSQ(GRAZE_RADIUS_SQ)) {
+                    AddEvent(c, j, SWEEP_B, i, 0, dist_squared < RSQ(PLAYER_HIT_RADIUS_SQ));
+                    found = 1;
+                }
+            }
+            if (found) break;
+        }
+    }
+}
+
+// 实体 (x, y(j)) 以每帧 vy 下落，在 [first, last] 内与自机第一次进入 range 方框的采样，没有返回 0
+static int FirstTouch(const GameState* game, const SweepLog* sweep, const PathPiece* path, int pieces,
+                      Real x, Real y_first, Real vy, int first, int last, double range) {
+    for (int p = 0; p < pieces; p++) {
+        int lo = path[p].a > first ? path[p].a : first;
+        int hi = path[p].b < last ? path[p].b : last;
+        if (lo > hi) continue;
+
+        Real y_lo = y_first + (Real)(lo - first) * vy;
+        double qx = RToDouble(x) - (path[p].x + (lo - path[p].a) * path[p].vx);
+        double qy = RToDouble(y_lo) - (path[p].y + (lo - path[p].a) * path[p].vy);
+        double t0 = 0, t1 = hi - lo;
+        if (!ClipBox(qx, qy, -path[p].vx, RToDouble(vy) - path[p].vy, range, &t0, &t1)) continue;
+
+        int j0, j1;
+        SampleRange(lo, hi, t0, t1, &j0, &j1);
+        for (int j = j0; j <= j1; j++) {
+            Real dx = x - sweep->player[j].x;
+            Real dy = y_first + (Real)(j - first) * vy - sweep->player[j].y;
+            if (RABS(dx) < R(range) && RABS(dy) < R(range)) return j;
+        }
+    }
+    (void)game;
+    return 0;
+}
+
+// C. 敌机本体 vs 自机
+static void SweepEnemyCrashes(GameState* game, const SweepLog* sweep, const PathPiece* path, int pieces) {
+    for (int m = 0; m < game->enemies.count; m++) {
+        int first = sweep->enemy_first[m] > 1 ? sweep->enemy_first[m] : 1;
+        int last = sweep->enemy_last[m];
+        if (first > last) continue;
+        int j = FirstTouch(game, sweep, path, pieces, game->enemies.x[m], EnemyYAt(game, sweep, m, first),
+                           EnemySpeedAt(game, m), first, last, ENEMY_CRASH_RANGE);
+        if (j > 0) AddEvent(game->collision, j, SWEEP_C, m, 0, 0);
+    }
+}
+
+// D. 自机 vs 步前已在场的道具
+static void SweepItems(GameState* game, const SweepLog* sweep, const PathPiece* path, int pieces) {
+    for (int m = 0; m < game->item_pool.count; m++) {
+        int slot = game->item_pool.dense[m];
+        int last = sweep->item_last[slot];
+        if (last < 1) continue;
+        int j = FirstTouch(game, sweep, path, pieces, game->items[slot].pos.x, ItemYAt(game, sweep, slot, 1),
+                           ITEM_FALL_SPEED, 1, last, ITEM_PICKUP_RANGE);
+        if (j > 0) AddEvent(game->collision, j, SWEEP_D, m, 0, 0);
+    }
+}
+
+static void PickUpItemAt(GameState* game, const SweepLog* sweep, int m, int j) {
+    PickUpItem(game, m);
+    if (game->items[game->item_pool.dense[m]].type != 0) {
+        game->player.power_timer -= sweep->steps - j; // 拾取之后的几帧已经过去
+    }
+}
+
+// 第 j 帧击毁 / 撞毁敌机时生成的爆炸和掉落的道具：补上步内剩下的几帧
+static void SettleSpawns(GameState* game, SweepLog* sweep, int explosions, int items, int j, int until) {
+    int steps = sweep->steps;
+    for (int k = explosions; k < game->explosion_pool.count; k++) {
+        game->explosions[game->explosion_pool.dense[k]].timer -= steps - j;
+    }
+    for (int m = items; m < game->item_pool.count; m++) {
+        int slot = game->item_pool.dense[m];
+        Item* item = &game->items[slot];
+        Real drop_y = item->pos.y;
+
+        // 逐帧模拟中道具当帧就可拾取，之后每帧下落，飞出底部的那一帧起消失
+        int last = steps;
+        for (int k = j + 1; k <= steps; k++) {
+            if (drop_y + (Real)(k - j) * ITEM_FALL_SPEED >= RFromInt(game->config.height - 1)) {
+                last = k - 1;
+                break;
+            }
+        }
+        sweep->item_last[slot] = (unsigned char)last;
+        item->pos.y = drop_y + (Real)((last < steps ? last + 1 : steps) - j) * ITEM_FALL_SPEED;
+
+        int stop = last < until ? last : until;
+        for (int k = j; k <= stop; k++) {
+            Real dx = item->pos.x - sweep->player[k].x;
+            Real dy = drop_y + (Real)(k - j) * ITEM_FALL_SPEED - sweep->player[k].y;
+            if (RABS(dx) < R(ITEM_PICKUP_RANGE) && RABS(dy) < R(ITEM_PICKUP_RANGE)) {
+                PickUpItemAt(game, sweep, m, k);
+                break;
+            }
+        }
+    }
+}
+
+// 按时间顺序让接触生效；自机死亡的那一帧之后的接触不再处理 (逐帧模拟中游戏已经结束)
+static void ApplyEvents(GameState* game, SweepLog* sweep) {
+    CollisionScratch* c = game->collision;
+    int steps = sweep->steps;
+    int death = 0, graze_at = 0;
+
+    qsort(c->events, (size_t)c->num_events, sizeof(SweepEvent), CompareEvents);
+    for (int k = 0; k < c->num_events; k++) {
+        const SweepEvent* e = &c->events[k];
+        int j = e->sample;
+        if (death > 0 && j > death) break;
+
+        int explosions = game->explosion_pool.count, items = game->item_pool.count;
+        switch (e->phase) {
+            case SWEEP_A: {
+                // 子弹命中后同一帧仍可击穿其他敌机，之后的帧里已经不存在
+                if (c->enemy_dead[e->other]) break;
+                if (c->bullet_hit[e->index] != 0 && c->bullet_hit[e->index] < j) break;
+                game->enemies.y[e->other] = EnemyYAt(game, sweep, e->other, j);
+                DestroyEnemy(game, e->other);
+                SettleSpawns(game, sweep, explosions, items, j, death > 0 ? death : steps);
+                c->bullet_hit[e->index] = (unsigned char)j;
+                BulletLaneKill(&game->player_bullets, e->index);
+                break;
+            }
+            case SWEEP_B: {
+                // 第 j 帧的无敌时间：步前的值逐帧递减，步内擦弹后从 INVINCIBLE_FRAMES 重新递减
+                int timer = graze_at > 0 ? INVINCIBLE_FRAMES - (j - graze_at) : sweep->invincible_start - j;
+                KillEnemyBullet(game, e->index);
+                int shooter = BULLET_SHOOTER_TYPE(game->enemy_bullets.flags[e->index]);
+                if (e->hit) {
+                    if (timer <= 0) RecordHit(game, EVENT_HIT, shooter, sweep->player[j].x, sweep->player[j].y, 1);
+                } else {
+                    game->player.graze_count++;
+                    game->player.score += 5;
+                    graze_at = j;
+                    LogEvent(game, EVENT_GRAZE, sweep->player[j].x, sweep->player[j].y, shooter, 5);
+                }
+                break;
+            }
+            case SWEEP_C: {
+                if (c->enemy_dead[e->index]) break;
+                game->enemies.y[e->index] = EnemyYAt(game, sweep, e->index, j);
+                CrashEnemy(game, e->index);
+                SettleSpawns(game, sweep, explosions, items, j, j);
+                break;
+            }
+            case SWEEP_D:
+                if (!c->item_taken[e->index]) PickUpItemAt(game, sweep, e->index, j);
+                break;
+        }
+        if (death == 0 && game->player.lives <= 0) death = j;
+    }
+
+    if (graze_at > 0) game->player.invincible_timer = INVINCIBLE_FRAMES - (steps - graze_at);
+}
+
+// 步末回收：先回收击毁 / 拾取的实体，再回收步内飞出底部的，最后剔除越界子弹
+static void EndSweep(GameState* game, const SweepLog* sweep) {
+    EndPass(game);
+    for (int m = game->enemies.count - 1; m >= 0; m--) {
+        if (sweep->enemy_last[m] < sweep->steps) EnemyGroupsRemove(&game->enemies, m);
+    }
+    for (int m = game->item_pool.count - 1; m >= 0; m--) {
+        int slot = game->item_pool.dense[m];
+        if (sweep->item_last[slot] < sweep->steps) PoolRelease(&game->item_pool, slot);
+    }
+    BulletLaneCull(&game->player_bullets, (LaneReal)RFromInt(game->config.width), (LaneReal)RFromInt(game->config.height));
+    BulletLaneCull(&game->enemy_bullets, (LaneReal)RFromInt(game->config.width), (LaneReal)RFromInt(game->config.height));
+}
+
+void ResolveCollisionsSwept(GameState* game) {
+    CollisionScratch* c = game->collision;
+    SweepLog* sweep = &c->sweep;
+    PathPiece path[UPDATE_MAX_STEPS];
+    int pieces = BuildPlayerPath(sweep, path);
+
+    c->num_events = 0;
+    memset(c->bullet_hit, 0, (size_t)game->player_bullets.count);
+
+    PROF_BEGIN(PROF_COLLIDE_A);
+    SweepBulletsVsEnemies(game, sweep);
+    PROF_END(PROF_COLLIDE_A);
+
+    PROF_BEGIN(PROF_COLLIDE_B);
+    SweepEnemyBullets(game, sweep, path, pieces);
+    PROF_END(PROF_COLLIDE_B);
+
+    PROF_BEGIN(PROF_COLLIDE_C);
+    SweepEnemyCrashes(game, sweep, path, pieces);
+    PROF_END(PROF_COLLIDE_C);
+
+    PROF_BEGIN(PROF_COLLIDE_D);
+    SweepItems(game, sweep, path, pieces);
+    ApplyEvents(game, sweep);
+    EndSweep(game, sweep);
+    PROF_END(PROF_COLLIDE_D);
+}
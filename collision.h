@@ -0,0 +1,53 @@
+#ifndef COLLISION_H
+#define COLLISION_H
+
+// Update() 第 7 步的碰撞检测
+//
+// 两种实现的判定顺序和结果完全一致：
+// - ResolveCollisions 用均匀网格做粗检测，每帧重建一次，开销与实体数量成线性
+// - ResolveCollisionsBruteForce 逐对检测，作为参考实现用于基准对比和结果校验
+//
+// UpdateSteps() 的粗时间步另用 ResolveCollisionsSwept：子弹、敌机、道具在步内都是匀速直线运动，
+// 自机按住同一输入时是至多几段的折线，两两之间的相对运动因此是分段线性的。
+// 对每一对候选，用线段 vs 方框 (子弹 vs 敌机、敌机本体、道具) 或线段 vs 圆 (敌弹 vs 擦弹圈)
+// 的解析解求出相对轨迹落在判定区内的时间区间，再只在区间内的整数帧上做精确判定，
+// 得到逐帧模拟会在哪一帧检测到这次接触 (擦弹还是命中也按那一帧的距离决定)。
+// 所有接触按 (帧, 判定步骤, 编号) 排序后依次生效，步内的击毁、擦弹无敌、死亡都按时间先后处理。
+//
+// 与逐帧模拟的差别 (都只影响统计上的细节)：
+// - 步内被击毁的敌机在步末之前仍会发射子弹；分数、火力的变化到步末才影响射速和生成间隔
+// - 步内掉落的道具立即按剩余轨迹判定拾取，不与同一步里更晚的接触排序
+// - 击毁敌机时的掉落随机数在整步的生成、发射之后才抽取，随机数序列与逐帧模拟不同，单局轨迹会分叉
+
+#include "arena.h"
+#include "game.h"
+
+void ResolveCollisions(GameState* game);
+void ResolveCollisionsBruteForce(GameState* game);
+
+// 多线程 Update 用的分段接口 (见 game.c)，结果与 ResolveCollisions 完全一致：
+// 两个网格可以同时构建；敌机网格建好后，把自机子弹分成互不重叠的段并行调用 ScanPlayerBullets
+// (只读，筛出与敌机重叠的子弹，返回数量)，最后由一个线程按段的顺序调用 ResolveScannedCollisions，
+// 击毁、计分、掉落、扣血等副作用都在这里按子弹编号的顺序生效
+void BuildEnemyGrid(GameState* game);
+void BuildEnemyBulletGrid(GameState* game);
+int ScanPlayerBullets(const GameState* game, int begin, int end);
+void ResolveScannedCollisions(GameState* game, const int* chunk_begin, const int* chunk_found, int chunks);
+
+// 粗时间步内记录的轨迹信息 (由 UpdateSteps 填写)。采样 j = 1..steps 对应逐帧模拟第 j 帧的碰撞检测
+typedef struct {
+    int steps;
+    int invincible_start;                // 步前的擦弹无敌时间
+    Vec2 player[UPDATE_MAX_STEPS + 1];   // player[j]：第 j 帧移动之后的位置，player[0] 为步前
+    unsigned char* enemy_first;          // 按敌机下标 (即 game->enemies.first/last)：参与碰撞的第一个 / 最后一个采样
+    unsigned char* enemy_last;           // (本步生成的从生成那一帧开始，飞出底部的到前一帧为止)
+    unsigned char* item_last;
+} SweepLog;
+
+SweepLog* BeginSweep(GameState* game, int steps);
+void ResolveCollisionsSwept(GameState* game);
+
+// 碰撞检测的临时数据，由 CreateGame 从游戏的 arena 中切出 (只计算大小时返回 NULL)
+CollisionScratch* CarveCollisionScratch(Arena* arena, const GameConfig* config);
+
+#endif
@@ -0,0 +1,142 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "config.h"
+#include "platform.h"
+
+#define CONFIG_LINE_BYTES 256
+
+typedef struct {
+    const char* name;       // 参数名 (不含 --)，也是配置文件的 key
+    size_t offset;          // 在 GameConfig 中的位置
+} ConfigField;
+
+static const ConfigField config_fields[] = {
+    {"width", offsetof(GameConfig, width)},
+    {"height", offsetof(GameConfig, height)},
+    {"max-bullets", offsetof(GameConfig, max_bullets)},
+    {"max-enemies", offsetof(GameConfig, max_enemies)},
+    {"max-items", offsetof(GameConfig, max_items)},
+    {"max-explosions", offsetof(GameConfig, max_explosions)},
+};
+
+#define NUM_CONFIG_FIELDS ((int)(sizeof(config_fields) / sizeof(config_fields[0])))
+
+static const ConfigField* FindField(const char* name) {
+    for (int f = 0; f < NUM_CONFIG_FIELDS; f++) {
+        if (strcmp(config_fields[f].name, name) == 0) return &config_fields[f];
+    }
+    return NULL;
+}
+
+// 只接受完整的十进制正整数
+static int ParsePositive(const char* text, int* value) {
+    char* end;
+    long v = strtol(text, &end, 10);
+    if (end == text || *end != '\0' || v <= 0 || v > MAX_CAPACITY) return 0;
+    *value = (int)v;
+    return 1;
+}
+
+static int SetField(GameConfig* config, const ConfigField* field, const char* text) {
+    int value;
+    if (!ParsePositive(text, &value)) return 0;
+    memcpy((char*)config + field->offset, &value, sizeof(int));
+    return 1;
+}
+
+char* ConfigTrim(char* s) {
+    while (*s == ' ' || *s == '\t') s++;
+    char* end = s + strlen(s);
+    while (end > s && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r' || end[-1] == '\n')) end--;
+    *end = '\0';
+    return s;
+}
+
+int ConfigLoadFile(GameConfig* config, const char* path) {
+    FILE* file = fopen(path, "r");
+    if (file == NULL) {
+        fprintf(stderr, "config: cannot open %s\n", path);
+        return 0;
+    }
+
+    char line[CONFIG_LINE_BYTES];
+    int number = 0, ok = 1;
+    while (ok && fgets(line, sizeof(line), file) != NULL) {
+        number++;
+        char* comment = strchr(line, '#');
+        if (comment != NULL) *comment = '\0';
+        char* text = ConfigTrim(line);
+        if (*text == '\0') continue;
+
+        char* equals = strchr(text, '=');
+        if (equals == NULL) {
+            fprintf(stderr, "config: %s:%d: expected key = value\n", path, number);
+            ok = 0;
+            break;
+        }
+        *equals = '\0';
+        char* key = ConfigTrim(text);
+        char* value = ConfigTrim(equals + 1);
+        const ConfigField* field = FindField(key);
+        if (field == NULL) {
+            fprintf(stderr, "config: %s:%d: unknown key '%s'\n", path, number, key);
+            ok = 0;
+        } else if (!SetField(config, field, value)) {
+            fprintf(stderr, "config: %s:%d: bad value '%s' for %s\n", path, number, value, key);
+            ok = 0;
+        }
+    }
+    fclose(file);
+    return ok;
+}
+
+int ConfigParseArgs(GameConfig* config, int argc, char** argv) {
+    int kept = 1;
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const ConfigField* field = strncmp(arg, "--", 2) == 0 ? FindField(arg + 2) : NULL;
+        if (field != NULL || strcmp(arg, "--config") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "config: %s needs a value\n", arg);
+                return -1;
+            }
+            const char* value = argv[++i];
+            if (field == NULL) {
+                if (!ConfigLoadFile(config, value)) return -1;
+            } else if (!SetField(config, field, value)) {
+                fprintf(stderr, "config: bad value '%s' for %s\n", value, arg);
+                return -1;
+            }
+        } else {
+            argv[kept++] = argv[i];
+        }
+    }
+    argv[kept] = NULL;
+
+    const char* error = GameConfigError(config);
+    if (error != NULL) {
+        fprintf(stderr, "config: %s (field %d..%d x %d..%d, capacities 1..%d)\n", error,
+                MIN_FIELD_WIDTH, MAX_FIELD_WIDTH, MIN_FIELD_HEIGHT, MAX_FIELD_HEIGHT, MAX_CAPACITY);
+        return -1;
+    }
+    return kept;
+}
+
+static int Clamp(int value, int lo, int hi) {
+    return value < lo ? lo : value > hi ? hi : value;
+}
+
+int ConfigFitTerminal(GameConfig* config) {
+    int cols, rows;
+    if (!PlatformTerminalSize(&cols, &rows)) return 0;
+    config->width = Clamp(cols, MIN_FIELD_WIDTH, MAX_FIELD_WIDTH);
+    config->height = Clamp(rows - CONFIG_TERMINAL_RESERVED_ROWS, MIN_FIELD_HEIGHT, MAX_FIELD_HEIGHT);
+    return 1;
+}
+
+void ConfigPrint(const GameConfig* config, FILE* out) {
+    fprintf(out, "field %dx%d, capacity: bullets %d per lane, enemies %d, items %d, explosions %d\n",
+            config->width, config->height, config->max_bullets, config->max_enemies,
+            config->max_items, config->max_explosions);
+}
@@ -0,0 +1,35 @@
+#ifndef CONFIG_H
+#define CONFIG_H
+
+#include <stdio.h>
+#include "game.h"
+
+// 运行时配置：游戏区域大小和实体容量 (GameConfig) 的命令行参数、配置文件和终端适配。
+// 所有前端共用同一组参数，改区域大小或容量不需要重新编译：
+//   --width N --height N --max-bullets N --max-enemies N --max-items N --max-explosions N --config FILE
+//
+// 配置文件每行一个 "key = value" (key 同参数名，去掉前面的 --)，'#' 之后是注释，例如：
+//   width = 200
+//   height = 100
+//   max-bullets = 50000
+// 参数按出现顺序生效，--config 之后的参数会覆盖文件中的值。
+
+// 终端留给状态栏和光标的行数 (状态栏 1 行 + 最后 1 行不写，避免滚屏)
+#define CONFIG_TERMINAL_RESERVED_ROWS 2
+
+// 从 argv 中取出上述参数，其余参数按原顺序留在 argv[1..]，返回剩余的 argc；
+// 参数或配置文件有误、最终配置超出范围时打印原因并返回 -1
+int ConfigParseArgs(GameConfig* config, int argc, char** argv);
+
+// 读取配置文件，成功返回 1；失败时打印原因 (含行号) 并返回 0
+int ConfigLoadFile(GameConfig* config, const char* path);
+
+// 让游戏区域填满当前终端 (限制在允许范围内)；标准输出不是终端时保持不变，返回 0
+int ConfigFitTerminal(GameConfig* config);
+
+void ConfigPrint(const GameConfig* config, FILE* out);  // 一行摘要，用于各工具的报告
+
+// 去掉首尾空白 (原地修改)；同样是 "key = value" 格式的场景文件 (perfsuite) 也用它
+char* ConfigTrim(char* s);
+
+#endif
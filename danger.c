@@ -0,0 +1,177 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "danger.h"
+
+#define ENEMY_REACH 0.8             // 敌机本体判定 (与 collision.c 的 ENEMY_CRASH_RANGE 一致)
+
+struct DangerField {
+    int frame;                      // 对应的 frame_count，-1 表示下一次 Update() 时重建
+    int head;                       // 层环中 "1 帧之后" 那一层的下标
+    int stamped;                    // 上一帧结束时已计入的敌弹数，Update() 之外追加的子弹在下一帧补上
+    int rebuilding;                 // 本帧正在重建 (到步骤 4 结束)：敌机也要写满全部层
+    int cols, rows;                 // 小格数，由游戏区域大小决定
+    uint16_t cells[];               // [DANGER_LOOKAHEAD][rows][cols]
+};
+
+// 第 layer 层第 cy 行的首个小格
+static uint16_t* CellRow(const DangerField* field, int layer, int cy) {
+    return (uint16_t*)&field->cells[((size_t)layer * field->rows + cy) * field->cols];
+}
+
+static size_t LayerCells(const DangerField* field) {
+    return (size_t)field->rows * field->cols;
+}
+
+int AttachDangerField(GameState* game) {
+    if (game->danger != NULL) return 1;
+    int cols = game->config.width * DANGER_SUBDIV, rows = game->config.height * DANGER_SUBDIV;
+    DangerField* field = (DangerField*)malloc(sizeof(DangerField) + sizeof(uint16_t) * DANGER_LOOKAHEAD * rows * cols);
+    if (field == NULL) return 0;
+    field->cols = cols;
+    field->rows = rows;
+    DangerFieldReset(field);
+    game->danger = field;
+    return 1;
+}
+
+void DestroyDangerField(DangerField* field) {
+    free(field);
+}
+
+void DangerFieldReset(DangerField* field) {
+    field->frame = -1;
+    field->stamped = 0;
+    field->rebuilding = 0;
+}
+
+int DangerFieldReady(const DangerField* field, const GameState* game) {
+    return field != NULL && field->frame == game->frame_count;
+}
+
+static int LayerIndex(const DangerField* field, int k) {
+    return (field->head + k - 1) % DANGER_LOOKAHEAD;
+}
+
+// 子弹坐标所在小格 (坐标非负时)，直接在 LaneReal 上计算
+#if PHYSICS_FIXED_POINT
+#define LANE_CELL(v) ((int)(((int64_t)(v) * DANGER_SUBDIV) >> FIXED_FRAC_BITS))
+#else
+#define LANE_CELL(v) ((int)((v) * DANGER_SUBDIV))
+#endif
+
+// delta 为正时饱和相加，为负时减到 0 为止
+static void AddCell(uint16_t* cell, int delta) {
+    int v = *cell + delta;
+    *cell = (uint16_t)(v < 0 ? 0 : v > 0xFFFF ? 0xFFFF : v);
+}
+
+static void StampPoint(DangerField* field, int layer, LaneReal x, LaneReal y, int delta) {
+    if (x < 0 || y < 0) return;
+    int cx = LANE_CELL(x), cy = LANE_CELL(y);
+    if (cx < field->cols && cy < field->rows) AddCell(&CellRow(field, layer, cy)[cx], delta);
+}
+
+// 子弹 i 在 k 帧之后的位置写进对应的层，k 取 [k0, k1]
+static void StampBullet(DangerField* field, const BulletLane* lane, int i, int k0, int k1, int delta) {
+    for (int k = k0; k <= k1; k++) {
+        LaneReal x = lane->x[i] + (LaneReal)k * lane->vx[i];
+        LaneReal y = lane->y[i] + (LaneReal)k * lane->vy[i];
+        StampPoint(field, LayerIndex(field, k), x, y, delta);
+    }
+}
+
+// 敌机按判定范围覆盖的所有小格计入
+static void StampEnemy(DangerField* field, Real x, Real y, Real vy, int k0, int k1, int delta) {
+    double ex = RToDouble(x);
+    for (int k = k0; k <= k1; k++) {
+        double ey = RToDouble(y + (Real)k * vy);
+        int x0 = (int)((ex - ENEMY_REACH) * DANGER_SUBDIV), x1 = (int)((ex + ENEMY_REACH) * DANGER_SUBDIV);
+        int y0 = (int)((ey - ENEMY_REACH) * DANGER_SUBDIV), y1 = (int)((ey + ENEMY_REACH) * DANGER_SUBDIV);
+        if (x0 < 0) x0 = 0;
+        if (y0 < 0) y0 = 0;
+        if (x1 >= field->cols) x1 = field->cols - 1;
+        if (y1 >= field->rows) y1 = field->rows - 1;
+        int layer = LayerIndex(field, k);
+        for (int cy = y0; cy <= y1; cy++) {
+            uint16_t* row = CellRow(field, layer, cy);
+            for (int cx = x0; cx <= x1; cx++) AddCell(&row[cx], delta);
+        }
+    }
+}
+
+void DangerFieldBeginFrame(DangerField* field, const GameState* game) {
+    const BulletLane* lane = &game->enemy_bullets;
+    if (field->frame != game->frame_count - 1) {
+        // 第一次使用或状态被替换：从当前 (积分前) 的位置完整建立，敌机在步骤 4 写入
+        memset(field->cells, 0, sizeof(uint16_t) * DANGER_LOOKAHEAD * LayerCells(field));
+        field->head = 0;
+        field->rebuilding = 1;
+        for (int i = 0; i < lane->count; i++) StampBullet(field, lane, i, 1, DANGER_LOOKAHEAD, 1);
+    } else {
+        for (int i = field->stamped; i < lane->count; i++) StampBullet(field, lane, i, 1, DANGER_LOOKAHEAD, 1);
+    }
+}
+
+void DangerFieldAdvance(DangerField* field, const BulletLane* lane) {
+    // 最近一帧已经到来：清空后成为新的最远层
+    int far = field->head;
+    memset(CellRow(field, far, 0), 0, sizeof(uint16_t) * LayerCells(field));
+    field->head = (field->head + 1) % DANGER_LOOKAHEAD;
+
+    for (int i = 0; i < lane->count; i++) {
+        LaneReal x = lane->x[i] + (LaneReal)DANGER_LOOKAHEAD * lane->vx[i];
+        LaneReal y = lane->y[i] + (LaneReal)DANGER_LOOKAHEAD * lane->vy[i];
+        StampPoint(field, far, x, y, 1);
+    }
+}
+
+void DangerFieldStampEnemy(DangerField* field, Real x, Real y, Real vy, int is_new) {
+    int k0 = is_new || field->rebuilding ? 1 : DANGER_LOOKAHEAD;
+    StampEnemy(field, x, y, vy, k0, DANGER_LOOKAHEAD, DANGER_ENEMY_WEIGHT);
+}
+
+void DangerFieldStampBullets(DangerField* field, const BulletLane* lane, int first) {
+    for (int i = first; i < lane->count; i++) StampBullet(field, lane, i, 1, DANGER_LOOKAHEAD, 1);
+    field->rebuilding = 0;
+}
+
+void DangerFieldEraseBullet(DangerField* field, const BulletLane* lane, int i) {
+    StampBullet(field, lane, i, 1, DANGER_LOOKAHEAD, -1);
+}
+
+void DangerFieldEraseEnemy(DangerField* field, Real x, Real y, Real vy) {
+    if (field->rebuilding) return; // 重建的这一帧，飞出底部的敌机还没写入
+    StampEnemy(field, x, y, vy, 1, DANGER_LOOKAHEAD, -DANGER_ENEMY_WEIGHT);
+}
+
+void DangerFieldEndFrame(DangerField* field, const GameState* game) {
+    field->frame = game->frame_count;
+    field->stamped = game->enemy_bullets.count;
+}
+
+void DangerFieldSums(const DangerField* field, int k, double x, double y, int inner, int outer,
+                     int* inner_sum, int* outer_sum) {
+    int cx = (int)(x * DANGER_SUBDIV), cy = (int)(y * DANGER_SUBDIV);
+    int x0 = cx - outer, x1 = cx + outer, y0 = cy - outer, y1 = cy + outer;
+    if (x0 < 0) x0 = 0;
+    if (y0 < 0) y0 = 0;
+    if (x1 >= field->cols) x1 = field->cols - 1;
+    if (y1 >= field->rows) y1 = field->rows - 1;
+
+    int layer = LayerIndex(field, k);
+    int in_sum = 0, out_sum = 0;
+    for (int row = y0; row <= y1; row++) {
+        const uint16_t* cells = CellRow(field, layer, row);
+        int row_sum = 0;
+        for (int col = x0; col <= x1; col++) row_sum += cells[col];
+        out_sum += row_sum;
+        if (row >= cy - inner && row <= cy + inner) {
+            for (int col = cx - inner; col <= cx + inner; col++) {
+                if (col >= x0 && col <= x1) in_sum += cells[col];
+            }
+        }
+    }
+    *inner_sum = in_sum;
+    *outer_sum = out_sum;
+}
@@ -0,0 +1,44 @@
+#ifndef DANGER_H
+#define DANGER_H
+
+#include "game.h"
+
+// 危险场：自动驾驶用的粗粒度前瞻网格
+//
+// 把游戏区域划成 0.5 x 0.5 的小格，保存未来 1..DANGER_LOOKAHEAD 帧每格里的敌弹数
+// (敌机本体按 DANGER_ENEMY_WEIGHT 颗子弹计)。子弹和敌机都是匀速直线运动，
+// 所以各层不必每帧重算：层按帧号组成环，Update() 步骤 3 积分子弹后丢掉已经到来的一层，
+// 把每颗敌弹 L 帧后的位置写进新的最远层；步骤 4 移动敌机时同样只写最远层，
+// 本帧新发射的子弹、新生成的敌机写满全部层；被击中、擦弹消除或飞出底部的实体从各层减掉。
+// 维护代价是每颗敌弹每帧一次写入，与 Update() 的积分在同一趟里完成；
+// 自动驾驶查询只读固定数量的格子，与子弹数无关。
+//
+// 危险场只是 Update() 的旁路输出，不参与 GameHash、快照和随机数，开不开都不影响模拟结果。
+// 浮点模式下 p + k*v 与逐帧积分的舍入可能差一格，误差在该层转到最近一帧后随层清空。
+
+#define DANGER_LOOKAHEAD 8          // 前瞻帧数 (层数)
+#define DANGER_SUBDIV 2             // 每个字符格分成 2 x 2 个小格
+#define DANGER_ENEMY_WEIGHT 64
+
+// 为 game 创建危险场 (game->danger，按 game 的区域大小分配)，下一次 Update() 时从当前状态完整建立；失败返回 0
+int AttachDangerField(GameState* game);
+void DestroyDangerField(DangerField* field);
+void DangerFieldReset(DangerField* field);      // 状态被整体替换后 (InitGame、快照恢复) 调用
+
+// 危险场是否对应 game 的当前帧 (Reset 之后到下一次 Update() 之前不可用)
+int DangerFieldReady(const DangerField* field, const GameState* game);
+
+// k 帧之后 (1..DANGER_LOOKAHEAD)，以 (x, y) 所在小格为中心、半径 inner / outer 个小格的两个方块内的危险值之和
+void DangerFieldSums(const DangerField* field, int k, double x, double y, int inner, int outer,
+                     int* inner_sum, int* outer_sum);
+
+// --- 由 Update() / 碰撞检测调用 ---
+void DangerFieldBeginFrame(DangerField* field, const GameState* game); // 步骤 3，子弹积分之前
+void DangerFieldAdvance(DangerField* field, const BulletLane* lane);   // 步骤 3，子弹积分之后
+void DangerFieldStampEnemy(DangerField* field, Real x, Real y, Real vy, int is_new); // 步骤 4，敌机移动之后
+void DangerFieldStampBullets(DangerField* field, const BulletLane* lane, int first); // 步骤 4 结束：新发射的子弹
+void DangerFieldEraseBullet(DangerField* field, const BulletLane* lane, int i);
+void DangerFieldEraseEnemy(DangerField* field, Real x, Real y, Real vy);
+void DangerFieldEndFrame(DangerField* field, const GameState* game);   // Update() 结束
+
+#endif
@@ -0,0 +1,100 @@
+#include <stdint.h>
+#include <string.h>
+#include "delta.h"
+
+#define DELTA_MIN_RUN 4    // 少于 4 个相同字节不值得结束当前的不同段
+#define DELTA_MAX_VARINT 10
+
+static size_t PutVarint(unsigned char* out, size_t pos, size_t value) {
+    do {
+        unsigned char byte = value & 0x7F;
+        value >>= 7;
+        out[pos++] = byte | (value ? 0x80 : 0);
+    } while (value);
+    return pos;
+}
+
+// 读到末尾仍未结束时返回 0 (*ok 置 0)
+static size_t GetVarint(const unsigned char* in, size_t size, size_t* pos, int* ok) {
+    size_t value = 0;
+    int shift = 0;
+    unsigned char byte;
+    do {
+        if (*pos >= size || shift >= 64) {
+            *ok = 0;
+            return 0;
+        }
+        byte = in[(*pos)++];
+        value |= (size_t)(byte & 0x7F) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+    return value;
+}
+
+size_t DeltaEncode(unsigned char* base, size_t base_bytes, unsigned char* target, size_t target_bytes,
+                   unsigned char* out, size_t limit) {
+    size_t n = base_bytes > target_bytes ? base_bytes : target_bytes;
+    if (base_bytes < n) memset(base + base_bytes, 0, n - base_bytes);
+    if (target_bytes < n) memset(target + target_bytes, 0, n - target_bytes);
+    if (limit < DELTA_HEADER_BYTES) return 0;
+
+    uint32_t header = (uint32_t)target_bytes;
+    memcpy(out, &header, sizeof(header));
+    size_t pos = DELTA_HEADER_BYTES;
+
+    size_t i = 0;
+    while (i < n) {
+        size_t same_start = i;
+        // 相同段按 8 字节一组跳过
+        while (i + 8 <= n) {
+            uint64_t a, b;
+            memcpy(&a, base + i, 8);
+            memcpy(&b, target + i, 8);
+            if (a != b) break;
+            i += 8;
+        }
+        while (i < n && base[i] == target[i]) i++;
+        if (i == n) break;
+
+        size_t diff_start = i;
+        while (i < n) {
+            if (base[i] != target[i]) {
+                i++;
+                continue;
+            }
+            size_t same = 1;
+            while (same < DELTA_MIN_RUN && i + same < n && base[i + same] == target[i + same]) same++;
+            if (same >= DELTA_MIN_RUN || i + same == n) break;
+            i += same;
+        }
+
+        size_t diff = i - diff_start;
+        if (pos + 2 * DELTA_MAX_VARINT + diff > limit) return 0;
+        pos = PutVarint(out, pos, diff_start - same_start);
+        pos = PutVarint(out, pos, diff);
+        for (size_t k = diff_start; k < i; k++) out[pos++] = base[k] ^ target[k];
+    }
+    return pos;
+}
+
+size_t DeltaApply(unsigned char* block, size_t bytes, size_t capacity,
+                  const unsigned char* delta, size_t delta_bytes) {
+    uint32_t target;
+    if (delta_bytes < DELTA_HEADER_BYTES) return 0;
+    memcpy(&target, delta, sizeof(target));
+    if (target == 0 || target > capacity || bytes > capacity) return 0;
+    if (target > bytes) memset(block + bytes, 0, target - bytes);
+
+    size_t n = target > bytes ? target : bytes;
+    size_t pos = DELTA_HEADER_BYTES;
+    size_t i = 0;
+    int ok = 1;
+    while (pos < delta_bytes) {
+        size_t same = GetVarint(delta, delta_bytes, &pos, &ok);
+        size_t diff = GetVarint(delta, delta_bytes, &pos, &ok);
+        if (!ok || same > n - i || diff > n - i - same || diff > delta_bytes - pos) return 0;
+        i += same;
+        for (size_t k = 0; k < diff; k++) block[i++] ^= delta[pos++];
+    }
+    return target;
+}
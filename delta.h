@@ -0,0 +1,23 @@
+#ifndef DELTA_H
+#define DELTA_H
+
+#include <stddef.h>
+
+// 差分编码：target 与 base 逐字节 XOR，再对结果做零字节游程编码 (快照环和观战流共用)
+//
+// 格式：目标字节数 u32，然后是若干 (相同字节数 varint, 不同字节数 varint, XOR 字节[不同字节数])。
+// 较短的一方视为末尾补零；最后一段相同字节不写出，完全相同的两块只占 4 字节。
+
+#define DELTA_HEADER_BYTES 4
+
+// 编码 base -> target 到 out (至少 limit 字节)，返回字节数；超过 limit 时返回 0 (不如直接存完整数据)。
+// base 和 target 的缓冲区都至少要有 max(base_bytes, target_bytes) 字节，较短一方的末尾会被清零
+size_t DeltaEncode(unsigned char* base, size_t base_bytes, unsigned char* target, size_t target_bytes,
+                   unsigned char* out, size_t limit);
+
+// 把差分作用到 block (当前内容为 bytes 字节的 base，缓冲区共 capacity 字节)，
+// 返回目标字节数；差分损坏或超出 capacity 时返回 0
+size_t DeltaApply(unsigned char* block, size_t bytes, size_t capacity,
+                  const unsigned char* delta, size_t delta_bytes);
+
+#endif
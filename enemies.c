@@ -0,0 +1,74 @@
+#include "enemies.h"
+
+void EnemyGroupsInit(EnemyGroups* groups, void* storage, int capacity) {
+    int stride = ENEMY_GROUPS_STRIDE(capacity);
+    groups->capacity = capacity;
+    groups->count = 0;
+    for (int t = 0; t <= ENEMY_TYPE_COUNT; t++) groups->start[t] = 0;
+    groups->x = (Real*)storage;
+    groups->y = groups->x + stride;
+    groups->cooldown = (int*)(groups->y + stride);
+    groups->shot = groups->cooldown + stride;
+    groups->type = (unsigned char*)(groups->shot + stride);
+    groups->first = groups->type + stride;
+    groups->last = groups->first + stride;
+}
+
+static void Move(EnemyGroups* groups, int from, int to) {
+    groups->x[to] = groups->x[from];
+    groups->y[to] = groups->y[from];
+    groups->cooldown[to] = groups->cooldown[from];
+    groups->shot[to] = groups->shot[from];
+    groups->type[to] = groups->type[from];
+    groups->first[to] = groups->first[from];
+    groups->last[to] = groups->last[from];
+}
+
+// 从末尾开始，每组把自己的第一个元素挪到末尾之后，空位逐组前移到第 type 组的末尾
+int EnemyGroupsAdd(EnemyGroups* groups, int type) {
+    if (groups->count >= groups->capacity) return -1;
+
+    int hole = groups->count++;
+    for (int t = ENEMY_TYPE_COUNT - 1; t > type; t--) {
+        int head = groups->start[t];
+        if (head != hole) Move(groups, head, hole);
+        hole = head;
+    }
+    for (int t = type + 1; t <= ENEMY_TYPE_COUNT; t++) groups->start[t]++;
+    groups->type[hole] = (unsigned char)type;
+    return hole;
+}
+
+// 空位先移到本组末尾，再逐组后移到整个数组的末尾
+void EnemyGroupsRemove(EnemyGroups* groups, int i) {
+    int type = groups->type[i];
+    int hole = groups->start[type + 1] - 1;
+    if (i != hole) Move(groups, hole, i);
+    for (int t = type + 1; t < ENEMY_TYPE_COUNT; t++) {
+        int tail = groups->start[t + 1] - 1;
+        if (tail != hole) Move(groups, tail, hole);
+        hole = tail;
+    }
+    for (int t = type + 1; t <= ENEMY_TYPE_COUNT; t++) groups->start[t]--;
+    groups->count--;
+}
+
+void EnemyGroupsStep(EnemyGroups* groups, const Real speeds[ENEMY_TYPE_COUNT], int sweep_steps) {
+    Real* y = groups->y;
+    int* cooldown = groups->cooldown;
+    const unsigned char* last = groups->last;
+    for (int t = 0; t < ENEMY_TYPE_COUNT; t++) {
+        int begin = groups->start[t], end = groups->start[t + 1];
+        Real speed = speeds[t];
+        if (sweep_steps == 0) {
+            for (int i = begin; i < end; i++) y[i] += speed;
+            for (int i = begin; i < end; i++) cooldown[i]--;
+        } else {
+            for (int i = begin; i < end; i++) {
+                int active = last[i] == sweep_steps;
+                y[i] += speed * active;
+                cooldown[i] -= active;
+            }
+        }
+    }
+}
@@ -0,0 +1,48 @@
+#ifndef ENEMIES_H
+#define ENEMIES_H
+
+#include <stddef.h>
+#include "fixed.h"
+
+// 敌机存储 (SoA，按原型分组)：同一原型的敌机在数组里连续存放，
+// 第 t 组占 [start[t], start[t + 1])，所有组首尾相接，总数为 count。
+// 同组敌机的速度、冷却范围、分数都相同 (见 game.h 的 EnemyArchetype)，
+// 移动和冷却递减可以按组写成没有分支的紧凑循环。
+//
+// 加入时把后面每一组的第一个元素挪到该组末尾，腾出本组末尾的位置；
+// 删除时先用本组末尾元素填洞，再把后面每一组的末尾元素挪到前一组留下的空位。
+// 两者都只移动 O(ENEMY_TYPE_COUNT) 个元素，被移动的都是下标比操作位置大的元素，
+// 所以遍历时如果要删除当前元素，请从 count-1 倒序遍历到 0 (与 Pool 相同)。
+// 下标在增删后会变化，只在一帧的同一阶段内有效。
+
+// 原型数量：不超过 BULLET_SHOOTER_MAX (敌弹 flags 里发射者字段的容量，见 bullets.h 和 game.h)
+#define ENEMY_TYPE_COUNT 3
+
+// 每个数组按 8 个元素对齐
+#define ENEMY_GROUPS_STRIDE(capacity) (((capacity) + 7) & ~7)
+#define ENEMY_GROUPS_BYTES(capacity) \
+    ((size_t)ENEMY_GROUPS_STRIDE(capacity) * (2 * sizeof(Real) + 2 * sizeof(int) + 3))
+
+typedef struct {
+    int capacity;                     // 所有组合计
+    int count;
+    int start[ENEMY_TYPE_COUNT + 1];  // start[ENEMY_TYPE_COUNT] == count
+    Real* x;
+    Real* y;
+    int* cooldown;                    // 发射冷却
+    int* shot;                        // 已发射次数 (旋转弹的角度、连发进度)
+    unsigned char* type;              // 所在的组，供按下标查原型 (碰撞、统计)
+    unsigned char* first;             // 粗时间步：参与碰撞的第一个 / 最后一个采样 (见 collision.h)，
+    unsigned char* last;              // 随元素一起移动
+} EnemyGroups;
+
+// storage 至少 ENEMY_GROUPS_BYTES(capacity) 字节，按 8 字节对齐
+void EnemyGroupsInit(EnemyGroups* groups, void* storage, int capacity);
+int EnemyGroupsAdd(EnemyGroups* groups, int type); // 返回新敌机的下标 (其余字段由调用方填写)，已满时返回 -1
+void EnemyGroupsRemove(EnemyGroups* groups, int i);
+
+// 前进一帧：第 t 组下落 speeds[t]，冷却减 1，按组循环、没有分支。
+// sweep_steps > 0 时 (粗时间步) 只移动 last == sweep_steps 的敌机，早些时候已飞出底部的停在原处
+void EnemyGroupsStep(EnemyGroups* groups, const Real speeds[ENEMY_TYPE_COUNT], int sweep_steps);
+
+#endif
@@ -0,0 +1,290 @@
+#include <stdlib.h>
+#include <string.h>
+#include "env.h"
+#include "platform.h"
+#include "rng.h"
+
+#define ENV_CACHE_LINE 64
+#define CHUNKS_PER_THREAD 4         // 分段数约为线程数的几倍，窃取时容易均衡
+#define MAX_SPRITE_CELLS 6          // 敌机造型 2 行 x 3 列
+
+// 每局一个槽位，各占整数个缓存行：并行推进时不同线程只写各自的槽位
+typedef struct {
+    _Alignas(ENV_CACHE_LINE) GameState* game;
+    unsigned long long next_seed;
+    long long steps, episodes, score_total, frames_total;
+} EnvSlot;
+
+typedef struct {
+    int dx[MAX_SPRITE_CELLS], dy[MAX_SPRITE_CELLS];
+    int cells;
+} SpriteCells;
+
+struct VecEnv {
+    int count;
+    EnvOptions options;
+    int width, height;
+    int obs_size;
+    EnvSlot* slots;
+    int* col_block;                 // 按列 / 行：所在的块，边框为 -1
+    int* row_block;
+    float* block_weight;            // 按块：1 / 块的字符数
+    SpriteCells sprites[ENEMY_TYPE_COUNT];
+
+    JobPool* pool;
+    JobGraph graph;
+    // 本次 VecEnvStep 的参数 (任务读取)
+    const unsigned* actions;
+    float* observations;
+    float* rewards;
+    unsigned char* dones;
+};
+
+EnvOptions DefaultEnvOptions() {
+    EnvOptions options;
+    options.grid_cols = 19;         // 默认 40x25 区域去掉边框为 38x23，每块 2x2 字符左右
+    options.grid_rows = 12;
+    options.frame_skip = 1;
+    options.max_frames = 0;
+    options.life_penalty = -100.0f;
+    return options;
+}
+
+unsigned VecEnvActionKeys(int action) {
+    static const unsigned directions[9] = {
+        0, KEY_UP, KEY_DOWN, KEY_LEFT, KEY_RIGHT,
+        KEY_UP | KEY_LEFT, KEY_UP | KEY_RIGHT, KEY_DOWN | KEY_LEFT, KEY_DOWN | KEY_RIGHT
+    };
+    if (action < 0 || action >= ENV_ACTIONS) return 0;
+    return directions[action % 9] | (action >= 9 ? KEY_SLOW : 0);
+}
+
+// 区域内部 (去掉边框) 的 n 个字符均匀分成 blocks 块
+static void MapBlocks(int* block, int size, int blocks) {
+    int inner = size - 2;
+    for (int i = 0; i < size; i++) {
+        block[i] = i >= 1 && i <= inner ? (i - 1) * blocks / inner : -1;
+    }
+}
+
+VecEnv* VecEnvCreate(const GameConfig* config, int count, unsigned long long seed, const EnvOptions* options,
+                     JobPool* pool) {
+    GameConfig resolved = config != NULL ? *config : DefaultGameConfig();
+    if (GameConfigError(&resolved) != NULL || count < 1 || options->frame_skip < 1 || options->max_frames < 0 ||
+        options->grid_cols < 1 || options->grid_cols > resolved.width - 2 ||
+        options->grid_rows < 1 || options->grid_rows > resolved.height - 2) {
+        return NULL;
+    }
+
+    VecEnv* env = (VecEnv*)calloc(1, sizeof(VecEnv));
+    if (env == NULL) return NULL;
+    env->count = count;
+    env->options = *options;
+    env->width = resolved.width;
+    env->height = resolved.height;
+    env->obs_size = ENV_CHANNELS * options->grid_rows * options->grid_cols + ENV_SCALARS;
+    env->pool = pool;
+    env->slots = (EnvSlot*)PlatformAlignedAlloc(ENV_CACHE_LINE, sizeof(EnvSlot) * count);
+    env->col_block = (int*)malloc(sizeof(int) * resolved.width);
+    env->row_block = (int*)malloc(sizeof(int) * resolved.height);
+    env->block_weight = (float*)calloc((size_t)options->grid_rows * options->grid_cols, sizeof(float));
+    if (env->slots == NULL || env->col_block == NULL || env->row_block == NULL || env->block_weight == NULL) {
+        VecEnvDestroy(env);
+        return NULL;
+    }
+    memset(env->slots, 0, sizeof(EnvSlot) * count);
+    for (int i = 0; i < count; i++) {
+        env->slots[i].game = CreateGame(&resolved, seed + (unsigned long long)i);
+        if (env->slots[i].game == NULL) {
+            VecEnvDestroy(env);
+            return NULL;
+        }
+        env->slots[i].next_seed = seed + (unsigned long long)i + (unsigned long long)count;
+    }
+
+    MapBlocks(env->col_block, resolved.width, options->grid_cols);
+    MapBlocks(env->row_block, resolved.height, options->grid_rows);
+    for (int y = 0; y < resolved.height; y++) {
+        for (int x = 0; x < resolved.width; x++) {
+            if (env->row_block[y] >= 0 && env->col_block[x] >= 0) {
+                env->block_weight[env->row_block[y] * options->grid_cols + env->col_block[x]] += 1.0f;
+            }
+        }
+    }
+    for (int b = 0; b < options->grid_rows * options->grid_cols; b++) {
+        env->block_weight[b] = 1.0f / env->block_weight[b];
+    }
+
+    // 敌机造型中非空白的字符 (各局的原型表相同)
+    const GameState* game = env->slots[0].game;
+    for (int t = 0; t < ENEMY_TYPE_COUNT; t++) {
+        SpriteCells* cells = &env->sprites[t];
+        for (int row = 0; row < 2; row++) {
+            for (int col = 0; col < 3; col++) {
+                if (game->archetypes[t].sprite[row][col] == ' ') continue;
+                cells->dx[cells->cells] = col - 1;
+                cells->dy[cells->cells] = row - 1;
+                cells->cells++;
+            }
+        }
+    }
+    return env;
+}
+
+void VecEnvDestroy(VecEnv* env) {
+    if (env == NULL) return;
+    if (env->slots != NULL) {
+        for (int i = 0; i < env->count; i++) DestroyGame(env->slots[i].game);
+        PlatformAlignedFree(env->slots);
+    }
+    free(env->col_block);
+    free(env->row_block);
+    free(env->block_weight);
+    free(env);
+}
+
+int VecEnvCount(const VecEnv* env) {
+    return env->count;
+}
+
+int VecEnvObservationSize(const VecEnv* env) {
+    return env->obs_size;
+}
+
+const GameState* VecEnvGame(const VecEnv* env, int i) {
+    return env->slots[i].game;
+}
+
+// --- 观测 ---
+
+// 与 PutChar 相同的裁剪：边框和区域外的字符不画，也不计入
+static void Occupy(const VecEnv* env, float* grid, int x, int y) {
+    if (x < 0 || x >= env->width || y < 0 || y >= env->height) return;
+    int col = env->col_block[x], row = env->row_block[y];
+    if (col < 0 || row < 0) return;
+    int b = row * env->options.grid_cols + col;
+    grid[b] += env->block_weight[b];
+}
+
+static void WriteObservation(const VecEnv* env, const GameState* game, float* out) {
+    int blocks = env->options.grid_rows * env->options.grid_cols;
+    memset(out, 0, sizeof(float) * ENV_CHANNELS * blocks);
+
+    float* grid = out + ENV_CHANNEL_ENEMY_BULLETS * blocks;
+    for (int i = 0; i < game->enemy_bullets.count; i++) {
+        Occupy(env, grid, RToInt(game->enemy_bullets.x[i]), RToInt(game->enemy_bullets.y[i]));
+    }
+    grid = out + ENV_CHANNEL_ENEMIES * blocks;
+    for (int t = 0; t < ENEMY_TYPE_COUNT; t++) {
+        const SpriteCells* cells = &env->sprites[t];
+        for (int i = game->enemies.start[t]; i < game->enemies.start[t + 1]; i++) {
+            int x = RToInt(game->enemies.x[i]), y = RToInt(game->enemies.y[i]);
+            for (int c = 0; c < cells->cells; c++) Occupy(env, grid, x + cells->dx[c], y + cells->dy[c]);
+        }
+    }
+    grid = out + ENV_CHANNEL_PLAYER_BULLETS * blocks;
+    for (int i = 0; i < game->player_bullets.count; i++) {
+        Occupy(env, grid, RToInt(game->player_bullets.x[i]), RToInt(game->player_bullets.y[i]));
+    }
+    grid = out + ENV_CHANNEL_ITEMS * blocks;
+    for (int k = 0; k < game->item_pool.count; k++) {
+        const Item* item = &game->items[game->item_pool.dense[k]];
+        Occupy(env, grid, RToInt(item->pos.x), RToInt(item->pos.y));
+    }
+
+    float* scalars = out + ENV_CHANNELS * blocks;
+    const Player* player = &game->player;
+    scalars[ENV_SCALAR_X] = (float)(RToDouble(player->pos.x) / env->width);
+    scalars[ENV_SCALAR_Y] = (float)(RToDouble(player->pos.y) / env->height);
+    scalars[ENV_SCALAR_LIVES] = (float)player->lives;
+    scalars[ENV_SCALAR_POWER_LEVEL] = (float)player->power_level;
+    scalars[ENV_SCALAR_POWER_TIMER] = (float)player->power_timer / 60.0f;
+    scalars[ENV_SCALAR_SLOW_MODE] = (float)player->slow_mode;
+    scalars[ENV_SCALAR_INVINCIBLE] = (float)player->invincible_timer;
+    scalars[ENV_SCALAR_GRAZE] = (float)player->graze_count;
+}
+
+void VecEnvObserve(const VecEnv* env, float* observations) {
+    for (int i = 0; i < env->count; i++) {
+        WriteObservation(env, env->slots[i].game, observations + (size_t)i * env->obs_size);
+    }
+}
+
+// --- 推进 ---
+
+static void StartEpisode(VecEnv* env, EnvSlot* slot, unsigned long long seed) {
+    RngSeed(&slot->game->rng, seed);
+    InitGame(slot->game);
+    slot->next_seed = seed + (unsigned long long)env->count;
+}
+
+void VecEnvReset(VecEnv* env, const unsigned long long* seeds, float* observations) {
+    for (int i = 0; i < env->count; i++) {
+        StartEpisode(env, &env->slots[i], seeds != NULL ? seeds[i] : env->slots[i].next_seed);
+    }
+    VecEnvObserve(env, observations);
+}
+
+static void StepRange(VecEnv* env, int begin, int end) {
+    const EnvOptions* options = &env->options;
+    for (int i = begin; i < end; i++) {
+        EnvSlot* slot = &env->slots[i];
+        GameState* game = slot->game;
+        int score = game->player.score, lives = game->player.lives;
+        GameInput input = {env->actions[i]};
+        for (int f = 0; f < options->frame_skip && game->player.lives > 0; f++) {
+            Update(game, &input);
+        }
+
+        int lost = lives - game->player.lives;
+        env->rewards[i] = (float)(game->player.score - score) + (lost > 0 ? (float)lost * options->life_penalty : 0.0f);
+        int done = game->player.lives <= 0 || (options->max_frames > 0 && game->frame_count >= options->max_frames);
+        env->dones[i] = (unsigned char)done;
+        slot->steps++;
+        if (done) {
+            slot->episodes++;
+            slot->score_total += game->player.score;
+            slot->frames_total += game->frame_count;
+            StartEpisode(env, slot, slot->next_seed);
+        }
+        WriteObservation(env, game, env->observations + (size_t)i * env->obs_size);
+    }
+}
+
+static void JobStepRange(void* context, int begin, int end, int worker) {
+    (void)worker;
+    StepRange((VecEnv*)context, begin, end);
+}
+
+void VecEnvStep(VecEnv* env, const unsigned* actions, float* observations, float* rewards, unsigned char* dones) {
+    env->actions = actions;
+    env->observations = observations;
+    env->rewards = rewards;
+    env->dones = dones;
+    if (env->pool == NULL || JobPoolThreads(env->pool) == 1) {
+        StepRange(env, 0, env->count);
+        return;
+    }
+
+    // 各局互不相关，按局分段；每局只由一个任务推进，结果与分段方式无关
+    int chunks = JobPoolThreads(env->pool) * CHUNKS_PER_THREAD;
+    if (chunks > JOB_GRAPH_MAX_JOBS) chunks = JOB_GRAPH_MAX_JOBS;
+    int size = (env->count + chunks - 1) / chunks;
+    JobGraphClear(&env->graph);
+    for (int begin = 0; begin < env->count; begin += size) {
+        JobGraphAdd(&env->graph, JobStepRange, env, begin, begin + size < env->count ? begin + size : env->count);
+    }
+    JobPoolRun(env->pool, &env->graph);
+}
+
+VecEnvStats VecEnvGetStats(const VecEnv* env) {
+    VecEnvStats stats;
+    memset(&stats, 0, sizeof(stats));
+    for (int i = 0; i < env->count; i++) {
+        stats.steps += env->slots[i].steps;
+        stats.episodes += env->slots[i].episodes;
+        stats.score_total += env->slots[i].score_total;
+        stats.frames_total += env->slots[i].frames_total;
+    }
+    return stats;
+}
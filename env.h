@@ -0,0 +1,83 @@
+#ifndef ENV_H
+#define ENV_H
+
+#include "game.h"
+#include "jobs.h"
+
+// 批量环境：供训练和评估控制策略
+//
+// 一个 VecEnv 持有 count 局相互独立的游戏 (各自 CreateGame)，VecEnvStep 一次调用让每局按各自的动作
+// 推进 frame_skip 帧，规则就是 Update() (擦弹、慢速模式、道具等全部照常)。
+// 观测、奖励、结束标志直接写进调用方提供的连续数组，第 i 局写在各数组的第 i 段，不经过中间缓冲：
+//   observations: count * VecEnvObservationSize() 个 float
+//   rewards:      count 个 float
+//   dones:        count 个字节
+//
+// 观测 = 占用网格 + 自机标量。占用网格把 Draw() 画面 (游戏区域，不含边框) 按块降采样为 grid_rows x grid_cols，
+// 分 ENV_CHANNELS 个通道，每格的值为该块中被对应实体占据的字符数 / 块的字符数 (实体重叠时可能超过 1)。
+// 占据的字符与 RenderWorld 画出的位置相同 (敌机按原型造型的非空白字符计)，但按实体类型直接累加，
+// 不从字符反推类型 ('|' 既是自机子弹也是敌机造型)。标量见 EnvScalar。
+//
+// 一局结束 (没有生命，或达到 max_frames) 时 dones 置 1，该局立即用下一个种子重新开始，
+// 这一步写出的观测已经是新一局的第一帧。第 i 局的种子依次为 seed + i、seed + i + count、seed + i + 2 * count ...，
+// 结果与线程数无关。pool 不为 NULL 时各局分段在线程池中并行推进 (见 jobs.h)。
+
+#define ENV_CHANNELS 4
+#define ENV_ACTIONS 18   // 9 个方向 x 正常/慢速，见 VecEnvActionKeys
+
+typedef enum {
+    ENV_CHANNEL_ENEMY_BULLETS,
+    ENV_CHANNEL_ENEMIES,
+    ENV_CHANNEL_PLAYER_BULLETS,
+    ENV_CHANNEL_ITEMS
+} EnvChannel;
+
+// 占用网格之后的标量
+typedef enum {
+    ENV_SCALAR_X,            // 自机位置 / 区域宽度
+    ENV_SCALAR_Y,            // 自机位置 / 区域高度
+    ENV_SCALAR_LIVES,
+    ENV_SCALAR_POWER_LEVEL,
+    ENV_SCALAR_POWER_TIMER,  // 火力升级剩余帧数 / 60
+    ENV_SCALAR_SLOW_MODE,
+    ENV_SCALAR_INVINCIBLE,   // 擦弹无敌剩余帧数
+    ENV_SCALAR_GRAZE,        // 本局擦弹数
+    ENV_SCALARS
+} EnvScalar;
+
+typedef struct {
+    int grid_cols, grid_rows;   // 占用网格大小，不超过游戏区域
+    int frame_skip;             // 每次 step 按住同一动作的帧数
+    int max_frames;             // 单局帧数上限 (0 为不限)，达到时视为结束
+    float life_penalty;         // 每失去一条命计入奖励的值 (奖励 = 得分增量 + 失去的命数 * life_penalty)
+} EnvOptions;
+
+EnvOptions DefaultEnvOptions();
+
+typedef struct VecEnv VecEnv;
+
+typedef struct {
+    long long steps;            // 单局步数之和
+    long long episodes;         // 结束的局数
+    long long score_total;      // 结束时的分数之和
+    long long frames_total;     // 结束时的帧数之和
+} VecEnvStats;
+
+// 配置或选项无效、内存不足时返回 NULL。pool 由调用方启动和停止，生存期须覆盖 VecEnv
+VecEnv* VecEnvCreate(const GameConfig* config, int count, unsigned long long seed, const EnvOptions* options,
+                     JobPool* pool);
+void VecEnvDestroy(VecEnv* env);
+int VecEnvCount(const VecEnv* env);
+int VecEnvObservationSize(const VecEnv* env);       // 每局的 float 数：ENV_CHANNELS * grid_rows * grid_cols + ENV_SCALARS
+const GameState* VecEnvGame(const VecEnv* env, int i);
+
+// 创建后各局已经处于第一局 (种子 seed + i) 的开头，可以直接 step；VecEnvObserve 写出当前的观测
+void VecEnvObserve(const VecEnv* env, float* observations);
+// 全部重新开始并写出观测；seeds 为 NULL 时用各局的下一个种子，否则第 i 局用 seeds[i] (之后依次加 count)
+void VecEnvReset(VecEnv* env, const unsigned long long* seeds, float* observations);
+// actions[i] 为第 i 局的按键 (KEY_* 位掩码)
+void VecEnvStep(VecEnv* env, const unsigned* actions, float* observations, float* rewards, unsigned char* dones);
+unsigned VecEnvActionKeys(int action);              // 离散动作 0..ENV_ACTIONS-1 对应的按键
+VecEnvStats VecEnvGetStats(const VecEnv* env);
+
+#endif
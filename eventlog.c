@@ -0,0 +1,236 @@
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include "eventlog.h"
+#include "platform.h"
+
+#define HEADER_BYTES ((long long)sizeof(EventLogHeader))
+#define RECORD_BYTES ((long long)sizeof(GameEventRecord))
+
+_Static_assert(sizeof(EventLogHeader) == 64, "EventLogHeader 必须是 64 字节");
+_Static_assert(sizeof(GameEventRecord) == 32, "GameEventRecord 必须是 32 字节");
+_Static_assert(EVENTLOG_CHUNK_BYTES % sizeof(GameEventRecord) == 0, "记录不能跨越窗口");
+_Static_assert(ENEMY_TYPE_COUNT <= INT8_MAX, "GameEventRecord.enemy_type 放不下所有敌机类型");
+
+struct EventLog {
+    PlatformFile* file;
+    EventLogHeader* header;      // 文件头单独映射，每次批量写入后更新 records
+    unsigned char* window;       // 当前写入的窗口 [window_offset, window_offset + EVENTLOG_CHUNK_BYTES)
+    long long window_offset;
+    long long file_size;         // 按窗口预先扩大后的文件大小
+    uint64_t records;            // 已提交的记录数
+    uint32_t run;
+    int failed;                  // 映射失败后不再写入，之后的记录计入 stats.dropped
+    atomic_flag lock;            // 本进程内的写入环之间；进程之间靠打开期间一直持有的文件排他锁
+    EventLogStats stats;
+};
+
+struct EventRing {
+    EventLog* log;
+    int capacity;
+    int count;
+    uint16_t source;
+    uint32_t game;               // 本写入环上的局数，EVENT_GAME_START 时加一
+    GameEventRecord records[];
+};
+
+// 单线程写入时无竞争；多个写入环共用日志时，每次也只在整环写入期间持有
+static void Lock(EventLog* log) {
+    while (atomic_flag_test_and_set_explicit(&log->lock, memory_order_acquire)) {
+        PlatformSleep(0.00001);
+    }
+}
+
+static void Unlock(EventLog* log) {
+    atomic_flag_clear_explicit(&log->lock, memory_order_release);
+}
+
+// 切换写入窗口：先解除全部映射，需要时扩大文件，再重新映射文件头和新窗口
+static int MapWindow(EventLog* log, long long offset) {
+    PlatformFileUnmap(log->window, EVENTLOG_CHUNK_BYTES);
+    PlatformFileUnmap(log->header, sizeof(EventLogHeader));
+    log->window = NULL;
+    log->header = NULL;
+
+    long long end = offset + EVENTLOG_CHUNK_BYTES;
+    if (log->file_size < end) {
+        if (!PlatformFileResize(log->file, end)) return 0;
+        log->file_size = end;
+    }
+    log->header = (EventLogHeader*)PlatformFileMap(log->file, 0, sizeof(EventLogHeader), 0);
+    log->window = (unsigned char*)PlatformFileMap(log->file, offset, EVENTLOG_CHUNK_BYTES, 1);
+    if (log->header == NULL || log->window == NULL) return 0;
+    log->window_offset = offset;
+    log->stats.chunks++;
+    return 1;
+}
+
+EventLog* EventLogOpen(const char* path, int width, int height, const char** error) {
+    static const char* no_error;
+    if (error == NULL) error = &no_error;
+    if (EVENTLOG_CHUNK_BYTES % PlatformMapGranularity() != 0) {
+        *error = "map granularity does not divide the window size";
+        return NULL;
+    }
+
+    EventLog* log = (EventLog*)calloc(1, sizeof(EventLog));
+    if (log == NULL) {
+        *error = "out of memory";
+        return NULL;
+    }
+    atomic_flag_clear(&log->lock);
+    log->file = PlatformFileOpen(path, 1);
+    if (log->file == NULL) {
+        *error = "cannot open file";
+        free(log);
+        return NULL;
+    }
+
+    // 两个进程都从文件头的记录数接着写会互相覆盖，所以写入方在打开期间一直持有排他锁
+    if (!PlatformFileTryLock(log->file, 1)) {
+        *error = "log is open for writing by another process";
+        PlatformFileClose(log->file);
+        free(log);
+        return NULL;
+    }
+
+    log->file_size = PlatformFileSize(log->file);
+    int created = log->file_size == 0;
+    if (log->file_size < 0 || (!created && log->file_size < HEADER_BYTES)) {
+        *error = "not an event log";
+    } else if (!MapWindow(log, 0)) {
+        *error = "cannot map file";
+    } else {
+        EventLogHeader* header = log->header;
+        if (created) {
+            header->magic = EVENTLOG_MAGIC;
+            header->version = EVENTLOG_VERSION;
+            header->record_bytes = (uint32_t)RECORD_BYTES;
+            header->width = width;
+            header->height = height;
+        }
+        if (header->magic != EVENTLOG_MAGIC || header->version != EVENTLOG_VERSION ||
+            header->record_bytes != RECORD_BYTES) {
+            *error = "not an event log or unsupported version";
+        } else if (header->width != width || header->height != height) {
+            *error = "field size differs from the log";
+        } else if (HEADER_BYTES + (long long)header->records * RECORD_BYTES > log->file_size) {
+            *error = "corrupt log (record count exceeds file size)";
+        } else {
+            log->records = header->records;
+            log->run = ++header->runs;
+            *error = NULL;
+            return log;
+        }
+    }
+    // 只是读出来不合格，文件保持原样
+    PlatformFileUnmap(log->window, EVENTLOG_CHUNK_BYTES);
+    PlatformFileUnmap(log->header, sizeof(EventLogHeader));
+    PlatformFileUnlock(log->file);
+    PlatformFileClose(log->file);
+    free(log);
+    return NULL;
+}
+
+void EventLogClose(EventLog* log) {
+    if (log == NULL) return;
+    PlatformFileUnmap(log->window, EVENTLOG_CHUNK_BYTES);
+    PlatformFileUnmap(log->header, sizeof(EventLogHeader));
+    PlatformFileResize(log->file, HEADER_BYTES + (long long)log->records * RECORD_BYTES);
+    PlatformFileUnlock(log->file);
+    PlatformFileClose(log->file);
+    free(log);
+}
+
+uint32_t EventLogRun(const EventLog* log) {
+    return log->run;
+}
+
+EventLogStats EventLogGetStats(EventLog* log) {
+    Lock(log);
+    EventLogStats stats = log->stats;
+    Unlock(log);
+    return stats;
+}
+
+// 把 count 条记录接在已提交的记录之后，写完整批才更新文件头
+static void WriteRecords(EventLog* log, const GameEventRecord* records, int count) {
+    double start = PlatformNow();
+    Lock(log);
+    uint64_t committed = log->records;
+    int remaining = count;
+    while (remaining > 0 && !log->failed) {
+        long long position = HEADER_BYTES + (long long)committed * RECORD_BYTES;
+        long long offset = position - position % EVENTLOG_CHUNK_BYTES;
+        if (log->window == NULL || log->window_offset != offset) {
+            if (!MapWindow(log, offset)) {
+                log->failed = 1;
+                break;
+            }
+        }
+        int room = (int)((offset + EVENTLOG_CHUNK_BYTES - position) / RECORD_BYTES);
+        int n = remaining < room ? remaining : room;
+        memcpy(log->window + (position - offset), records, (size_t)n * RECORD_BYTES);
+        committed += n;
+        records += n;
+        remaining -= n;
+    }
+    if (remaining > 0) {
+        log->stats.dropped += count; // 写到一半失败的整批都不提交
+    } else {
+        atomic_thread_fence(memory_order_release); // 记录先于记录数可见
+        log->header->records = committed;
+        log->records = committed;
+        log->stats.records += count;
+    }
+    log->stats.flushes++;
+    double elapsed = PlatformNow() - start;
+    log->stats.flush_seconds += elapsed;
+    if (elapsed > log->stats.flush_max) log->stats.flush_max = elapsed;
+    Unlock(log);
+}
+
+// --- 写入环 ---
+
+int AttachEventRing(GameState* game, EventLog* log, int source, int capacity) {
+    if (game->events != NULL) return 1;
+    if (capacity <= 0) capacity = EVENT_RING_DEFAULT_CAPACITY;
+    EventRing* ring = (EventRing*)malloc(sizeof(EventRing) + sizeof(GameEventRecord) * (size_t)capacity);
+    if (ring == NULL) return 0;
+    ring->log = log;
+    ring->capacity = capacity;
+    ring->count = 0;
+    ring->source = (uint16_t)source;
+    ring->game = 0;
+    game->events = ring;
+    return 1;
+}
+
+void DestroyEventRing(EventRing* ring) {
+    if (ring == NULL) return;
+    EventRingFlush(ring);
+    free(ring);
+}
+
+void EventRingFlush(EventRing* ring) {
+    if (ring->count == 0) return;
+    WriteRecords(ring->log, ring->records, ring->count);
+    ring->count = 0;
+}
+
+void EventRingPush(EventRing* ring, const GameState* game, GameEventType type, Real x, Real y,
+                   int enemy_type, int score_delta) {
+    if (type == EVENT_GAME_START) ring->game++;
+    GameEventRecord* record = &ring->records[ring->count];
+    record->run = ring->log->run;
+    record->source = ring->source;
+    record->type = (uint8_t)type;
+    record->enemy_type = (int8_t)enemy_type;
+    record->game = ring->game;
+    record->frame = (uint32_t)game->frame_count;
+    record->x = (float)RToDouble(x);
+    record->y = (float)RToDouble(y);
+    record->score_delta = score_delta;
+    record->score = game->player.score;
+    if (++ring->count == ring->capacity) EventRingFlush(ring);
+}
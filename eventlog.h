@@ -0,0 +1,72 @@
+#ifndef EVENTLOG_H
+#define EVENTLOG_H
+
+#include <stdint.h>
+#include "game.h"
+
+// 游戏事件日志：击毁、擦弹、受伤、撞机、拾取道具等事件按定长二进制记录追加到文件
+//
+// 游戏线程只往预先分配好的写入环 (EventRing) 里填一条记录，不调用 stdio、不申请内存；
+// 环满时 (或 EventRingFlush) 把整环一次拷进日志文件的内存映射窗口。
+// 文件按 EVENTLOG_CHUNK_BYTES 一段段预先扩大并映射，只有跨段时才有系统调用；
+// 每次批量写入之后更新文件头里的记录数，进程中途退出时读取方只读到最后一次提交为止。
+// 多个线程的写入环可以共用一个日志 (写入时加锁，每次一整环)，记录里的 source 区分来自哪个环。
+// 同一时刻只能有一个进程写入同一文件：打开时对文件加排他锁直到关闭，已被其他进程打开时 EventLogOpen 失败。
+//
+// 文件格式 (本机字节序)：EventLogHeader (64 字节) | GameEventRecord[records] (每条 32 字节)
+// 日志只追加：再次打开同一文件时接在已提交的记录之后，runs 加一；区域大小不同的运行拒绝追加。
+
+#define EVENTLOG_MAGIC 0x45564750u        // "PGVE"
+#define EVENTLOG_VERSION 1
+#define EVENTLOG_CHUNK_BYTES (16 << 20)   // 映射窗口 / 文件增长的步长
+#define EVENT_RING_DEFAULT_CAPACITY 4096  // 每个写入环的记录数 (128KB)
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t record_bytes;       // sizeof(GameEventRecord)
+    uint32_t runs;               // 追加过的运行次数
+    int32_t width, height;       // 游戏区域大小 (热力图的范围)
+    uint64_t records;            // 已提交的记录数
+    uint8_t reserved[32];
+} EventLogHeader;
+
+typedef struct {
+    uint32_t run;                // 第几次运行 (从 1 开始，见 EventLogHeader.runs)
+    uint16_t source;             // 写入环的编号 (AttachEventRing 的参数)
+    uint8_t type;                // GameEventType
+    int8_t enemy_type;           // 相关的敌机类型，-1 表示无关或未知
+    uint32_t game;               // 该写入环上的第几局 (从 1 开始)
+    uint32_t frame;              // game->frame_count
+    float x, y;                  // 事件位置 (击毁 / 撞机为敌机，擦弹 / 受伤为自机，拾取为道具)
+    int32_t score_delta;
+    int32_t score;               // 事件之后的分数
+} GameEventRecord;
+
+typedef struct EventLog EventLog;
+
+typedef struct {
+    long long records;           // 本次运行写入的记录数
+    long long flushes;           // 批量写入次数
+    long long chunks;            // 映射过的窗口数
+    long long dropped;           // 映射或扩大文件失败而丢弃的记录数
+    double flush_seconds;        // 花在批量写入上的总时间 (含等锁)
+    double flush_max;
+} EventLogStats;
+
+// 追加打开 (不存在时创建)；失败返回 NULL，*error 为原因
+EventLog* EventLogOpen(const char* path, int width, int height, const char** error);
+void EventLogClose(EventLog* log);  // 请先销毁所有写入环；截掉预先扩大但没用到的部分
+uint32_t EventLogRun(const EventLog* log);
+EventLogStats EventLogGetStats(EventLog* log);
+
+// 为 game 创建写入环 (game->events)，capacity 为 0 时用默认容量；失败返回 0。
+// 局数从下一次 InitGame (EVENT_GAME_START) 算起，挂上之后请先 InitGame 再开始模拟。
+// DestroyGame 会把剩余记录写入日志后释放写入环，所以日志要比游戏晚关闭
+int AttachEventRing(GameState* game, EventLog* log, int source, int capacity);
+void DestroyEventRing(EventRing* ring);
+void EventRingFlush(EventRing* ring);
+void EventRingPush(EventRing* ring, const GameState* game, GameEventType type, Real x, Real y,
+                   int enemy_type, int score_delta); // 由 LogEvent 调用
+
+#endif
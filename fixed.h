@@ -0,0 +1,70 @@
+#ifndef FIXED_H
+#define FIXED_H
+
+#include <stdint.h>
+
+// 物理数值类型：位置、速度和判定距离
+//
+// 默认用 double 存位置和速度 (子弹道也是 double，与逐帧的实体结构体结果一致)。
+// 加上 -DUSE_FIXED_POINT 编译后全部改为 Q16.16 定点数 (int32，低 16 位为小数)，
+// 移动、碰撞和自机狙的归一化都只用整数运算，模拟结果与编译器、浮点选项和 CPU 无关。
+// 两种模式的录像互不兼容 (见 replay.h)。
+//
+//   Real      位置、速度
+//   LaneReal  子弹道中的 x/y/vx/vy (定点模式下同 Real)
+//   RealSq    距离平方 (定点模式下为 Q32.32 的 int64，避免溢出)
+//
+//   R(c)        十进制常数 -> Real，四舍五入到最近的 1/65536
+//   RSQ(c)      平方单位的常数 -> RealSq (例如 PLAYER_HIT_RADIUS_SQ)
+//   RFromInt(n) 整数 -> Real
+//   RToInt(a)   向零取整 (用于画到字符格子上)
+//   RToDouble(a)
+//   RMUL(a, b)  Real * Real
+//   RSQMUL(a, b) Real * Real -> RealSq
+//   RABS(a)
+
+#define FIXED_FRAC_BITS 16
+#define FIXED_ONE (1 << FIXED_FRAC_BITS)
+
+#ifdef USE_FIXED_POINT
+
+#define PHYSICS_FIXED_POINT 1
+
+typedef int32_t Real;
+typedef int32_t LaneReal;
+typedef int64_t RealSq;
+
+#define R(c) ((Real)((c) * 65536.0 + ((c) >= 0 ? 0.5 : -0.5)))
+#define RSQ(c) ((RealSq)((c) * 4294967296.0 + 0.5))
+#define RFromInt(n) ((Real)(n) * FIXED_ONE)
+#define RToInt(a) ((int)((a) / FIXED_ONE))
+#define RToDouble(a) ((double)(a) / 65536.0)
+#define RMUL(a, b) ((Real)(((int64_t)(a) * (b)) >> FIXED_FRAC_BITS))
+#define RSQMUL(a, b) ((RealSq)(a) * (b))
+
+#else
+
+#define PHYSICS_FIXED_POINT 0
+
+typedef double Real;
+typedef double LaneReal;
+typedef double RealSq;
+
+#define R(c) ((Real)(c))
+#define RSQ(c) ((RealSq)(c))
+#define RFromInt(n) ((Real)(n))
+#define RToInt(a) ((int)(a))
+#define RToDouble(a) ((double)(a))
+#define RMUL(a, b) ((a) * (b))
+#define RSQMUL(a, b) ((RealSq)(a) * (b))
+
+#endif
+
+#define RABS(a) ((a) < 0 ? -(a) : (a))
+
+// 整数倒数平方根 (两种模式都可用，定点模式用于自机狙的方向归一化)
+// x 为 Q32.32 的非负数 (即 RSQMUL 的结果)，返回 1/sqrt(x) 的 Q16.16，相对误差约 0.1%；
+// x 为 0 时返回 0，结果超出 int32 时饱和
+int32_t FixedInvSqrt(uint64_t x);
+
+#endif
@@ -0,0 +1,116 @@
+#include <math.h>
+#include "frameclock.h"
+#include "platform.h"
+
+// 粗略休眠后预留的自旋时间，抵消系统休眠精度不足
+#define SPIN_MARGIN_SECONDS 0.002
+
+void FrameClockInit(FrameClock* clock, double tick, double render_hz, int max_catchup, double now) {
+    clock->tick = tick;
+    clock->render_interval = render_hz > 0 ? 1.0 / render_hz : 0;
+    clock->max_catchup = max_catchup;
+    clock->accumulator = 0;
+    clock->last_time = now;
+    clock->next_render = now;
+
+    clock->frames = clock->ticks = clock->renders = 0;
+    clock->missed = clock->dropped_ticks = 0;
+    clock->sim_total = clock->render_total = clock->slack_total = 0;
+    clock->sim_max = clock->render_max = 0;
+    clock->slack_min = 1e9;
+    clock->last_tick_start = 0;
+    clock->intervals = 0;
+    clock->jitter_sq_total = clock->jitter_max = 0;
+    clock->csv = NULL;
+}
+
+int FrameClockAdvance(FrameClock* clock, double now) {
+    clock->accumulator += now - clock->last_time;
+    clock->last_time = now;
+
+    int ticks = (int)(clock->accumulator / clock->tick);
+    if (ticks > clock->max_catchup) {
+        // 落后太多：只追赶上限步数，其余时间直接丢弃
+        clock->dropped_ticks += ticks - clock->max_catchup;
+        ticks = clock->max_catchup;
+        clock->accumulator = ticks * clock->tick;
+    }
+    clock->accumulator -= ticks * clock->tick;
+
+    for (int t = 0; t < ticks; t++) {
+        if (clock->last_tick_start > 0) {
+            double error = now - clock->last_tick_start - clock->tick;
+            double magnitude = error < 0 ? -error : error;
+            clock->intervals++;
+            clock->jitter_sq_total += error * error;
+            if (magnitude > clock->jitter_max) clock->jitter_max = magnitude;
+        }
+        clock->last_tick_start = now;
+    }
+    return ticks;
+}
+
+int FrameClockShouldRender(FrameClock* clock, double now) {
+    if (now < clock->next_render) return 0;
+
+    clock->next_render += clock->render_interval;
+    if (clock->next_render < now) clock->next_render = now; // 渲染落后时不补帧
+    return 1;
+}
+
+// 下一个模拟步的截止时刻
+static double NextTickTime(const FrameClock* clock) {
+    return clock->last_time + (clock->tick - clock->accumulator);
+}
+
+void FrameClockEndFrame(FrameClock* clock, int ticks, double sim_seconds, double render_seconds, double now) {
+    double slack = NextTickTime(clock) - now;
+
+    clock->frames++;
+    clock->ticks += ticks;
+    if (render_seconds > 0) clock->renders++;
+    if (slack < 0) clock->missed++;
+    clock->sim_total += sim_seconds;
+    clock->render_total += render_seconds;
+    clock->slack_total += slack;
+    if (sim_seconds > clock->sim_max) clock->sim_max = sim_seconds;
+    if (render_seconds > clock->render_max) clock->render_max = render_seconds;
+    if (slack < clock->slack_min) clock->slack_min = slack;
+
+    if (clock->csv != NULL) {
+        if (clock->frames == 1) {
+            fprintf(clock->csv, "frame,ticks,sim_ms,render_ms,slack_ms,missed\n");
+        }
+        fprintf(clock->csv, "%lld,%d,%.4f,%.4f,%.4f,%d\n", clock->frames, ticks,
+                sim_seconds * 1e3, render_seconds * 1e3, slack * 1e3, slack < 0);
+    }
+}
+
+void FrameClockWait(const FrameClock* clock) {
+    double deadline = NextTickTime(clock);
+    double remaining = deadline - PlatformNow();
+    if (remaining > SPIN_MARGIN_SECONDS) {
+        PlatformSleep(remaining - SPIN_MARGIN_SECONDS);
+    }
+    while (PlatformNow() < deadline) {
+        // 自旋等待剩余的不到 2ms
+    }
+}
+
+void FrameClockPrintSummary(const FrameClock* clock, FILE* out) {
+    if (clock->frames == 0) return;
+
+    double frames = (double)clock->frames;
+    fprintf(out, "timing: %lld frames, %lld ticks, %lld renders\n",
+            clock->frames, clock->ticks, clock->renders);
+    fprintf(out, "  sim    avg %.3f ms  max %.3f ms\n", clock->sim_total / frames * 1e3, clock->sim_max * 1e3);
+    fprintf(out, "  render avg %.3f ms  max %.3f ms\n",
+            clock->renders > 0 ? clock->render_total / clock->renders * 1e3 : 0.0, clock->render_max * 1e3);
+    fprintf(out, "  slack  avg %.3f ms  min %.3f ms\n", clock->slack_total / frames * 1e3, clock->slack_min * 1e3);
+    fprintf(out, "  missed deadlines %lld, dropped ticks %lld\n", clock->missed, clock->dropped_ticks);
+    fprintf(out, "  tick jitter rms %.3f ms  max %.3f ms\n", FrameClockJitterRms(clock) * 1e3, clock->jitter_max * 1e3);
+}
+
+double FrameClockJitterRms(const FrameClock* clock) {
+    return clock->intervals > 0 ? sqrt(clock->jitter_sq_total / (double)clock->intervals) : 0.0;
+}
@@ -0,0 +1,51 @@
+#ifndef FRAMECLOCK_H
+#define FRAMECLOCK_H
+
+#include <stdio.h>
+
+// 固定步长游戏循环的计时器
+//
+// 模拟按固定步长 (SIM_TICK_SECONDS) 推进，真实经过的时间先累积到 accumulator，
+// 每轮循环取出整数个步长执行；单轮最多追赶 max_catchup 步，超出部分直接丢弃，
+// 避免机器卡顿后越追越慢 (spiral of death)。渲染有独立的频率上限，
+// 空闲时先粗略休眠、再自旋到下一个模拟步的截止时间。
+
+#define SIM_TICK_SECONDS 0.016  // 62.5 Hz，与原来的 Sleep(16) 一致，power_timer 等帧计时保持原义
+#define DEFAULT_RENDER_HZ 60.0
+#define DEFAULT_MAX_CATCHUP 5
+
+typedef struct {
+    double tick;              // 模拟步长 (秒)
+    double render_interval;   // 两次渲染的最小间隔 (秒)
+    int max_catchup;          // 单轮循环最多执行的模拟步数
+
+    double accumulator;       // 尚未模拟的时间
+    double last_time;         // 上一次累积时间的时刻
+    double next_render;       // 下一次允许渲染的时刻
+
+    // 统计
+    long long frames;         // 循环轮数
+    long long ticks;          // 执行的模拟步数
+    long long renders;        // 渲染次数
+    long long missed;         // 错过截止时间的轮数 (slack < 0)
+    long long dropped_ticks;  // 因追赶上限被丢弃的模拟步数
+    double sim_total, render_total, slack_total;
+    double sim_max, render_max, slack_min;
+    // 模拟步抖动：每步实际开始的间隔与步长之差 (追赶时同一轮的几步视为同时开始)
+    double last_tick_start;   // 上一步开始的时刻 (0 为还没有)
+    long long intervals;      // 参与统计的间隔数
+    double jitter_sq_total;   // 间隔误差的平方和
+    double jitter_max;        // 最大的间隔误差 (绝对值)
+
+    FILE* csv;                // 非 NULL 时逐帧导出计时
+} FrameClock;
+
+void FrameClockInit(FrameClock* clock, double tick, double render_hz, int max_catchup, double now);
+int FrameClockAdvance(FrameClock* clock, double now);       // 返回本轮应执行的模拟步数，并记录这些步的开始间隔
+int FrameClockShouldRender(FrameClock* clock, double now);
+void FrameClockEndFrame(FrameClock* clock, int ticks, double sim_seconds, double render_seconds, double now);
+void FrameClockWait(const FrameClock* clock);               // 精确等待到下一个模拟步
+void FrameClockPrintSummary(const FrameClock* clock, FILE* out);
+double FrameClockJitterRms(const FrameClock* clock);        // 模拟步间隔误差的均方根 (秒)
+
+#endif
@@ -0,0 +1,746 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "game.h"
+#include "arena.h"
+#include "collision.h"
+#include "danger.h"
+#include "eventlog.h"
+#include "jobs.h"
+#include "platform.h"
+#include "profiler.h"
+
+// 通知前端播放音效 (headless 模式下没有回调，直接忽略)
+void EmitSound(GameState* game, SoundId id) {
+    if (game->sound_hook != NULL) {
+        game->sound_hook(id);
+    }
+}
+
+// 写入事件日志 (没有挂上写入环时直接忽略)
+void LogEvent(GameState* game, GameEventType type, Real x, Real y, int enemy_type, int score_delta) {
+    if (game->events != NULL) {
+        EventRingPush(game->events, game, type, x, y, enemy_type, score_delta);
+    }
+}
+
+// --- 状态哈希 (FNV-1a) ---
+
+#define HASH_OFFSET 14695981039346656037ULL
+#define HASH_PRIME 1099511628211ULL
+
+static unsigned long long HashBytes(unsigned long long h, const void* data, size_t size) {
+    const unsigned char* p = (const unsigned char*)data;
+    for (size_t i = 0; i < size; i++) {
+        h = (h ^ p[i]) * HASH_PRIME;
+    }
+    return h;
+}
+
+// 按 dense 顺序 (敌机按存储顺序) 哈希活跃实体，空闲槽位里的旧数据不影响结果
+unsigned long long GameHash(const GameState* game) {
+    unsigned long long h = HASH_OFFSET;
+    h = HashBytes(h, &game->frame_count, sizeof(game->frame_count));
+    h = HashBytes(h, &game->rng, sizeof(game->rng));
+    h = HashBytes(h, &game->player, sizeof(game->player));
+
+    const BulletLane* lanes[2] = {&game->player_bullets, &game->enemy_bullets};
+    for (int l = 0; l < 2; l++) {
+        const BulletLane* lane = lanes[l];
+        h = HashBytes(h, &lane->count, sizeof(lane->count));
+        h = HashBytes(h, lane->x, sizeof(LaneReal) * lane->count);
+        h = HashBytes(h, lane->y, sizeof(LaneReal) * lane->count);
+        h = HashBytes(h, lane->vx, sizeof(LaneReal) * lane->count);
+        h = HashBytes(h, lane->vy, sizeof(LaneReal) * lane->count);
+        h = HashBytes(h, lane->flags, sizeof(BulletFlags) * (size_t)lane->count);
+    }
+    const EnemyGroups* enemies = &game->enemies;
+    h = HashBytes(h, enemies->start, sizeof(enemies->start));
+    h = HashBytes(h, enemies->x, sizeof(Real) * enemies->count);
+    h = HashBytes(h, enemies->y, sizeof(Real) * enemies->count);
+    h = HashBytes(h, enemies->cooldown, sizeof(int) * enemies->count);
+    h = HashBytes(h, enemies->shot, sizeof(int) * enemies->count);
+    // 逐字段哈希：Item/Explosion 结构体末尾有填充字节
+    for (int k = 0; k < game->item_pool.count; k++) {
+        const Item* it = &game->items[game->item_pool.dense[k]];
+        h = HashBytes(h, &it->pos, sizeof(it->pos));
+        h = HashBytes(h, &it->type, sizeof(it->type));
+    }
+    for (int k = 0; k < game->explosion_pool.count; k++) {
+        const Explosion* ex = &game->explosions[game->explosion_pool.dense[k]];
+        h = HashBytes(h, &ex->pos, sizeof(ex->pos));
+        h = HashBytes(h, &ex->timer, sizeof(ex->timer));
+    }
+    return h;
+}
+
+// --- 弹幕模式表 ---
+
+// 散射机的三发散射弹：左下、正下、右下
+static const double spread_vectors[3][2] = {{-0.3, 0.5}, {0, 0.6}, {0.3, 0.5}};
+
+// 敌机原型表 (下标即类型)：
+//   普通机缓慢下落，发射自机狙；直线机快速俯冲，不发射；散射机最慢，发射三发散射弹
+// 生成权重：分数低于 tier1 只有普通机，低于 tier2 为 70% 普通 30% 直线，之后 50/30/20
+static const EnemyArchetype enemy_archetypes[ENEMY_TYPE_COUNT] = {
+    {.name = "normal", .speed = R(0.1), .score = 10, .spawn_weight = {1, 70, 50},
+     .sprite = {"\\ /", " V "},
+     .pattern = {.kind = PATTERN_AIMED, .count = 1, .speed = 0.5, .cooldown = 40, .cooldown_jitter = 40}},
+    {.name = "fast", .speed = R(0.3), .score = 15, .spawn_weight = {0, 30, 30},
+     .sprite = {" | ", " v "},
+     .pattern = {.kind = PATTERN_NONE}},
+    {.name = "spread", .speed = R(0.08), .score = 20, .spawn_weight = {0, 0, 20},
+     .sprite = {"< >", " W "},
+     .pattern = {.kind = PATTERN_VECTORS, .count = 3, .vectors = spread_vectors, .cooldown = 50, .cooldown_jitter = 30}},
+};
+
+// 按火力等级：单发、双发 (间距 1.0)、三发 (间距 0.7)，都笔直向上
+static const PatternDef player_pattern_defs[3] = {
+    {.kind = PATTERN_LINE, .count = 1, .speed = 1.0, .angle = PATTERN_ANGLE_UP},
+    {.kind = PATTERN_LINE, .count = 2, .speed = 1.0, .angle = PATTERN_ANGLE_UP, .spacing = 1.0},
+    {.kind = PATTERN_LINE, .count = 3, .speed = 1.0, .angle = PATTERN_ANGLE_UP, .spacing = 0.7},
+};
+
+// --- 游戏逻辑函数 ---
+
+const EnemyArchetype* DefaultEnemyArchetypes() {
+    return enemy_archetypes;
+}
+
+GameConfig DefaultGameConfig() {
+    GameConfig config = {DEFAULT_WIDTH, DEFAULT_HEIGHT, MAX_BULLETS, MAX_ENEMIES, MAX_ITEMS, MAX_EXPLOSIONS};
+    return config;
+}
+
+static int InRange(int value, int lo, int hi) {
+    return value >= lo && value <= hi;
+}
+
+const char* GameConfigError(const GameConfig* config) {
+    if (!InRange(config->width, MIN_FIELD_WIDTH, MAX_FIELD_WIDTH)) return "width out of range";
+    if (!InRange(config->height, MIN_FIELD_HEIGHT, MAX_FIELD_HEIGHT)) return "height out of range";
+    if (!InRange(config->max_bullets, 1, MAX_CAPACITY)) return "max-bullets out of range";
+    if (!InRange(config->max_enemies, 1, MAX_CAPACITY)) return "max-enemies out of range";
+    if (!InRange(config->max_items, 1, MAX_CAPACITY)) return "max-items out of range";
+    if (!InRange(config->max_explosions, 1, MAX_CAPACITY)) return "max-explosions out of range";
+    return NULL;
+}
+
+// 按固定顺序切出一局游戏的全部存储；arena 只计算大小时返回 NULL
+static GameState* CarveGame(Arena* arena, const GameConfig* config) {
+    GameState* game = (GameState*)ArenaAlloc(arena, sizeof(GameState));
+    void* player_bullet_storage = ArenaAlloc(arena, BULLET_LANE_BYTES(BULLET_LANE_CAPACITY(config->max_bullets)));
+    void* enemy_bullet_storage = ArenaAlloc(arena, BULLET_LANE_BYTES(BULLET_LANE_CAPACITY(config->max_bullets)));
+    void* enemy_storage = ArenaAlloc(arena, ENEMY_GROUPS_BYTES(config->max_enemies));
+    Item* items = (Item*)ArenaAlloc(arena, sizeof(Item) * config->max_items);
+    Explosion* explosions = (Explosion*)ArenaAlloc(arena, sizeof(Explosion) * config->max_explosions);
+    int* item_link = (int*)ArenaAlloc(arena, 2 * sizeof(int) * config->max_items);
+    int* explosion_link = (int*)ArenaAlloc(arena, 2 * sizeof(int) * config->max_explosions);
+    char* render_buffer = (char*)ArenaAlloc(arena, (size_t)config->height * (config->width + 1));
+    CollisionScratch* collision = CarveCollisionScratch(arena, config);
+    if (game == NULL) return NULL;
+
+    game->config = *config;
+    game->player_bullet_storage = player_bullet_storage;
+    game->enemy_bullet_storage = enemy_bullet_storage;
+    game->enemy_storage = enemy_storage;
+    game->items = items;
+    game->explosions = explosions;
+    game->item_link = item_link;
+    game->item_dense = item_link + config->max_items;
+    game->explosion_link = explosion_link;
+    game->explosion_dense = explosion_link + config->max_explosions;
+    game->render_buffer = render_buffer;
+    game->collision = collision;
+    game->arena_bytes = arena->size;
+    return game;
+}
+
+// 先量出所需大小，再一次性分配、切分 (之后的模拟不再申请内存)
+GameState* CreateGame(const GameConfig* config, unsigned long long seed) {
+    GameConfig defaults = DefaultGameConfig();
+    if (config == NULL) config = &defaults;
+    if (GameConfigError(config) != NULL) return NULL;
+
+    Arena arena;
+    ArenaMeasure(&arena);
+    CarveGame(&arena, config);
+    if (!ArenaCreate(&arena, arena.used)) return NULL;
+    GameState* game = CarveGame(&arena, config);
+
+    game->tuning.tier1_score = 100;
+    game->tuning.tier2_score = 300;
+    game->tuning.spawn_base = 50;
+    game->tuning.spawn_score_div = 100;
+    game->tuning.spawn_min = 20;
+    for (int t = 0; t < ENEMY_TYPE_COUNT; t++) {
+        game->archetypes[t] = enemy_archetypes[t];
+        PatternCompile(&game->archetypes[t].pattern, &game->enemy_patterns[t]);
+    }
+    for (int p = 0; p < 3; p++) PatternCompile(&player_pattern_defs[p], &game->player_patterns[p]);
+    RngSeed(&game->rng, seed);
+    InitGame(game);
+    return game;
+}
+
+// GameState 位于整块内存的开头
+void DestroyGame(GameState* game) {
+    if (game == NULL) return;
+    DestroyDangerField(game->danger);
+    DestroyEventRing(game->events);
+    free(game->jobs);
+    PlatformAlignedFree(game);
+}
+
+void InitGame(GameState* game) {
+    // 初始化玩家
+    game->player.pos.x = RFromInt(game->config.width / 2);
+    game->player.pos.y = RFromInt(game->config.height - 2);
+    game->player.lives = 3;
+    game->player.score = 0;
+    game->player.shoot_timer = 0;
+    game->player.power_level = 0;
+    game->player.power_timer = 0;
+    game->player.slow_mode = 0;
+    game->player.invincible_timer = 0;
+    game->player.graze_count = 0;
+    game->frame_count = 0;
+
+    // 清空对象池
+    BulletLaneInit(&game->player_bullets, game->player_bullet_storage, BULLET_LANE_CAPACITY(game->config.max_bullets));
+    BulletLaneInit(&game->enemy_bullets, game->enemy_bullet_storage, BULLET_LANE_CAPACITY(game->config.max_bullets));
+    game->player_bullets.limit = game->config.max_bullets;
+    game->enemy_bullets.limit = game->config.max_bullets;
+    EnemyGroupsInit(&game->enemies, game->enemy_storage, game->config.max_enemies);
+    PoolInit(&game->item_pool, game->item_link, game->item_dense, game->config.max_items);
+    PoolInit(&game->explosion_pool, game->explosion_link, game->explosion_dense, game->config.max_explosions);
+
+    // 本局统计
+    memset(&game->stats, 0, sizeof(game->stats));
+    game->stats.killer_type = -1;
+    if (game->danger != NULL) DangerFieldReset(game->danger);
+    LogEvent(game, EVENT_GAME_START, game->player.pos.x, game->player.pos.y, -1, 0);
+}
+
+// 发射子弹
+void SpawnBullet(GameState* game, Real x, Real y, Real vx, Real vy, int is_enemy) {
+    if (is_enemy) {
+        BulletLanePush(&game->enemy_bullets, (LaneReal)x, (LaneReal)y, (LaneReal)vx, (LaneReal)vy, BULLET_OWNER_ENEMY);
+    } else {
+        BulletLanePush(&game->player_bullets, (LaneReal)x, (LaneReal)y, (LaneReal)vx, (LaneReal)vy, 0);
+    }
+}
+
+// 敌机子弹，flags 中记录发射者类型 (用于统计死因)
+void SpawnEnemyBullet(GameState* game, Real x, Real y, Real vx, Real vy, int shooter_type) {
+    BulletLanePush(&game->enemy_bullets, (LaneReal)x, (LaneReal)y, (LaneReal)vx, (LaneReal)vy,
+                   BULLET_OWNER_ENEMY | BULLET_SHOOTER(shooter_type));
+}
+
+// 按当前难度阶段的生成权重抽取敌机类型；只有一种可选时不消耗随机数
+static int PickEnemyType(GameState* game) {
+    int tier = game->player.score < game->tuning.tier1_score ? 0
+             : game->player.score < game->tuning.tier2_score ? 1 : 2;
+    int total = 0, candidates = 0, only = 0;
+    for (int t = 0; t < ENEMY_TYPE_COUNT; t++) {
+        int w = game->archetypes[t].spawn_weight[tier];
+        total += w;
+        if (w > 0) {
+            candidates++;
+            only = t;
+        }
+    }
+    if (candidates <= 1) return only;
+
+    int r = RngRange(&game->rng, total);
+    for (int t = 0; t < ENEMY_TYPE_COUNT; t++) {
+        r -= game->archetypes[t].spawn_weight[tier];
+        if (r < 0) return t;
+    }
+    return ENEMY_TYPE_COUNT - 1;
+}
+
+int PlaceEnemy(GameState* game, int type, Real x, Real y, int cooldown) {
+    int i = EnemyGroupsAdd(&game->enemies, type);
+    if (i < 0) return -1;
+    game->enemies.x[i] = x;
+    game->enemies.y[i] = y;
+    game->enemies.cooldown[i] = cooldown;
+    game->enemies.shot[i] = 0;
+    return i;
+}
+
+// 生成敌人 - 根据分数决定类型，返回新敌机的下标 (已满时返回 -1)
+int SpawnEnemy(GameState* game) {
+    if (game->enemies.count >= game->enemies.capacity) return -1;
+
+    Real x = RFromInt(RngRange(&game->rng, game->config.width - 2) + 1);
+    int cooldown = 20 + RngRange(&game->rng, 30); // 随机初始冷却
+    int i = PlaceEnemy(game, PickEnemyType(game), x, R(1), cooldown);
+    LogEvent(game, EVENT_SPAWN, x, R(1), game->enemies.type[i], 0);
+    return i;
+}
+
+// 生成道具
+void SpawnItem(GameState* game, Real x, Real y, int type) {
+    int i = PoolAcquire(&game->item_pool);
+    if (i < 0) return;
+
+    game->items[i].pos.x = x;
+    game->items[i].pos.y = y;
+    game->items[i].type = type;
+}
+
+// 生成爆炸效果
+void SpawnExplosion(GameState* game, Real x, Real y) {
+    int i = PoolAcquire(&game->explosion_pool);
+    if (i < 0) return;
+
+    game->explosions[i].pos.x = x;
+    game->explosions[i].pos.y = y;
+    game->explosions[i].timer = 10; // 爆炸持续10帧
+}
+
+// --- 每帧的各个步骤 (Update() 与 UpdateSteps() 共用) ---
+// sweep 为 NULL 时是逐帧模拟；否则处于粗时间步的第 substep 帧，
+// 飞出底部的实体只登记到 sweep 里，留到步末的碰撞检测之后再回收
+
+// 1. 玩家移动 (输入由平台层或脚本在帧开始前采集)
+static void MovePlayer(GameState* game, const GameInput* input) {
+    PROF_BEGIN(PROF_INPUT);
+    // Shift/Space 按住时进入精确移动模式
+    game->player.slow_mode = (input->keys & KEY_SLOW) != 0;
+    
+    // 根据模式设置移动速度 (结合主分支的0.8速度和慢速模式)
+    Real speed = game->player.slow_mode ? R(0.25) : R(0.8); // 慢速模式为约1/3速度
+    
+    if ((input->keys & KEY_UP) && game->player.pos.y > R(1)) game->player.pos.y -= speed;
+    if ((input->keys & KEY_DOWN) && game->player.pos.y < RFromInt(game->config.height - 2)) game->player.pos.y += speed;
+    if ((input->keys & KEY_LEFT) && game->player.pos.x > R(1)) game->player.pos.x -= speed;
+    if ((input->keys & KEY_RIGHT) && game->player.pos.x < RFromInt(game->config.width - 2)) game->player.pos.x += speed;
+    
+    // 更新无敌时间
+    if (game->player.invincible_timer > 0) {
+        game->player.invincible_timer--;
+    }
+    PROF_END(PROF_INPUT);
+}
+
+// 2. 玩家自动射击
+// 分数越高，射击间隔越短。最低间隔为 3 帧。
+static void FirePlayer(GameState* game) {
+    PROF_BEGIN(PROF_AUTOFIRE);
+    int fire_rate = 15 - (game->player.score / 50); 
+    if (fire_rate < 3) fire_rate = 3;
+    
+    game->player.shoot_timer++;
+    if (game->player.shoot_timer >= fire_rate) {
+        // 根据火力等级发射子弹 (单发 / 双发 / 三发，见 player_pattern_defs)
+        PatternEmit(&game->player_patterns[game->player.power_level], &game->player_bullets,
+                    game->player.pos.x, game->player.pos.y - R(1), 0, 0, 0, 0);
+        EmitSound(game, SOUND_SHOOT); // 播放射击音效
+        game->player.shoot_timer = 0;
+    }
+    
+    // 更新火力升级计时器
+    if (game->player.power_timer > 0) {
+        game->player.power_timer--;
+        if (game->player.power_timer == 0) {
+            game->player.power_level = 0; // 恢复普通火力
+        }
+    }
+    PROF_END(PROF_AUTOFIRE);
+}
+
+// 4. 更新敌人 & 敌机发射
+// 4a. 生成和移动，返回本帧生成的敌机下标 (没有时为 -1)
+static int MoveEnemies(GameState* game, SweepLog* sweep, int substep) {
+    // 动态控制敌机生成：调整初始频率，并限制最大在场数量
+    EnemyGroups* enemies = &game->enemies;
+
+    // 默认 50 - score/100，最低 20 (见 GameTuning)
+    int spawn_interval = game->tuning.spawn_base - (game->player.score / game->tuning.spawn_score_div);
+    if (spawn_interval < game->tuning.spawn_min) spawn_interval = game->tuning.spawn_min;
+    
+    // 只有在未达到上限时才生成新敌机 (下标在本阶段末尾回收之前保持不变)
+    int spawned = -1;
+    if (game->frame_count % spawn_interval == 0) {
+        spawned = SpawnEnemy(game);
+        if (sweep != NULL && spawned >= 0) {
+            enemies->first[spawned] = (unsigned char)substep;
+            enemies->last[spawned] = (unsigned char)sweep->steps;
+        }
+    }
+
+    Real speeds[ENEMY_TYPE_COUNT];
+    for (int t = 0; t < ENEMY_TYPE_COUNT; t++) speeds[t] = game->archetypes[t].speed;
+    EnemyGroupsStep(enemies, speeds, sweep != NULL ? sweep->steps : 0);
+    return spawned;
+}
+
+// 4b. 飞出底部、危险场和发射：按组查原型，同组共用弹幕模式和发射者标记
+// 开启危险场时顺带写入敌机和本帧新发射的敌弹 (见 danger.h)；粗时间步不维护危险场
+static void FireEnemies(GameState* game, SweepLog* sweep, int substep, int spawned) {
+    DangerField* danger = sweep == NULL ? game->danger : NULL;
+    EnemyGroups* enemies = &game->enemies;
+    int first_new_bullet = game->enemy_bullets.count; // 之后的敌弹都是本帧新发射的
+    Real floor_y = RFromInt(game->config.height - 1);
+    for (int t = 0; t < ENEMY_TYPE_COUNT; t++) {
+        const PatternProgram* pattern = &game->enemy_patterns[t];
+        if (pattern->count == 0 && danger == NULL && sweep == NULL) continue; // 不发射的组只需统一回收
+        Real speed = game->archetypes[t].speed;
+        BulletFlags shooter = BULLET_OWNER_ENEMY | BULLET_SHOOTER(t);
+        for (int i = enemies->start[t]; i < enemies->start[t + 1]; i++) {
+            if (sweep != NULL && enemies->last[i] < sweep->steps) continue; // 本步早些时候已飞出底部
+
+            // 消失在底部 (逐帧模拟在下面统一回收)
+            if (enemies->y[i] >= floor_y) {
+                if (sweep != NULL) enemies->last[i] = (unsigned char)(substep - 1);
+                if (danger != NULL) DangerFieldEraseEnemy(danger, enemies->x[i], enemies->y[i], speed);
+                continue;
+            }
+            if (danger != NULL) DangerFieldStampEnemy(danger, enemies->x[i], enemies->y[i], speed, i == spawned);
+
+            if (enemies->cooldown[i] <= 0 && pattern->count > 0) {
+                PatternEmit(pattern, &game->enemy_bullets, enemies->x[i], enemies->y[i],
+                            game->player.pos.x, game->player.pos.y, enemies->shot[i], shooter);
+                enemies->cooldown[i] = PatternNextCooldown(pattern, enemies->shot[i], &game->rng);
+                enemies->shot[i]++;
+            }
+        }
+    }
+    if (sweep == NULL) {
+        for (int i = enemies->count - 1; i >= 0; i--) {
+            if (enemies->y[i] >= floor_y) EnemyGroupsRemove(enemies, i);
+        }
+    }
+    if (danger != NULL) DangerFieldStampBullets(danger, &game->enemy_bullets, first_new_bullet);
+}
+
+static void UpdateEnemies(GameState* game, SweepLog* sweep, int substep) {
+    PROF_BEGIN(PROF_ENEMIES);
+    int spawned = MoveEnemies(game, sweep, substep);
+    FireEnemies(game, sweep, substep, spawned);
+    PROF_END(PROF_ENEMIES);
+}
+
+// 5. 更新道具 (也在任务里执行，剖析由调用方负责)
+static void UpdateItems(GameState* game, SweepLog* sweep, int substep) {
+    for (int k = game->item_pool.count - 1; k >= 0; k--) {
+        int i = game->item_pool.dense[k];
+        if (sweep != NULL && sweep->item_last[i] < sweep->steps) continue;
+        game->items[i].pos.y += ITEM_FALL_SPEED; // 缓慢下落
+        
+        // 消失在底部
+        if (game->items[i].pos.y >= RFromInt(game->config.height - 1)) {
+            if (sweep != NULL) {
+                sweep->item_last[i] = (unsigned char)(substep - 1);
+            } else {
+                PoolRelease(&game->item_pool, i);
+            }
+        }
+    }
+}
+
+// 6. 更新爆炸效果 (同上)
+static void UpdateExplosions(GameState* game) {
+    for (int k = game->explosion_pool.count - 1; k >= 0; k--) {
+        int i = game->explosion_pool.dense[k];
+        game->explosions[i].timer--;
+        if (game->explosions[i].timer <= 0) {
+            PoolRelease(&game->explosion_pool, i);
+        }
+    }
+}
+
+static void CountEntities(GameState* game) {
+    PROF_COUNT(PROF_COUNT_PLAYER_BULLETS, game->player_bullets.count);
+    PROF_COUNT(PROF_COUNT_ENEMY_BULLETS, game->enemy_bullets.count);
+    PROF_COUNT(PROF_COUNT_ENEMIES, game->enemies.count);
+    PROF_COUNT(PROF_COUNT_ITEMS, game->item_pool.count);
+    PROF_COUNT(PROF_COUNT_EXPLOSIONS, game->explosion_pool.count);
+    (void)game;
+}
+
+// --- 多线程 Update (见 jobs.h) ---
+// 移动和射击之后的步骤拆成任务图：
+//
+//   自机子弹积分 ─┐
+//   敌弹积分 (分段) ┴→ 回收越界子弹 ─┐
+//   生成并移动敌机 ─────────────────┴→ 敌机发射 ─→ 敌机网格 ─→ 7A 粗筛 (分段)
+//                                              └→ 敌弹网格
+//   道具、爆炸 (与以上都无关)
+//
+// 任务之间只有这些依赖，各任务写的数据互不重叠；用到随机数的生成和发射前后相继，
+// 顺序与单线程相同。7A 的粗筛只读，筛出的子弹按段写进各自的缓冲，
+// JobPoolRun 返回后由调用线程按子弹编号的顺序让击毁、计分、掉落、扣血生效，再做 7B-7D。
+// 因此结果与单线程 Update 逐位相同，与线程数和调度无关。
+// 剖析数据只记录道具、爆炸和碰撞的 A-D 步骤；粗时间步 (UpdateSteps) 仍然单线程执行。
+
+#define ENEMY_BULLET_CHUNK 4096     // 敌弹积分每段至少这么多颗 (8 的倍数，保证 SIMD 对齐)
+#define PLAYER_BULLET_CHUNK 256     // 7A 粗筛每段至少这么多颗
+#define CHUNKS_PER_THREAD 4         // 段数约为线程数的几倍，窃取时容易均衡
+#define MAX_CHUNKS 96               // 每种分段任务的上限 (两种合计不超过任务图容量)
+
+struct UpdateJobs {
+    JobPool* pool;
+    JobGraph graph;
+    int spawned;                    // 本帧生成的敌机 (移动任务写，发射任务读)
+    int scan_chunk;                 // 7A 粗筛的段长
+    int scan_chunks;
+    int scan_begin[MAX_CHUNKS];
+    int scan_found[MAX_CHUNKS];     // 第 k 段筛出的子弹数 (编号在碰撞缓冲的 scan_begin[k] 处)
+};
+
+int AttachJobPool(GameState* game, JobPool* pool) {
+    if (pool == NULL) {
+        free(game->jobs);
+        game->jobs = NULL;
+        return 1;
+    }
+    if (game->jobs == NULL) {
+        game->jobs = (UpdateJobs*)malloc(sizeof(UpdateJobs));
+        if (game->jobs == NULL) return 0;
+    }
+    game->jobs->pool = pool;
+    BulletActiveKernel(); // 子弹内核在任务开始前选好
+    return 1;
+}
+
+// 把 count 分成至多 threads * CHUNKS_PER_THREAD 段，段长不小于 min_chunk，按 8 对齐
+static int ChunkSize(int count, int threads, int min_chunk) {
+    int chunks = threads * CHUNKS_PER_THREAD;
+    if (chunks > MAX_CHUNKS) chunks = MAX_CHUNKS;
+    int size = (count + chunks - 1) / chunks;
+    if (size < min_chunk) size = min_chunk;
+    return (size + 7) & ~7;
+}
+
+static void JobStepPlayerBullets(void* context, int begin, int end, int worker) {
+    GameState* game = (GameState*)context;
+    (void)worker;
+    BulletLaneStepRange(&game->player_bullets, begin, end, (LaneReal)RFromInt(game->config.width),
+                        (LaneReal)RFromInt(game->config.height));
+}
+
+static void JobStepEnemyBullets(void* context, int begin, int end, int worker) {
+    GameState* game = (GameState*)context;
+    (void)worker;
+    BulletLaneStepRange(&game->enemy_bullets, begin, end, (LaneReal)RFromInt(game->config.width),
+                        (LaneReal)RFromInt(game->config.height));
+}
+
+static void JobCompactBullets(void* context, int begin, int end, int worker) {
+    GameState* game = (GameState*)context;
+    (void)begin, (void)end, (void)worker;
+    BulletLaneCompact(&game->player_bullets);
+    BulletLaneCompact(&game->enemy_bullets);
+    if (game->danger != NULL) DangerFieldAdvance(game->danger, &game->enemy_bullets);
+}
+
+static void JobMoveEnemies(void* context, int begin, int end, int worker) {
+    GameState* game = (GameState*)context;
+    (void)begin, (void)end, (void)worker;
+    game->jobs->spawned = MoveEnemies(game, NULL, 0);
+}
+
+static void JobFireEnemies(void* context, int begin, int end, int worker) {
+    GameState* game = (GameState*)context;
+    (void)begin, (void)end, (void)worker;
+    FireEnemies(game, NULL, 0, game->jobs->spawned);
+}
+
+static void JobUpdateItems(void* context, int begin, int end, int worker) {
+    (void)begin, (void)end, (void)worker;
+    UpdateItems((GameState*)context, NULL, 0);
+}
+
+static void JobUpdateExplosions(void* context, int begin, int end, int worker) {
+    (void)begin, (void)end, (void)worker;
+    UpdateExplosions((GameState*)context);
+}
+
+static void JobBuildEnemyGrid(void* context, int begin, int end, int worker) {
+    (void)begin, (void)end, (void)worker;
+    BuildEnemyGrid((GameState*)context);
+}
+
+static void JobBuildEnemyBulletGrid(void* context, int begin, int end, int worker) {
+    (void)begin, (void)end, (void)worker;
+    BuildEnemyBulletGrid((GameState*)context);
+}
+
+// 段的范围按回收前的子弹数划分，执行时截到回收后的数量
+static void JobScanPlayerBullets(void* context, int begin, int end, int worker) {
+    GameState* game = (GameState*)context;
+    UpdateJobs* jobs = game->jobs;
+    (void)worker;
+    if (end > game->player_bullets.count) end = game->player_bullets.count;
+    jobs->scan_found[begin / jobs->scan_chunk] = begin < end ? ScanPlayerBullets(game, begin, end) : 0;
+}
+
+static void RunUpdateJobs(GameState* game) {
+    UpdateJobs* jobs = game->jobs;
+    JobGraph* graph = &jobs->graph;
+    int threads = JobPoolThreads(jobs->pool);
+    JobGraphClear(graph);
+
+    // 3. 子弹
+    int compact = JobGraphAdd(graph, JobCompactBullets, game, 0, 0);
+    int player_bullets = game->player_bullets.count;
+    JobGraphDepend(graph, JobGraphAdd(graph, JobStepPlayerBullets, game, 0, player_bullets), compact);
+    int enemy_bullets = game->enemy_bullets.count;
+    int size = ChunkSize(enemy_bullets, threads, ENEMY_BULLET_CHUNK);
+    for (int begin = 0; begin < enemy_bullets; begin += size) {
+        int end = begin + size < enemy_bullets ? begin + size : enemy_bullets;
+        JobGraphDepend(graph, JobGraphAdd(graph, JobStepEnemyBullets, game, begin, end), compact);
+    }
+
+    // 4-6. 敌机、道具、爆炸
+    int move = JobGraphAdd(graph, JobMoveEnemies, game, 0, 0);
+    int fire = JobGraphAdd(graph, JobFireEnemies, game, 0, 0);
+    JobGraphDepend(graph, compact, fire);
+    JobGraphDepend(graph, move, fire);
+    JobGraphAdd(graph, JobUpdateItems, game, 0, 0);
+    JobGraphAdd(graph, JobUpdateExplosions, game, 0, 0);
+
+    // 7. 网格和 7A 粗筛
+    int enemy_grid = JobGraphAdd(graph, JobBuildEnemyGrid, game, 0, 0);
+    JobGraphDepend(graph, fire, enemy_grid);
+    JobGraphDepend(graph, fire, JobGraphAdd(graph, JobBuildEnemyBulletGrid, game, 0, 0));
+    jobs->scan_chunk = ChunkSize(player_bullets, threads, PLAYER_BULLET_CHUNK);
+    jobs->scan_chunks = 0;
+    for (int begin = 0; begin < player_bullets; begin += jobs->scan_chunk) {
+        int end = begin + jobs->scan_chunk < player_bullets ? begin + jobs->scan_chunk : player_bullets;
+        jobs->scan_begin[jobs->scan_chunks++] = begin;
+        JobGraphDepend(graph, enemy_grid, JobGraphAdd(graph, JobScanPlayerBullets, game, begin, end));
+    }
+
+    JobPoolRun(jobs->pool, graph);
+    ResolveScannedCollisions(game, jobs->scan_begin, jobs->scan_found, jobs->scan_chunks);
+}
+
+// 核心更新逻辑
+void Update(GameState* game, const GameInput* input) {
+    game->frame_count++;
+
+    MovePlayer(game, input);
+    FirePlayer(game);
+
+    if (game->jobs != NULL) {
+        if (game->danger != NULL) DangerFieldBeginFrame(game->danger, game);
+        PROF_BEGIN(PROF_UPDATE_JOBS);
+        RunUpdateJobs(game);
+        PROF_END(PROF_UPDATE_JOBS);
+        if (game->danger != NULL) DangerFieldEndFrame(game->danger, game);
+        CountEntities(game);
+        return;
+    }
+
+    // 3. 更新子弹 (SIMD 积分 + 边界剔除，内核按 CPU 特性选择)
+    // 开启危险场时顺带把敌弹写进最远的前瞻层 (见 danger.h)
+    PROF_BEGIN(PROF_BULLETS);
+    DangerField* danger = game->danger;
+    if (danger != NULL) DangerFieldBeginFrame(danger, game);
+    BulletLaneStep(&game->player_bullets, (LaneReal)RFromInt(game->config.width), (LaneReal)RFromInt(game->config.height));
+    BulletLaneStep(&game->enemy_bullets, (LaneReal)RFromInt(game->config.width), (LaneReal)RFromInt(game->config.height));
+    if (danger != NULL) DangerFieldAdvance(danger, &game->enemy_bullets);
+    PROF_END(PROF_BULLETS);
+
+    UpdateEnemies(game, NULL, 0);
+    PROF_BEGIN(PROF_ITEMS);
+    UpdateItems(game, NULL, 0);
+    PROF_END(PROF_ITEMS);
+    PROF_BEGIN(PROF_EXPLOSIONS);
+    UpdateExplosions(game);
+    PROF_END(PROF_EXPLOSIONS);
+
+    // 7. 碰撞检测 (网格粗检测，见 collision.c)
+    ResolveCollisions(game);
+    if (danger != NULL) DangerFieldEndFrame(danger, game);
+    CountEntities(game);
+}
+
+// 把第 substep 帧新发射的子弹 [first, count) 往回挪 back 帧并记下发射帧：
+// 步末统一前进 steps 帧后，它们正好停在逐帧模拟的位置上
+static void TagSubstepBullets(BulletLane* lane, int first, int back, int substep) {
+    for (int i = first; i < lane->count; i++) {
+        lane->x[i] -= (LaneReal)back * lane->vx[i];
+        lane->y[i] -= (LaneReal)back * lane->vy[i];
+        lane->flags[i] |= BULLET_BIRTH(substep);
+    }
+}
+
+// 粗时间步内子弹的位置是第 0 帧的位置 (第 k 帧在 x + k * vx)。把 [first, count) 中在第 from..steps 帧
+// 飞出场外的子弹按飞出的那一帧计入 exits；匀速直线运动离开矩形后不会再回来，步末仍在场内的直接跳过
+static int LaneOutAt(const BulletLane* lane, int i, int k, LaneReal width, LaneReal height) {
+    LaneReal x = lane->x[i] + (LaneReal)k * lane->vx[i], y = lane->y[i] + (LaneReal)k * lane->vy[i];
+    return x <= 0 || x >= width || y <= 0 || y >= height;
+}
+
+static void CountExits(const GameState* game, const BulletLane* lane, int first, int from, int steps, int* exits) {
+    LaneReal width = (LaneReal)RFromInt(game->config.width), height = (LaneReal)RFromInt(game->config.height);
+    for (int i = first; i < lane->count; i++) {
+        if (!LaneOutAt(lane, i, steps, width, height)) continue;
+        for (int k = from; k <= steps; k++) {
+            if (LaneOutAt(lane, i, k, width, height)) {
+                exits[k]++;
+                break;
+            }
+        }
+    }
+}
+
+// 粗时间步：逐帧跑移动、射击、生成和计时这些便宜的步骤，子弹只积分一次，
+// 碰撞检测按每个实体在步内的轨迹做连续检测 (ResolveCollisionsSwept)。
+// 开销大头 (子弹积分和碰撞) 每步只做一次，与 steps 无关
+void UpdateSteps(GameState* game, const GameInput* input, int steps) {
+    if (steps <= 1) {
+        Update(game, input);
+        return;
+    }
+    if (steps > UPDATE_MAX_STEPS) steps = UPDATE_MAX_STEPS;
+    if (game->danger != NULL) DangerFieldReset(game->danger); // 回到逐帧模拟后重建
+
+    // 逐帧模拟中飞出场外的子弹在那一帧就被回收、让出位置。这里要留到步末，
+    // 所以每帧发射前把已经飞出的子弹记为 retired，在场子弹数仍按逐帧模拟的规则受 max_bullets 限制
+    int player_exits[UPDATE_MAX_STEPS + 1] = {0}, enemy_exits[UPDATE_MAX_STEPS + 1] = {0};
+    CountExits(game, &game->player_bullets, 0, 1, steps, player_exits);
+    CountExits(game, &game->enemy_bullets, 0, 1, steps, enemy_exits);
+
+    SweepLog* sweep = BeginSweep(game, steps);
+    for (int s = 1; s <= steps; s++) {
+        game->frame_count++;
+        MovePlayer(game, input);
+        sweep->player[s] = game->player.pos;
+
+        // 自机子弹发射后当帧就积分一次，敌弹要到下一帧；
+        // 所以自机发射时第 s 帧的积分还没做，敌机发射时已经做了
+        game->player_bullets.retired += player_exits[s - 1];
+        int first = game->player_bullets.count;
+        FirePlayer(game);
+        TagSubstepBullets(&game->player_bullets, first, s - 1, s);
+        CountExits(game, &game->player_bullets, first, s, steps, player_exits);
+
+        game->enemy_bullets.retired += enemy_exits[s];
+        first = game->enemy_bullets.count;
+        UpdateEnemies(game, sweep, s);
+        TagSubstepBullets(&game->enemy_bullets, first, s, s);
+        CountExits(game, &game->enemy_bullets, first, s + 1, steps, enemy_exits);
+
+        PROF_BEGIN(PROF_ITEMS);
+        UpdateItems(game, sweep, s);
+        PROF_END(PROF_ITEMS);
+        PROF_BEGIN(PROF_EXPLOSIONS);
+        UpdateExplosions(game);
+        PROF_END(PROF_EXPLOSIONS);
+    }
+
+    PROF_BEGIN(PROF_BULLETS);
+    BulletLaneAdvance(&game->player_bullets, steps);
+    BulletLaneAdvance(&game->enemy_bullets, steps);
+    PROF_END(PROF_BULLETS);
+
+    ResolveCollisionsSwept(game);
+    CountEntities(game);
+}
@@ -0,0 +1,236 @@
+#ifndef GAME_H
+#define GAME_H
+
+#include "pool.h"
+#include "bullets.h"
+#include "enemies.h"
+#include "pattern.h"
+#include "rng.h"
+
+_Static_assert(ENEMY_TYPE_COUNT <= BULLET_SHOOTER_MAX, "敌机类型数超出子弹 flags 的发射者字段");
+
+// 游戏模拟核心：不依赖任何平台 I/O (无 <windows.h>/<conio.h>)
+// 输入通过 GameInput 传入，音效通过 sound_hook 回调传出，状态全部在 GameState 中，
+// 因此既可以由控制台前端驱动，也可以在无终端的 headless 模式下全速运行。
+
+// --- 游戏配置参数 ---
+// 区域大小和容量在运行时由 GameConfig 决定 (命令行或配置文件，见 config.h)，这里只是默认值。
+// 默认容量仍可在编译时覆盖 (例如 -DMAX_BULLETS=100000 让弹幕压力测试默认使用大容量)
+#define DEFAULT_WIDTH 40    // 游戏区域宽度
+#define DEFAULT_HEIGHT 25   // 游戏区域高度
+#ifndef MAX_BULLETS
+#define MAX_BULLETS 100 // 最大子弹数
+#endif
+#ifndef MAX_ENEMIES
+#define MAX_ENEMIES 8   // 最大敌人数 (降低以改善平衡性)
+#endif
+#ifndef MAX_ITEMS
+#define MAX_ITEMS 5     // 最大道具数
+#endif
+#ifndef MAX_EXPLOSIONS
+#define MAX_EXPLOSIONS 10 // 最大爆炸效果数
+#endif
+// 运行时配置的取值范围
+#define MIN_FIELD_WIDTH 20
+#define MIN_FIELD_HEIGHT 12
+#define MAX_FIELD_WIDTH 320
+#define MAX_FIELD_HEIGHT 160
+#define MAX_CAPACITY (1 << 22)  // 每种实体的容量上限
+
+// 子弹道实际分配的位置数：粗时间步中途飞出场外的子弹要留到步末的连续碰撞检测之后才回收，
+// 为它们多留一倍位置；同时在场的子弹仍不超过 max_bullets (见 BulletLane.limit)
+#define BULLET_LANE_CAPACITY(max_bullets) (2 * (max_bullets))
+#define GRAZE_DISTANCE 1.0 // 擦弹判定距离
+#define INVINCIBLE_FRAMES 30 // 擦弹后无敌时间（帧数）
+#define ITEM_FALL_SPEED R(0.15) // 道具每帧下落的距离
+#define UPDATE_MAX_STEPS 8   // UpdateSteps() 一次最多合并的帧数
+
+// --- 输入按键位掩码 ---
+#define KEY_UP    0x01
+#define KEY_DOWN  0x02
+#define KEY_LEFT  0x04
+#define KEY_RIGHT 0x08
+#define KEY_SLOW  0x10  // Shift/Space: 精确移动模式
+
+// --- 数据结构 ---
+
+// 一局游戏的区域大小和实体容量 (含边框；子弹容量按每条子弹道计)
+typedef struct {
+    int width, height;
+    int max_bullets;
+    int max_enemies;
+    int max_items;
+    int max_explosions;
+} GameConfig;
+
+// 坐标结构 (Real 默认为 double，-DUSE_FIXED_POINT 时为 Q16.16 定点数，见 fixed.h)
+typedef struct {
+    Real x, y;
+} Vec2;
+
+// 道具结构
+typedef struct {
+    Vec2 pos;
+    int type;      // 0=生命恢复(H), 1=火力升级(P)
+} Item;
+
+// 爆炸效果结构
+typedef struct {
+    Vec2 pos;
+    int timer;     // 爆炸持续时间
+} Explosion;
+
+// 自机结构
+typedef struct {
+    Vec2 pos;
+    int lives;
+    int score;
+    int shoot_timer; // 射击计时器
+    int power_level; // 火力等级: 0=普通, 1=双发, 2=三发
+    int power_timer; // 火力升级持续时间
+    int slow_mode;   // 慢速移动模式: 0=正常, 1=精确模式
+    int invincible_timer; // 擦弹无敌时间
+    int graze_count; // 擦弹计数
+} Player;
+
+// 每帧输入 (由平台层或脚本填充)
+typedef struct {
+    unsigned keys; // KEY_* 位掩码
+} GameInput;
+
+// 模拟过程中产生的音效事件
+typedef enum {
+    SOUND_SHOOT,     // 射击
+    SOUND_HIT,       // 击中敌机
+    SOUND_DAMAGE,    // 自机被击中
+    SOUND_EXPLOSION  // 碰撞爆炸
+} SoundId;
+
+typedef void (*SoundHook)(SoundId id);
+
+// 写进事件日志的游戏事件 (见 eventlog.h)
+typedef enum {
+    EVENT_GAME_START = 1,  // InitGame
+    EVENT_SPAWN,           // 生成敌机
+    EVENT_KILL,            // 击毁敌机 (score_delta 为得分)
+    EVENT_GRAZE,           // 擦弹 (位置为自机)
+    EVENT_HIT,             // 被敌弹击中扣血 (无敌时不计)
+    EVENT_CRASH,           // 撞上敌机
+    EVENT_PICKUP_LIFE,     // 拾取 H
+    EVENT_PICKUP_POWER,    // 拾取 P (火力升级)
+    EVENT_GAME_OVER,       // 生命耗尽 (score_delta 为最终分数)
+    EVENT_TYPE_COUNT
+} GameEventType;
+
+#define ENEMY_TIER_COUNT 3   // 难度阶段：低于 tier1_score、低于 tier2_score、之后
+
+// 敌机原型：一种敌机的全部行为参数。CreateGame 时从 game.c 的原型表复制进 GameState，
+// 生成、移动、发射、计分和绘制都只查这张表，新增一种敌机只需要在表里加一行
+// (下标即类型，存储按类型分组，见 enemies.h)
+typedef struct {
+    const char* name;
+    Real speed;                         // 每帧下落的距离
+    int score;                          // 击毁得分
+    int spawn_weight[ENEMY_TIER_COUNT]; // 各难度阶段的生成权重 (只有一种可选时不消耗随机数)
+    char sprite[2][4];                  // 造型：上一行和本行，各 3 列以 x 居中，' ' 表示透明
+    PatternDef pattern;                 // 弹幕与发射冷却范围 (见 pattern.h)
+} EnemyArchetype;
+
+// 难度曲线参数：默认值就是原来写死的常数，平衡性工具可以逐局修改
+typedef struct {
+    int tier1_score;          // 难度阶段的分界 (各阶段的敌机组成见 EnemyArchetype.spawn_weight)
+    int tier2_score;
+    int spawn_base;           // 生成间隔 = spawn_base - score / spawn_score_div
+    int spawn_score_div;
+    int spawn_min;            // 生成间隔下限
+} GameTuning;
+
+// 每局统计 (InitGame 清零)
+typedef struct {
+    int hits_by_type[ENEMY_TYPE_COUNT];   // 被各类敌机的子弹击中 / 撞击的次数
+    int kills_by_type[ENEMY_TYPE_COUNT];  // 击毁的各类敌机数量
+    int killer_type;                      // 造成最后一次死亡的敌机类型，-1 表示未知/未死亡
+} GameStats;
+
+// 碰撞检测的网格和标记数组 (见 collision.c)
+typedef struct CollisionScratch CollisionScratch;
+
+// 自动驾驶用的前瞻危险场 (见 danger.h)
+typedef struct DangerField DangerField;
+
+// 事件日志的写入环 (见 eventlog.h)
+typedef struct EventRing EventRing;
+
+// 多线程 Update 的任务图和临时数据 (见 game.c)
+typedef struct UpdateJobs UpdateJobs;
+typedef struct JobPool JobPool;
+
+// --- 游戏状态 ---
+// 一局游戏的全部状态，函数之间不共享任何全局变量，多个 GameState 可以在不同线程中并行模拟。
+// 道具和爆炸按槽位存储，是否存活由对应的对象池决定；遍历请使用池的 dense 列表。
+// 敌机按原型分组紧凑存放，遍历范围就是 [0, enemies.count)。
+// 子弹按发射方分为两条 SoA 子弹道，每条最多同时有 config.max_bullets 颗 (位置数见 BULLET_LANE_CAPACITY)。
+// GameState 本身和下面所有数组都切自 CreateGame 分配的同一块内存 (见 arena.h)。
+typedef struct GameState {
+    GameConfig config;       // 创建后不可修改
+    Player player;
+    BulletLane player_bullets;
+    BulletLane enemy_bullets;
+    EnemyGroups enemies;     // 按原型分组存放 (见 enemies.h)
+    Item* items;
+    Explosion* explosions;
+    Pool item_pool;
+    Pool explosion_pool;
+    int frame_count;
+    Rng rng;                 // 所有游戏逻辑的随机数都来自这里，InitGame 不会重置它
+    GameTuning tuning;
+    GameStats stats;
+    SoundHook sound_hook;    // 为 NULL 时静音 (headless)
+
+    // 敌机原型和弹幕模式 (CreateGame 时由 game.c 中的表复制、编译)
+    EnemyArchetype archetypes[ENEMY_TYPE_COUNT];
+    PatternProgram enemy_patterns[ENEMY_TYPE_COUNT];
+    PatternProgram player_patterns[3];    // 按火力等级
+
+    // 子弹道存储 (按缓存行对齐，供 SIMD 内核使用)
+    void* player_bullet_storage;
+    void* enemy_bullet_storage;
+    void* enemy_storage;
+
+    // 对象池的空闲链表与活跃索引存储
+    int *item_link, *item_dense;
+    int *explosion_link, *explosion_dense;
+
+    CollisionScratch* collision;
+    char* render_buffer;     // RenderWorld 的字符缓冲：height 行，每行 width + 1 字节 ('\0' 结尾)
+    DangerField* danger;     // 为 NULL 时不维护 (AttachDangerField 开启，单独分配)
+    EventRing* events;       // 为 NULL 时不记录事件 (AttachEventRing 开启，单独分配)
+    UpdateJobs* jobs;        // 为 NULL 时单线程更新 (AttachJobPool 开启，单独分配)
+    size_t arena_bytes;      // 整块内存的大小
+} GameState;
+
+// --- 游戏逻辑函数 ---
+GameConfig DefaultGameConfig();                   // 编译时的默认区域大小和容量
+const EnemyArchetype* DefaultEnemyArchetypes();   // CreateGame 使用的原型表 (ENEMY_TYPE_COUNT 项)
+const char* GameConfigError(const GameConfig* config); // 配置超出上面的范围时返回原因，否则返回 NULL
+GameState* CreateGame(const GameConfig* config, unsigned long long seed); // config 为 NULL 时用默认配置；配置无效或内存不足返回 NULL
+void DestroyGame(GameState* game);
+void InitGame(GameState* game);                   // 重新开始 (保留随机数状态和难度参数)
+void SpawnBullet(GameState* game, Real x, Real y, Real vx, Real vy, int is_enemy);
+void SpawnEnemyBullet(GameState* game, Real x, Real y, Real vx, Real vy, int shooter_type);
+int SpawnEnemy(GameState* game);                 // 返回新敌机的下标，已满时返回 -1
+int PlaceEnemy(GameState* game, int type, Real x, Real y, int cooldown); // 直接放置 (不消耗随机数、不记录事件)，已满时返回 -1
+void SpawnItem(GameState* game, Real x, Real y, int type);
+void SpawnExplosion(GameState* game, Real x, Real y);
+void Update(GameState* game, const GameInput* input);
+// 粗时间步：按住同一输入前进 steps 帧 (1..UPDATE_MAX_STEPS)，碰撞用连续检测 (见 collision.h)。
+// steps 为 1 时就是 Update()；更大时不再逐帧一致，但统计结果与逐帧模拟相符，用于批量模拟快进
+void UpdateSteps(GameState* game, const GameInput* input, int steps);
+// 之后的 Update() 拆成任务图交给 pool 的线程执行 (见 jobs.h)，结果与单线程逐位相同；pool 为 NULL 时恢复单线程。
+// 失败返回 0。一个 pool 可以由多个游戏轮流使用，但同一时间只能执行一个游戏的 Update()
+int AttachJobPool(GameState* game, JobPool* pool);
+void EmitSound(GameState* game, SoundId id);
+void LogEvent(GameState* game, GameEventType type, Real x, Real y, int enemy_type, int score_delta);
+unsigned long long GameHash(const GameState* game); // 全部模拟状态的哈希，用于回放校验
+
+#endif
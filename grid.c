@@ -0,0 +1,95 @@
+#include <math.h>
+#include <string.h>
+#include "grid.h"
+
+// 查询范围额外放宽的距离，抵消 x±radius 的舍入误差，保证不漏掉候选
+#define GRID_QUERY_MARGIN 0.01
+
+int GridChooseCellSize(int width, int height, int capacity, int min_cell_size) {
+    int cell_size = min_cell_size;
+    while (GRID_DIM(width, cell_size) * GRID_DIM(height, cell_size) > capacity &&
+           cell_size < width && cell_size < height) {
+        cell_size++;
+    }
+    return cell_size;
+}
+
+void GridInit(Grid* grid, int width, int height, int cell_size, int capacity, int* storage) {
+    grid->cols = GRID_DIM(width, cell_size);
+    grid->rows = GRID_DIM(height, cell_size);
+    grid->inv_cell = 1.0 / cell_size;
+    grid->capacity = capacity;
+    grid->count = 0;
+
+    int cell_count = grid->cols * grid->rows;
+    grid->cell_start = storage;
+    grid->entries = storage + cell_count + 1;
+    grid->cells = grid->entries + capacity;
+}
+
+void GridClear(Grid* grid) {
+    grid->count = 0;
+}
+
+// 坐标转格子，场外坐标夹到边缘格子 (夹取是单调的，不影响查询正确性)
+static int ClampCol(const Grid* grid, double x) {
+    int c = (int)floor(x * grid->inv_cell);
+    if (c < 0) return 0;
+    if (c >= grid->cols) return grid->cols - 1;
+    return c;
+}
+
+static int ClampRow(const Grid* grid, double y) {
+    int r = (int)floor(y * grid->inv_cell);
+    if (r < 0) return 0;
+    if (r >= grid->rows) return grid->rows - 1;
+    return r;
+}
+
+int GridInsert(Grid* grid, double x, double y) {
+    if (grid->count >= grid->capacity) return -1;
+
+    int index = grid->count++;
+    grid->cells[index] = ClampRow(grid, y) * grid->cols + ClampCol(grid, x);
+    return index;
+}
+
+// 计数排序：统计每格数量 -> 前缀和 -> 按插入顺序分发 -> 整体右移一格还原起点
+void GridBuild(Grid* grid) {
+    if (grid->count == 0) return; // 空网格：查询直接返回
+
+    int cell_count = grid->cols * grid->rows;
+    int* start = grid->cell_start;
+    memset(start, 0, sizeof(int) * (cell_count + 1));
+
+    for (int i = 0; i < grid->count; i++) {
+        start[grid->cells[i] + 1]++;
+    }
+    for (int c = 0; c < cell_count; c++) {
+        start[c + 1] += start[c];
+    }
+    // 分发后 start[c] 指向第 c 格的末尾，也就是第 c+1 格的起点
+    for (int i = 0; i < grid->count; i++) {
+        grid->entries[start[grid->cells[i]]++] = i;
+    }
+    memmove(start + 1, start, sizeof(int) * cell_count);
+    start[0] = 0;
+}
+
+int GridQuery(const Grid* grid, double x, double y, double radius, int* out, int max_out) {
+    if (grid->count == 0) return 0;
+
+    double r = radius + GRID_QUERY_MARGIN;
+    int c0 = ClampCol(grid, x - r), c1 = ClampCol(grid, x + r);
+    int r0 = ClampRow(grid, y - r), r1 = ClampRow(grid, y + r);
+    int found = 0;
+
+    for (int row = r0; row <= r1; row++) {
+        int begin = grid->cell_start[row * grid->cols + c0];
+        int end = grid->cell_start[row * grid->cols + c1 + 1]; // 同一行的相邻格子在 entries 中连续
+        for (int e = begin; e < end && found < max_out; e++) {
+            out[found++] = grid->entries[e];
+        }
+    }
+    return found;
+}
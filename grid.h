@@ -0,0 +1,35 @@
+#ifndef GRID_H
+#define GRID_H
+
+// 均匀网格 (空间哈希) 粗检测：每帧用计数排序重建。
+//
+// 用法：GridClear -> 对每个实体按顺序 GridInsert -> GridBuild -> GridQuery。
+// 实体编号就是插入顺序，调用方据此映射回自己的数组。
+// 查询返回的是候选集合 (顺序按格子排列)，调用方仍需做精确判定。
+
+typedef struct {
+    int cols, rows;
+    double inv_cell;  // 1 / 格子边长
+    int capacity;
+    int count;
+    int* cell_start;  // cols*rows+1，第 c 格的实体为 entries[cell_start[c] .. cell_start[c+1])
+    int* entries;     // 按格子排序后的实体编号
+    int* cells;       // 每个实体所在格子
+} Grid;
+
+#define GRID_DIM(extent, cell_size) (((extent) + (cell_size) - 1) / (cell_size))
+#define GRID_STORAGE_INTS(cols, rows, capacity) ((cols) * (rows) + 1 + 2 * (capacity))
+
+// 根据容量挑选格子边长：实体越稀疏格子越大，避免每帧清空大量空格子
+int GridChooseCellSize(int width, int height, int capacity, int min_cell_size);
+
+// 覆盖 width x height 的区域，storage 至少 GRID_STORAGE_INTS(cols, rows, capacity) 个 int
+void GridInit(Grid* grid, int width, int height, int cell_size, int capacity, int* storage);
+void GridClear(Grid* grid);
+int GridInsert(Grid* grid, double x, double y);  // 返回实体编号，满时返回 -1
+void GridBuild(Grid* grid);
+
+// 收集与 [x-radius, x+radius] x [y-radius, y+radius] 相交的格子中的实体编号，返回数量
+int GridQuery(const Grid* grid, double x, double y, double radius, int* out, int max_out);
+
+#endif
@@ -0,0 +1,343 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "autopilot.h"
+#include "config.h"
+#include "eventlog.h"
+#include "game.h"
+#include "jobs.h"
+#include "leaderboard.h"
+#include "platform.h"
+#include "profiler.h"
+#include "replay.h"
+
+// Headless 批量运行器：无终端、无休眠、无音效，按脚本输入全速模拟，
+// 用于平衡性测试和回归运行。玩家死亡后自动开始下一局，直到跑满指定帧数。
+// --record 把本次运行录成录像，--replay 全速重放录像并逐段校验状态哈希。
+// --autopilot 改由自动驾驶 (危险场版本，见 autopilot.h) 操作，用于长时间浸泡测试。
+// --events 把击毁、擦弹、受伤等事件追加到二进制事件日志 (见 eventlog.h，用 logquery 查询)。
+// --leaderboard 把每一局的成绩在结束时一次追加到排行榜 (见 leaderboard.h，用 scores 查询)。
+//
+// 脚本格式：每行 "<帧数> <按键>"，按键为 w/a/s/d 组合，S 表示慢速，- 表示不按键；
+// '#' 开头为注释。脚本执行完后从头循环。
+
+#define MAX_SCRIPT_STEPS 1024
+
+typedef struct {
+    int frames;     // 持续帧数
+    unsigned keys;  // KEY_* 位掩码
+} ScriptStep;
+
+static ScriptStep script[MAX_SCRIPT_STEPS];
+static int script_length = 0;
+
+// 未指定脚本时使用的默认输入：左右扫动，偶尔进入慢速模式
+static const ScriptStep default_script[] = {
+    {40, KEY_LEFT},
+    {20, 0},
+    {40, KEY_RIGHT},
+    {20, KEY_RIGHT | KEY_SLOW},
+    {40, KEY_RIGHT},
+    {20, 0},
+    {40, KEY_LEFT},
+    {20, KEY_LEFT | KEY_SLOW},
+};
+
+static unsigned ParseKeys(const char* text) {
+    unsigned keys = 0;
+    for (const char* p = text; *p; p++) {
+        if (*p == 'w') keys |= KEY_UP;
+        if (*p == 's') keys |= KEY_DOWN;
+        if (*p == 'a') keys |= KEY_LEFT;
+        if (*p == 'd') keys |= KEY_RIGHT;
+        if (*p == 'S') keys |= KEY_SLOW;
+    }
+    return keys;
+}
+
+// 读取输入脚本，成功返回 1
+static int LoadScript(const char* path) {
+    FILE* file = fopen(path, "r");
+    if (file == NULL) return 0;
+
+    char line[128];
+    script_length = 0;
+    while (fgets(line, sizeof(line), file) != NULL && script_length < MAX_SCRIPT_STEPS) {
+        int frames;
+        char keys[32];
+        if (line[0] == '#') continue;
+        if (sscanf(line, "%d %31s", &frames, keys) != 2 || frames <= 0) continue;
+        script[script_length].frames = frames;
+        script[script_length].keys = ParseKeys(keys);
+        script_length++;
+    }
+    fclose(file);
+    return script_length > 0;
+}
+
+static void UseDefaultScript() {
+    script_length = (int)(sizeof(default_script) / sizeof(default_script[0]));
+    memcpy(script, default_script, sizeof(default_script));
+}
+
+static void PrintUsage(const char* program) {
+    printf("usage: %s [--frames N] [--seed S] [--script FILE] [--autopilot] [--profile FILE]\n"
+           "       [--record FILE] [--hash-interval N] [--replay FILE] [--events FILE]\n"
+           "       [--threads N] [--leaderboard FILE]\n"
+           "       [--width N] [--height N] [--max-bullets N] [--max-enemies N] [--max-items N]\n"
+           "       [--max-explosions N] [--config FILE]\n", program);
+}
+
+// 重放录像：按录像的种子和输入重新模拟，每 hash_interval 帧比对一次状态哈希
+static int RunReplay(const char* path) {
+    Replay replay;
+    if (!ReplayLoad(&replay, path)) {
+        fprintf(stderr, "failed to load replay: %s\n", path);
+        return 1;
+    }
+
+    // 按录制时的配置重建 (配置参数对回放无效)
+    if (GameConfigError(&replay.config) != NULL) {
+        fprintf(stderr, "replay has invalid config: %s\n", GameConfigError(&replay.config));
+        ReplayFree(&replay);
+        return 1;
+    }
+    GameState* game = CreateGame(&replay.config, replay.seed);
+    if (game == NULL) {
+        fprintf(stderr, "out of memory\n");
+        ReplayFree(&replay);
+        return 1;
+    }
+
+    ReplayCursor cursor;
+    ReplayCursorInit(&cursor);
+    long long frames = 0;
+    int checked = 0;
+    long long mismatch_frame = -1;
+
+    double start = PlatformNow();
+    GameInput input;
+    while (ReplayNextKeys(&replay, &cursor, &input.keys)) {
+        Update(game, &input);
+        frames++;
+
+        if (frames % replay.hash_interval == 0 && checked < replay.num_hashes) {
+            if (GameHash(game) != replay.hashes[checked]) {
+                mismatch_frame = frames;
+                break;
+            }
+            checked++;
+        }
+        if (game->player.lives <= 0) InitGame(game);
+    }
+    double elapsed = PlatformNow() - start;
+    DestroyGame(game);
+
+    printf("replay: %s (seed %llu)\n", path, replay.seed);
+    ConfigPrint(&replay.config, stdout);
+    printf("frames: %lld / %d\n", frames, replay.frames);
+    printf("elapsed: %.3f s\n", elapsed);
+    printf("frames/sec: %.0f\n", elapsed > 0 ? (double)frames / elapsed : 0.0);
+    printf("hash checks: %d / %d passed\n", checked, replay.num_hashes);
+    ReplayFree(&replay);
+
+    if (mismatch_frame >= 0) {
+        printf("DESYNC at frame %lld\n", mismatch_frame);
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    long long total_frames = 1000000;
+    unsigned long long seed = 1;
+    const char* script_path = NULL;
+    int autopilot = 0;
+    const char* profile_path = NULL;
+    const char* record_path = NULL;
+    const char* replay_path = NULL;
+    const char* events_path = NULL;
+    const char* leaderboard_path = NULL;
+    int threads = 0;
+    int hash_interval = REPLAY_DEFAULT_HASH_INTERVAL;
+    GameConfig config = DefaultGameConfig();
+    argc = ConfigParseArgs(&config, argc, argv);
+    if (argc < 0) return 1;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            total_frames = atoll(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--script") == 0 && i + 1 < argc) {
+            script_path = argv[++i];
+        } else if (strcmp(argv[i], "--autopilot") == 0) {
+            autopilot = 1;
+        } else if (strcmp(argv[i], "--profile") == 0 && i + 1 < argc) {
+            profile_path = argv[++i];
+        } else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            record_path = argv[++i];
+        } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replay_path = argv[++i];
+        } else if (strcmp(argv[i], "--hash-interval") == 0 && i + 1 < argc) {
+            hash_interval = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--events") == 0 && i + 1 < argc) {
+            events_path = argv[++i];
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--leaderboard") == 0 && i + 1 < argc) {
+            leaderboard_path = argv[++i];
+        } else {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (replay_path != NULL) {
+        return RunReplay(replay_path);
+    }
+
+    if (script_path != NULL) {
+        if (!LoadScript(script_path)) {
+            fprintf(stderr, "failed to load script: %s\n", script_path);
+            return 1;
+        }
+    } else {
+        UseDefaultScript();
+    }
+
+    GameState* game = CreateGame(&config, seed);
+    if (game == NULL || (autopilot && !AttachDangerField(game))) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    // 多线程 Update，结果与单线程逐位相同 (可以用 --record 录制后不带 --threads 回放校验)
+    JobPool* pool = NULL;
+    if (threads > 0) {
+        pool = JobPoolStart(threads);
+        if (pool == NULL || !AttachJobPool(game, pool)) {
+            fprintf(stderr, "failed to start %d threads\n", threads);
+            return 1;
+        }
+    }
+
+    EventLog* events = NULL;
+    if (events_path != NULL) {
+        const char* error;
+        events = EventLogOpen(events_path, config.width, config.height, &error);
+        if (events == NULL) {
+            fprintf(stderr, "failed to open event log %s: %s\n", events_path, error);
+            return 1;
+        }
+        if (!AttachEventRing(game, events, 0, 0)) {
+            fprintf(stderr, "out of memory\n");
+            return 1;
+        }
+        InitGame(game); // 从第一局的开始记录 (InitGame 不消耗随机数，与不记录时完全一致)
+    }
+
+    Replay replay;
+    ReplayInit(&replay, &config, seed, hash_interval);
+
+    int step = 0;
+    int step_frames = 0;
+    long long games = 0;
+    long long score_sum = 0;
+    int best_score = 0;
+    LeaderboardRecord* records = NULL; // --leaderboard：各局成绩，结束后一次追加
+    long long records_capacity = 0;
+
+    double start = PlatformNow();
+    for (long long frame = 0; frame < total_frames; frame++) {
+        GameInput input;
+        input.keys = autopilot ? AutopilotKeys(game) : script[step].keys;
+        if (++step_frames >= script[step].frames) {
+            step_frames = 0;
+            step = (step + 1) % script_length;
+        }
+
+        Update(game, &input);
+        if (record_path != NULL) ReplayRecord(&replay, game, input.keys);
+
+        // 本局结束：记录成绩后立即开始下一局
+        if (game->player.lives <= 0) {
+            games++;
+            score_sum += game->player.score;
+            if (game->player.score > best_score) best_score = game->player.score;
+            if (leaderboard_path != NULL) {
+                if (games > records_capacity) {
+                    records_capacity = records_capacity > 0 ? records_capacity * 2 : 64;
+                    records = (LeaderboardRecord*)realloc(records, sizeof(LeaderboardRecord) * records_capacity);
+                    if (records == NULL) {
+                        fprintf(stderr, "out of memory\n");
+                        return 1;
+                    }
+                }
+                records[games - 1] = LeaderboardRecordGame(game, seed);
+            }
+            if (frame + 1 < total_frames) InitGame(game);
+        }
+    }
+    double elapsed = PlatformNow() - start;
+
+    ConfigPrint(&config, stdout);
+    printf("frames: %lld\n", total_frames);
+    printf("elapsed: %.3f s\n", elapsed);
+    printf("frames/sec: %.0f\n", elapsed > 0 ? (double)total_frames / elapsed : 0.0);
+    printf("games finished: %lld\n", games);
+    if (games > 0) {
+        printf("best score: %d  mean score: %.1f\n", best_score, (double)score_sum / (double)games);
+    }
+    printf("final score: %d  lives: %d\n", game->player.score, game->player.lives);
+    DestroyGame(game); // 写入环中剩余的事件在这里写入日志
+    if (pool != NULL) {
+        JobPoolStats stats = JobPoolGetStats(pool);
+        double runs = stats.runs > 0 ? (double)stats.runs : 1;
+        printf("threads: %d, %.1f jobs/frame, %.2f steals/frame\n", JobPoolThreads(pool), (double)stats.jobs / runs,
+               (double)stats.steals / runs);
+        JobPoolStop(pool);
+    }
+
+    if (events != NULL) {
+        EventLogStats stats = EventLogGetStats(events);
+        printf("events: %s run %u, %lld records, %lld flushes (%.3f ms max), %lld dropped\n", events_path,
+               EventLogRun(events), stats.records, stats.flushes, stats.flush_max * 1e3, stats.dropped);
+        EventLogClose(events);
+    }
+
+    if (leaderboard_path != NULL) {
+        const char* error = "write failed";
+        Leaderboard* board = LeaderboardOpen(leaderboard_path, 1, &error);
+        int ok = board != NULL && LeaderboardAdd(board, records, (int)games);
+        if (ok) {
+            LeaderboardStats stats = LeaderboardGetStats(board);
+            printf("leaderboard: %s, %lld games added, %lld records, best %d\n", leaderboard_path, games,
+                   stats.records, LeaderboardBest(board));
+        }
+        LeaderboardClose(board);
+        free(records);
+        if (!ok) {
+            fprintf(stderr, "failed to record scores in %s: %s\n", leaderboard_path, error);
+            return 1;
+        }
+    }
+
+    if (record_path != NULL) {
+        if (!ReplaySave(&replay, record_path)) {
+            fprintf(stderr, "failed to write replay: %s\n", record_path);
+            return 1;
+        }
+        printf("recorded: %s (%d input bytes, %d hashes)\n", record_path, replay.runs_size, replay.num_hashes);
+    }
+    ReplayFree(&replay);
+
+    // 分阶段耗时 (需要 -DENABLE_PROFILER 编译)
+    if (profile_path != NULL && !PROF_DUMP(profile_path)) {
+        fprintf(stderr, PROFILER_ENABLED ? "failed to write profile: %s\n"
+                                         : "profiler disabled, rebuild with -DENABLE_PROFILER (%s)\n",
+                profile_path);
+        return 1;
+    }
+    return 0;
+}
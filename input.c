@@ -0,0 +1,73 @@
+#include <stddef.h>
+#include "input.h"
+#include "platform.h"
+#include "spsc.h"
+
+static SpscRing queue;
+static InputEvent queue_storage[INPUT_QUEUE_CAPACITY];
+static atomic_int running;
+static PlatformThread* input_thread = NULL;
+
+// 输入线程每次扫描后发布的按住状态。按住与否以它为准，不从事件重建：
+// 队列满时丢掉的松开事件不会让按键一直处于按住状态
+static atomic_uint held_keys;
+static InputStats stats;
+
+static void InputThreadMain(void* arg) {
+    (void)arg;
+    unsigned previous = 0;
+    while (atomic_load(&running)) {
+        unsigned keys = PlatformScanKeys(INPUT_SCAN_INTERVAL);
+        unsigned changed = keys ^ previous;
+        if (changed == 0) continue;
+
+        double now = PlatformNow();
+        for (unsigned bit = 1; bit <= changed; bit <<= 1) {
+            if (!(changed & bit)) continue;
+            InputEvent event = {now, bit, (keys & bit) != 0};
+            stats.events++;
+            if (!SpscPush(&queue, &event)) stats.dropped++;
+        }
+        atomic_store_explicit(&held_keys, keys, memory_order_release);
+        previous = keys;
+    }
+}
+
+int InputStart() {
+    SpscInit(&queue, queue_storage, INPUT_QUEUE_CAPACITY, sizeof(InputEvent));
+    atomic_store(&held_keys, 0);
+    stats.events = stats.dropped = 0;
+
+    atomic_store(&running, 1);
+    input_thread = PlatformThreadStart(InputThreadMain, NULL);
+    return input_thread != NULL;
+}
+
+void InputStop() {
+    if (input_thread == NULL) return;
+    atomic_store(&running, 0);
+    PlatformThreadJoin(input_thread);
+    input_thread = NULL;
+}
+
+unsigned InputDrain(double* first_press) {
+    unsigned tapped = 0;
+    double earliest = 0;
+
+    // 事件只用来找出期间按下过的键 (包括已经松开的点按) 和最早的按下时间
+    InputEvent event;
+    while (SpscPop(&queue, &event)) {
+        if (event.pressed) {
+            tapped |= event.key;
+            if (earliest == 0) earliest = event.time;
+        }
+    }
+
+    if (first_press != NULL) *first_press = earliest;
+    return atomic_load_explicit(&held_keys, memory_order_acquire) | tapped;
+}
+
+// 统计由输入线程写入，请在 InputStop 之后读取
+InputStats InputGetStats() {
+    return stats;
+}
@@ -0,0 +1,31 @@
+#ifndef INPUT_H
+#define INPUT_H
+
+// 输入线程：持续扫描键盘 (PlatformScanKeys)，把按键状态的变化作为带时间戳的按下/松开事件
+// 写入无锁队列，同时发布当前按住的按键掩码。模拟每一步调用 InputDrain 取出全部事件，
+// 不再受每帧只读一个字符和按键重复速度的限制，多个方向键同时按住即可斜向移动。
+
+#define INPUT_SCAN_INTERVAL 0.002   // 扫描间隔 (秒)
+#define INPUT_QUEUE_CAPACITY 256    // 事件队列容量 (2 的幂)
+
+typedef struct {
+    double time;      // PlatformNow() 时间戳
+    unsigned key;     // 单个 KEY_* 位
+    int pressed;      // 1=按下, 0=松开
+} InputEvent;
+
+typedef struct {
+    long long events;   // 产生的事件数
+    long long dropped;  // 队列满丢弃的事件数
+} InputStats;
+
+int InputStart();      // 成功返回 1
+void InputStop();
+
+// 取出自上次调用以来的所有事件，返回本步使用的按键掩码：
+// 当前按住的键 (输入线程发布的掩码，队列满丢掉事件也不会卡住按键)，加上期间按下又松开的键 (短于一步的点按也不会丢)。
+// first_press 不为 NULL 时写入其中最早的按下事件时间 (没有按下事件时写 0)
+unsigned InputDrain(double* first_press);
+InputStats InputGetStats();
+
+#endif
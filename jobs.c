@@ -0,0 +1,264 @@
+#include <stdlib.h>
+#include <string.h>
+#include "jobs.h"
+#include "platform.h"
+
+#define JOB_CACHE_LINE 64
+#define DEQUE_CAPACITY 256           // 2 的幂，不小于 JOB_GRAPH_MAX_JOBS：一次运行的任务不会让队列溢出
+#define IDLE_SPINS 64                // 找不到任务时先自旋的次数，之后开始休眠
+#define IDLE_SLEEP 0.00005
+
+_Static_assert(DEQUE_CAPACITY >= JOB_GRAPH_MAX_JOBS, "队列容量必须能放下整个任务图");
+
+// Chase-Lev 工作窃取队列：所有者在底部压入 / 弹出，其他线程在顶部窃取。
+// 下标只增不减，按容量取模；每次运行压入的任务总数不超过容量，因此不需要扩容
+typedef struct {
+    _Alignas(JOB_CACHE_LINE) atomic_long top;
+    _Alignas(JOB_CACHE_LINE) atomic_long bottom;
+    atomic_int slots[DEQUE_CAPACITY];
+} JobDeque;
+
+typedef struct {
+    JobPool* pool;
+    int index;
+    PlatformThread* thread;
+    _Alignas(JOB_CACHE_LINE) long long jobs;   // 只由本线程写
+    long long steals;
+} JobWorker;
+
+struct JobPool {
+    int threads;
+    JobDeque deques[JOB_MAX_WORKERS];
+    JobWorker workers[JOB_MAX_WORKERS];
+    _Alignas(JOB_CACHE_LINE) atomic_int generation;  // 每次 JobPoolRun 加一，唤醒工作线程
+    atomic_int running;
+    atomic_int active;                               // 正在参与本次运行的工作线程数
+    JobGraph* _Atomic graph;
+    long long runs;
+};
+
+// --- 双端队列 ---
+
+static void DequePush(JobDeque* deque, int job) {
+    long b = atomic_load_explicit(&deque->bottom, memory_order_relaxed);
+    atomic_store_explicit(&deque->slots[b & (DEQUE_CAPACITY - 1)], job, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&deque->bottom, b + 1, memory_order_relaxed);
+}
+
+// 所有者弹出最近压入的任务，队列空时返回 -1
+static int DequeTake(JobDeque* deque) {
+    long b = atomic_load_explicit(&deque->bottom, memory_order_relaxed) - 1;
+    atomic_store_explicit(&deque->bottom, b, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    long t = atomic_load_explicit(&deque->top, memory_order_relaxed);
+    if (t > b) {
+        atomic_store_explicit(&deque->bottom, b + 1, memory_order_relaxed);
+        return -1;
+    }
+    int job = atomic_load_explicit(&deque->slots[b & (DEQUE_CAPACITY - 1)], memory_order_relaxed);
+    if (t == b) {
+        // 只剩一个：与窃取者竞争
+        if (!atomic_compare_exchange_strong_explicit(&deque->top, &t, t + 1, memory_order_seq_cst,
+                                                     memory_order_relaxed)) {
+            job = -1;
+        }
+        atomic_store_explicit(&deque->bottom, b + 1, memory_order_relaxed);
+    }
+    return job;
+}
+
+// 其他线程窃取最早压入的任务，队列空或竞争失败时返回 -1
+static int DequeSteal(JobDeque* deque) {
+    long t = atomic_load_explicit(&deque->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    long b = atomic_load_explicit(&deque->bottom, memory_order_acquire);
+    if (t >= b) return -1;
+    int job = atomic_load_explicit(&deque->slots[t & (DEQUE_CAPACITY - 1)], memory_order_relaxed);
+    if (!atomic_compare_exchange_strong_explicit(&deque->top, &t, t + 1, memory_order_seq_cst,
+                                                 memory_order_relaxed)) {
+        return -1;
+    }
+    return job;
+}
+
+// --- 任务图 ---
+
+void JobGraphClear(JobGraph* graph) {
+    graph->count = 0;
+    graph->edges = 0;
+}
+
+int JobGraphAdd(JobGraph* graph, JobFn fn, void* context, int begin, int end) {
+    if (graph->count >= JOB_GRAPH_MAX_JOBS) return -1;
+    Job* job = &graph->jobs[graph->count];
+    job->fn = fn;
+    job->context = context;
+    job->begin = begin;
+    job->end = end;
+    job->dependencies = 0;
+    job->first_edge = -1;
+    return graph->count++;
+}
+
+int JobGraphDepend(JobGraph* graph, int before, int after) {
+    if (before < 0 || after < 0 || graph->edges >= JOB_GRAPH_MAX_EDGES) return 0;
+    int e = graph->edges++;
+    graph->edge_to[e] = after;
+    graph->edge_next[e] = graph->jobs[before].first_edge;
+    graph->jobs[before].first_edge = e;
+    graph->jobs[after].dependencies++;
+    return 1;
+}
+
+// --- 执行 ---
+
+static void RunJob(JobPool* pool, JobGraph* graph, int index, JobWorker* worker) {
+    Job* job = &graph->jobs[index];
+    job->fn(job->context, job->begin, job->end, worker->index);
+    worker->jobs++;
+
+    // 最后一个完成的前置任务负责放出后继任务 (acq_rel：后继任务能看到所有前置任务的写入)
+    for (int e = job->first_edge; e >= 0; e = graph->edge_next[e]) {
+        int next = graph->edge_to[e];
+        if (atomic_fetch_sub_explicit(&graph->jobs[next].pending, 1, memory_order_acq_rel) == 1) {
+            DequePush(&pool->deques[worker->index], next);
+        }
+    }
+    atomic_fetch_sub_explicit(&graph->remaining, 1, memory_order_release);
+}
+
+static int FindJob(JobPool* pool, JobWorker* worker) {
+    int job = DequeTake(&pool->deques[worker->index]);
+    if (job >= 0) return job;
+    for (int k = 1; k < pool->threads; k++) {
+        int victim = (worker->index + k) % pool->threads;
+        job = DequeSteal(&pool->deques[victim]);
+        if (job >= 0) {
+            worker->steals++;
+            return job;
+        }
+    }
+    return -1;
+}
+
+// 直到本次运行的任务全部完成
+static void WorkOn(JobPool* pool, JobGraph* graph, JobWorker* worker) {
+    int idle = 0;
+    while (atomic_load_explicit(&graph->remaining, memory_order_acquire) > 0) {
+        int job = FindJob(pool, worker);
+        if (job >= 0) {
+            RunJob(pool, graph, job, worker);
+            idle = 0;
+        } else if (++idle > IDLE_SPINS) {
+            PlatformSleep(IDLE_SLEEP);
+        }
+    }
+}
+
+static void WorkerMain(void* arg) {
+    JobWorker* worker = (JobWorker*)arg;
+    JobPool* pool = worker->pool;
+    int seen = atomic_load(&pool->generation);
+    int idle = 0;
+    while (atomic_load(&pool->running)) {
+        int generation = atomic_load_explicit(&pool->generation, memory_order_acquire);
+        if (generation == seen) {
+            if (++idle > IDLE_SPINS) PlatformSleep(IDLE_SLEEP);
+            continue;
+        }
+        seen = generation;
+        idle = 0;
+
+        // 先登记再取任务图：JobPoolRun 等 active 归零后才返回，任务图不会在使用中被改写
+        atomic_fetch_add(&pool->active, 1);
+        JobGraph* graph = atomic_load(&pool->graph);
+        if (graph != NULL) WorkOn(pool, graph, worker);
+        atomic_fetch_sub(&pool->active, 1);
+    }
+}
+
+JobPool* JobPoolStart(int threads) {
+    if (threads < 1) threads = 1;
+    if (threads > JOB_MAX_WORKERS) threads = JOB_MAX_WORKERS;
+    JobPool* pool = (JobPool*)PlatformAlignedAlloc(JOB_CACHE_LINE, sizeof(JobPool));
+    if (pool == NULL) return NULL;
+    memset(pool, 0, sizeof(JobPool));
+    pool->threads = threads;
+    for (int w = 0; w < JOB_MAX_WORKERS; w++) {
+        atomic_init(&pool->deques[w].top, 0);
+        atomic_init(&pool->deques[w].bottom, 0);
+    }
+    atomic_init(&pool->generation, 0);
+    atomic_init(&pool->running, 1);
+    atomic_init(&pool->active, 0);
+    atomic_init(&pool->graph, NULL);
+
+    for (int w = 0; w < threads; w++) {
+        pool->workers[w].pool = pool;
+        pool->workers[w].index = w;
+    }
+    for (int w = 1; w < threads; w++) {
+        pool->workers[w].thread = PlatformThreadStart(WorkerMain, &pool->workers[w]);
+        if (pool->workers[w].thread == NULL) {
+            pool->threads = w; // 已启动的线程照常退出
+            JobPoolStop(pool);
+            return NULL;
+        }
+    }
+    return pool;
+}
+
+void JobPoolStop(JobPool* pool) {
+    if (pool == NULL) return;
+    atomic_store(&pool->running, 0);
+    for (int w = 1; w < pool->threads; w++) PlatformThreadJoin(pool->workers[w].thread);
+    PlatformAlignedFree(pool);
+}
+
+int JobPoolThreads(const JobPool* pool) {
+    return pool->threads;
+}
+
+void JobPoolRun(JobPool* pool, JobGraph* graph) {
+    if (graph->count == 0) return;
+    for (int j = 0; j < graph->count; j++) {
+        atomic_store_explicit(&graph->jobs[j].pending, graph->jobs[j].dependencies, memory_order_relaxed);
+    }
+    atomic_store_explicit(&graph->remaining, graph->count, memory_order_relaxed);
+
+    JobWorker* self = &pool->workers[0];
+    for (int j = graph->count - 1; j >= 0; j--) {
+        if (graph->jobs[j].dependencies == 0) DequePush(&pool->deques[0], j); // 倒序压入，本线程按编号顺序取
+    }
+    atomic_store(&pool->graph, graph);
+    atomic_fetch_add_explicit(&pool->generation, 1, memory_order_release);
+
+    WorkOn(pool, graph, self);
+    atomic_store(&pool->graph, NULL);
+    // 还在 WorkOn 里的线程只差最后一次检查 remaining (可能正在休眠)
+    for (int spins = 0; atomic_load(&pool->active) > 0; spins++) {
+        if (spins > IDLE_SPINS) PlatformSleep(IDLE_SLEEP);
+    }
+    pool->runs++;
+}
+
+JobPoolStats JobPoolGetStats(JobPool* pool) {
+    JobPoolStats stats;
+    memset(&stats, 0, sizeof(stats));
+    stats.runs = pool->runs;
+    for (int w = 0; w < pool->threads; w++) {
+        stats.jobs += pool->workers[w].jobs;
+        stats.steals += pool->workers[w].steals;
+        stats.jobs_by_worker[w] = pool->workers[w].jobs;
+    }
+    return stats;
+}
+
+void JobPoolResetStats(JobPool* pool) {
+    pool->runs = 0;
+    for (int w = 0; w < pool->threads; w++) {
+        pool->workers[w].jobs = 0;
+        pool->workers[w].steals = 0;
+    }
+}
@@ -0,0 +1,65 @@
+#ifndef JOBS_H
+#define JOBS_H
+
+#include <stdatomic.h>
+
+// 任务图 + 工作窃取线程池
+//
+// 一帧的工作描述为任务图：每个任务是一个函数和一段范围 [begin, end)，任务之间用 JobGraphDepend 声明先后。
+// JobPoolRun 把没有前置任务的任务放进调用线程的队列，工作线程从自己队列的底部取任务，
+// 空闲时从其他线程队列的顶部窃取 (Chase-Lev 双端队列)；一个任务完成后，前置任务全部完成的后继任务
+// 放进完成它的线程的队列。调用线程作为 0 号工作线程一起执行，全部任务完成后返回。
+//
+// 任务由哪个线程执行取决于调度，结果不能依赖于此：需要按固定顺序生效的副作用请写进按任务 (或按工作线程)
+// 划分的缓冲，JobPoolRun 返回后再按固定顺序合并 (见 game.c 的多线程 Update)。
+// 空闲的工作线程先自旋、再以 PlatformSleep 轮询 (与 audio.c、spectator.c 相同)，不依赖条件变量。
+
+#define JOB_MAX_WORKERS 64
+#define JOB_GRAPH_MAX_JOBS 256
+#define JOB_GRAPH_MAX_EDGES 1024
+
+// worker 为执行该任务的工作线程编号 (0 为调用 JobPoolRun 的线程)，可用来选择按线程划分的临时缓冲
+typedef void (*JobFn)(void* context, int begin, int end, int worker);
+
+typedef struct {
+    JobFn fn;
+    void* context;
+    int begin, end;
+    int dependencies;            // 前置任务数 (构建时累加)
+    int first_edge;              // 后继任务链表，-1 结尾
+    atomic_int pending;          // 运行时尚未完成的前置任务数
+} Job;
+
+typedef struct {
+    int count;
+    int edges;
+    Job jobs[JOB_GRAPH_MAX_JOBS];
+    int edge_to[JOB_GRAPH_MAX_EDGES];
+    int edge_next[JOB_GRAPH_MAX_EDGES];
+    atomic_int remaining;        // 本次运行尚未完成的任务数
+} JobGraph;
+
+void JobGraphClear(JobGraph* graph);
+int JobGraphAdd(JobGraph* graph, JobFn fn, void* context, int begin, int end); // 返回任务编号，已满时返回 -1
+int JobGraphDepend(JobGraph* graph, int before, int after);                    // after 在 before 完成后才开始；成功返回 1
+
+typedef struct JobPool JobPool;
+
+typedef struct {
+    long long runs;
+    long long jobs;              // 执行的任务数
+    long long steals;            // 其中从其他线程窃取的任务数
+    long long jobs_by_worker[JOB_MAX_WORKERS];
+} JobPoolStats;
+
+// threads 为参与执行的线程总数 (含调用线程)，启动 threads - 1 个工作线程；无法创建线程时返回 NULL
+JobPool* JobPoolStart(int threads);
+void JobPoolStop(JobPool* pool);
+int JobPoolThreads(const JobPool* pool);
+
+// 执行整个任务图，全部完成后返回；同一时间只能有一个线程调用。任务图不能有环
+void JobPoolRun(JobPool* pool, JobGraph* graph);
+JobPoolStats JobPoolGetStats(JobPool* pool); // 请在两次 JobPoolRun 之间调用
+void JobPoolResetStats(JobPool* pool);
+
+#endif
@@ -0,0 +1,387 @@
+#include <math.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "leaderboard.h"
+#include "platform.h"
+
+#define INDEX_SUFFIX ".idx"
+#define SCAN_RECORDS 4096                // 补齐 / 重建索引时每次读入的记录数
+
+// 分数直方图：1024 以下每个分数一桶 (精确)，之后每个 2 的幂区间再细分 64 桶 (误差 < 1/64)
+#define SCORE_LINEAR 1024
+#define SCORE_LINEAR_BITS 10
+#define SCORE_SUB_BITS 6
+#define SCORE_SUB (1 << SCORE_SUB_BITS)
+#define SCORE_BUCKETS (SCORE_LINEAR + (31 - SCORE_LINEAR_BITS) * SCORE_SUB)
+
+// 索引文件 (整个文件就是这个结构，读写双方都直接映射)
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t record_bytes;
+    uint32_t top_k;
+    uint32_t dirty;                      // 正在更新；打开时仍为 1 说明上一个写入方中途退出
+    uint32_t top_count;
+    uint64_t data_bytes;                 // 已编入索引的数据文件长度 (含文件头)
+    uint64_t records;
+    uint64_t corrupt;
+    int64_t score_total;
+    uint8_t reserved[16];
+    LeaderboardRecord top[LEADERBOARD_TOP_K];
+    uint64_t histogram[SCORE_BUCKETS];
+} LeaderboardIndex;
+
+struct Leaderboard {
+    PlatformFile* data;                  // 只读打开时为 NULL
+    PlatformFile* index_file;
+    LeaderboardIndex* index;             // 映射的索引文件
+    int writable;
+};
+
+// --- 记录 ---
+
+static uint32_t RecordChecksum(const LeaderboardRecord* record) {
+    LeaderboardRecord copy = *record;
+    copy.checksum = 0;
+    const unsigned char* p = (const unsigned char*)&copy;
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < sizeof(copy); i++) {
+        h ^= p[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+LeaderboardRecord LeaderboardRecordGame(const GameState* game, unsigned long long seed) {
+    LeaderboardRecord record;
+    memset(&record, 0, sizeof(record));
+    record.score = game->player.score;
+    record.graze = game->player.graze_count;
+    record.frames = game->frame_count;
+    record.seed = seed;
+    record.timestamp = (int64_t)time(NULL);
+    return record;
+}
+
+// --- 索引 ---
+
+static int ScoreBucket(int32_t score) {
+    if (score < SCORE_LINEAR) return score < 0 ? 0 : score;
+
+    int octave = 30;
+    while (!((uint32_t)score >> octave)) octave--;
+    int sub = (int)(((uint32_t)score >> (octave - SCORE_SUB_BITS)) & (SCORE_SUB - 1));
+    return SCORE_LINEAR + (octave - SCORE_LINEAR_BITS) * SCORE_SUB + sub;
+}
+
+// 桶内最小的分数
+static int BucketLower(int bucket) {
+    if (bucket < SCORE_LINEAR) return bucket;
+
+    int octave = (bucket - SCORE_LINEAR) / SCORE_SUB + SCORE_LINEAR_BITS;
+    int sub = (bucket - SCORE_LINEAR) % SCORE_SUB;
+    return (1 << octave) + (sub << (octave - SCORE_SUB_BITS));
+}
+
+static void IndexRecord(LeaderboardIndex* index, const LeaderboardRecord* record) {
+    index->records++;
+    index->score_total += record->score;
+    index->histogram[ScoreBucket(record->score)]++;
+
+    // 插入前 K 名：同分的新记录排在旧记录之后
+    int count = (int)index->top_count;
+    if (count == LEADERBOARD_TOP_K && record->score <= index->top[count - 1].score) return;
+    int at = count;
+    while (at > 0 && index->top[at - 1].score < record->score) at--;
+    int moved = (count < LEADERBOARD_TOP_K ? count : LEADERBOARD_TOP_K - 1) - at;
+    memmove(&index->top[at + 1], &index->top[at], sizeof(LeaderboardRecord) * moved);
+    index->top[at] = *record;
+    if (count < LEADERBOARD_TOP_K) index->top_count++;
+}
+
+// 数据文件中完整记录的末尾 (半条记录不算)
+static long long AlignedEnd(long long size) {
+    long long header = (long long)sizeof(LeaderboardHeader);
+    if (size < header) return header;
+    return header + (size - header) / (long long)sizeof(LeaderboardRecord) * (long long)sizeof(LeaderboardRecord);
+}
+
+// 索引的每次更新：置 dirty 并等它落盘 -> 修改索引 -> 等整个索引落盘 -> 清除 dirty 并等它落盘。
+// 映射页写回磁盘的顺序不确定，所以每一步都同步等待；进程或系统在任何位置中断，
+// 磁盘上 (以及其他进程看到的) dirty 为 0 时索引一定是完整的。
+// dirty 用 volatile 写入并在前后加内存屏障，编译器不会把它和索引的修改重排
+#define INDEX_HEADER_BYTES offsetof(LeaderboardIndex, top)
+
+static void SetDirty(LeaderboardIndex* index, uint32_t dirty) {
+    atomic_thread_fence(memory_order_release);
+    *(volatile uint32_t*)&index->dirty = dirty;
+    atomic_thread_fence(memory_order_release);
+}
+
+static int BeginIndexUpdate(Leaderboard* board) {
+    SetDirty(board->index, 1);
+    return PlatformFileSyncMap(board->index_file, board->index, INDEX_HEADER_BYTES);
+}
+
+// 失败时保持 dirty，下一个可写打开会重建
+static int EndIndexUpdate(Leaderboard* board) {
+    if (!PlatformFileSyncMap(board->index_file, board->index, sizeof(LeaderboardIndex))) return 0;
+    SetDirty(board->index, 0);
+    return PlatformFileSyncMap(board->index_file, board->index, INDEX_HEADER_BYTES);
+}
+
+// 把 data_bytes 之后直到 end 的完整记录编入索引 (调用方持有排他锁并已置 dirty)
+static int ScanRecords(Leaderboard* board, long long end) {
+    LeaderboardIndex* index = board->index;
+    LeaderboardRecord* buffer = (LeaderboardRecord*)malloc(sizeof(LeaderboardRecord) * SCAN_RECORDS);
+    if (buffer == NULL) return 0;
+
+    int ok = 1;
+    while (ok && (long long)index->data_bytes < end) {
+        long long left = (end - (long long)index->data_bytes) / (long long)sizeof(LeaderboardRecord);
+        int count = left < SCAN_RECORDS ? (int)left : SCAN_RECORDS;
+        ok = PlatformFileRead(board->data, (long long)index->data_bytes, buffer, sizeof(LeaderboardRecord) * count);
+        for (int i = 0; ok && i < count; i++) {
+            if (buffer[i].checksum == RecordChecksum(&buffer[i])) {
+                IndexRecord(index, &buffer[i]);
+            } else {
+                index->corrupt++;
+            }
+        }
+        if (ok) index->data_bytes += sizeof(LeaderboardRecord) * (uint64_t)count;
+    }
+    free(buffer);
+    return ok;
+}
+
+// 补上已落盘但还没编入索引的记录 (调用方持有排他锁)
+static int CatchUp(Leaderboard* board, long long end) {
+    if ((long long)board->index->data_bytes >= end) return 1;
+    return BeginIndexUpdate(board) && ScanRecords(board, end) && EndIndexUpdate(board);
+}
+
+static int RebuildLocked(Leaderboard* board) {
+    LeaderboardIndex* index = board->index;
+    if (!BeginIndexUpdate(board)) return 0;
+    // dirty 之后的字段全部清零，dirty 本身保持为 1
+    size_t kept = offsetof(LeaderboardIndex, top_count);
+    memset((char*)index + kept, 0, sizeof(*index) - kept);
+    index->magic = LEADERBOARD_INDEX_MAGIC;
+    index->version = LEADERBOARD_VERSION;
+    index->record_bytes = sizeof(LeaderboardRecord);
+    index->top_k = LEADERBOARD_TOP_K;
+    index->data_bytes = sizeof(LeaderboardHeader);
+    return ScanRecords(board, AlignedEnd(PlatformFileSize(board->data))) && EndIndexUpdate(board);
+}
+
+static int IndexUsable(const LeaderboardIndex* index) {
+    return index->magic == LEADERBOARD_INDEX_MAGIC && index->version == LEADERBOARD_VERSION &&
+           index->record_bytes == sizeof(LeaderboardRecord) && index->top_k == LEADERBOARD_TOP_K;
+}
+
+// 数据文件头：新文件 (或创建时中途退出只写了一部分) 写入文件头，否则校验
+static int PrepareDataFile(PlatformFile* data, const char** error) {
+    LeaderboardHeader header;
+    if (PlatformFileSize(data) < (long long)sizeof(header)) {
+        memset(&header, 0, sizeof(header));
+        header.magic = LEADERBOARD_MAGIC;
+        header.version = LEADERBOARD_VERSION;
+        header.record_bytes = sizeof(LeaderboardRecord);
+        if (!PlatformFileResize(data, 0) || !PlatformFileWrite(data, 0, &header, sizeof(header)) ||
+            !PlatformFileSync(data)) {
+            *error = "cannot write data file header";
+            return 0;
+        }
+        return 1;
+    }
+    if (!PlatformFileRead(data, 0, &header, sizeof(header)) || header.magic != LEADERBOARD_MAGIC) {
+        *error = "not a leaderboard file";
+        return 0;
+    }
+    if (header.version != LEADERBOARD_VERSION || header.record_bytes != sizeof(LeaderboardRecord)) {
+        *error = "unsupported leaderboard version";
+        return 0;
+    }
+    return 1;
+}
+
+// --- 打开 / 关闭 ---
+
+static int OpenLocked(Leaderboard* board, const char** error) {
+    if (!PrepareDataFile(board->data, error)) return 0;
+
+    int fresh = PlatformFileSize(board->index_file) != (long long)sizeof(LeaderboardIndex);
+    if (fresh && !PlatformFileResize(board->index_file, sizeof(LeaderboardIndex))) {
+        *error = "cannot resize index file";
+        return 0;
+    }
+    board->index = (LeaderboardIndex*)PlatformFileMap(board->index_file, 0, sizeof(LeaderboardIndex), 0);
+    if (board->index == NULL) {
+        *error = "cannot map index file";
+        return 0;
+    }
+
+    long long end = AlignedEnd(PlatformFileSize(board->data));
+    int ok = fresh || !IndexUsable(board->index) || board->index->dirty || (long long)board->index->data_bytes > end
+                 ? RebuildLocked(board)
+                 : CatchUp(board, end);
+    if (!ok) *error = "cannot read data file";
+    return ok;
+}
+
+Leaderboard* LeaderboardOpen(const char* path, int writable, const char** error) {
+    const char* reason = NULL;
+    if (error == NULL) error = &reason;
+    size_t length = strlen(path);
+    char* index_path = (char*)malloc(length + sizeof(INDEX_SUFFIX));
+    Leaderboard* board = (Leaderboard*)calloc(1, sizeof(Leaderboard));
+    if (index_path == NULL || board == NULL) {
+        free(index_path);
+        free(board);
+        *error = "out of memory";
+        return NULL;
+    }
+    memcpy(index_path, path, length);
+    memcpy(index_path + length, INDEX_SUFFIX, sizeof(INDEX_SUFFIX));
+    board->writable = writable;
+    board->index_file = PlatformFileOpen(index_path, writable);
+    free(index_path);
+
+    int ok = board->index_file != NULL;
+    if (!ok) {
+        *error = writable ? "cannot open index file" : "no leaderboard index";
+    } else if (writable) {
+        board->data = PlatformFileOpen(path, 1);
+        ok = board->data != NULL && PlatformFileLock(board->index_file, 1);
+        if (!ok) {
+            *error = "cannot open or lock data file";
+        } else {
+            ok = OpenLocked(board, error);
+            PlatformFileUnlock(board->index_file);
+        }
+    } else if (PlatformFileSize(board->index_file) != (long long)sizeof(LeaderboardIndex)) {
+        ok = 0;
+        *error = "index has a different format (open writable to rebuild)";
+    } else {
+        board->index = (LeaderboardIndex*)PlatformFileMap(board->index_file, 0, sizeof(LeaderboardIndex), 0);
+        ok = board->index != NULL && board->index->magic == LEADERBOARD_INDEX_MAGIC;
+        if (!ok) *error = "cannot map index file";
+    }
+
+    if (!ok) {
+        LeaderboardClose(board);
+        return NULL;
+    }
+    return board;
+}
+
+void LeaderboardClose(Leaderboard* board) {
+    if (board == NULL) return;
+    PlatformFileUnmap(board->index, sizeof(LeaderboardIndex));
+    PlatformFileClose(board->index_file);
+    PlatformFileClose(board->data);
+    free(board);
+}
+
+// --- 写入 ---
+
+int LeaderboardAdd(Leaderboard* board, LeaderboardRecord* records, int count) {
+    if (!board->writable || count < 0) return 0;
+    for (int i = 0; i < count; i++) records[i].checksum = RecordChecksum(&records[i]);
+    if (!PlatformFileLock(board->index_file, 1)) return 0;
+
+    // 截掉上一个写入方中途退出留下的半条记录，补上已落盘但还没编入索引的记录
+    long long size = PlatformFileSize(board->data);
+    long long end = AlignedEnd(size);
+    int ok = size == end || PlatformFileResize(board->data, end);
+    if (ok) ok = (long long)board->index->data_bytes > end ? RebuildLocked(board) : CatchUp(board, end);
+
+    size_t bytes = sizeof(LeaderboardRecord) * (size_t)count;
+    if (ok && !(PlatformFileWrite(board->data, end, records, bytes) && PlatformFileSync(board->data))) {
+        PlatformFileResize(board->data, end);
+        ok = 0;
+    }
+    if (ok) ok = BeginIndexUpdate(board);
+    if (ok) {
+        LeaderboardIndex* index = board->index;
+        for (int i = 0; i < count; i++) IndexRecord(index, &records[i]);
+        index->data_bytes = (uint64_t)end + bytes;
+        ok = EndIndexUpdate(board);
+    }
+    PlatformFileUnlock(board->index_file);
+    return ok;
+}
+
+int LeaderboardRebuild(Leaderboard* board) {
+    if (!board->writable || !PlatformFileLock(board->index_file, 1)) return 0;
+    int ok = RebuildLocked(board);
+    PlatformFileUnlock(board->index_file);
+    return ok;
+}
+
+// --- 查询 (共享锁下读取映射的索引) ---
+
+int LeaderboardBest(Leaderboard* board) {
+    if (!PlatformFileLock(board->index_file, 0)) return 0;
+    int best = board->index->top_count > 0 ? board->index->top[0].score : 0;
+    PlatformFileUnlock(board->index_file);
+    return best;
+}
+
+int LeaderboardTop(Leaderboard* board, LeaderboardRecord* out, int k) {
+    if (!PlatformFileLock(board->index_file, 0)) return 0;
+    int count = (int)board->index->top_count;
+    if (k < count) count = k < 0 ? 0 : k;
+    memcpy(out, board->index->top, sizeof(LeaderboardRecord) * (size_t)count);
+    PlatformFileUnlock(board->index_file);
+    return count;
+}
+
+int LeaderboardScoreAtPercentile(Leaderboard* board, double percent) {
+    if (!PlatformFileLock(board->index_file, 0)) return 0;
+    const LeaderboardIndex* index = board->index;
+    int score = 0;
+    if (index->records > 0) {
+        double wanted = ceil(percent / 100.0 * (double)index->records);
+        uint64_t target = wanted < 1.0 ? 1 : wanted > (double)index->records ? index->records : (uint64_t)wanted;
+        uint64_t seen = 0;
+        for (int b = 0; b < SCORE_BUCKETS; b++) {
+            seen += index->histogram[b];
+            if (seen >= target) {
+                score = BucketLower(b);
+                break;
+            }
+        }
+    }
+    PlatformFileUnlock(board->index_file);
+    return score;
+}
+
+double LeaderboardPercentileOfScore(Leaderboard* board, int score) {
+    if (!PlatformFileLock(board->index_file, 0)) return 0.0;
+    const LeaderboardIndex* index = board->index;
+    uint64_t below = 0;
+    int bucket = ScoreBucket(score);
+    for (int b = 0; b < bucket; b++) below += index->histogram[b];
+    double percent = index->records > 0 ? (double)below * 100.0 / (double)index->records : 0.0;
+    PlatformFileUnlock(board->index_file);
+    return percent;
+}
+
+LeaderboardStats LeaderboardGetStats(Leaderboard* board) {
+    LeaderboardStats stats;
+    memset(&stats, 0, sizeof(stats));
+    if (!PlatformFileLock(board->index_file, 0)) return stats;
+    const LeaderboardIndex* index = board->index;
+    stats.records = (long long)index->records;
+    stats.corrupt = (long long)index->corrupt;
+    stats.data_bytes = (long long)index->data_bytes;
+    stats.score_total = index->score_total;
+    stats.stale = index->dirty != 0 || !IndexUsable(index);
+    PlatformFileUnlock(board->index_file);
+    return stats;
+}
@@ -0,0 +1,72 @@
+#ifndef LEADERBOARD_H
+#define LEADERBOARD_H
+
+#include <stdint.h>
+#include "game.h"
+
+// 排行榜：记录每一局结束时的成绩 (分数、擦弹数、存活帧数、种子、时间)，取代只存一个整数的 highscore.txt
+//
+// 两个文件：
+//   数据文件 (path)          LeaderboardHeader (64 字节) | LeaderboardRecord[] (每条 32 字节)，只追加
+//   索引文件 (path + ".idx") 定长，内存映射：记录数、按分数排列的前 LEADERBOARD_TOP_K 名、分数直方图
+//
+// 写入方对索引文件加排他的建议锁 (见 PlatformFileLock)，把一批记录用一次写入追加到数据文件末尾、落盘，
+// 再更新索引；查询只加共享锁读取映射的索引，前 K 名和百分位与总记录数无关，都在微秒级。
+// 每条记录带校验和：进程在写入途中退出留下的半条记录，下一个写入方会截掉；校验和不符的记录不计入索引。
+// 索引只是数据文件的摘要：更新时先置 dirty 并落盘，改完后整个索引落盘再清除 dirty (见 PlatformFileSyncMap)；
+// 打开时发现 dirty、与数据文件对不上或数据文件后面还有没编入的记录，就从数据文件补齐或重建。
+//
+// 文件为本机字节序，不是跨平台的交换格式。
+
+#define LEADERBOARD_MAGIC 0x44524C50u          // "PLRD"
+#define LEADERBOARD_INDEX_MAGIC 0x58494C50u    // "PLIX"
+#define LEADERBOARD_VERSION 1
+#define LEADERBOARD_TOP_K 100
+#define LEADERBOARD_DEFAULT_PATH "leaderboard.dat"
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t record_bytes;       // sizeof(LeaderboardRecord)
+    uint8_t reserved[52];
+} LeaderboardHeader;
+
+typedef struct {
+    int32_t score;
+    int32_t graze;
+    int32_t frames;              // 存活帧数
+    uint32_t checksum;           // 本条记录的 FNV-1a (计算时此字段为 0)，由 LeaderboardAdd 填写
+    uint64_t seed;               // 开局种子 (可以用 headless --seed 重放同一局)
+    int64_t timestamp;           // 结束时刻 (Unix 秒)
+} LeaderboardRecord;
+
+typedef struct Leaderboard Leaderboard;
+
+typedef struct {
+    long long records;           // 已编入索引的有效记录数
+    long long corrupt;           // 校验和不符而跳过的记录数
+    long long data_bytes;        // 索引覆盖到的数据文件长度
+    long long score_total;       // 全部有效记录的分数之和
+    int stale;                   // 索引的上次更新中途退出 (只读打开不会修复，结果可能不完整)
+} LeaderboardStats;
+
+// 打开 path 对应的排行榜。writable 时不存在则创建，并在排他锁下补齐或重建索引；
+// 只读打开只映射索引 (不读数据文件，不增加启动时间)，索引不存在时失败。失败返回 NULL，*error 为原因
+Leaderboard* LeaderboardOpen(const char* path, int writable, const char** error);
+void LeaderboardClose(Leaderboard* board);
+
+// 填好校验和后把 count 条记录一次追加并更新索引 (需要可写打开)，成功返回 1
+int LeaderboardAdd(Leaderboard* board, LeaderboardRecord* records, int count);
+// 从数据文件重新生成索引 (需要可写打开)，成功返回 1
+int LeaderboardRebuild(Leaderboard* board);
+
+// 一局结束时的成绩，时间取当前时刻
+LeaderboardRecord LeaderboardRecordGame(const GameState* game, unsigned long long seed);
+
+int LeaderboardBest(Leaderboard* board);                            // 最高分，没有记录时为 0
+int LeaderboardTop(Leaderboard* board, LeaderboardRecord* out, int k); // 前 k 名 (分数从高到低，同分先记录的在前)，返回条数
+int LeaderboardScoreAtPercentile(Leaderboard* board, double percent); // 不超过该分数的记录占 percent% 的最小分数
+double LeaderboardPercentileOfScore(Leaderboard* board, int score);  // 低于 score 的记录所占的百分比
+LeaderboardStats LeaderboardGetStats(Leaderboard* board);
+
+#endif
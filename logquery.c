@@ -0,0 +1,201 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "eventlog.h"
+#include "game.h"
+#include "platform.h"
+
+// 事件日志查询：logquery FILE [--run N] [--heatmap-width W]
+// 按 SCAN_WINDOW_BYTES 逐段只读映射日志并顺序扫描一遍，汇总各类敌机的生成数、击毁率、撞机和击中次数，
+// 各局的最终分数，以及擦弹位置的热力图。内层循环对每条记录做同样的计数 (没有按事件类型的分支)，
+// 不符合 --run 的记录以 0 计入，扫描速度只受内存带宽限制。
+
+#define SCAN_WINDOW_BYTES (256LL << 20)
+#define TYPE_SLOTS 16                    // 覆盖 GameEventType (低 4 位)
+#define ENEMY_SLOTS (ENEMY_TYPE_COUNT + 1) // 第 0 列为 "无关或未知"
+#define DEFAULT_HEATMAP_WIDTH 80
+
+typedef struct {
+    long long counts[TYPE_SLOTS][ENEMY_SLOTS];
+    long long points[TYPE_SLOTS][ENEMY_SLOTS]; // score_delta 之和
+    long long scanned;                   // 扫描的记录数 (含被 --run 过滤掉的)
+    long long* heat;                     // 擦弹位置，width * height
+    int width, height;
+} Summary;
+
+// 对 count 条记录计数；run 为 0 时统计全部运行
+static void ScanRecords(Summary* s, const GameEventRecord* records, long long count, uint32_t run) {
+    int max_x = s->width - 1, max_y = s->height - 1;
+    for (long long i = 0; i < count; i++) {
+        const GameEventRecord* r = &records[i];
+        int keep = (run == 0) | (r->run == run);
+        int type = r->type & (TYPE_SLOTS - 1);
+        unsigned enemy = (unsigned)(r->enemy_type + 1);
+        enemy = enemy < ENEMY_SLOTS ? enemy : 0;  // 越界的类型 (损坏或更新版本的日志) 记为未知
+        s->counts[type][enemy] += keep;
+        s->points[type][enemy] += (long long)r->score_delta * keep;
+
+        int x = (int)r->x, y = (int)r->y;
+        x = x < 0 ? 0 : x > max_x ? max_x : x;
+        y = y < 0 ? 0 : y > max_y ? max_y : y;
+        s->heat[(size_t)y * s->width + x] += keep & (type == EVENT_GRAZE);
+    }
+    s->scanned += count;
+}
+
+static long long SumType(const long long table[TYPE_SLOTS][ENEMY_SLOTS], int type) {
+    long long n = 0;
+    for (int e = 0; e < ENEMY_SLOTS; e++) n += table[type][e];
+    return n;
+}
+
+// 把 width * height 的热力图缩到不超过 columns 列 (行按同样的比例)，用字符深浅表示擦弹次数 (对数刻度)
+static void PrintHeatmap(const Summary* s, int columns) {
+    static const char shades[] = " .:-=+*#%@";
+    int levels = (int)sizeof(shades) - 2;
+    int scale = (s->width + columns - 1) / columns;
+    int cols = (s->width + scale - 1) / scale, rows = (s->height + scale - 1) / scale;
+
+    long long* cells = (long long*)calloc((size_t)cols * rows, sizeof(long long));
+    if (cells == NULL) return;
+    long long peak = 0;
+    for (int y = 0; y < s->height; y++) {
+        for (int x = 0; x < s->width; x++) {
+            long long* cell = &cells[(size_t)(y / scale) * cols + x / scale];
+            *cell += s->heat[(size_t)y * s->width + x];
+            if (*cell > peak) peak = *cell;
+        }
+    }
+
+    printf("\ngraze heatmap (%dx%d cells per char, peak %lld)\n+", scale, scale, peak);
+    for (int x = 0; x < cols; x++) putchar('-');
+    printf("+\n");
+    for (int y = 0; y < rows; y++) {
+        putchar('|');
+        for (int x = 0; x < cols; x++) {
+            long long v = cells[(size_t)y * cols + x];
+            int level = v == 0 ? 0 : peak <= 1 ? levels : 1 + (int)(log((double)v) / log((double)peak) * (levels - 1));
+            putchar(shades[level]);
+        }
+        printf("|\n");
+    }
+    putchar('+');
+    for (int x = 0; x < cols; x++) putchar('-');
+    printf("+\n");
+    free(cells);
+}
+
+static void PrintReport(const Summary* s, const EventLogHeader* header, uint32_t run) {
+    const EnemyArchetype* archetypes = DefaultEnemyArchetypes();
+    if (run == 0) printf("runs: %u (all)  ", header->runs);
+    else printf("run: %u of %u  ", run, header->runs);
+    printf("area: %dx%d\n", header->width, header->height);
+
+    long long games = SumType(s->counts, EVENT_GAME_START), over = SumType(s->counts, EVENT_GAME_OVER);
+    printf("games: %lld  game over: %lld", games, over);
+    if (over > 0) printf("  mean final score: %.1f", (double)SumType(s->points, EVENT_GAME_OVER) / (double)over);
+    printf("\ngrazes: %lld  life pickups: %lld  power pickups: %lld\n", SumType(s->counts, EVENT_GRAZE),
+           SumType(s->counts, EVENT_PICKUP_LIFE), SumType(s->counts, EVENT_PICKUP_POWER));
+
+    printf("\n%-8s %9s %9s %9s %8s %8s %8s %10s\n", "enemy", "spawned", "killed", "kill rate", "crashes", "hits",
+           "grazes", "points");
+    for (int t = 0; t < ENEMY_TYPE_COUNT; t++) {
+        long long spawned = s->counts[EVENT_SPAWN][t + 1], killed = s->counts[EVENT_KILL][t + 1];
+        printf("%-8s %9lld %9lld %8.1f%% %8lld %8lld %8lld %10lld\n", archetypes[t].name, spawned, killed,
+               spawned > 0 ? 100.0 * (double)killed / (double)spawned : 0.0, s->counts[EVENT_CRASH][t + 1],
+               s->counts[EVENT_HIT][t + 1], s->counts[EVENT_GRAZE][t + 1], s->points[EVENT_KILL][t + 1]);
+    }
+}
+
+static void PrintUsage(const char* program) {
+    printf("usage: %s FILE [--run N] [--heatmap-width W]\n", program);
+}
+
+int main(int argc, char** argv) {
+    const char* path = NULL;
+    uint32_t run = 0;
+    int heatmap_width = DEFAULT_HEATMAP_WIDTH;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--run") == 0 && i + 1 < argc) {
+            run = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--heatmap-width") == 0 && i + 1 < argc) {
+            heatmap_width = atoi(argv[++i]);
+        } else if (argv[i][0] != '-' && path == NULL) {
+            path = argv[i];
+        } else {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (path == NULL || heatmap_width < 1) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    PlatformFile* file = PlatformFileOpen(path, 0);
+    if (file == NULL) {
+        fprintf(stderr, "failed to open %s\n", path);
+        return 1;
+    }
+    long long size = PlatformFileSize(file);
+    EventLogHeader* mapped = size >= (long long)sizeof(EventLogHeader)
+        ? (EventLogHeader*)PlatformFileMap(file, 0, sizeof(EventLogHeader), 0) : NULL;
+    if (mapped == NULL || mapped->magic != EVENTLOG_MAGIC || mapped->version != EVENTLOG_VERSION ||
+        mapped->record_bytes != sizeof(GameEventRecord) || mapped->width < 1 || mapped->height < 1) {
+        fprintf(stderr, "not an event log: %s\n", path);
+        PlatformFileUnmap(mapped, sizeof(EventLogHeader));
+        PlatformFileClose(file);
+        return 1;
+    }
+    EventLogHeader header = *mapped;
+    PlatformFileUnmap(mapped, sizeof(EventLogHeader));
+
+    // 只读已提交的记录 (写入方可能仍在运行)
+    long long records = (long long)header.records;
+    long long available = (size - (long long)sizeof(EventLogHeader)) / (long long)sizeof(GameEventRecord);
+    if (records > available) records = available;
+
+    Summary summary;
+    memset(&summary, 0, sizeof(summary));
+    summary.width = header.width;
+    summary.height = header.height;
+    summary.heat = (long long*)calloc((size_t)header.width * header.height, sizeof(long long));
+    if (summary.heat == NULL) {
+        fprintf(stderr, "out of memory\n");
+        PlatformFileClose(file);
+        return 1;
+    }
+
+    // 窗口从 0 开始按 SCAN_WINDOW_BYTES 对齐，文件头和记录都不会跨越窗口
+    long long end = (long long)sizeof(EventLogHeader) + records * (long long)sizeof(GameEventRecord);
+    int failed = 0;
+    double start = PlatformNow();
+    for (long long offset = 0; offset < end; offset += SCAN_WINDOW_BYTES) {
+        size_t length = (size_t)(end - offset < SCAN_WINDOW_BYTES ? end - offset : SCAN_WINDOW_BYTES);
+        const unsigned char* window = (const unsigned char*)PlatformFileMap(file, offset, length, 1);
+        if (window == NULL) {
+            failed = 1;
+            break;
+        }
+        size_t skip = offset == 0 ? sizeof(EventLogHeader) : 0;
+        ScanRecords(&summary, (const GameEventRecord*)(window + skip),
+                    (long long)((length - skip) / sizeof(GameEventRecord)), run);
+        PlatformFileUnmap((void*)window, length);
+    }
+    double elapsed = PlatformNow() - start;
+    PlatformFileClose(file);
+    if (failed) {
+        fprintf(stderr, "failed to map %s\n", path);
+        free(summary.heat);
+        return 1;
+    }
+
+    double bytes = (double)summary.scanned * sizeof(GameEventRecord);
+    printf("log: %s  records: %lld  scanned in %.3f s (%.2f GB/s)\n", path, summary.scanned, elapsed,
+           elapsed > 0 ? bytes / elapsed / 1e9 : 0.0);
+    PrintReport(&summary, &header, run);
+    PrintHeatmap(&summary, heatmap_width);
+    free(summary.heat);
+    return 0;
+}
@@ -0,0 +1,157 @@
+#include <math.h>
+#include "pattern.h"
+
+// 正弦表的前四分之一圈 (0..90 度)，Q16.16：round(sin(i * 2pi / 256) * 65536)
+static const int32_t quarter_sine[PATTERN_ANGLES / 4 + 1] = {
+    0, 1608, 3216, 4821, 6424, 8022, 9616, 11204,
+    12785, 14359, 15924, 17479, 19024, 20557, 22078, 23586,
+    25080, 26558, 28020, 29466, 30893, 32303, 33692, 35062,
+    36410, 37736, 39040, 40320, 41576, 42806, 44011, 45190,
+    46341, 47464, 48559, 49624, 50660, 51665, 52639, 53581,
+    54491, 55368, 56212, 57022, 57798, 58538, 59244, 59914,
+    60547, 61145, 61705, 62228, 62714, 63162, 63572, 63944,
+    64277, 64571, 64827, 65043, 65220, 65358, 65457, 65516,
+    65536,
+};
+
+#if PHYSICS_FIXED_POINT
+#define Q16_TO_REAL(v) ((Real)(v))
+#else
+#define Q16_TO_REAL(v) ((Real)(v) / 65536.0)
+#endif
+
+Real PatternSin(int angle) {
+    int a = angle & (PATTERN_ANGLES - 1);
+    int quarter = PATTERN_ANGLES / 4;
+    int32_t v;
+    if (a <= quarter) v = quarter_sine[a];
+    else if (a <= 2 * quarter) v = quarter_sine[2 * quarter - a];
+    else if (a <= 3 * quarter) v = -quarter_sine[a - 2 * quarter];
+    else v = -quarter_sine[4 * quarter - a];
+    return Q16_TO_REAL(v);
+}
+
+Real PatternCos(int angle) {
+    return PatternSin(angle + PATTERN_ANGLES / 4);
+}
+
+// --- 编译 ---
+
+static void SetDirection(PatternProgram* program, int k, Real speed, int angle) {
+    program->vx[k] = RMUL(speed, PatternCos(angle));
+    program->vy[k] = RMUL(speed, PatternSin(angle));
+}
+
+void PatternCompile(const PatternDef* def, PatternProgram* program) {
+    int n = def->count;
+    if (n > PATTERN_MAX_BULLETS) n = PATTERN_MAX_BULLETS;
+    if (def->kind == PATTERN_NONE || n < 0) n = 0;
+
+    program->count = n;
+    program->flags = 0;
+    program->spin = def->spin;
+    program->volleys = def->volleys > 1 ? def->volleys : 1;
+    program->volley_gap = def->volley_gap;
+    program->cooldown = def->cooldown;
+    program->cooldown_jitter = def->cooldown_jitter;
+
+    Real speed = R(def->speed);
+    for (int k = 0; k < n; k++) {
+        program->ox[k] = 0;
+        program->oy[k] = 0;
+        // 扇形中第 k 颗相对中心方向的偏角，左右对称
+        int offset = (2 * k - (n - 1)) * def->spread / 2;
+
+        switch (def->kind) {
+            case PATTERN_AIMED:
+            case PATTERN_BURST:
+                SetDirection(program, k, speed, offset); // 以 +x 为基准，发射时转向目标
+                break;
+            case PATTERN_N_WAY:
+                SetDirection(program, k, speed, def->angle + offset);
+                break;
+            case PATTERN_RING:
+            case PATTERN_SPIRAL:
+                SetDirection(program, k, speed, def->angle + k * PATTERN_ANGLES / n);
+                break;
+            case PATTERN_VECTORS:
+                program->vx[k] = R(def->vectors[k][0]);
+                program->vy[k] = R(def->vectors[k][1]);
+                break;
+            case PATTERN_LINE:
+                program->ox[k] = R((k - (n - 1) / 2.0) * def->spacing);
+                SetDirection(program, k, speed, def->angle);
+                break;
+            default:
+                break;
+        }
+    }
+
+    if (def->kind == PATTERN_AIMED || def->kind == PATTERN_BURST) program->flags |= PATTERN_AIM;
+    if (def->kind == PATTERN_SPIRAL) program->flags |= PATTERN_SPIN;
+}
+
+// --- 发射 ---
+
+// 指向 (dx, dy) 的单位向量，距离为 0 时返回 0
+// 定点模式用整数倒数平方根，结果在所有平台上逐位一致
+static int AimDirection(Real dx, Real dy, Real* c, Real* s) {
+#if PHYSICS_FIXED_POINT
+    RealSq dist_sq = RSQMUL(dx, dx) + RSQMUL(dy, dy);
+    if (dist_sq == 0) return 0;
+    Real inv_dist = FixedInvSqrt((uint64_t)dist_sq);
+    *c = RMUL(dx, inv_dist);
+    *s = RMUL(dy, inv_dist);
+#else
+    double dist = sqrt(dx*dx + dy*dy);
+    if (dist <= 0) return 0;
+    *c = dx/dist;
+    *s = dy/dist;
+#endif
+    return 1;
+}
+
+int PatternEmit(const PatternProgram* program, BulletLane* lane, Real x, Real y,
+                Real target_x, Real target_y, int shot, BulletFlags flags) {
+    if (program->count == 0) return 0;
+
+    // 整个模式绕发射点旋转 (c, s)
+    Real c = R(1), s = 0;
+    if (program->flags & PATTERN_AIM) {
+        if (!AimDirection(target_x - x, target_y - y, &c, &s)) return 0;
+    } else if (program->flags & PATTERN_SPIN) {
+        c = PatternCos(shot * program->spin);
+        s = PatternSin(shot * program->spin);
+    }
+
+    int first;
+    int n = BulletLaneReserve(lane, program->count, &first);
+    LaneReal* lx = lane->x + first;
+    LaneReal* ly = lane->y + first;
+    LaneReal* lvx = lane->vx + first;
+    LaneReal* lvy = lane->vy + first;
+
+    if (program->flags & (PATTERN_AIM | PATTERN_SPIN)) {
+        for (int k = 0; k < n; k++) {
+            lx[k] = (LaneReal)(x + RMUL(program->ox[k], c) - RMUL(program->oy[k], s));
+            ly[k] = (LaneReal)(y + RMUL(program->ox[k], s) + RMUL(program->oy[k], c));
+            lvx[k] = (LaneReal)(RMUL(program->vx[k], c) - RMUL(program->vy[k], s));
+            lvy[k] = (LaneReal)(RMUL(program->vx[k], s) + RMUL(program->vy[k], c));
+        }
+    } else {
+        for (int k = 0; k < n; k++) {
+            lx[k] = (LaneReal)(x + program->ox[k]);
+            ly[k] = (LaneReal)(y + program->oy[k]);
+            lvx[k] = (LaneReal)program->vx[k];
+            lvy[k] = (LaneReal)program->vy[k];
+        }
+    }
+    for (int k = 0; k < n; k++) lane->flags[first + k] = flags;
+    return n;
+}
+
+int PatternNextCooldown(const PatternProgram* program, int shot, Rng* rng) {
+    if ((shot + 1) % program->volleys != 0) return program->volley_gap;
+    if (program->cooldown_jitter <= 0) return program->cooldown;
+    return program->cooldown + RngRange(rng, program->cooldown_jitter);
+}
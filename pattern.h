@@ -0,0 +1,76 @@
+#ifndef PATTERN_H
+#define PATTERN_H
+
+#include "bullets.h"
+#include "rng.h"
+
+// 弹幕模式引擎：模式用 PatternDef 声明 (纯数据)，启动时编译成 PatternProgram，
+// 每颗子弹的相对位置和速度都预先算好；发射时只做一次旋转 (自机狙 / 旋转弹) 和平移，
+// 用 BulletLaneReserve 一次性写入子弹道，不再逐颗调用 SpawnBullet。
+//
+// 角度单位：一圈 PATTERN_ANGLES 份，0 指向 +x，PATTERN_ANGLES/4 指向 +y (屏幕向下)。
+// 方向取自预先算好的正弦表 (Q16.16 常数)，编译和发射都不调用 sin/cos，定点模式下结果逐位一致。
+
+#define PATTERN_ANGLES 256
+#define PATTERN_ANGLE_DOWN (PATTERN_ANGLES / 4)
+#define PATTERN_ANGLE_UP (PATTERN_ANGLES * 3 / 4)
+#define PATTERN_MAX_BULLETS 64   // 单次发射的子弹上限
+
+typedef enum {
+    PATTERN_NONE,       // 不发射
+    PATTERN_AIMED,      // 自机狙：count 颗以 spread 为间隔对准目标 (count = 1 即单发)
+    PATTERN_N_WAY,      // 固定方向的 n-way 扇形：以 angle 为中心、spread 为间隔
+    PATTERN_RING,       // 环形：count 颗均匀分布在一圈上，起始角 angle
+    PATTERN_SPIRAL,     // 旋转环：每次发射在 RING 的基础上再转 spin
+    PATTERN_BURST,      // 连发自机狙：每轮 volleys 次，间隔 volley_gap 帧
+    PATTERN_VECTORS,    // 显式速度列表 vectors[count]
+    PATTERN_LINE,       // 横排：count 颗间距 spacing、居中排开，都朝 angle 方向飞
+} PatternKind;
+
+typedef struct {
+    PatternKind kind;
+    int count;                     // 每次发射的子弹数
+    double speed;                  // 弹速 (格/帧)，VECTORS 不使用
+    int angle;                     // 中心方向 / 起始角
+    int spread;                    // 相邻子弹夹角
+    int spin;                      // SPIRAL：每次发射的旋转量
+    double spacing;                // LINE：相邻子弹的横向间距
+    int volleys;                   // 每轮发射次数 (0 视为 1)
+    int volley_gap;                // 同一轮内两次发射的间隔 (帧)
+    int cooldown;                  // 一轮结束后的冷却 = cooldown + 随机 [0, cooldown_jitter)
+    int cooldown_jitter;
+    const double (*vectors)[2];    // VECTORS：count 个 (vx, vy)
+} PatternDef;
+
+// 发射时需要的变换
+#define PATTERN_AIM  0x01  // 旋转到指向目标的方向
+#define PATTERN_SPIN 0x02  // 按发射次数旋转
+
+typedef struct {
+    int count;
+    int flags;                     // PATTERN_AIM / PATTERN_SPIN
+    int spin;
+    int volleys, volley_gap;
+    int cooldown, cooldown_jitter;
+    Real ox[PATTERN_MAX_BULLETS];  // 相对发射点的位置
+    Real oy[PATTERN_MAX_BULLETS];
+    Real vx[PATTERN_MAX_BULLETS];  // 速度 (AIM 模式下以 +x 为基准方向)
+    Real vy[PATTERN_MAX_BULLETS];
+} PatternProgram;
+
+// 编译模式，count 超过 PATTERN_MAX_BULLETS 时截断
+void PatternCompile(const PatternDef* def, PatternProgram* program);
+
+// 第 shot 次发射 (从 0 开始)：从 (x, y) 发射，AIM 模式对准 (target_x, target_y)，
+// 返回写入的子弹数 (子弹道满时可能少于 count；目标与发射点重合时不发射)
+int PatternEmit(const PatternProgram* program, BulletLane* lane, Real x, Real y,
+                Real target_x, Real target_y, int shot, BulletFlags flags);
+
+// 第 shot 次发射之后到下一次发射的帧数：同一轮内为 volley_gap，一轮结束时为 cooldown + 随机抖动
+int PatternNextCooldown(const PatternProgram* program, int shot, Rng* rng);
+
+// 查表得到 angle 方向的单位向量
+Real PatternCos(int angle);
+Real PatternSin(int angle);
+
+#endif
@@ -0,0 +1,703 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "config.h"
+#include "game.h"
+#include "platform.h"
+#include "profiler.h"
+#include "render.h"
+#include "snapshot.h"
+
+// 场景基准套件：perfsuite [--scenarios FILE] [--only NAME] [--frames F] [--warmup W] [--segment S] [--repeat N]
+//                         [--phases] [--json OUT] [--compare BASELINE] [--threshold PCT] [--min-us US] [--metric p50|mean|p99] [--gate-phases]
+// 每个场景按参数 (区域大小、两条子弹道的子弹数、每种原型的敌机数、道具数、爆炸数) 直接把实体放进各个池，
+// 预热 W 帧后逐帧分别计时 Update() 和绘制 (RenderWorld + RenderHud，不输出到终端)，
+// 用 -DENABLE_PROFILER 编译时还按阶段统计 (见 profiler.h)。
+// 每隔 S 帧 (默认 10，即爆炸的持续时间) 从快照恢复初始场景，实体数量在整个计时过程中保持稳定，
+// 每一段都是同样的工作量，结果可以在不同提交之间比较。
+// 每个场景完整运行 N 次 (默认 3)，每项统计取各次中的最小值，滤掉调度和其他进程造成的偶发变慢。
+//
+// --json 写出结果；--compare 读入之前写出的结果作为基线，任何场景的 Update 或绘制耗时 (--gate-phases 时含各阶段)
+// 比基线慢超过 --threshold 百分比 (且绝对差超过 --min-us)，或者基线里的场景这次没有运行 (--only 滤掉的除外)，
+// 就报告失败并以 1 退出，可以直接放进 CI。基线可以被重新排版 (只按键名读取结果行)。
+
+#define MAX_SCENARIOS 64
+#define SCENARIO_NAME_BYTES 32
+#define SCENARIO_LINE_BYTES 256
+#define SCENARIO_SEED 2024
+#define SCENARIO_LIVES 1000000
+#define MAX_RESULTS (MAX_SCENARIOS * (PROF_PHASE_COUNT + 2))
+#define DEFAULT_FRAMES 600
+#define DEFAULT_WARMUP 60
+#define DEFAULT_SEGMENT 10
+#define DEFAULT_REPEAT 3
+#define DEFAULT_THRESHOLD 10.0
+#define DEFAULT_MIN_US 1.0
+
+typedef struct {
+    char name[SCENARIO_NAME_BYTES];
+    int width, height;
+    int player_bullets, enemy_bullets;
+    int enemies[ENEMY_TYPE_COUNT];      // 每种原型的数量 (下标即类型)
+    int items, explosions;
+} Scenario;
+
+// 内置场景：默认区域的空场和常见局面，以及几种把单项负载推到极端的大场景
+static const Scenario builtin_scenarios[] = {
+    {"idle", 40, 25, 0, 0, {0, 0, 0}, 0, 0},
+    {"classic", 40, 25, 20, 40, {3, 2, 2}, 2, 3},
+    {"bullet_hell", 160, 80, 2000, 20000, {10, 10, 10}, 0, 10},
+    {"swarm", 200, 100, 500, 1000, {1000, 1000, 1000}, 50, 100},
+    {"effects", 120, 60, 0, 0, {0, 0, 0}, 2000, 2000},
+    {"large_mixed", 320, 160, 10000, 50000, {300, 300, 300}, 500, 500},
+};
+
+#define NUM_BUILTIN_SCENARIOS ((int)(sizeof(builtin_scenarios) / sizeof(builtin_scenarios[0])))
+
+// 一个场景的一项指标：Update、绘制或某个剖析阶段 (单位微秒)
+typedef struct {
+    char scenario[SCENARIO_NAME_BYTES];
+    char metric[SCENARIO_NAME_BYTES];
+    unsigned long long samples;
+    double mean, p50, p99, max;
+} SuiteResult;
+
+typedef struct {
+    int frames, warmup, segment;
+    int repeat;
+    int phases;                          // 在终端输出各阶段
+} SuiteOptions;
+
+// --- 场景文件 ---
+//
+//   [name]                 # 开始一个新场景，未写出的参数为 0 (区域默认 40x25)
+//   width = 160
+//   height = 80
+//   player-bullets = 2000
+//   enemy-bullets = 20000
+//   enemies = 10           # 每种原型各 10 架
+//   enemies.spread = 50    # 按原型名单独指定 (见 game.c 的原型表)
+//   items = 100
+//   explosions = 100
+
+typedef struct {
+    const char* name;
+    size_t offset;
+} ScenarioField;
+
+static const ScenarioField scenario_fields[] = {
+    {"width", offsetof(Scenario, width)},
+    {"height", offsetof(Scenario, height)},
+    {"player-bullets", offsetof(Scenario, player_bullets)},
+    {"enemy-bullets", offsetof(Scenario, enemy_bullets)},
+    {"items", offsetof(Scenario, items)},
+    {"explosions", offsetof(Scenario, explosions)},
+};
+
+#define NUM_SCENARIO_FIELDS ((int)(sizeof(scenario_fields) / sizeof(scenario_fields[0])))
+
+static int ParseCount(const char* text, int* value) {
+    char* end;
+    long v = strtol(text, &end, 10);
+    if (end == text || *end != '\0' || v < 0 || v > MAX_CAPACITY) return 0;
+    *value = (int)v;
+    return 1;
+}
+
+// 设置一个参数，key 不认识或值无效时返回 0
+static int SetScenarioValue(Scenario* s, const char* key, const char* text) {
+    int value;
+    if (!ParseCount(text, &value)) return 0;
+    for (int f = 0; f < NUM_SCENARIO_FIELDS; f++) {
+        if (strcmp(scenario_fields[f].name, key) == 0) {
+            memcpy((char*)s + scenario_fields[f].offset, &value, sizeof(int));
+            return 1;
+        }
+    }
+    if (strcmp(key, "enemies") == 0) {
+        for (int t = 0; t < ENEMY_TYPE_COUNT; t++) s->enemies[t] = value;
+        return 1;
+    }
+    const EnemyArchetype* archetypes = DefaultEnemyArchetypes();
+    for (int t = 0; t < ENEMY_TYPE_COUNT; t++) {
+        if (strncmp(key, "enemies.", 8) == 0 && strcmp(key + 8, archetypes[t].name) == 0) {
+            s->enemies[t] = value;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// 读入场景文件，返回场景数，出错返回 -1
+static int LoadScenarios(const char* path, Scenario* scenarios) {
+    FILE* file = fopen(path, "r");
+    if (file == NULL) {
+        fprintf(stderr, "perfsuite: cannot open %s\n", path);
+        return -1;
+    }
+
+    char line[SCENARIO_LINE_BYTES];
+    int number = 0, count = 0, ok = 1;
+    while (ok && fgets(line, sizeof(line), file) != NULL) {
+        number++;
+        char* comment = strchr(line, '#');
+        if (comment != NULL) *comment = '\0';
+        char* text = ConfigTrim(line);
+        if (*text == '\0') continue;
+
+        if (*text == '[') {
+            char* close = strchr(text, ']');
+            if (close == NULL || close == text + 1 || close - text > SCENARIO_NAME_BYTES || count == MAX_SCENARIOS) {
+                fprintf(stderr, "perfsuite: %s:%d: bad scenario header\n", path, number);
+                ok = 0;
+                break;
+            }
+            *close = '\0';
+            Scenario* s = &scenarios[count++];
+            memset(s, 0, sizeof(*s));
+            strcpy(s->name, text + 1);
+            s->width = DEFAULT_WIDTH;
+            s->height = DEFAULT_HEIGHT;
+            continue;
+        }
+
+        char* equals = strchr(text, '=');
+        if (count == 0 || equals == NULL) {
+            fprintf(stderr, "perfsuite: %s:%d: expected [name] or key = value\n", path, number);
+            ok = 0;
+            break;
+        }
+        *equals = '\0';
+        char* key = ConfigTrim(text);
+        char* value = ConfigTrim(equals + 1);
+        if (!SetScenarioValue(&scenarios[count - 1], key, value)) {
+            fprintf(stderr, "perfsuite: %s:%d: bad key or value '%s = %s'\n", path, number, key, value);
+            ok = 0;
+        }
+    }
+    fclose(file);
+    if (ok && count == 0) {
+        fprintf(stderr, "perfsuite: %s: no scenarios\n", path);
+        ok = 0;
+    }
+    return ok ? count : -1;
+}
+
+// --- 构造场景 ---
+
+static int ClampCapacity(long long value) {
+    return value > MAX_CAPACITY ? MAX_CAPACITY : (int)value;
+}
+
+// 容量按场景的实体数留出余量：敌机在一段内还会发射子弹、被击毁后掉落道具和产生爆炸
+static GameConfig ScenarioConfig(const Scenario* s) {
+    GameConfig config = DefaultGameConfig();
+    long long enemies = 64;
+    for (int t = 0; t < ENEMY_TYPE_COUNT; t++) enemies += s->enemies[t];
+    int bullets = s->player_bullets > s->enemy_bullets ? s->player_bullets : s->enemy_bullets;
+    config.width = s->width;
+    config.height = s->height;
+    config.max_bullets = ClampCapacity(2LL * bullets + 4096);
+    config.max_enemies = ClampCapacity(enemies);
+    config.max_items = ClampCapacity(s->items + enemies);
+    config.max_explosions = ClampCapacity(s->explosions + enemies);
+    return config;
+}
+
+// [lo, hi) 内的随机坐标，取 1/1024 的整数倍 (两种数值模式都能精确表示)
+static Real RandomReal(Rng* rng, double lo, double hi) {
+    return R(lo) + RMUL(RFromInt(RngRange(rng, (int)((hi - lo) * 1024))), R(1.0 / 1024));
+}
+
+// 按固定种子在全场随机放置实体：自机子弹以正常速度向上，敌弹缓慢散开，敌机在上半场，
+// 爆炸都从头开始 (一段之内不会消失)
+static void PlaceScenario(GameState* game, const Scenario* s) {
+    Rng rng;
+    RngSeed(&rng, SCENARIO_SEED);
+    double w = s->width, h = s->height;
+    game->player.lives = SCENARIO_LIVES;
+
+    for (int k = 0; k < s->player_bullets; k++) {
+        SpawnBullet(game, RandomReal(&rng, 1, w - 1), RandomReal(&rng, 1, h - 1), 0, R(-1.0), 0);
+    }
+    for (int k = 0; k < s->enemy_bullets; k++) {
+        SpawnEnemyBullet(game, RandomReal(&rng, 1, w - 1), RandomReal(&rng, 1, h - 1),
+                         RandomReal(&rng, -0.2, 0.2), RandomReal(&rng, -0.2, 0.4), RngRange(&rng, ENEMY_TYPE_COUNT));
+    }
+    for (int t = 0; t < ENEMY_TYPE_COUNT; t++) {
+        for (int k = 0; k < s->enemies[t]; k++) {
+            PlaceEnemy(game, t, RandomReal(&rng, 2, w - 2), RandomReal(&rng, 1, h * 0.6), 1 + RngRange(&rng, 40));
+        }
+    }
+    for (int k = 0; k < s->items; k++) {
+        SpawnItem(game, RandomReal(&rng, 1, w - 1), RandomReal(&rng, 1, h - 1), RngRange(&rng, 2));
+    }
+    for (int k = 0; k < s->explosions; k++) {
+        SpawnExplosion(game, RandomReal(&rng, 2, w - 2), RandomReal(&rng, 1, h - 2));
+    }
+}
+
+// --- 计时 ---
+
+static int CompareDouble(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// 逐帧样本 (微秒) 的精确统计，会把 samples 排序
+static SuiteResult SummarizeSamples(const char* scenario, const char* metric, double* samples, int count) {
+    SuiteResult r;
+    memset(&r, 0, sizeof(r));
+    snprintf(r.scenario, sizeof(r.scenario), "%s", scenario);
+    snprintf(r.metric, sizeof(r.metric), "%s", metric);
+    qsort(samples, count, sizeof(double), CompareDouble);
+    double total = 0;
+    for (int i = 0; i < count; i++) total += samples[i];
+    r.samples = (unsigned long long)count;
+    r.mean = total / count;
+    r.p50 = samples[count / 2];
+    r.p99 = samples[(int)(count * 0.99) < count ? (int)(count * 0.99) : count - 1];
+    r.max = samples[count - 1];
+    return r;
+}
+
+// 运行一个场景，把 update、draw 和各阶段的结果追加到 results，返回追加的个数，失败返回 -1。
+// live 输出计时帧的平均实体数
+static int RunScenario(const Scenario* s, const SuiteOptions* options, SuiteResult* results, double* live) {
+    GameConfig config = ScenarioConfig(s);
+    const char* error = GameConfigError(&config);
+    if (error != NULL) {
+        fprintf(stderr, "perfsuite: scenario %s: %s\n", s->name, error);
+        return -1;
+    }
+    GameState* game = CreateGame(&config, SCENARIO_SEED);
+    void* initial = malloc(SnapshotMaxBytes(&config));
+    double* update_us = (double*)malloc(sizeof(double) * options->frames);
+    double* draw_us = (double*)malloc(sizeof(double) * options->frames);
+    char hud[HUD_WIDTH + 1];
+    if (game == NULL || initial == NULL || update_us == NULL || draw_us == NULL) {
+        fprintf(stderr, "perfsuite: scenario %s: out of memory\n", s->name);
+        DestroyGame(game);
+        free(initial);
+        free(update_us);
+        free(draw_us);
+        return -1;
+    }
+    PlaceScenario(game, s);
+    SnapshotCapture(game, initial);
+
+    GameInput input = {0};
+    double entities = 0;
+    int total = options->warmup + options->frames;
+    for (int frame = 0; frame < total; frame++) {
+        if (frame % options->segment == 0) SnapshotRestore(game, initial);
+#if PROFILER_ENABLED
+        if (frame == options->warmup) ProfilerReset();
+#endif
+        double start = PlatformNow();
+        Update(game, &input);
+        double updated = PlatformNow();
+        RenderWorld(game, game->render_buffer);
+        PROF_BEGIN(PROF_DRAW_HUD);
+        RenderHud(game, hud, sizeof(hud));
+        PROF_END(PROF_DRAW_HUD);
+        double drawn = PlatformNow();
+
+        int k = frame - options->warmup;
+        if (k < 0) continue;
+        update_us[k] = (updated - start) * 1e6;
+        draw_us[k] = (drawn - updated) * 1e6;
+        entities += game->player_bullets.count + game->enemy_bullets.count + game->enemies.count +
+                    game->item_pool.count + game->explosion_pool.count;
+    }
+    *live = entities / options->frames;
+
+    int count = 0;
+    results[count++] = SummarizeSamples(s->name, "update", update_us, options->frames);
+    results[count++] = SummarizeSamples(s->name, "draw", draw_us, options->frames);
+#if PROFILER_ENABLED
+    for (int p = 0; p < PROF_PHASE_COUNT; p++) {
+        ProfilerPhaseStats stats = ProfilerGetPhase((ProfPhase)p);
+        if (stats.samples == 0) continue;
+        SuiteResult* r = &results[count++];
+        memcpy(r->scenario, s->name, sizeof(r->scenario));
+        snprintf(r->metric, sizeof(r->metric), "%s", stats.name);
+        r->samples = stats.samples;
+        r->mean = stats.mean;
+        r->p50 = stats.p50;
+        r->p99 = stats.p99;
+        r->max = stats.max;
+    }
+#endif
+
+    DestroyGame(game);
+    free(initial);
+    free(update_us);
+    free(draw_us);
+    return count;
+}
+
+static double Min(double a, double b) {
+    return a < b ? a : b;
+}
+
+// 运行 options->repeat 次，每项统计取最小值
+static int RunBestOf(const Scenario* s, const SuiteOptions* options, SuiteResult* results, double* live) {
+    SuiteResult run[PROF_PHASE_COUNT + 2];
+    int count = RunScenario(s, options, results, live);
+    for (int k = 1; k < options->repeat && count > 0; k++) {
+        if (RunScenario(s, options, run, live) != count) return -1;
+        for (int i = 0; i < count; i++) {
+            results[i].mean = Min(results[i].mean, run[i].mean);
+            results[i].p50 = Min(results[i].p50, run[i].p50);
+            results[i].p99 = Min(results[i].p99, run[i].p99);
+            results[i].max = Min(results[i].max, run[i].max);
+        }
+    }
+    return count;
+}
+
+// --- JSON 结果与基线比较 ---
+// results 每行一项，比较时逐行读回 (只需要认得本工具写出的格式)
+
+#define RESULT_ROW_FORMAT "{\"scenario\": \"%s\", \"metric\": \"%s\", \"samples\": %llu, " \
+                          "\"mean_us\": %.4f, \"p50_us\": %.4f, \"p99_us\": %.4f, \"max_us\": %.4f}"
+
+static const char* NumericMode() {
+#ifdef USE_FIXED_POINT
+    return "fixed";
+#else
+    return "double";
+#endif
+}
+
+static int WriteJson(const char* path, const SuiteOptions* options, const Scenario* scenarios, int num_scenarios,
+                     const SuiteResult* results, int num_results) {
+    FILE* file = fopen(path, "w");
+    if (file == NULL) {
+        fprintf(stderr, "perfsuite: cannot write %s\n", path);
+        return 0;
+    }
+    fprintf(file, "{\n  \"numeric\": \"%s\",\n  \"profiler\": %d,\n", NumericMode(), PROFILER_ENABLED);
+    fprintf(file, "  \"frames\": %d,\n  \"warmup\": %d,\n  \"segment\": %d,\n  \"repeat\": %d,\n", options->frames,
+            options->warmup, options->segment, options->repeat);
+    fprintf(file, "  \"scenarios\": [\n");
+    for (int i = 0; i < num_scenarios; i++) {
+        const Scenario* s = &scenarios[i];
+        fprintf(file, "    {\"name\": \"%s\", \"width\": %d, \"height\": %d, \"player_bullets\": %d, "
+                      "\"enemy_bullets\": %d, \"enemies\": [", s->name, s->width, s->height,
+                s->player_bullets, s->enemy_bullets);
+        for (int t = 0; t < ENEMY_TYPE_COUNT; t++) fprintf(file, "%s%d", t > 0 ? ", " : "", s->enemies[t]);
+        fprintf(file, "], \"items\": %d, \"explosions\": %d}%s\n", s->items, s->explosions,
+                i + 1 < num_scenarios ? "," : "");
+    }
+    fprintf(file, "  ],\n  \"results\": [\n");
+    for (int i = 0; i < num_results; i++) {
+        const SuiteResult* r = &results[i];
+        fprintf(file, "    " RESULT_ROW_FORMAT "%s\n", r->scenario, r->metric, r->samples, r->mean, r->p50,
+                r->p99, r->max, i + 1 < num_results ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+    fclose(file);
+    return 1;
+}
+
+// --- 读入基线 ---
+// 不依赖 WriteJson 的排版：逐个扫描不含嵌套 {} 的对象，按键名取值，缩进、换行和键的顺序都不影响。
+// 带 "scenario" 和 "metric" 的对象是结果行，其余对象 (场景参数) 忽略。
+
+static const char* SkipSpace(const char* p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) p++;
+    return p;
+}
+
+// 在 [begin, end) 中找到 "key": 后面的值，找不到返回 NULL
+static const char* FindJsonValue(const char* begin, const char* end, const char* key) {
+    size_t len = strlen(key);
+    for (const char* p = begin; p + len + 2 <= end; p++) {
+        if (p[0] != '"' || strncmp(p + 1, key, len) != 0 || p[len + 1] != '"') continue;
+        const char* value = SkipSpace(p + len + 2, end);
+        if (value < end && *value == ':') {
+            value = SkipSpace(value + 1, end);
+            return value < end ? value : NULL;
+        }
+    }
+    return NULL;
+}
+
+static int JsonString(const char* begin, const char* end, const char* key, char* out, size_t size) {
+    const char* value = FindJsonValue(begin, end, key);
+    if (value == NULL || *value != '"') return 0;
+    const char* close = memchr(value + 1, '"', (size_t)(end - value - 1));
+    if (close == NULL || (size_t)(close - value - 1) >= size) return 0;
+    memcpy(out, value + 1, (size_t)(close - value - 1));
+    out[close - value - 1] = '\0';
+    return 1;
+}
+
+// 文本以 '\0' 结尾，strtod 不会读出 end 之后的缓冲区
+static int JsonNumber(const char* begin, const char* end, const char* key, double* out) {
+    const char* value = FindJsonValue(begin, end, key);
+    if (value == NULL) return 0;
+    char* stop;
+    *out = strtod(value, &stop);
+    return stop > value && stop <= end;
+}
+
+// 读入整个文件，末尾补 '\0'；失败返回 NULL
+static char* ReadWholeFile(const char* path, size_t* size) {
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) return NULL;
+    char* text = NULL;
+    long length = fseek(file, 0, SEEK_END) == 0 ? ftell(file) : -1;
+    if (length >= 0 && fseek(file, 0, SEEK_SET) == 0) text = (char*)malloc((size_t)length + 1);
+    if (text != NULL && fread(text, 1, (size_t)length, file) != (size_t)length) {
+        free(text);
+        text = NULL;
+    }
+    fclose(file);
+    if (text != NULL) {
+        text[length] = '\0';
+        *size = (size_t)length;
+    }
+    return text;
+}
+
+// 读入基线的结果行，返回行数，出错返回 -1
+static int LoadBaseline(const char* path, SuiteResult* results, char* numeric, int numeric_size) {
+    size_t size;
+    char* text = ReadWholeFile(path, &size);
+    if (text == NULL) {
+        fprintf(stderr, "perfsuite: cannot open baseline %s\n", path);
+        return -1;
+    }
+    const char* end = text + size;
+    numeric[0] = '\0';
+    JsonString(text, end, "numeric", numeric, (size_t)numeric_size);
+
+    int count = 0, ok = 1;
+    for (const char* open = strchr(text, '{'); open != NULL && ok; ) {
+        const char* close = strpbrk(open + 1, "{}");
+        if (close == NULL) break;
+        if (*close == '{') { // 外层对象，继续找最内层
+            open = close;
+            continue;
+        }
+        if (FindJsonValue(open, close, "scenario") != NULL) {
+            SuiteResult* r = &results[count];
+            double samples;
+            ok = count < MAX_RESULTS && JsonString(open, close, "scenario", r->scenario, sizeof(r->scenario)) &&
+                 JsonString(open, close, "metric", r->metric, sizeof(r->metric)) &&
+                 JsonNumber(open, close, "samples", &samples) && JsonNumber(open, close, "mean_us", &r->mean) &&
+                 JsonNumber(open, close, "p50_us", &r->p50) && JsonNumber(open, close, "p99_us", &r->p99) &&
+                 JsonNumber(open, close, "max_us", &r->max);
+            if (!ok) {
+                fprintf(stderr, "perfsuite: %s: %s at byte %ld\n", path,
+                        count < MAX_RESULTS ? "malformed result" : "too many results", (long)(open - text));
+                break;
+            }
+            r->samples = (unsigned long long)samples;
+            count++;
+        }
+        open = strchr(close, '{');
+    }
+    free(text);
+    if (!ok) return -1;
+    if (count == 0) {
+        fprintf(stderr, "perfsuite: %s: no results\n", path);
+        return -1;
+    }
+    return count;
+}
+
+typedef enum { METRIC_P50, METRIC_MEAN, METRIC_P99 } CompareMetric;
+
+static double MetricValue(const SuiteResult* r, CompareMetric metric) {
+    return metric == METRIC_MEAN ? r->mean : metric == METRIC_P99 ? r->p99 : r->p50;
+}
+
+static int IsPhase(const SuiteResult* r) {
+    return strcmp(r->metric, "update") != 0 && strcmp(r->metric, "draw") != 0;
+}
+
+// 逐项与基线比较，输出变化并返回回退的项数
+static int CompareWithBaseline(const SuiteResult* current, int num_current, const SuiteResult* baseline,
+                               int num_baseline, CompareMetric metric, double threshold, double min_us,
+                               int gate_phases) {
+    static const char* metric_names[] = {"p50", "mean", "p99"};
+    int regressions = 0;
+    printf("\ncompare %s against baseline (threshold +%.1f%%, min %.2f us%s)\n", metric_names[metric], threshold,
+           min_us, gate_phases ? ", phases gated" : "");
+    printf("%-14s %-16s %12s %12s %9s\n", "scenario", "metric", "baseline us", "current us", "change");
+    for (int i = 0; i < num_current; i++) {
+        const SuiteResult* r = &current[i];
+        const SuiteResult* base = NULL;
+        for (int j = 0; j < num_baseline && base == NULL; j++) {
+            if (strcmp(baseline[j].scenario, r->scenario) == 0 && strcmp(baseline[j].metric, r->metric) == 0) {
+                base = &baseline[j];
+            }
+        }
+        if (base == NULL) {
+            printf("%-14s %-16s %12s %12.3f %9s\n", r->scenario, r->metric, "-", MetricValue(r, metric), "new");
+            continue;
+        }
+
+        double old_value = MetricValue(base, metric), new_value = MetricValue(r, metric);
+        double change = old_value > 0 ? (new_value - old_value) / old_value * 100.0 : 0.0;
+        int gated = gate_phases || !IsPhase(r);
+        int regressed = gated && new_value > old_value * (1.0 + threshold / 100.0) && new_value - old_value > min_us;
+        regressions += regressed;
+        if (IsPhase(r) && !regressed && !gate_phases) continue; // 只列出回退的阶段，避免刷屏
+        printf("%-14s %-16s %12.3f %12.3f %+8.1f%%%s\n", r->scenario, r->metric, old_value, new_value, change,
+               regressed ? "  REGRESSION" : "");
+    }
+    return regressions;
+}
+
+// 基线里有、这次却没有运行的场景 (--only 滤掉的除外) 算作失败：场景改名或漏跑不能被当成"没有回退"
+static int ReportMissingScenarios(const SuiteResult* current, int num_current, const SuiteResult* baseline,
+                                  int num_baseline, const char* only) {
+    int missing = 0;
+    for (int j = 0; j < num_baseline; j++) {
+        const SuiteResult* base = &baseline[j];
+        if (strcmp(base->metric, "update") != 0 || (only != NULL && strcmp(base->scenario, only) != 0)) continue;
+        int found = 0;
+        for (int i = 0; i < num_current && !found; i++) found = strcmp(current[i].scenario, base->scenario) == 0;
+        if (!found) {
+            printf("%-14s %-16s %12.3f %12s %9s\n", base->scenario, "update", base->p50, "-", "MISSING");
+            missing++;
+        }
+    }
+    return missing;
+}
+
+// --- 主程序 ---
+
+static void PrintPhases(const SuiteResult* results, int count) {
+    for (int i = 0; i < count; i++) {
+        if (!IsPhase(&results[i])) continue;
+        printf("    %-16s mean %9.3f  p50 %9.3f  p99 %9.3f us\n", results[i].metric, results[i].mean, results[i].p50,
+               results[i].p99);
+    }
+}
+
+static void PrintUsage(const char* program) {
+    fprintf(stderr,
+            "usage: %s [--scenarios FILE] [--only NAME] [--frames F] [--warmup W] [--segment S] [--repeat N]\n"
+            "       [--phases] [--json OUT] [--compare BASELINE] [--threshold PCT] [--min-us US] [--metric p50|mean|p99]\n"
+            "       [--gate-phases]\n",
+            program);
+}
+
+int main(int argc, char** argv) {
+    SuiteOptions options = {DEFAULT_FRAMES, DEFAULT_WARMUP, DEFAULT_SEGMENT, DEFAULT_REPEAT, 0};
+    const char *scenario_path = NULL, *only = NULL, *json_path = NULL, *baseline_path = NULL;
+    double threshold = DEFAULT_THRESHOLD, min_us = DEFAULT_MIN_US;
+    CompareMetric metric = METRIC_P50;
+    int gate_phases = 0;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        int has_value = i + 1 < argc;
+        if (strcmp(arg, "--phases") == 0) {
+            options.phases = 1;
+        } else if (strcmp(arg, "--gate-phases") == 0) {
+            gate_phases = 1;
+        } else if (!has_value) {
+            PrintUsage(argv[0]);
+            return 1;
+        } else if (strcmp(arg, "--scenarios") == 0) {
+            scenario_path = argv[++i];
+        } else if (strcmp(arg, "--only") == 0) {
+            only = argv[++i];
+        } else if (strcmp(arg, "--frames") == 0) {
+            options.frames = atoi(argv[++i]);
+        } else if (strcmp(arg, "--warmup") == 0) {
+            options.warmup = atoi(argv[++i]);
+        } else if (strcmp(arg, "--segment") == 0) {
+            options.segment = atoi(argv[++i]);
+        } else if (strcmp(arg, "--repeat") == 0) {
+            options.repeat = atoi(argv[++i]);
+        } else if (strcmp(arg, "--json") == 0) {
+            json_path = argv[++i];
+        } else if (strcmp(arg, "--compare") == 0) {
+            baseline_path = argv[++i];
+        } else if (strcmp(arg, "--threshold") == 0) {
+            threshold = atof(argv[++i]);
+        } else if (strcmp(arg, "--min-us") == 0) {
+            min_us = atof(argv[++i]);
+        } else if (strcmp(arg, "--metric") == 0) {
+            const char* name = argv[++i];
+            metric = strcmp(name, "mean") == 0 ? METRIC_MEAN : strcmp(name, "p99") == 0 ? METRIC_P99 : METRIC_P50;
+        } else {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (options.frames <= 0 || options.warmup < 0 || options.segment <= 0 || options.repeat <= 0 || threshold < 0) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    static Scenario scenarios[MAX_SCENARIOS];
+    int num_scenarios = NUM_BUILTIN_SCENARIOS;
+    if (scenario_path != NULL) {
+        num_scenarios = LoadScenarios(scenario_path, scenarios);
+        if (num_scenarios < 0) return 1;
+    } else {
+        memcpy(scenarios, builtin_scenarios, sizeof(builtin_scenarios));
+    }
+    if (only != NULL) {
+        int kept = 0;
+        for (int i = 0; i < num_scenarios; i++) {
+            if (strcmp(scenarios[i].name, only) == 0) scenarios[kept++] = scenarios[i];
+        }
+        if (kept == 0) {
+            fprintf(stderr, "perfsuite: no scenario named %s\n", only);
+            return 1;
+        }
+        num_scenarios = kept;
+    }
+
+    static SuiteResult results[MAX_RESULTS];
+    int num_results = 0;
+    printf("scenario suite: %d frames after %d warm-up, restore every %d, best of %d, %s physics%s\n",
+           options.frames, options.warmup, options.segment, options.repeat, NumericMode(), PROFILER_ENABLED ? ", profiler on" : "");
+    printf("%-14s %9s %9s %11s %11s %11s %11s\n", "scenario", "field", "entities", "update p50", "update p99",
+           "draw p50", "draw p99");
+    for (int i = 0; i < num_scenarios; i++) {
+        const Scenario* s = &scenarios[i];
+        double live;
+        int added = RunBestOf(s, &options, &results[num_results], &live);
+        if (added < 0) return 1;
+        const SuiteResult* update = &results[num_results];
+        const SuiteResult* draw = &results[num_results + 1];
+        char field[16];
+        snprintf(field, sizeof(field), "%dx%d", s->width, s->height);
+        printf("%-14s %9s %9.0f %11.2f %11.2f %11.2f %11.2f\n", s->name, field, live, update->p50, update->p99,
+               draw->p50, draw->p99);
+        if (options.phases) PrintPhases(&results[num_results], added);
+        num_results += added;
+    }
+    printf("(times in us)\n");
+
+    if (json_path != NULL && !WriteJson(json_path, &options, scenarios, num_scenarios, results, num_results)) return 1;
+    if (baseline_path == NULL) return 0;
+
+    static SuiteResult baseline[MAX_RESULTS];
+    char numeric[16];
+    int num_baseline = LoadBaseline(baseline_path, baseline, numeric, sizeof(numeric));
+    if (num_baseline < 0) return 1;
+    if (numeric[0] != '\0' && strcmp(numeric, NumericMode()) != 0) {
+        fprintf(stderr, "perfsuite: warning: baseline was built with %s physics, this build uses %s\n", numeric,
+                NumericMode());
+    }
+    int regressions = CompareWithBaseline(results, num_results, baseline, num_baseline, metric, threshold, min_us,
+                                          gate_phases);
+    int missing = ReportMissingScenarios(results, num_results, baseline, num_baseline, only);
+    if (regressions > 0) printf("%d regression(s) past +%.1f%%\n", regressions, threshold);
+    if (missing > 0) printf("%d baseline scenario(s) missing from this run\n", missing);
+    if (regressions > 0 || missing > 0) return 1;
+    printf("no regressions\n");
+    return 0;
+}
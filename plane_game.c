@@ -1,650 +1,316 @@
 #include <stdio.h>
 #include <stdlib.h>
-#include <conio.h>
-#include <windows.h>
+#include <string.h>
 #include <time.h>
-#include <math.h>
-
-// --- 游戏配置参数 ---
-#define WIDTH 40        // 游戏区域宽度
-#define HEIGHT 25       // 游戏区域高度
-#define MAX_BULLETS 100 // 最大子弹数
-#define MAX_ENEMIES 8   // 最大敌人数 (降低以改善平衡性)
-#define MAX_ITEMS 5     // 最大道具数
-#define MAX_EXPLOSIONS 10 // 最大爆炸效果数
-#define GRAZE_DISTANCE 1.0 // 擦弹判定距离
-#define INVINCIBLE_FRAMES 30 // 擦弹后无敌时间（帧数）
-
-// --- 数据结构 ---
-
-// 坐标结构 (使用浮点数是为了敌机子弹能计算角度)
-typedef struct {
-    double x, y;
-} Vec2;
-
-// 子弹结构
-typedef struct {
-    Vec2 pos;
-    Vec2 velocity; // 速度向量
-    int active;    // 是否激活
-    int is_enemy;  // 0: 自机子弹, 1: 敌机子弹
-} Bullet;
-
-// 敌机结构
-typedef struct {
-    Vec2 pos;
-    int active;
-    int cooldown;  // 发射冷却
-    int type;      // 敌机类型: 0=普通(自机狙), 1=直线机, 2=散射机
-} Enemy;
-
-// 道具结构
-typedef struct {
-    Vec2 pos;
-    int active;
-    int type;      // 0=生命恢复(H), 1=火力升级(P)
-} Item;
-
-// 爆炸效果结构
-typedef struct {
-    Vec2 pos;
-    int active;
-    int timer;     // 爆炸持续时间
-} Explosion;
-
-// 自机结构
-typedef struct {
-    Vec2 pos;
-    int lives;
-    int score;
-    int shoot_timer; // 射击计时器
-    int power_level; // 火力等级: 0=普通, 1=双发, 2=三发
-    int power_timer; // 火力升级持续时间
-    int slow_mode;   // 慢速移动模式: 0=正常, 1=精确模式
-    int invincible_timer; // 擦弹无敌时间
-    int graze_count; // 擦弹计数
-} Player;
-
-// --- 全局变量 ---
-Player player;
-Bullet bullets[MAX_BULLETS];
-Enemy enemies[MAX_ENEMIES];
-Item items[MAX_ITEMS];
-Explosion explosions[MAX_EXPLOSIONS];
-int frame_count = 0;
-int high_score = 0; // 最高分记录
-
-// --- 辅助函数：控制台光标 ---
-
-// 隐藏光标，防止闪烁
-void HideCursor() {
-    CONSOLE_CURSOR_INFO cursor_info = {1, 0};
-    SetConsoleCursorInfo(GetStdHandle(STD_OUTPUT_HANDLE), &cursor_info);
+#include "audio.h"
+#include "autopilot.h"
+#include "config.h"
+#include "frameclock.h"
+#include "game.h"
+#include "input.h"
+#include "leaderboard.h"
+#include "platform.h"
+#include "profiler.h"
+#include "replay.h"
+#include "render.h"
+#include "renderthread.h"
+#include "screen.h"
+#include "spectator.h"
+
+// 控制台前端：负责输入采集、音效和绘制，游戏逻辑见 game.c
+
+// 当前这局游戏
+static GameState* game = NULL;
+
+// 差分渲染器：第 0 行状态栏 + height 行游戏区域
+static Screen screen;
+
+// 输入到画面延迟 (--latency)：按键事件时间戳到包含该输入的画面写出终端为止
+#define MAX_LATENCY_SAMPLES 4096
+static double latency_samples[MAX_LATENCY_SAMPLES];
+static int num_latency_samples = 0;
+
+static int CompareDouble(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
 }
 
-// 移动光标到指定位置 (替代 system("cls"))
-void GotoXY(int x, int y) {
-    COORD coord;
-    coord.X = x;
-    coord.Y = y;
-    SetConsoleCursorPosition(GetStdHandle(STD_OUTPUT_HANDLE), coord);
+// 排行榜的最高分：只映射索引，不读数据文件；还没有排行榜时为 0
+static int LoadBestScore(const char* path) {
+    Leaderboard* board = LeaderboardOpen(path, 0, NULL);
+    if (board == NULL) return 0;
+    int best = LeaderboardBest(board);
+    LeaderboardClose(board);
+    return best;
+}
+
+// 把这局的成绩追加到排行榜，成功返回 1
+static int RecordScore(const char* path, unsigned long long seed) {
+    Leaderboard* board = LeaderboardOpen(path, 1, NULL);
+    if (board == NULL) return 0;
+    LeaderboardRecord record = LeaderboardRecordGame(game, seed);
+    int ok = LeaderboardAdd(board, &record, 1);
+    LeaderboardClose(board);
+    return ok;
+}
+
+static void PrintLatency() {
+    if (num_latency_samples == 0) {
+        printf("latency: no key presses recorded\n");
+        return;
+    }
+    qsort(latency_samples, (size_t)num_latency_samples, sizeof(double), CompareDouble);
+    printf("input-to-photon latency: %d presses, p50 %.2f ms, p99 %.2f ms, max %.2f ms\n",
+           num_latency_samples,
+           latency_samples[num_latency_samples / 2] * 1e3,
+           latency_samples[(int)(num_latency_samples * 0.99)] * 1e3,
+           latency_samples[num_latency_samples - 1] * 1e3);
 }
 
 // --- 音效函数 ---
+// 只向音频线程投递事件，不阻塞游戏循环 (见 audio.c)
 
 // 播放射击音效 (高音)
 void PlayShootSound() {
-    Beep(1200, 30); // 1200Hz, 30ms
+    AudioPlayTone(1200, 30); // 1200Hz, 30ms
 }
 
 // 播放击中音效 (中音)
 void PlayHitSound() {
-    Beep(800, 50); // 800Hz, 50ms
+    AudioPlayTone(800, 50); // 800Hz, 50ms
 }
 
 // 播放被击中音效 (低音)
 void PlayDamageSound() {
-    Beep(300, 100); // 300Hz, 100ms
+    AudioPlayTone(300, 100); // 300Hz, 100ms
 }
 
 // 播放爆炸音效 (报警音)
 void PlayExplosionSound() {
-    Beep(200, 150); // 200Hz, 150ms
+    AudioPlayTone(200, 150); // 200Hz, 150ms
 }
 
-// --- 最高分管理函数 ---
-
-// 从文件读取最高分
-void LoadHighScore() {
-    FILE* file = fopen("highscore.txt", "r");
-    if (file != NULL) {
-        if (fscanf(file, "%d", &high_score) != 1) {
-            high_score = 0; // 读取失败时重置为0
-        }
-        fclose(file);
+// 将模拟核心产生的音效事件映射到具体音效
+void OnGameSound(SoundId id) {
+    switch (id) {
+        case SOUND_SHOOT: PlayShootSound(); break;
+        case SOUND_HIT: PlayHitSound(); break;
+        case SOUND_DAMAGE: PlayDamageSound(); break;
+        case SOUND_EXPLOSION: PlayExplosionSound(); break;
     }
 }
 
-// 保存最高分到文件
-void SaveHighScore() {
-    if (player.score > high_score) {
-        high_score = player.score;
-        FILE* file = fopen("highscore.txt", "w");
-        if (file != NULL) {
-            fprintf(file, "%d", high_score);
-            fclose(file);
-        }
-    }
-}
+// --- 渲染函数 ---
 
-// --- 游戏逻辑函数 ---
-
-void InitGame() {
-    // 初始化玩家
-    player.pos.x = WIDTH / 2;
-    player.pos.y = HEIGHT - 2;
-    player.lives = 3;
-    player.score = 0;
-    player.shoot_timer = 0;
-    player.power_level = 0;
-    player.power_timer = 0;
-    player.slow_mode = 0;
-    player.invincible_timer = 0;
-    player.graze_count = 0;
-
-    // 清空对象池
-    for(int i=0; i<MAX_BULLETS; i++) bullets[i].active = 0;
-    for(int i=0; i<MAX_ENEMIES; i++) enemies[i].active = 0;
-    for(int i=0; i<MAX_ITEMS; i++) items[i].active = 0;
-    for(int i=0; i<MAX_EXPLOSIONS; i++) explosions[i].active = 0;
-}
+// 第 0 行为状态栏 (hud_length 之后补空格)，其后是游戏区域；每行右侧补空格覆盖上一帧的残留
+static void FillScreen(int hud_length, const char* buffer, int width, int height) {
+    char* row = ScreenRow(&screen, 0);
+    for (int x = hud_length; x < screen.cols; x++) row[x] = ' ';
 
-// 发射子弹
-void SpawnBullet(double x, double y, double vx, double vy, int is_enemy) {
-    for (int i = 0; i < MAX_BULLETS; i++) {
-        if (!bullets[i].active) {
-            bullets[i].pos.x = x;
-            bullets[i].pos.y = y;
-            bullets[i].velocity.x = vx;
-            bullets[i].velocity.y = vy;
-            bullets[i].active = 1;
-            bullets[i].is_enemy = is_enemy;
-            return;
-        }
+    for (int y = 0; y < height; y++) {
+        row = ScreenRow(&screen, y + 1);
+        memcpy(row, buffer + y * (width + 1), width);
+        for (int x = width; x < screen.cols; x++) row[x] = ' ';
     }
 }
 
-// 生成敌人 - 根据分数决定类型
-void SpawnEnemy() {
-    for (int i = 0; i < MAX_ENEMIES; i++) {
-        if (!enemies[i].active) {
-            enemies[i].pos.x = rand() % (WIDTH - 2) + 1;
-            enemies[i].pos.y = 1;
-            enemies[i].active = 1;
-            enemies[i].cooldown = 20 + rand() % 30; // 随机初始冷却
-            
-            // 根据分数决定敌机类型
-            if (player.score < 100) {
-                enemies[i].type = 0; // 只有普通敌机
-            } else if (player.score < 300) {
-                enemies[i].type = (rand() % 100 < 70) ? 0 : 1; // 70%普通, 30%直线
-            } else {
-                int r = rand() % 100;
-                if (r < 50) enemies[i].type = 0;      // 50%普通
-                else if (r < 80) enemies[i].type = 1; // 30%直线
-                else enemies[i].type = 2;             // 20%散射
-            }
-            return;
-        }
-    }
+// 渲染函数：绘制到缓冲区后交给差分渲染器，只输出变化的部分
+void Draw() {
+    char* buffer = game->render_buffer;
+    RenderWorld(game, buffer);
+    SpectatorPublish(game, buffer); // 未开启观战时直接返回
+
+    PROF_BEGIN(PROF_DRAW_HUD);
+    int len = RenderHud(game, ScreenRow(&screen, 0), screen.cols + 1);
+    FillScreen(len, buffer, game->config.width, game->config.height);
+    PROF_END(PROF_DRAW_HUD);
+
+    PROF_BEGIN(PROF_DRAW_PRESENT);
+    ScreenPresent(&screen);
+    PROF_END(PROF_DRAW_PRESENT);
 }
 
-// 生成道具
-void SpawnItem(double x, double y, int type) {
-    for (int i = 0; i < MAX_ITEMS; i++) {
-        if (!items[i].active) {
-            items[i].pos.x = x;
-            items[i].pos.y = y;
-            items[i].active = 1;
-            items[i].type = type;
-            return;
+// --render-thread：在渲染线程绘制快照并输出 (不记录剖析数据，剖析器只在游戏线程使用)
+static char* snapshot_buffer = NULL;  // 快照的字符缓冲，只由渲染线程使用
+static double shown_press = 0;        // 已经显示到画面上的最近一次按键
+
+static void PresentSnapshot(const RenderSnapshot* snapshot, void* context) {
+    int measure_latency = *(const int*)context;
+    RenderSnapshotWorld(snapshot, snapshot_buffer);
+    int len = RenderSnapshotHud(snapshot, ScreenRow(&screen, 0), screen.cols + 1);
+    FillScreen(len, snapshot_buffer, snapshot->width, snapshot->height);
+    ScreenPresent(&screen);
+
+    // 快照带的是最近一次按键，包含它的第一帧画出时记一次延迟 (中间被丢弃的帧不影响)
+    if (snapshot->input_time > shown_press) {
+        shown_press = snapshot->input_time;
+        if (measure_latency && num_latency_samples < MAX_LATENCY_SAMPLES) {
+            latency_samples[num_latency_samples++] = PlatformNow() - snapshot->input_time;
         }
     }
 }
 
-// 生成爆炸效果
-void SpawnExplosion(double x, double y) {
-    for (int i = 0; i < MAX_EXPLOSIONS; i++) {
-        if (!explosions[i].active) {
-            explosions[i].pos.x = x;
-            explosions[i].pos.y = y;
-            explosions[i].active = 1;
-            explosions[i].timer = 10; // 爆炸持续10帧
-            return;
+int main(int argc, char** argv) {
+    int show_render_stats = 0;
+    double render_hz = DEFAULT_RENDER_HZ;
+    const char* timing_path = NULL;
+    const char* profile_path = NULL;
+    const char* record_path = NULL;
+    unsigned long long seed = (unsigned long long)time(NULL);
+    AudioSink audio_sink = AUDIO_SINK_BEEP;
+    const char* wav_path = NULL;
+    int show_audio_stats = 0;
+    int measure_latency = 0;
+    const char* spectate_path = NULL;
+    int autopilot = 0;
+    int render_thread = 0;
+    const char* leaderboard_path = LEADERBOARD_DEFAULT_PATH;
+    // 默认让游戏区域填满终端，--width/--height/--config 可以覆盖
+    GameConfig config = DefaultGameConfig();
+    ConfigFitTerminal(&config);
+    argc = ConfigParseArgs(&config, argc, argv);
+    if (argc < 0) return 1;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--render-stats") == 0) {
+            show_render_stats = 1;
+        } else if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc) {
+            render_hz = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--timing") == 0 && i + 1 < argc) {
+            timing_path = argv[++i];
+        } else if (strcmp(argv[i], "--profile") == 0 && i + 1 < argc) {
+            profile_path = argv[++i];
+        } else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            record_path = argv[++i];
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--audio-wav") == 0 && i + 1 < argc) {
+            audio_sink = AUDIO_SINK_WAV;
+            wav_path = argv[++i];
+        } else if (strcmp(argv[i], "--audio-null") == 0) {
+            audio_sink = AUDIO_SINK_NULL;
+        } else if (strcmp(argv[i], "--audio-stats") == 0) {
+            show_audio_stats = 1;
+        } else if (strcmp(argv[i], "--latency") == 0) {
+            measure_latency = 1;
+        } else if (strcmp(argv[i], "--spectate") == 0 && i + 1 < argc) {
+            spectate_path = argv[++i];
+        } else if (strcmp(argv[i], "--autopilot") == 0) {
+            autopilot = 1; // 演示模式：由自动驾驶操作，键盘输入被忽略
+        } else if (strcmp(argv[i], "--render-thread") == 0) {
+            render_thread = 1;
+        } else if (strcmp(argv[i], "--leaderboard") == 0 && i + 1 < argc) {
+            leaderboard_path = argv[++i];
         }
     }
-}
 
-// 核心更新逻辑
-void Update() {
-    frame_count++;
-
-    // 1. 玩家移动 (非阻塞输入)
-    // 检测Shift/Space键状态 (使用GetAsyncKeyState)
-    int shift_pressed = GetAsyncKeyState(VK_SHIFT) & 0x8000;
-    int space_pressed = GetAsyncKeyState(VK_SPACE) & 0x8000;
-    player.slow_mode = shift_pressed || space_pressed;
-    
-    if (_kbhit()) {
-        char key = _getch();
-        
-        // 根据模式设置移动速度 (结合主分支的0.8速度和慢速模式)
-        double speed = player.slow_mode ? 0.25 : 0.8; // 慢速模式为约1/3速度
-        
-        if (key == 'w' && player.pos.y > 1) player.pos.y -= speed;
-        if (key == 's' && player.pos.y < HEIGHT - 2) player.pos.y += speed;
-        if (key == 'a' && player.pos.x > 1) player.pos.x -= speed;
-        if (key == 'd' && player.pos.x < WIDTH - 2) player.pos.x += speed;
+    game = CreateGame(&config, seed);
+    int screen_cols = config.width > HUD_WIDTH ? config.width : HUD_WIDTH;
+    if (game == NULL || (autopilot && !AttachDangerField(game)) || !ScreenInit(&screen, screen_cols, config.height + 1)) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
     }
-    
-    // 更新无敌时间
-    if (player.invincible_timer > 0) {
-        player.invincible_timer--;
+    if (!AudioStart(audio_sink, wav_path)) {
+        fprintf(stderr, "audio disabled: failed to start audio output\n");
     }
-
-    // 2. 玩家自动射击
-    // 分数越高，射击间隔越短。最低间隔为 3 帧。
-    int fire_rate = 15 - (player.score / 50); 
-    if (fire_rate < 3) fire_rate = 3;
-    
-    player.shoot_timer++;
-    if (player.shoot_timer >= fire_rate) {
-        // 根据火力等级发射子弹
-        if (player.power_level == 0) {
-            SpawnBullet(player.pos.x, player.pos.y - 1, 0, -1.0, 0);
-        } else if (player.power_level == 1) {
-            // 双发
-            SpawnBullet(player.pos.x - 0.5, player.pos.y - 1, 0, -1.0, 0);
-            SpawnBullet(player.pos.x + 0.5, player.pos.y - 1, 0, -1.0, 0);
-        } else {
-            // 三发
-            SpawnBullet(player.pos.x - 0.7, player.pos.y - 1, 0, -1.0, 0);
-            SpawnBullet(player.pos.x, player.pos.y - 1, 0, -1.0, 0);
-            SpawnBullet(player.pos.x + 0.7, player.pos.y - 1, 0, -1.0, 0);
-        }
-        PlayShootSound(); // 播放射击音效
-        player.shoot_timer = 0;
-    }
-    
-    // 更新火力升级计时器
-    if (player.power_timer > 0) {
-        player.power_timer--;
-        if (player.power_timer == 0) {
-            player.power_level = 0; // 恢复普通火力
-        }
+    if (spectate_path != NULL && !SpectatorStart(spectate_path, SPECTATOR_DEFAULT_KEYFRAME, config.width, config.height)) {
+        fprintf(stderr, "spectator feed disabled: failed to listen on %s\n", spectate_path);
     }
+    PlatformInitConsole();
+    game->sound_hook = OnGameSound;
+    int high_score = LoadBestScore(leaderboard_path); // 排行榜中的最高分
 
-    // 3. 更新子弹
-    for (int i = 0; i < MAX_BULLETS; i++) {
-        if (bullets[i].active) {
-            bullets[i].pos.x += bullets[i].velocity.x;
-            bullets[i].pos.y += bullets[i].velocity.y;
+    // 录像：记录种子和每个模拟步的输入，可用 headless --replay 重放
+    Replay replay;
+    ReplayInit(&replay, &config, seed, REPLAY_DEFAULT_HASH_INTERVAL);
 
-            // 边界检查
-            if (bullets[i].pos.x <= 0 || bullets[i].pos.x >= WIDTH ||
-                bullets[i].pos.y <= 0 || bullets[i].pos.y >= HEIGHT) {
-                bullets[i].active = 0;
-            }
-        }
-    }
-
-    // 4. 更新敌人 & 敌机发射
-    // 动态控制敌机生成：调整初始频率，并限制最大在场数量
-    int spawn_interval = 50 - (player.score / 100); // 提高初始间隔从30到50
-    if (spawn_interval < 20) spawn_interval = 20; // 提高最低间隔从15到20
-    
-    // 计算当前在场敌机数量
-    int active_enemies = 0;
-    for (int i = 0; i < MAX_ENEMIES; i++) {
-        if (enemies[i].active) active_enemies++;
-    }
-    
-    // 只有在未达到上限时才生成新敌机
-    if (frame_count % spawn_interval == 0 && active_enemies < MAX_ENEMIES) {
-        SpawnEnemy();
-    }
-
-    for (int i = 0; i < MAX_ENEMIES; i++) {
-        if (enemies[i].active) {
-            // 根据类型移动
-            if (enemies[i].type == 0) {
-                // 普通敌机：缓慢向下
-                enemies[i].pos.y += 0.1;
-            } else if (enemies[i].type == 1) {
-                // 直线机：快速向下
-                enemies[i].pos.y += 0.3;
-            } else {
-                // 散射机：缓慢向下
-                enemies[i].pos.y += 0.08;
-            }
-
-            // 消失在底部
-            if (enemies[i].pos.y >= HEIGHT - 1) {
-                enemies[i].active = 0;
-                continue;
-            }
-
-            // 发射子弹逻辑
-            enemies[i].cooldown--;
-            if (enemies[i].cooldown <= 0) {
-                if (enemies[i].type == 0) {
-                    // 普通敌机：发射自机狙
-                    double dx = player.pos.x - enemies[i].pos.x;
-                    double dy = player.pos.y - enemies[i].pos.y;
-                    double dist = sqrt(dx*dx + dy*dy);
-                    
-                    if (dist > 0) {
-                        double speed = 0.5;
-                        SpawnBullet(enemies[i].pos.x, enemies[i].pos.y, (dx/dist)*speed, (dy/dist)*speed, 1);
-                    }
-                    enemies[i].cooldown = 40 + rand() % 40;
-                } else if (enemies[i].type == 2) {
-                    // 散射机：发射三发散射弹
-                    SpawnBullet(enemies[i].pos.x, enemies[i].pos.y, -0.3, 0.5, 1); // 左下
-                    SpawnBullet(enemies[i].pos.x, enemies[i].pos.y, 0, 0.6, 1);    // 正下
-                    SpawnBullet(enemies[i].pos.x, enemies[i].pos.y, 0.3, 0.5, 1);  // 右下
-                    enemies[i].cooldown = 50 + rand() % 30;
-                }
-                // 直线机不发射子弹
-            }
-        }
-    }
-    
-    // 5. 更新道具
-    for (int i = 0; i < MAX_ITEMS; i++) {
-        if (items[i].active) {
-            items[i].pos.y += 0.15; // 缓慢下落
-            
-            // 消失在底部
-            if (items[i].pos.y >= HEIGHT - 1) {
-                items[i].active = 0;
-            }
-        }
-    }
-    
-    // 6. 更新爆炸效果
-    for (int i = 0; i < MAX_EXPLOSIONS; i++) {
-        if (explosions[i].active) {
-            explosions[i].timer--;
-            if (explosions[i].timer <= 0) {
-                explosions[i].active = 0;
-            }
+    printf("HIGH SCORE: %d\n", high_score);
+    printf("PRESS ANY KEY TO START...");
+    PlatformWaitKey();
+    fflush(stdout); // 之后的画面由差分渲染器直接写终端
+    if (!InputStart()) {
+        fprintf(stderr, "failed to start input thread\n");
+        return 1;
+    }
+
+    // 渲染线程：模拟每轮发布一个快照，由渲染线程按 --fps 的节奏输出
+    if (render_thread) {
+        snapshot_buffer = (char*)malloc((size_t)config.height * (config.width + 1));
+        if (snapshot_buffer == NULL || !RenderThreadStart(&config, render_hz, PresentSnapshot, &measure_latency)) {
+            fprintf(stderr, "failed to start render thread\n");
+            return 1;
         }
     }
 
-    // 7. 碰撞检测 (优化判定精度)
-    
-    // A. 子弹 vs 敌人
-    for (int i = 0; i < MAX_BULLETS; i++) {
-        if (bullets[i].active && !bullets[i].is_enemy) {
-            for (int j = 0; j < MAX_ENEMIES; j++) {
-                if (enemies[j].active) {
-                    // 优化判定：子弹判定为 0.8
-                    if (fabs(bullets[i].pos.x - enemies[j].pos.x) < 0.8 && 
-                        fabs(bullets[i].pos.y - enemies[j].pos.y) < 0.8) {
-                        bullets[i].active = 0;
-                        enemies[j].active = 0;
-                        
-                        // 生成爆炸效果
-                        SpawnExplosion(enemies[j].pos.x, enemies[j].pos.y);
-                        PlayHitSound(); // 播放击中音效
-                        
-                        // 根据敌机类型给予不同分数
-                        if (enemies[j].type == 0) player.score += 10;
-                        else if (enemies[j].type == 1) player.score += 15;
-                        else player.score += 20;
-                        
-                        // 10%概率掉落道具
-                        int drop_rand = rand();
-                        if (drop_rand % 100 < 10) {
-                            int item_type = (drop_rand / 100) % 2; // 0=生命, 1=火力
-                            SpawnItem(enemies[j].pos.x, enemies[j].pos.y, item_type);
-                        }
-                    }
-                }
-            }
+    // 固定步长循环：模拟固定 62.5 Hz，渲染单独限速，空闲时间精确等待
+    FrameClock clock;
+    FrameClockInit(&clock, SIM_TICK_SECONDS, render_hz, DEFAULT_MAX_CATCHUP, PlatformNow());
+    if (timing_path != NULL) {
+        clock.csv = fopen(timing_path, "w");
+    }
+
+    double pending_press = 0; // 尚未显示到画面上的最早按键时间
+    double last_press = 0;    // 最近一次按键 (渲染线程模式下随快照发布)
+    while (game->player.lives > 0) {
+        double frame_start = PlatformNow();
+        int ticks = FrameClockAdvance(&clock, frame_start);
+        for (int t = 0; t < ticks && game->player.lives > 0; t++) {
+            GameInput input;
+            double first_press;
+            input.keys = InputDrain(&first_press); // 每步取出输入线程积累的全部事件
+            if (autopilot) input.keys = AutopilotKeys(game);
+            if (first_press > 0 && pending_press == 0) pending_press = first_press;
+            if (first_press > 0) last_press = first_press;
+            Update(game, &input);
+            if (record_path != NULL) ReplayRecord(&replay, game, input.keys);
         }
-    }
 
-    // B. 敌机子弹 vs 玩家 (缩小判定到 0.5，实现擦弹)
-    for (int i = 0; i < MAX_BULLETS; i++) {
-        if (bullets[i].active && bullets[i].is_enemy) {
-            double dx = fabs(bullets[i].pos.x - player.pos.x);
-            double dy = fabs(bullets[i].pos.y - player.pos.y);
-            double dist_squared = dx*dx + dy*dy; // 使用距离平方避免sqrt计算
-            
-            // 直接命中判定（使用圆形判定与擦弹保持一致）
-            if (dist_squared < 0.25) { // 0.5*0.5 = 0.25
-                // 如果处于无敌状态，不扣血
-                if (player.invincible_timer > 0) {
-                    bullets[i].active = 0;
-                } else {
-                    bullets[i].active = 0;
-                    player.lives--;
-                }
+        double sim_end = PlatformNow();
+        double render_end = sim_end;
+        if (ticks > 0 && render_thread) {
+            // 游戏线程只拷贝快照；观战流仍按渲染频率在这里发布 (不涉及终端输出)
+            RenderThreadPublish(game, last_press);
+            if (spectate_path != NULL && FrameClockShouldRender(&clock, sim_end)) {
+                RenderWorld(game, game->render_buffer);
+                SpectatorPublish(game, game->render_buffer);
             }
-            // 擦弹判定：子弹极度接近但未命中
-            else if (dist_squared < 1.0 && dist_squared >= 0.25) { // GRAZE_DISTANCE^2 = 1.0
-                // 触发擦弹奖励，并移除子弹防止重复触发
-                bullets[i].active = 0;
-                player.graze_count++;
-                player.score += 5; // 擦弹奖励5分
-                player.invincible_timer = INVINCIBLE_FRAMES; // 给予短暂无敌时间
-            }
-        }
-    }
-
-    // C. 敌机本体 vs 玩家 (缩小判定)
-    for (int i = 0; i < MAX_ENEMIES; i++) {
-        if (enemies[i].active) {
-             if (fabs(enemies[i].pos.x - player.pos.x) < 0.8 && 
-                 fabs(enemies[i].pos.y - player.pos.y) < 0.8) {
-                 enemies[i].active = 0;
-                 SpawnExplosion(enemies[i].pos.x, enemies[i].pos.y);
-                 PlayExplosionSound(); // 播放爆炸音效
-                 player.lives = 0; // 直接死亡
-             }
-        }
-    }
-    
-    // D. 玩家 vs 道具
-    for (int i = 0; i < MAX_ITEMS; i++) {
-        if (items[i].active) {
-            if (fabs(items[i].pos.x - player.pos.x) < 1.2 && 
-                fabs(items[i].pos.y - player.pos.y) < 1.2) {
-                items[i].active = 0;
-                
-                if (items[i].type == 0) {
-                    // 生命恢复
-                    if (player.lives < 5) player.lives++;
-                } else {
-                    // 火力升级
-                    if (player.power_level < 2) player.power_level++;
-                    player.power_timer = 625; // 10秒 (625帧 @ 62.5fps with Sleep(16))
+            render_end = PlatformNow();
+        } else if (ticks > 0 && FrameClockShouldRender(&clock, sim_end)) {
+            Draw();
+            render_end = PlatformNow();
+            if (pending_press > 0) {
+                if (measure_latency && num_latency_samples < MAX_LATENCY_SAMPLES) {
+                    latency_samples[num_latency_samples++] = render_end - pending_press;
                 }
+                pending_press = 0;
             }
         }
-    }
-}
 
-// 辅助函数：在buffer中安全地放置字符
-void PutChar(char buffer[HEIGHT][WIDTH + 1], int x, int y, char c) {
-    if (x > 0 && x < WIDTH - 1 && y > 0 && y < HEIGHT - 1) {
-        buffer[y][x] = c;
+        FrameClockEndFrame(&clock, ticks, sim_end - frame_start, render_end - sim_end, render_end);
+        FrameClockWait(&clock);
     }
-}
-
-// 渲染函数 (使用缓冲区思想，直接打印字符)
-void Draw() {
-    char buffer[HEIGHT][WIDTH + 1];
-
-    // 1. 清空 Buffer (填充背景)
-    for (int y = 0; y < HEIGHT; y++) {
-        for (int x = 0; x < WIDTH; x++) {
-            if (y == 0 || y == HEIGHT - 1) buffer[y][x] = '-';
-            else if (x == 0 || x == WIDTH - 1) buffer[y][x] = '|';
-            else buffer[y][x] = ' ';
-        }
-        buffer[y][WIDTH] = '\0';
-    }
-
-    // 2. 绘制子弹
-    for (int i = 0; i < MAX_BULLETS; i++) {
-        if (bullets[i].active) {
-            int x = (int)bullets[i].pos.x;
-            int y = (int)bullets[i].pos.y;
-            PutChar(buffer, x, y, bullets[i].is_enemy ? '*' : '|');
-        }
-    }
-
-    // 3. 绘制道具
-    for (int i = 0; i < MAX_ITEMS; i++) {
-        if (items[i].active) {
-            int x = (int)items[i].pos.x;
-            int y = (int)items[i].pos.y;
-            char icon = (items[i].type == 0) ? 'H' : 'P';
-            PutChar(buffer, x, y, icon);
-        }
-    }
-
-    // 4. 绘制爆炸效果 (多字符)
-    for (int i = 0; i < MAX_EXPLOSIONS; i++) {
-        if (explosions[i].active) {
-            int x = (int)explosions[i].pos.x;
-            int y = (int)explosions[i].pos.y;
-            
-            // 根据计时器显示不同阶段的爆炸
-            if (explosions[i].timer > 6) {
-                PutChar(buffer, x, y, '#');
-                PutChar(buffer, x-1, y, '*');
-                PutChar(buffer, x+1, y, '*');
-            } else if (explosions[i].timer > 3) {
-                PutChar(buffer, x, y, 'X');
-                PutChar(buffer, x-1, y, 'x');
-                PutChar(buffer, x+1, y, 'x');
-            } else {
-                PutChar(buffer, x, y, '+');
-            }
-        }
-    }
-
-    // 5. 绘制敌人 (多字符造型)
-    for (int i = 0; i < MAX_ENEMIES; i++) {
-        if (enemies[i].active) {
-            int x = (int)enemies[i].pos.x;
-            int y = (int)enemies[i].pos.y;
-            
-            if (enemies[i].type == 0) {
-                // 普通敌机 - 使用V字型
-                PutChar(buffer, x, y, 'V');
-                PutChar(buffer, x-1, y-1, '\\');
-                PutChar(buffer, x+1, y-1, '/');
-            } else if (enemies[i].type == 1) {
-                // 直线机 - 使用简单三角
-                PutChar(buffer, x, y, 'v');
-                PutChar(buffer, x, y-1, '|');
-            } else {
-                // 散射机 - 使用W字型
-                PutChar(buffer, x, y, 'W');
-                PutChar(buffer, x-1, y-1, '<');
-                PutChar(buffer, x+1, y-1, '>');
-            }
-        }
-    }
-
-    // 6. 绘制玩家 (多字符造型)
-    int px = (int)player.pos.x;
-    int py = (int)player.pos.y;
-    if (px > 0 && px < WIDTH - 1 && py > 0 && py < HEIGHT - 1) {
-        PutChar(buffer, px, py, 'A');
-        PutChar(buffer, px-1, py+1, '/');
-        PutChar(buffer, px+1, py+1, '\\');
-        PutChar(buffer, px, py-1, '^');
-        
-        // 在慢速模式下显示精确判定点
-        if (player.slow_mode) {
-            PutChar(buffer, px, py, 'o'); // 显示判定点
-        }
-    }
-
-    // 7. 真正的输出到屏幕
-    GotoXY(0, 0);
-    
-    // 生命值条显示
-    printf("Score: %d  Lives: ", player.score);
-    for (int i = 0; i < player.lives && i < 5; i++) {
-        printf("*");
-    }
-    for (int i = player.lives; i < 5; i++) {
-        printf("-");
-    }
-    
-    // 火力等级显示
-    if (player.power_level > 0) {
-        printf("  POWER: ");
-        for (int i = 0; i < player.power_level; i++) {
-            printf("P");
-        }
-        printf(" (%ds)", (player.power_timer * 16) / 1000); // 正确计算秒数
-    }
-    
-    // 擦弹计数显示
-    printf("  Graze: %d", player.graze_count);
-    
-    // 慢速模式显示
-    if (player.slow_mode) {
-        printf("  [SLOW]");
-    }
-    
-    // 无敌状态显示
-    if (player.invincible_timer > 0) {
-        printf("  [INVINCIBLE]");
-    }
-    
-    printf("  (WASD + Space/Shift)\n");
-    
-    for (int y = 0; y < HEIGHT; y++) {
-        printf("%s\n", buffer[y]);
-    }
-}
-
-int main() {
-    srand((unsigned)time(NULL));
-    HideCursor();
-    LoadHighScore(); // 加载最高分
-    InitGame();
-
-    printf("HIGH SCORE: %d\n", high_score);
-    printf("PRESS ANY KEY TO START...");
-    _getch();
+    if (clock.csv != NULL) fclose(clock.csv);
 
-    while (player.lives > 0) {
-        Update();
-        Draw();
-        Sleep(16); // 控制游戏速度 (~62.5 FPS)
+    RenderThreadStop(); // 之后的输出回到游戏线程
+    free(snapshot_buffer);
+    InputStop();
+    AudioStop();
+    SpectatorStop();
+    if (record_path != NULL && !ReplaySave(&replay, record_path)) {
+        fprintf(stderr, "failed to write replay: %s\n", record_path);
     }
+    ReplayFree(&replay);
 
     // 检查是否破纪录
-    int is_new_record = (player.score > high_score);
+    int is_new_record = (game->player.score > high_score);
     
-    // 保存最高分
-    SaveHighScore();
+    // 记入排行榜
+    int recorded = RecordScore(leaderboard_path, seed);
     
-    GotoXY(WIDTH / 2 - 5, HEIGHT / 2);
+    GotoXY(config.width / 2 - 5, config.height / 2);
     printf("GAME OVER!");
-    GotoXY(WIDTH / 2 - 6, HEIGHT / 2 + 1);
-    printf("Final Score: %d", player.score);
-    GotoXY(WIDTH / 2 - 6, HEIGHT / 2 + 2);
+    GotoXY(config.width / 2 - 6, config.height / 2 + 1);
+    printf("Final Score: %d", game->player.score);
+    GotoXY(config.width / 2 - 6, config.height / 2 + 2);
     
     // 显示最高分信息
     if (is_new_record) {
@@ -654,6 +320,61 @@ int main() {
     }
     
     // 防止程序直接退出
-    while(1) if(_kbhit()) break; 
+    fflush(stdout);
+    while(1) if(PlatformKeyPressed()) break; 
+    PlatformShutdownConsole();
+    if (!recorded) {
+        fprintf(stderr, "failed to record score in leaderboard %s\n", leaderboard_path);
+    }
+
+    // 渲染统计：平均每帧输出字节数和系统调用次数
+    if (show_render_stats && screen.stats.frames > 0) {
+        printf("render: %lld frames, %.1f bytes/frame, %.2f writes/frame, %.1f cells/frame\n",
+               screen.stats.frames,
+               (double)screen.stats.bytes / screen.stats.frames,
+               (double)screen.stats.writes / screen.stats.frames,
+               (double)screen.stats.cells / screen.stats.frames);
+    }
+    if (timing_path != NULL) {
+        FrameClockPrintSummary(&clock, stdout);
+    }
+    // 渲染线程统计：丢帧 (来不及画就被替换) 和重复帧 (渲染时刻没有新快照)
+    if (render_thread) {
+        RenderThreadStats rt = RenderThreadGetStats();
+        printf("render thread: %lld published, %lld presented, %lld dropped, %lld duplicated, "
+               "%.2f us/publish on game thread, present avg %.3f ms max %.3f ms, age max %.3f ms\n",
+               rt.published, rt.presented, rt.dropped, rt.duplicated,
+               rt.published > 0 ? rt.publish_seconds * 1e6 / rt.published : 0.0,
+               rt.presented > 0 ? rt.present_seconds * 1e3 / rt.presented : 0.0, rt.present_max * 1e3,
+               rt.age_max * 1e3);
+    }
+    if (measure_latency) {
+        PrintLatency();
+    }
+    // 音频统计：游戏线程花在音效上的时间应接近 0
+    if (show_audio_stats) {
+        AudioStats audio = AudioGetStats();
+        printf("audio: %lld events, %lld dropped, game thread %.3f ms total (%.2f us max), "
+               "%lld buffers, %lld underruns\n",
+               audio.events, audio.dropped, audio.post_seconds * 1e3, audio.post_max * 1e6,
+               audio.buffers, audio.underruns);
+    }
+    // 观战流统计：游戏线程的发布开销、编码后的带宽和慢观众跳过的帧
+    if (spectate_path != NULL) {
+        SpectatorStats spectator = SpectatorGetStats();
+        printf("spectator: %lld frames (%lld dropped), %.2f us/frame on game thread, %.1f bytes/frame, "
+               "%lld viewers, %lld frames skipped\n",
+               spectator.published, spectator.dropped,
+               spectator.published > 0 ? spectator.post_seconds * 1e6 / spectator.published : 0.0,
+               spectator.published > 0 ? (double)spectator.encoded_bytes / spectator.published : 0.0,
+               spectator.clients, spectator.skipped);
+    }
+    if (profile_path != NULL && !PROF_DUMP(profile_path)) {
+        fprintf(stderr, PROFILER_ENABLED ? "failed to write profile: %s\n"
+                                         : "profiler disabled, rebuild with -DENABLE_PROFILER (%s)\n",
+                profile_path);
+    }
+    ScreenFree(&screen);
+    DestroyGame(game);
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,68 @@
+#ifndef PLATFORM_H
+#define PLATFORM_H
+
+#include <stddef.h>
+
+// 平台接口：控制台、键盘、音效、计时、线程和内存
+// Windows 实现见 platform_win32.c，Linux/POSIX 实现见 platform_posix.c
+
+// --- 计时 ---
+double PlatformNow();                 // 单调时钟 (秒)
+void PlatformSleep(double seconds);   // 休眠指定秒数
+
+// --- 控制台 ---
+void PlatformInitConsole();           // 进入游戏模式 (隐藏光标、关闭回显等)
+void PlatformShutdownConsole();       // 恢复终端状态
+void HideCursor();
+void GotoXY(int x, int y);
+int PlatformWrite(const char* data, int length); // 直接写终端 (绕过 stdio)，返回系统调用次数
+int PlatformTerminalSize(int* cols, int* rows);  // 终端窗口的列数和行数；标准输出不是终端时返回 0
+
+// --- 键盘 ---
+unsigned PlatformScanKeys(double wait); // 最多等待 wait 秒，返回当前按住的 KEY_* 位掩码 (由输入线程调用)
+int PlatformKeyPressed();             // 是否有按键等待读取
+int PlatformWaitKey();                // 阻塞等待一个按键
+
+// --- 音效 ---
+void PlatformBeep(int frequency, int duration_ms);
+
+// --- 线程 ---
+typedef struct PlatformThread PlatformThread;
+PlatformThread* PlatformThreadStart(void (*entry)(void* arg), void* arg); // 失败返回 NULL
+void PlatformThreadJoin(PlatformThread* thread);                          // 等待结束并释放
+int PlatformCpuCount();                                                   // 逻辑处理器数量
+
+// --- 内存 ---
+void* PlatformAlignedAlloc(size_t alignment, size_t size);  // size 不必是 alignment 的倍数
+void PlatformAlignedFree(void* ptr);
+
+// --- 内存映射文件 ---
+// 映射的偏移必须是 PlatformMapGranularity() 的倍数；调整文件大小前请先解除该文件的所有映射 (Windows 的限制)
+typedef struct PlatformFile PlatformFile;
+PlatformFile* PlatformFileOpen(const char* path, int writable); // writable 时读写打开，不存在则创建；失败返回 NULL
+long long PlatformFileSize(PlatformFile* file);
+int PlatformFileResize(PlatformFile* file, long long size);     // 成功返回 1
+void* PlatformFileMap(PlatformFile* file, long long offset, size_t size, int sequential); // 按打开方式读写 / 只读映射；sequential 提示内核顺序预读；失败返回 NULL
+void PlatformFileUnmap(void* address, size_t size);
+void PlatformFileClose(PlatformFile* file);
+size_t PlatformMapGranularity();
+int PlatformFileRead(PlatformFile* file, long long offset, void* data, size_t size);        // 读满 size 字节返回 1
+int PlatformFileWrite(PlatformFile* file, long long offset, const void* data, size_t size); // 写满 size 字节返回 1
+int PlatformFileSync(PlatformFile* file);                       // 把已写入的数据落盘，成功返回 1
+int PlatformFileSyncMap(PlatformFile* file, void* address, size_t size); // 把 file 的映射中 [address, address + size) 改过的页落盘 (address 为映射起点或页对齐)，成功返回 1
+// 整个文件的建议锁 (进程之间；POSIX 的记录锁属于进程，同一进程的多个线程请自己串行)。
+// 阻塞等待；exclusive 为 0 时是共享锁 (只读打开也可以加)，成功返回 1
+int PlatformFileLock(PlatformFile* file, int exclusive);
+int PlatformFileTryLock(PlatformFile* file, int exclusive);      // 不等待：已被其他进程锁住时返回 0
+void PlatformFileUnlock(PlatformFile* file);
+
+// --- 本地套接字 (POSIX 为 Unix domain socket；Windows 版暂未实现，全部返回失败) ---
+// 句柄为非负整数，失败返回 -1
+int PlatformLocalListen(const char* path);    // 删除同名的旧文件后监听
+int PlatformLocalAccept(int listener, int send_buffer); // 不阻塞：没有等待中的连接时返回 -1；返回非阻塞连接，send_buffer > 0 时限制内核发送缓冲
+int PlatformLocalConnect(const char* path);
+int PlatformSocketSend(int socket, const void* data, int size);          // 不阻塞：返回写入字节数 (发送缓冲满时为 0)，连接断开返回 -1
+int PlatformSocketRecv(int socket, void* data, int size, double wait);   // 最多等待 wait 秒：超时返回 0，连接关闭返回 -1
+void PlatformSocketClose(int socket);
+
+#endif
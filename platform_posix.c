@@ -0,0 +1,416 @@
+#define _POSIX_C_SOURCE 200809L
+#define _FILE_OFFSET_BITS 64   // 32 位系统上也能映射超过 2GB 的日志
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <termios.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <string.h>
+#include <pthread.h>
+#include "game.h"
+#include "platform.h"
+
+// Linux/POSIX 平台实现：ANSI 转义序列控制终端，termios 读取键盘
+
+static struct termios saved_termios;
+static int console_active = 0;
+
+// --- 计时 ---
+
+double PlatformNow() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+void PlatformSleep(double seconds) {
+    if (seconds > 0) {
+        struct timespec ts;
+        ts.tv_sec = (time_t)seconds;
+        ts.tv_nsec = (long)((seconds - (double)ts.tv_sec) * 1e9);
+        nanosleep(&ts, NULL);
+    }
+}
+
+// --- 控制台 ---
+
+void PlatformInitConsole() {
+    if (console_active || !isatty(STDIN_FILENO)) return;
+
+    // 原始输入模式：无需回车、不回显、不做流控和回车转换；保留 ISIG 以便 Ctrl-C 退出
+    struct termios raw;
+    tcgetattr(STDIN_FILENO, &saved_termios);
+    raw = saved_termios;
+    raw.c_lflag &= ~(ICANON | ECHO | IEXTEN);
+    raw.c_iflag &= ~(IXON | ICRNL);
+    raw.c_cc[VMIN] = 1;
+    raw.c_cc[VTIME] = 0;
+    tcsetattr(STDIN_FILENO, TCSANOW, &raw);
+    console_active = 1;
+    atexit(PlatformShutdownConsole);
+
+    printf("\033[2J\033[?7l"); // 清屏并关闭自动换行，超出终端宽度的内容直接截断
+    HideCursor();
+}
+
+void PlatformShutdownConsole() {
+    if (!console_active) return;
+    tcsetattr(STDIN_FILENO, TCSANOW, &saved_termios);
+    printf("\033[?7h\033[?25h\n"); // 恢复自动换行和光标
+    fflush(stdout);
+    console_active = 0;
+}
+
+// 隐藏光标，防止闪烁
+void HideCursor() {
+    printf("\033[?25l");
+    fflush(stdout);
+}
+
+// 移动光标到指定位置 (ANSI 行列从1开始)
+void GotoXY(int x, int y) {
+    printf("\033[%d;%dH", y + 1, x + 1);
+}
+
+int PlatformWrite(const char* data, int length) {
+    int calls = 0;
+    while (length > 0) {
+        ssize_t written = write(STDOUT_FILENO, data, (size_t)length);
+        calls++;
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        data += written;
+        length -= (int)written;
+    }
+    return calls;
+}
+
+int PlatformTerminalSize(int* cols, int* rows) {
+    struct winsize size;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) != 0 || size.ws_col == 0 || size.ws_row == 0) return 0;
+    *cols = size.ws_col;
+    *rows = size.ws_row;
+    return 1;
+}
+
+// --- 键盘 ---
+
+int PlatformKeyPressed() {
+    fd_set fds;
+    struct timeval tv = {0, 0};
+    FD_ZERO(&fds);
+    FD_SET(STDIN_FILENO, &fds);
+    return select(STDIN_FILENO + 1, &fds, NULL, NULL, &tv) > 0;
+}
+
+int PlatformWaitKey() {
+    unsigned char c = 0;
+    fflush(stdout);
+    if (read(STDIN_FILENO, &c, 1) != 1) return -1;
+    return c;
+}
+
+// 终端无法检测 Shift 是否按住：大写 WASD 视为慢速移动
+static unsigned KeyMask(int key) {
+    switch (key) {
+        case 'W': return KEY_UP | KEY_SLOW;
+        case 'w': return KEY_UP;
+        case 'S': return KEY_DOWN | KEY_SLOW;
+        case 's': return KEY_DOWN;
+        case 'A': return KEY_LEFT | KEY_SLOW;
+        case 'a': return KEY_LEFT;
+        case 'D': return KEY_RIGHT | KEY_SLOW;
+        case 'd': return KEY_RIGHT;
+        case ' ': return KEY_SLOW;
+        default: return 0;
+    }
+}
+
+// 终端只发送字符，没有松开事件：按住时依靠自动重复不断收到同一个字符，超时未再收到即视为松开。
+// 单击只保持很短时间 (与原来一次按键移动一步接近)；自动重复开始后按重复间隔判断是否仍按住。
+#define KEY_HOLD_FIRST 0.03
+#define KEY_HOLD_REPEAT 0.10
+#define NUM_KEY_BITS 5
+
+static double key_release_time[NUM_KEY_BITS];
+
+unsigned PlatformScanKeys(double wait) {
+    fd_set fds;
+    struct timeval tv;
+    tv.tv_sec = (time_t)wait;
+    tv.tv_usec = (long)((wait - (double)tv.tv_sec) * 1e6);
+    FD_ZERO(&fds);
+    FD_SET(STDIN_FILENO, &fds);
+
+    // 一次读完所有已到达的字符，同时按下的多个方向键都会生效
+    unsigned pressed = 0;
+    if (select(STDIN_FILENO + 1, &fds, NULL, NULL, &tv) > 0) {
+        unsigned char bytes[64];
+        ssize_t n = read(STDIN_FILENO, bytes, sizeof(bytes));
+        for (ssize_t i = 0; i < n; i++) pressed |= KeyMask(bytes[i]);
+    }
+
+    double now = PlatformNow();
+    unsigned keys = 0;
+    for (int b = 0; b < NUM_KEY_BITS; b++) {
+        if (pressed & (1u << b)) {
+            int held = key_release_time[b] > now;
+            key_release_time[b] = now + (held ? KEY_HOLD_REPEAT : KEY_HOLD_FIRST);
+        }
+        if (key_release_time[b] > now) keys |= 1u << b;
+    }
+    return keys;
+}
+
+// --- 音效 ---
+
+// 终端没有可控制频率的蜂鸣器，静音处理
+void PlatformBeep(int frequency, int duration_ms) {
+    (void)frequency;
+    (void)duration_ms;
+}
+
+// --- 线程 ---
+
+struct PlatformThread {
+    pthread_t id;
+    void (*entry)(void* arg);
+    void* arg;
+};
+
+static void* ThreadMain(void* param) {
+    PlatformThread* thread = (PlatformThread*)param;
+    thread->entry(thread->arg);
+    return NULL;
+}
+
+PlatformThread* PlatformThreadStart(void (*entry)(void* arg), void* arg) {
+    PlatformThread* thread = (PlatformThread*)malloc(sizeof(PlatformThread));
+    if (thread == NULL) return NULL;
+
+    thread->entry = entry;
+    thread->arg = arg;
+    if (pthread_create(&thread->id, NULL, ThreadMain, thread) != 0) {
+        free(thread);
+        return NULL;
+    }
+    return thread;
+}
+
+void PlatformThreadJoin(PlatformThread* thread) {
+    if (thread == NULL) return;
+    pthread_join(thread->id, NULL);
+    free(thread);
+}
+
+int PlatformCpuCount() {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+}
+
+// --- 内存 ---
+
+void* PlatformAlignedAlloc(size_t alignment, size_t size) {
+    void* ptr = NULL;
+    if (posix_memalign(&ptr, alignment, size) != 0) return NULL;
+    return ptr;
+}
+
+void PlatformAlignedFree(void* ptr) {
+    free(ptr);
+}
+
+// --- 内存映射文件 ---
+
+struct PlatformFile {
+    int fd;
+    int writable;
+};
+
+PlatformFile* PlatformFileOpen(const char* path, int writable) {
+    int fd = writable ? open(path, O_RDWR | O_CREAT, 0644) : open(path, O_RDONLY);
+    if (fd < 0) return NULL;
+    PlatformFile* file = (PlatformFile*)malloc(sizeof(PlatformFile));
+    if (file == NULL) {
+        close(fd);
+        return NULL;
+    }
+    file->fd = fd;
+    file->writable = writable;
+    return file;
+}
+
+long long PlatformFileSize(PlatformFile* file) {
+    struct stat st;
+    if (fstat(file->fd, &st) != 0) return -1;
+    return (long long)st.st_size;
+}
+
+int PlatformFileResize(PlatformFile* file, long long size) {
+    return ftruncate(file->fd, (off_t)size) == 0;
+}
+
+void* PlatformFileMap(PlatformFile* file, long long offset, size_t size, int sequential) {
+    int prot = file->writable ? PROT_READ | PROT_WRITE : PROT_READ;
+    void* address = mmap(NULL, size, prot, MAP_SHARED, file->fd, (off_t)offset);
+    if (address == MAP_FAILED) return NULL;
+    if (sequential) posix_madvise(address, size, POSIX_MADV_SEQUENTIAL);
+    return address;
+}
+
+void PlatformFileUnmap(void* address, size_t size) {
+    if (address != NULL) munmap(address, size);
+}
+
+void PlatformFileClose(PlatformFile* file) {
+    if (file == NULL) return;
+    close(file->fd);
+    free(file);
+}
+
+size_t PlatformMapGranularity() {
+    return (size_t)sysconf(_SC_PAGESIZE);
+}
+
+int PlatformFileRead(PlatformFile* file, long long offset, void* data, size_t size) {
+    char* p = (char*)data;
+    while (size > 0) {
+        ssize_t n = pread(file->fd, p, size, (off_t)offset);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return 0;
+        p += n;
+        offset += n;
+        size -= (size_t)n;
+    }
+    return 1;
+}
+
+int PlatformFileWrite(PlatformFile* file, long long offset, const void* data, size_t size) {
+    const char* p = (const char*)data;
+    while (size > 0) {
+        ssize_t n = pwrite(file->fd, p, size, (off_t)offset);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return 0;
+        p += n;
+        offset += n;
+        size -= (size_t)n;
+    }
+    return 1;
+}
+
+int PlatformFileSync(PlatformFile* file) {
+    return fsync(file->fd) == 0;
+}
+
+int PlatformFileSyncMap(PlatformFile* file, void* address, size_t size) {
+    (void)file;
+    return msync(address, size, MS_SYNC) == 0;
+}
+
+// fcntl 记录锁：len 为 0 表示锁到文件末尾之后 (包括将来追加的部分)；wait 为 0 时不等待
+static int SetFileLock(PlatformFile* file, short type, int wait) {
+    struct flock lock;
+    memset(&lock, 0, sizeof(lock));
+    lock.l_type = type;
+    lock.l_whence = SEEK_SET;
+    while (fcntl(file->fd, wait ? F_SETLKW : F_SETLK, &lock) != 0) {
+        if (errno != EINTR) return 0;
+    }
+    return 1;
+}
+
+int PlatformFileLock(PlatformFile* file, int exclusive) {
+    return SetFileLock(file, exclusive ? F_WRLCK : F_RDLCK, 1);
+}
+
+int PlatformFileTryLock(PlatformFile* file, int exclusive) {
+    return SetFileLock(file, exclusive ? F_WRLCK : F_RDLCK, 0);
+}
+
+void PlatformFileUnlock(PlatformFile* file) {
+    SetFileLock(file, F_UNLCK, 1);
+}
+
+// --- 本地套接字 ---
+
+static int FillAddress(struct sockaddr_un* addr, const char* path) {
+    memset(addr, 0, sizeof(*addr));
+    addr->sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr->sun_path)) return 0;
+    strcpy(addr->sun_path, path);
+    return 1;
+}
+
+static void SetNonBlocking(int fd) {
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+}
+
+int PlatformLocalListen(const char* path) {
+    struct sockaddr_un addr;
+    if (!FillAddress(&addr, path)) return -1;
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+
+    unlink(path);
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(fd, 16) != 0) {
+        close(fd);
+        return -1;
+    }
+    SetNonBlocking(fd);
+    return fd;
+}
+
+int PlatformLocalAccept(int listener, int send_buffer) {
+    int fd = accept(listener, NULL, NULL);
+    if (fd < 0) return -1;
+    SetNonBlocking(fd);
+    if (send_buffer > 0) setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &send_buffer, sizeof(send_buffer));
+    return fd;
+}
+
+int PlatformLocalConnect(const char* path) {
+    struct sockaddr_un addr;
+    if (!FillAddress(&addr, path)) return -1;
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// MSG_NOSIGNAL：对方已关闭时返回 EPIPE 而不是产生 SIGPIPE
+int PlatformSocketSend(int socket, const void* data, int size) {
+    ssize_t n = send(socket, data, (size_t)size, MSG_NOSIGNAL | MSG_DONTWAIT);
+    if (n >= 0) return (int)n;
+    if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) return 0;
+    return -1;
+}
+
+int PlatformSocketRecv(int socket, void* data, int size, double wait) {
+    struct pollfd fds = {socket, POLLIN, 0};
+    int ready = poll(&fds, 1, (int)(wait * 1000));
+    if (ready < 0) return errno == EINTR ? 0 : -1;
+    if (ready == 0) return 0;
+
+    ssize_t n = recv(socket, data, (size_t)size, MSG_DONTWAIT);
+    if (n > 0) return (int)n;
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) return 0;
+    return -1;
+}
+
+void PlatformSocketClose(int socket) {
+    if (socket >= 0) close(socket);
+}
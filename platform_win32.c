@@ -0,0 +1,327 @@
+#include <conio.h>
+#include <windows.h>
+#include <mmsystem.h>
+#include <malloc.h>
+#include <stdlib.h>
+#include <string.h>
+#include "game.h"
+#include "platform.h"
+
+// --- 计时 ---
+
+double PlatformNow() {
+    static LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+}
+
+void PlatformSleep(double seconds) {
+    if (seconds > 0) {
+        Sleep((DWORD)(seconds * 1000.0));
+    }
+}
+
+// --- 辅助函数：控制台光标 ---
+
+void PlatformInitConsole() {
+    // 开启虚拟终端处理，让差分渲染器输出的 ANSI 光标序列生效 (Windows 10 及以上)
+    HANDLE output = GetStdHandle(STD_OUTPUT_HANDLE);
+    DWORD mode = 0;
+    if (GetConsoleMode(output, &mode)) {
+        SetConsoleMode(output, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+    }
+    timeBeginPeriod(1); // 系统定时器精度提到 1ms，否则 Sleep 按 ~15.6ms 取整
+    HideCursor();
+}
+
+void PlatformShutdownConsole() {
+    timeEndPeriod(1);
+}
+
+// 隐藏光标，防止闪烁
+void HideCursor() {
+    CONSOLE_CURSOR_INFO cursor_info = {1, 0};
+    SetConsoleCursorInfo(GetStdHandle(STD_OUTPUT_HANDLE), &cursor_info);
+}
+
+// 移动光标到指定位置 (替代 system("cls"))
+void GotoXY(int x, int y) {
+    COORD coord;
+    coord.X = x;
+    coord.Y = y;
+    SetConsoleCursorPosition(GetStdHandle(STD_OUTPUT_HANDLE), coord);
+}
+
+int PlatformWrite(const char* data, int length) {
+    HANDLE output = GetStdHandle(STD_OUTPUT_HANDLE);
+    int calls = 0;
+    while (length > 0) {
+        DWORD written = 0;
+        calls++;
+        if (!WriteFile(output, data, (DWORD)length, &written, NULL) || written == 0) break;
+        data += written;
+        length -= (int)written;
+    }
+    return calls;
+}
+
+// 可见窗口的大小 (不是整个屏幕缓冲区)
+int PlatformTerminalSize(int* cols, int* rows) {
+    CONSOLE_SCREEN_BUFFER_INFO info;
+    if (!GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &info)) return 0;
+    *cols = info.srWindow.Right - info.srWindow.Left + 1;
+    *rows = info.srWindow.Bottom - info.srWindow.Top + 1;
+    return 1;
+}
+
+// --- 键盘 ---
+
+// GetAsyncKeyState 直接给出按住状态，可以同时按多个方向键 (斜向移动)
+unsigned PlatformScanKeys(double wait) {
+    PlatformSleep(wait);
+
+    // 丢弃控制台输入缓冲区里的字符，避免游戏结束时被 PlatformWaitKey 读到
+    while (_kbhit()) _getch();
+
+    unsigned keys = 0;
+    if (GetAsyncKeyState('W') & 0x8000) keys |= KEY_UP;
+    if (GetAsyncKeyState('S') & 0x8000) keys |= KEY_DOWN;
+    if (GetAsyncKeyState('A') & 0x8000) keys |= KEY_LEFT;
+    if (GetAsyncKeyState('D') & 0x8000) keys |= KEY_RIGHT;
+    if ((GetAsyncKeyState(VK_SHIFT) & 0x8000) || (GetAsyncKeyState(VK_SPACE) & 0x8000)) {
+        keys |= KEY_SLOW;
+    }
+    return keys;
+}
+
+int PlatformKeyPressed() {
+    return _kbhit();
+}
+
+int PlatformWaitKey() {
+    return _getch();
+}
+
+// --- 音效 ---
+
+void PlatformBeep(int frequency, int duration_ms) {
+    Beep(frequency, duration_ms);
+}
+
+// --- 线程 ---
+
+struct PlatformThread {
+    HANDLE handle;
+    void (*entry)(void* arg);
+    void* arg;
+};
+
+static DWORD WINAPI ThreadMain(LPVOID param) {
+    PlatformThread* thread = (PlatformThread*)param;
+    thread->entry(thread->arg);
+    return 0;
+}
+
+PlatformThread* PlatformThreadStart(void (*entry)(void* arg), void* arg) {
+    PlatformThread* thread = (PlatformThread*)malloc(sizeof(PlatformThread));
+    if (thread == NULL) return NULL;
+
+    thread->entry = entry;
+    thread->arg = arg;
+    thread->handle = CreateThread(NULL, 0, ThreadMain, thread, 0, NULL);
+    if (thread->handle == NULL) {
+        free(thread);
+        return NULL;
+    }
+    return thread;
+}
+
+void PlatformThreadJoin(PlatformThread* thread) {
+    if (thread == NULL) return;
+    WaitForSingleObject(thread->handle, INFINITE);
+    CloseHandle(thread->handle);
+    free(thread);
+}
+
+int PlatformCpuCount() {
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (int)info.dwNumberOfProcessors : 1;
+}
+
+// --- 内存 ---
+
+void* PlatformAlignedAlloc(size_t alignment, size_t size) {
+    return _aligned_malloc(size, alignment);
+}
+
+void PlatformAlignedFree(void* ptr) {
+    _aligned_free(ptr);
+}
+
+// --- 内存映射文件 ---
+
+struct PlatformFile {
+    HANDLE handle;
+    int writable;
+};
+
+PlatformFile* PlatformFileOpen(const char* path, int writable) {
+    HANDLE handle = writable
+        ? CreateFileA(path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL)
+        : CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING,
+                      FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (handle == INVALID_HANDLE_VALUE) return NULL;
+    PlatformFile* file = (PlatformFile*)malloc(sizeof(PlatformFile));
+    if (file == NULL) {
+        CloseHandle(handle);
+        return NULL;
+    }
+    file->handle = handle;
+    file->writable = writable;
+    return file;
+}
+
+long long PlatformFileSize(PlatformFile* file) {
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file->handle, &size)) return -1;
+    return (long long)size.QuadPart;
+}
+
+int PlatformFileResize(PlatformFile* file, long long size) {
+    LARGE_INTEGER position;
+    position.QuadPart = size;
+    return SetFilePointerEx(file->handle, position, NULL, FILE_BEGIN) && SetEndOfFile(file->handle);
+}
+
+// 每次映射单独建一个映射对象，视图保持期间对象不会真正释放
+void* PlatformFileMap(PlatformFile* file, long long offset, size_t size, int sequential) {
+    (void)sequential; // 顺序预读已在打开时由 FILE_FLAG_SEQUENTIAL_SCAN 提示
+    HANDLE mapping = CreateFileMappingA(file->handle, NULL, file->writable ? PAGE_READWRITE : PAGE_READONLY, 0, 0, NULL);
+    if (mapping == NULL) return NULL;
+    void* address = MapViewOfFile(mapping, file->writable ? FILE_MAP_WRITE : FILE_MAP_READ,
+                                  (DWORD)((unsigned long long)offset >> 32), (DWORD)(offset & 0xFFFFFFFF), size);
+    CloseHandle(mapping);
+    return address;
+}
+
+void PlatformFileUnmap(void* address, size_t size) {
+    (void)size;
+    if (address != NULL) UnmapViewOfFile(address);
+}
+
+void PlatformFileClose(PlatformFile* file) {
+    if (file == NULL) return;
+    CloseHandle(file->handle);
+    free(file);
+}
+
+size_t PlatformMapGranularity() {
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (size_t)info.dwAllocationGranularity;
+}
+
+// 带偏移的读写用 OVERLAPPED 指定位置 (同步句柄上仍是阻塞调用)，每次最多 1GB
+#define FILE_IO_STEP (1u << 30)
+
+static OVERLAPPED OffsetOverlapped(long long offset) {
+    OVERLAPPED overlapped;
+    memset(&overlapped, 0, sizeof(overlapped));
+    overlapped.Offset = (DWORD)(offset & 0xFFFFFFFF);
+    overlapped.OffsetHigh = (DWORD)((unsigned long long)offset >> 32);
+    return overlapped;
+}
+
+int PlatformFileRead(PlatformFile* file, long long offset, void* data, size_t size) {
+    char* p = (char*)data;
+    while (size > 0) {
+        DWORD step = size > FILE_IO_STEP ? FILE_IO_STEP : (DWORD)size, n = 0;
+        OVERLAPPED overlapped = OffsetOverlapped(offset);
+        if (!ReadFile(file->handle, p, step, &n, &overlapped) || n == 0) return 0;
+        p += n;
+        offset += n;
+        size -= n;
+    }
+    return 1;
+}
+
+int PlatformFileWrite(PlatformFile* file, long long offset, const void* data, size_t size) {
+    const char* p = (const char*)data;
+    while (size > 0) {
+        DWORD step = size > FILE_IO_STEP ? FILE_IO_STEP : (DWORD)size, n = 0;
+        OVERLAPPED overlapped = OffsetOverlapped(offset);
+        if (!WriteFile(file->handle, p, step, &n, &overlapped) || n == 0) return 0;
+        p += n;
+        offset += n;
+        size -= n;
+    }
+    return 1;
+}
+
+int PlatformFileSync(PlatformFile* file) {
+    return FlushFileBuffers(file->handle) != 0;
+}
+
+// FlushViewOfFile 只把页交给系统写回，还要 FlushFileBuffers 等它真正落盘
+int PlatformFileSyncMap(PlatformFile* file, void* address, size_t size) {
+    return FlushViewOfFile(address, size) && FlushFileBuffers(file->handle);
+}
+
+int PlatformFileLock(PlatformFile* file, int exclusive) {
+    OVERLAPPED overlapped = OffsetOverlapped(0);
+    return LockFileEx(file->handle, exclusive ? LOCKFILE_EXCLUSIVE_LOCK : 0, 0, MAXDWORD, MAXDWORD, &overlapped) != 0;
+}
+
+int PlatformFileTryLock(PlatformFile* file, int exclusive) {
+    OVERLAPPED overlapped = OffsetOverlapped(0);
+    DWORD flags = LOCKFILE_FAIL_IMMEDIATELY | (exclusive ? LOCKFILE_EXCLUSIVE_LOCK : 0);
+    return LockFileEx(file->handle, flags, 0, MAXDWORD, MAXDWORD, &overlapped) != 0;
+}
+
+void PlatformFileUnlock(PlatformFile* file) {
+    OVERLAPPED overlapped = OffsetOverlapped(0);
+    UnlockFileEx(file->handle, 0, MAXDWORD, MAXDWORD, &overlapped);
+}
+
+// --- 本地套接字 ---
+// 尚未实现 (可改用命名管道或 AF_UNIX 的 Winsock 版本)，观战功能在 Windows 上不可用
+
+int PlatformLocalListen(const char* path) {
+    (void)path;
+    return -1;
+}
+
+int PlatformLocalAccept(int listener, int send_buffer) {
+    (void)listener;
+    (void)send_buffer;
+    return -1;
+}
+
+int PlatformLocalConnect(const char* path) {
+    (void)path;
+    return -1;
+}
+
+int PlatformSocketSend(int socket, const void* data, int size) {
+    (void)socket;
+    (void)data;
+    (void)size;
+    return -1;
+}
+
+int PlatformSocketRecv(int socket, void* data, int size, double wait) {
+    (void)socket;
+    (void)data;
+    (void)size;
+    (void)wait;
+    return -1;
+}
+
+void PlatformSocketClose(int socket) {
+    (void)socket;
+}
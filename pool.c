@@ -0,0 +1,42 @@
+#include "pool.h"
+
+void PoolInit(Pool* pool, int* link, int* dense, int capacity) {
+    pool->capacity = capacity;
+    pool->link = link;
+    pool->dense = dense;
+    PoolClear(pool);
+}
+
+// 回收全部槽位，空闲链表按索引顺序重建 (先分配低索引)
+void PoolClear(Pool* pool) {
+    for (int i = 0; i < pool->capacity; i++) {
+        pool->link[i] = i + 1;
+    }
+    if (pool->capacity > 0) {
+        pool->link[pool->capacity - 1] = -1;
+    }
+    pool->free_head = pool->capacity > 0 ? 0 : -1;
+    pool->count = 0;
+}
+
+int PoolAcquire(Pool* pool) {
+    int slot = pool->free_head;
+    if (slot < 0) return -1;
+
+    pool->free_head = pool->link[slot];
+    pool->link[slot] = pool->count;
+    pool->dense[pool->count++] = slot;
+    return slot;
+}
+
+void PoolRelease(Pool* pool, int slot) {
+    // 用末尾的活跃槽位填补空洞
+    int pos = pool->link[slot];
+    int last = pool->dense[--pool->count];
+    pool->dense[pos] = last;
+    pool->link[last] = pos;
+
+    // 槽位挂回空闲链表头
+    pool->link[slot] = pool->free_head;
+    pool->free_head = slot;
+}
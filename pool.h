@@ -0,0 +1,25 @@
+#ifndef POOL_H
+#define POOL_H
+
+// 对象池：O(1) 分配/回收 + 活跃索引紧凑数组
+//
+// link 数组是侵入式空闲链表：空闲槽位存放下一个空闲槽位，活跃槽位存放自己在 dense 中的位置。
+// dense[0..count) 是所有活跃槽位，回收时把末尾元素换到被删除的位置 (swap-remove)，
+// 所以遍历和分配的开销只与活跃对象数量有关，与容量无关。
+//
+// 遍历时如果要回收当前对象，请从 count-1 倒序遍历到 0：被换过来的元素已经处理过。
+
+typedef struct {
+    int capacity;
+    int count;       // 活跃对象数量
+    int free_head;   // 空闲链表头 (-1 表示已满)
+    int* link;       // 空闲: 下一个空闲槽位; 活跃: 在 dense 中的位置
+    int* dense;      // 活跃槽位索引
+} Pool;
+
+void PoolInit(Pool* pool, int* link, int* dense, int capacity);
+void PoolClear(Pool* pool);
+int PoolAcquire(Pool* pool);              // 返回槽位索引，池满时返回 -1
+void PoolRelease(Pool* pool, int slot);
+
+#endif
@@ -0,0 +1,195 @@
+#include "profiler.h"
+
+#ifdef ENABLE_PROFILER
+
+#include <stdio.h>
+#include <string.h>
+#include "platform.h"
+
+// 对数-线性分桶：小于 16 的值精确记录，之后每个 2 的幂区间再细分 8 桶 (误差 < 12.5%)
+#define LINEAR_BUCKETS 16
+#define SUB_BUCKETS 8
+#define SUB_BITS 3
+#define NUM_BUCKETS (LINEAR_BUCKETS + (64 - 4) * SUB_BUCKETS)
+
+typedef struct {
+    unsigned long long samples;
+    unsigned long long total;
+    unsigned long long max;
+    unsigned int buckets[NUM_BUCKETS];
+} Histogram;
+
+static Histogram phases[PROF_PHASE_COUNT];
+static Histogram counters[PROF_COUNTER_COUNT];
+
+// 时钟校准：第一次记录时取一对 (ticks, 秒)，导出时再取一对，算出每秒 tick 数
+static int calibrated = 0;
+static unsigned long long base_ticks;
+static double base_seconds;
+
+static const char* phase_names[PROF_PHASE_COUNT] = {
+    "input", "autofire", "bullets", "enemies", "items", "explosions",
+    "collide_grid", "collide_a", "collide_b", "collide_c", "collide_d", "update_jobs",
+    "draw_clear", "draw_bullets", "draw_items", "draw_explosions", "draw_enemies",
+    "draw_player", "draw_hud", "draw_present",
+};
+
+static const char* counter_names[PROF_COUNTER_COUNT] = {
+    "player_bullets", "enemy_bullets", "enemies", "items", "explosions",
+};
+
+#if !PROFILER_RDTSC
+unsigned long long ProfilerTicks() {
+    return (unsigned long long)(PlatformNow() * 1e9);
+}
+#endif
+
+static int BucketIndex(unsigned long long v) {
+    if (v < LINEAR_BUCKETS) return (int)v;
+
+    int octave = 63;
+    while (!(v >> octave)) octave--;
+    int sub = (int)((v >> (octave - SUB_BITS)) & (SUB_BUCKETS - 1));
+    return LINEAR_BUCKETS + (octave - 4) * SUB_BUCKETS + sub;
+}
+
+// 桶的上界 (百分位取上界，偏保守)
+static unsigned long long BucketUpper(int index) {
+    if (index < LINEAR_BUCKETS) return (unsigned long long)index;
+
+    int octave = (index - LINEAR_BUCKETS) / SUB_BUCKETS + 4;
+    int sub = (index - LINEAR_BUCKETS) % SUB_BUCKETS;
+    unsigned long long step = 1ULL << (octave - SUB_BITS);
+    return (1ULL << octave) + (unsigned long long)(sub + 1) * step - 1;
+}
+
+static void HistogramAdd(Histogram* h, unsigned long long v) {
+    h->samples++;
+    h->total += v;
+    if (v > h->max) h->max = v;
+    h->buckets[BucketIndex(v)]++;
+}
+
+static unsigned long long HistogramPercentile(const Histogram* h, double p) {
+    if (h->samples == 0) return 0;
+
+    unsigned long long target = (unsigned long long)(p * (double)h->samples);
+    if (target >= h->samples) target = h->samples - 1;
+    unsigned long long seen = 0;
+    for (int i = 0; i < NUM_BUCKETS; i++) {
+        seen += h->buckets[i];
+        if (seen > target) {
+            unsigned long long upper = BucketUpper(i);
+            return upper < h->max ? upper : h->max;
+        }
+    }
+    return h->max;
+}
+
+void ProfilerRecord(ProfPhase phase, unsigned long long ticks) {
+    if (!calibrated) {
+        base_ticks = ProfilerTicks();
+        base_seconds = PlatformNow();
+        calibrated = 1;
+    }
+    HistogramAdd(&phases[phase], ticks);
+}
+
+void ProfilerCount(ProfCounter counter, unsigned long long value) {
+    HistogramAdd(&counters[counter], value);
+}
+
+static double TicksPerSecond() {
+#if PROFILER_RDTSC
+    double elapsed = PlatformNow() - base_seconds;
+    unsigned long long ticks = ProfilerTicks() - base_ticks;
+    if (!calibrated || elapsed <= 0.001) {
+        // 运行时间太短无法校准：短暂忙等一段再测
+        base_ticks = ProfilerTicks();
+        base_seconds = PlatformNow();
+        while (PlatformNow() - base_seconds < 0.01) {
+        }
+        elapsed = PlatformNow() - base_seconds;
+        ticks = ProfilerTicks() - base_ticks;
+    }
+    return (double)ticks / elapsed;
+#else
+    return 1e9;
+#endif
+}
+
+typedef struct {
+    const char* name;
+    const char* unit;
+    unsigned long long samples;
+    double mean, p50, p99, max;
+} Summary;
+
+static Summary Summarize(const char* name, const char* unit, const Histogram* h, double scale) {
+    Summary s;
+    s.name = name;
+    s.unit = unit;
+    s.samples = h->samples;
+    s.mean = h->samples > 0 ? (double)h->total / (double)h->samples * scale : 0.0;
+    s.p50 = (double)HistogramPercentile(h, 0.50) * scale;
+    s.p99 = (double)HistogramPercentile(h, 0.99) * scale;
+    s.max = (double)h->max * scale;
+    return s;
+}
+
+void ProfilerReset() {
+    memset(phases, 0, sizeof(phases));
+    memset(counters, 0, sizeof(counters));
+}
+
+ProfilerPhaseStats ProfilerGetPhase(ProfPhase phase) {
+    Summary s = Summarize(phase_names[phase], "us", &phases[phase], 1e6 / TicksPerSecond());
+    ProfilerPhaseStats stats = {s.name, s.samples, s.mean, s.p50, s.p99, s.max};
+    return stats;
+}
+
+static int EndsWith(const char* text, const char* suffix) {
+    size_t n = strlen(text), m = strlen(suffix);
+    return n >= m && strcmp(text + n - m, suffix) == 0;
+}
+
+int ProfilerDump(const char* path) {
+    FILE* file = fopen(path, "w");
+    if (file == NULL) return 0;
+
+    // 阶段耗时换算为微秒，计数保持原值
+    double us_per_tick = 1e6 / TicksPerSecond();
+    Summary rows[PROF_PHASE_COUNT + PROF_COUNTER_COUNT];
+    int num_rows = 0;
+    for (int i = 0; i < PROF_PHASE_COUNT; i++) {
+        if (phases[i].samples > 0) rows[num_rows++] = Summarize(phase_names[i], "us", &phases[i], us_per_tick);
+    }
+    for (int i = 0; i < PROF_COUNTER_COUNT; i++) {
+        if (counters[i].samples > 0) rows[num_rows++] = Summarize(counter_names[i], "count", &counters[i], 1.0);
+    }
+
+    if (EndsWith(path, ".json")) {
+        fprintf(file, "{\n  \"clock\": \"%s\",\n  \"rows\": [\n", PROFILER_RDTSC ? "rdtsc" : "monotonic");
+        for (int i = 0; i < num_rows; i++) {
+            fprintf(file, "    {\"name\": \"%s\", \"unit\": \"%s\", \"samples\": %llu, "
+                          "\"mean\": %.4f, \"p50\": %.4f, \"p99\": %.4f, \"max\": %.4f}%s\n",
+                    rows[i].name, rows[i].unit, rows[i].samples, rows[i].mean, rows[i].p50,
+                    rows[i].p99, rows[i].max, i + 1 < num_rows ? "," : "");
+        }
+        fprintf(file, "  ]\n}\n");
+    } else {
+        fprintf(file, "name,unit,samples,mean,p50,p99,max\n");
+        for (int i = 0; i < num_rows; i++) {
+            fprintf(file, "%s,%s,%llu,%.4f,%.4f,%.4f,%.4f\n", rows[i].name, rows[i].unit,
+                    rows[i].samples, rows[i].mean, rows[i].p50, rows[i].p99, rows[i].max);
+        }
+    }
+    fclose(file);
+    return 1;
+}
+
+#else
+
+typedef int ProfilerDisabled; // 未启用时本文件为空 (ISO C 不允许空翻译单元)
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+// 分阶段性能剖析：用 -DENABLE_PROFILER 编译时生效，否则所有宏展开为空，发布版本零开销。
+//
+//   PROF_BEGIN(PROF_BULLETS);
+//   ...
+//   PROF_END(PROF_BULLETS);
+//
+// 每个阶段每次调用记录一个样本，进入对数分桶直方图 (p50/p99/max)；
+// PROF_COUNT 记录每帧实体数量。PROF_DUMP(path) 在退出时写出 CSV 或 JSON (按扩展名)。
+// 统计数据是不加锁的全局变量，只能在一个线程里记录：任务池的任务体内不要调用这些宏。
+
+typedef enum {
+    // Update
+    PROF_INPUT,
+    PROF_AUTOFIRE,
+    PROF_BULLETS,
+    PROF_ENEMIES,
+    PROF_ITEMS,
+    PROF_EXPLOSIONS,
+    PROF_COLLIDE_GRID,  // 构建碰撞网格
+    PROF_COLLIDE_A,     // 子弹 vs 敌人
+    PROF_COLLIDE_B,     // 敌机子弹 vs 玩家
+    PROF_COLLIDE_C,     // 敌机本体 vs 玩家
+    PROF_COLLIDE_D,     // 玩家 vs 道具
+    PROF_UPDATE_JOBS,   // 多线程 Update 的整个任务图 (在调用线程测量，任务内部不记录)
+    // Draw
+    PROF_DRAW_CLEAR,
+    PROF_DRAW_BULLETS,
+    PROF_DRAW_ITEMS,
+    PROF_DRAW_EXPLOSIONS,
+    PROF_DRAW_ENEMIES,
+    PROF_DRAW_PLAYER,
+    PROF_DRAW_HUD,
+    PROF_DRAW_PRESENT,
+    PROF_PHASE_COUNT
+} ProfPhase;
+
+typedef enum {
+    PROF_COUNT_PLAYER_BULLETS,
+    PROF_COUNT_ENEMY_BULLETS,
+    PROF_COUNT_ENEMIES,
+    PROF_COUNT_ITEMS,
+    PROF_COUNT_EXPLOSIONS,
+    PROF_COUNTER_COUNT
+} ProfCounter;
+
+#ifdef ENABLE_PROFILER
+
+#define PROFILER_ENABLED 1
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define ProfilerTicks() __rdtsc()
+#define PROFILER_RDTSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define ProfilerTicks() __rdtsc()
+#define PROFILER_RDTSC 1
+#else
+unsigned long long ProfilerTicks(); // 单调时钟 (纳秒)
+#define PROFILER_RDTSC 0
+#endif
+
+// 一个阶段到目前为止的统计，耗时单位为微秒
+typedef struct {
+    const char* name;
+    unsigned long long samples;
+    double mean, p50, p99, max;
+} ProfilerPhaseStats;
+
+void ProfilerRecord(ProfPhase phase, unsigned long long ticks);
+void ProfilerCount(ProfCounter counter, unsigned long long value);
+int ProfilerDump(const char* path); // 成功返回 1
+void ProfilerReset();               // 清空所有阶段和计数 (保留时钟校准)，用于分段统计
+ProfilerPhaseStats ProfilerGetPhase(ProfPhase phase);
+
+#define PROF_BEGIN(phase) unsigned long long prof_start_##phase = ProfilerTicks()
+#define PROF_END(phase) ProfilerRecord(phase, ProfilerTicks() - prof_start_##phase)
+#define PROF_COUNT(counter, value) ProfilerCount(counter, (unsigned long long)(value))
+#define PROF_DUMP(path) ProfilerDump(path)
+
+#else
+
+#define PROFILER_ENABLED 0
+#define PROF_BEGIN(phase) ((void)0)
+#define PROF_END(phase) ((void)0)
+#define PROF_COUNT(counter, value) ((void)0)
+#define PROF_DUMP(path) 0
+
+#endif
+
+#endif
@@ -0,0 +1,248 @@
+#include <stdio.h>
+#include <string.h>
+#include "game.h"
+#include "profiler.h"
+#include "render.h"
+
+// 帧绘制：只生成字符画面，不做任何终端输出 (输出见 screen.c)
+
+// 辅助函数：在buffer中安全地放置字符 (buffer 为 width x height 的游戏区域)
+static void PutChar(int width, int height, char* buffer, int x, int y, char c) {
+    if (x > 0 && x < width - 1 && y > 0 && y < height - 1) {
+        buffer[y * (width + 1) + x] = c;
+    }
+}
+
+// 以下绘制函数由 RenderWorld 和 RenderSnapshotWorld 共用，两者画出的画面完全相同
+
+static void ClearField(int width, int height, char* buffer) {
+    for (int y = 0; y < height; y++) {
+        char* row = buffer + y * (width + 1);
+        for (int x = 0; x < width; x++) {
+            if (y == 0 || y == height - 1) row[x] = '-';
+            else if (x == 0 || x == width - 1) row[x] = '|';
+            else row[x] = ' ';
+        }
+        row[width] = '\0';
+    }
+}
+
+static void DrawItem(int width, int height, char* buffer, int x, int y, int type) {
+    PutChar(width, height, buffer, x, y, type == 0 ? 'H' : 'P');
+}
+
+// 根据计时器显示不同阶段的爆炸
+static void DrawExplosion(int width, int height, char* buffer, int x, int y, int timer) {
+    if (timer > 6) {
+        PutChar(width, height, buffer, x, y, '#');
+        PutChar(width, height, buffer, x-1, y, '*');
+        PutChar(width, height, buffer, x+1, y, '*');
+    } else if (timer > 3) {
+        PutChar(width, height, buffer, x, y, 'X');
+        PutChar(width, height, buffer, x-1, y, 'x');
+        PutChar(width, height, buffer, x+1, y, 'x');
+    } else {
+        PutChar(width, height, buffer, x, y, '+');
+    }
+}
+
+// 造型为上一行和本行各 3 列，' ' 为透明
+static void DrawEnemy(int width, int height, char* buffer, int x, int y, const char (*sprite)[4]) {
+    for (int row = 0; row < 2; row++) {
+        for (int col = 0; col < 3; col++) {
+            char c = sprite[row][col];
+            if (c != ' ') PutChar(width, height, buffer, x + col - 1, y + row - 1, c);
+        }
+    }
+}
+
+static void DrawPlayer(int width, int height, char* buffer, const Player* player) {
+    int px = RToInt(player->pos.x);
+    int py = RToInt(player->pos.y);
+    if (px > 0 && px < width - 1 && py > 0 && py < height - 1) {
+        PutChar(width, height, buffer, px, py, 'A');
+        PutChar(width, height, buffer, px-1, py+1, '/');
+        PutChar(width, height, buffer, px+1, py+1, '\\');
+        PutChar(width, height, buffer, px, py-1, '^');
+        
+        // 在慢速模式下显示精确判定点
+        if (player->slow_mode) {
+            PutChar(width, height, buffer, px, py, 'o'); // 显示判定点
+        }
+    }
+}
+
+// 把当前游戏状态绘制到字符缓冲区 (使用缓冲区思想)
+void RenderWorld(const GameState* game, char* buffer) {
+    int width = game->config.width, height = game->config.height;
+    // 1. 清空 Buffer (填充背景)
+    PROF_BEGIN(PROF_DRAW_CLEAR);
+    ClearField(width, height, buffer);
+    PROF_END(PROF_DRAW_CLEAR);
+
+    // 2. 绘制子弹
+    PROF_BEGIN(PROF_DRAW_BULLETS);
+    for (int i = 0; i < game->player_bullets.count; i++) {
+        PutChar(width, height, buffer, RToInt(game->player_bullets.x[i]), RToInt(game->player_bullets.y[i]), '|');
+    }
+    for (int i = 0; i < game->enemy_bullets.count; i++) {
+        PutChar(width, height, buffer, RToInt(game->enemy_bullets.x[i]), RToInt(game->enemy_bullets.y[i]), '*');
+    }
+    PROF_END(PROF_DRAW_BULLETS);
+
+    // 3. 绘制道具
+    PROF_BEGIN(PROF_DRAW_ITEMS);
+    for (int k = 0; k < game->item_pool.count; k++) {
+        int i = game->item_pool.dense[k];
+        DrawItem(width, height, buffer, RToInt(game->items[i].pos.x), RToInt(game->items[i].pos.y), game->items[i].type);
+    }
+    PROF_END(PROF_DRAW_ITEMS);
+
+    // 4. 绘制爆炸效果 (多字符)
+    PROF_BEGIN(PROF_DRAW_EXPLOSIONS);
+    for (int k = 0; k < game->explosion_pool.count; k++) {
+        int i = game->explosion_pool.dense[k];
+        DrawExplosion(width, height, buffer, RToInt(game->explosions[i].pos.x), RToInt(game->explosions[i].pos.y),
+                      game->explosions[i].timer);
+    }
+    PROF_END(PROF_DRAW_EXPLOSIONS);
+
+    // 5. 绘制敌人 (多字符造型，同组共用原型表里的造型)
+    PROF_BEGIN(PROF_DRAW_ENEMIES);
+    for (int t = 0; t < ENEMY_TYPE_COUNT; t++) {
+        for (int i = game->enemies.start[t]; i < game->enemies.start[t + 1]; i++) {
+            DrawEnemy(width, height, buffer, RToInt(game->enemies.x[i]), RToInt(game->enemies.y[i]),
+                      game->archetypes[t].sprite);
+        }
+    }
+    PROF_END(PROF_DRAW_ENEMIES);
+
+    // 6. 绘制玩家 (多字符造型)
+    PROF_BEGIN(PROF_DRAW_PLAYER);
+    DrawPlayer(width, height, buffer, &game->player);
+    PROF_END(PROF_DRAW_PLAYER);
+}
+
+// 生成状态栏文字，返回长度
+static int FormatHud(const Player* player, char* out, int size) {
+    int len = 0;
+
+#define HUD_APPEND(...) \
+    do { \
+        if (len < size) len += snprintf(out + len, size - len, __VA_ARGS__); \
+    } while (0)
+
+    // 生命值条显示
+    HUD_APPEND("Score: %d  Lives: ", player->score);
+    for (int i = 0; i < player->lives && i < 5; i++) {
+        HUD_APPEND("*");
+    }
+    for (int i = player->lives; i < 5; i++) {
+        HUD_APPEND("-");
+    }
+    
+    // 火力等级显示
+    if (player->power_level > 0) {
+        HUD_APPEND("  POWER: ");
+        for (int i = 0; i < player->power_level; i++) {
+            HUD_APPEND("P");
+        }
+        HUD_APPEND(" (%ds)", (player->power_timer * 16) / 1000); // 正确计算秒数
+    }
+    
+    // 擦弹计数显示
+    HUD_APPEND("  Graze: %d", player->graze_count);
+    
+    // 慢速模式显示
+    if (player->slow_mode) {
+        HUD_APPEND("  [SLOW]");
+    }
+    
+    // 无敌状态显示
+    if (player->invincible_timer > 0) {
+        HUD_APPEND("  [INVINCIBLE]");
+    }
+    
+    HUD_APPEND("  (WASD + Space/Shift)");
+
+#undef HUD_APPEND
+    return len < size ? len : size - 1;
+}
+
+int RenderHud(const GameState* game, char* out, int size) {
+    return FormatHud(&game->player, out, size);
+}
+
+// --- 绘制快照 ---
+
+size_t RenderSnapshotBytes(const GameConfig* config) {
+    size_t marks = 2 * (size_t)config->max_bullets + config->max_enemies + config->max_items + config->max_explosions;
+    return sizeof(RenderSnapshot) + marks * sizeof(RenderMark);
+}
+
+void RenderSnapshotInit(RenderSnapshot* snapshot, const GameConfig* config) {
+    memset(snapshot, 0, sizeof(RenderSnapshot));
+    snapshot->width = config->width;
+    snapshot->height = config->height;
+    snapshot->capacity = (int)((RenderSnapshotBytes(config) - sizeof(RenderSnapshot)) / sizeof(RenderMark));
+}
+
+static void AddMark(RenderSnapshot* snapshot, int x, int y, RenderMarkKind kind, int arg) {
+    RenderMark* mark = &snapshot->marks[snapshot->count++];
+    mark->x = (int16_t)x;
+    mark->y = (int16_t)y;
+    mark->kind = (uint8_t)kind;
+    mark->arg = (uint8_t)(arg < 0 ? 0 : arg > 255 ? 255 : arg);
+}
+
+// 只拷贝绘制需要的数据：坐标先转成格子，按 RenderWorld 的绘制顺序排列。
+// 各类实体的数量都不超过配置的容量，合计不会超过 capacity
+void CaptureRenderSnapshot(const GameState* game, RenderSnapshot* snapshot) {
+    snapshot->frame = game->frame_count;
+    snapshot->player = game->player;
+    for (int t = 0; t < ENEMY_TYPE_COUNT; t++) {
+        memcpy(snapshot->sprites[t], game->archetypes[t].sprite, sizeof(snapshot->sprites[t]));
+    }
+
+    snapshot->count = 0;
+    for (int i = 0; i < game->player_bullets.count; i++) {
+        AddMark(snapshot, RToInt(game->player_bullets.x[i]), RToInt(game->player_bullets.y[i]), MARK_PLAYER_BULLET, 0);
+    }
+    for (int i = 0; i < game->enemy_bullets.count; i++) {
+        AddMark(snapshot, RToInt(game->enemy_bullets.x[i]), RToInt(game->enemy_bullets.y[i]), MARK_ENEMY_BULLET, 0);
+    }
+    for (int k = 0; k < game->item_pool.count; k++) {
+        const Item* item = &game->items[game->item_pool.dense[k]];
+        AddMark(snapshot, RToInt(item->pos.x), RToInt(item->pos.y), MARK_ITEM, item->type);
+    }
+    for (int k = 0; k < game->explosion_pool.count; k++) {
+        const Explosion* explosion = &game->explosions[game->explosion_pool.dense[k]];
+        AddMark(snapshot, RToInt(explosion->pos.x), RToInt(explosion->pos.y), MARK_EXPLOSION, explosion->timer);
+    }
+    for (int t = 0; t < ENEMY_TYPE_COUNT; t++) {
+        for (int i = game->enemies.start[t]; i < game->enemies.start[t + 1]; i++) {
+            AddMark(snapshot, RToInt(game->enemies.x[i]), RToInt(game->enemies.y[i]), MARK_ENEMY, t);
+        }
+    }
+}
+
+// 不记录剖析数据：可能与游戏线程的 RenderWorld 同时运行
+void RenderSnapshotWorld(const RenderSnapshot* snapshot, char* buffer) {
+    int width = snapshot->width, height = snapshot->height;
+    ClearField(width, height, buffer);
+    for (int i = 0; i < snapshot->count; i++) {
+        const RenderMark* mark = &snapshot->marks[i];
+        switch (mark->kind) {
+            case MARK_PLAYER_BULLET: PutChar(width, height, buffer, mark->x, mark->y, '|'); break;
+            case MARK_ENEMY_BULLET: PutChar(width, height, buffer, mark->x, mark->y, '*'); break;
+            case MARK_ITEM: DrawItem(width, height, buffer, mark->x, mark->y, mark->arg); break;
+            case MARK_EXPLOSION: DrawExplosion(width, height, buffer, mark->x, mark->y, mark->arg); break;
+            case MARK_ENEMY: DrawEnemy(width, height, buffer, mark->x, mark->y, snapshot->sprites[mark->arg]); break;
+        }
+    }
+    DrawPlayer(width, height, buffer, &snapshot->player);
+}
+
+int RenderSnapshotHud(const RenderSnapshot* snapshot, char* out, int size) {
+    return FormatHud(&snapshot->player, out, size);
+}
@@ -0,0 +1,50 @@
+#ifndef RENDER_H
+#define RENDER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "game.h"
+
+// 状态栏最大宽度 (字符)
+#define HUD_WIDTH 100
+
+// buffer 为 height 行、每行 width + 1 字节 (行尾 '\0')，通常就是 game->render_buffer
+void RenderWorld(const GameState* game, char* buffer);
+int RenderHud(const GameState* game, char* out, int size);
+
+// 绘制快照：画一帧需要的全部数据，由游戏线程从 GameState 拷出，之后可以在别的线程绘制 (见 renderthread.h)。
+// 实体只保留格子坐标和类型，按 RenderWorld 的绘制顺序排列 (后画的盖住先画的)，
+// RenderSnapshotWorld / RenderSnapshotHud 画出的画面与 RenderWorld / RenderHud 完全相同
+typedef enum {
+    MARK_PLAYER_BULLET,
+    MARK_ENEMY_BULLET,
+    MARK_ITEM,           // arg 为道具类型
+    MARK_EXPLOSION,      // arg 为剩余时间 (超过 255 时截断，不影响造型)
+    MARK_ENEMY           // arg 为敌机类型
+} RenderMarkKind;
+
+typedef struct {
+    int16_t x, y;
+    uint8_t kind;        // RenderMarkKind
+    uint8_t arg;
+} RenderMark;
+
+typedef struct {
+    int frame;                           // game->frame_count
+    int width, height;
+    Player player;                       // 自机位置和状态栏字段
+    char sprites[ENEMY_TYPE_COUNT][2][4];
+    double published;                    // 发布时刻 (PlatformNow)，由发布方填写
+    double input_time;                   // 最近一次按键的时刻 (0 为没有)，由发布方填写
+    int count, capacity;
+    RenderMark marks[];                  // capacity 个
+} RenderSnapshot;
+
+// 按配置的容量计算大小 (两条子弹道 + 敌机 + 道具 + 爆炸)，分配后用 RenderSnapshotInit 初始化
+size_t RenderSnapshotBytes(const GameConfig* config);
+void RenderSnapshotInit(RenderSnapshot* snapshot, const GameConfig* config);
+void CaptureRenderSnapshot(const GameState* game, RenderSnapshot* snapshot);
+void RenderSnapshotWorld(const RenderSnapshot* snapshot, char* buffer);
+int RenderSnapshotHud(const RenderSnapshot* snapshot, char* out, int size);
+
+#endif
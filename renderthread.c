@@ -0,0 +1,110 @@
+#include <stdlib.h>
+#include <string.h>
+#include "platform.h"
+#include "renderthread.h"
+#include "triplebuf.h"
+
+#define IDLE_POLL_SECONDS 0.001   // render_hz 为 0 时等待新快照的轮询间隔
+
+static TripleBuffer buffer;
+static RenderSnapshot* slots[3];
+static unsigned char* storage = NULL;
+static double render_interval;
+static RenderPresentFn present_fn;
+static void* present_context;
+static atomic_int running;
+static PlatformThread* render_thread = NULL;
+static RenderThreadStats stats; // 发布相关的字段只由游戏线程写，其余只由渲染线程写
+
+static void PresentFront() {
+    const RenderSnapshot* snapshot = slots[TripleBufferFront(&buffer)];
+    double start = PlatformNow();
+    present_fn(snapshot, present_context);
+    double end = PlatformNow();
+
+    stats.presented++;
+    stats.present_seconds += end - start;
+    if (end - start > stats.present_max) stats.present_max = end - start;
+    stats.age_total += end - snapshot->published;
+    if (end - snapshot->published > stats.age_max) stats.age_max = end - snapshot->published;
+}
+
+static void RenderThreadMain(void* arg) {
+    (void)arg;
+    double next = PlatformNow();
+    while (atomic_load(&running)) {
+        double now = PlatformNow();
+        if (now < next) {
+            PlatformSleep(next - now);
+            continue;
+        }
+
+        if (TripleBufferAcquire(&buffer)) {
+            PresentFront();
+        } else if (render_interval > 0 && stats.presented > 0) {
+            stats.duplicated++;
+        }
+
+        if (render_interval > 0) {
+            next += render_interval;
+            if (next < now) next = now; // 渲染落后时不补帧
+        } else {
+            next = now + IDLE_POLL_SECONDS;
+        }
+    }
+}
+
+int RenderThreadStart(const GameConfig* config, double render_hz, RenderPresentFn present, void* context) {
+    size_t bytes = RenderSnapshotBytes(config);
+    bytes = (bytes + 63) & ~(size_t)63; // 三个槽位各占整数个缓存行
+    storage = (unsigned char*)PlatformAlignedAlloc(64, bytes * 3);
+    if (storage == NULL) return 0;
+    for (int i = 0; i < 3; i++) {
+        slots[i] = (RenderSnapshot*)(storage + bytes * i);
+        RenderSnapshotInit(slots[i], config);
+    }
+    TripleBufferInit(&buffer);
+    memset(&stats, 0, sizeof(stats));
+    render_interval = render_hz > 0 ? 1.0 / render_hz : 0;
+    present_fn = present;
+    present_context = context;
+
+    atomic_store(&running, 1);
+    render_thread = PlatformThreadStart(RenderThreadMain, NULL);
+    if (render_thread == NULL) {
+        PlatformAlignedFree(storage);
+        storage = NULL;
+        return 0;
+    }
+    return 1;
+}
+
+void RenderThreadPublish(const GameState* game, double input_time) {
+    if (render_thread == NULL) return;
+
+    double start = PlatformNow();
+    RenderSnapshot* snapshot = slots[TripleBufferBack(&buffer)];
+    CaptureRenderSnapshot(game, snapshot);
+    snapshot->input_time = input_time;
+    double end = PlatformNow();
+    snapshot->published = end;
+    if (TripleBufferPublish(&buffer)) stats.dropped++;
+
+    stats.published++;
+    stats.publish_seconds += end - start;
+    if (end - start > stats.publish_max) stats.publish_max = end - start;
+}
+
+void RenderThreadStop() {
+    if (render_thread == NULL) return;
+
+    atomic_store(&running, 0);
+    PlatformThreadJoin(render_thread);
+    render_thread = NULL;
+    PlatformAlignedFree(storage);
+    storage = NULL;
+}
+
+RenderThreadStats RenderThreadGetStats() {
+    return stats;
+}
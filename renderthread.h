@@ -0,0 +1,36 @@
+#ifndef RENDERTHREAD_H
+#define RENDERTHREAD_H
+
+#include "game.h"
+#include "render.h"
+
+// 渲染线程：让终端输出不再阻塞模拟
+//
+// 游戏线程每轮模拟之后调用 RenderThreadPublish，把画面需要的数据拷进绘制快照 (render.h)，
+// 通过无锁三缓冲 (triplebuf.h) 发布，从不等待。渲染线程按自己的节奏 (render_hz) 取最新的快照交给
+// present 回调绘制并输出；终端卡住时只有渲染线程停下来，模拟步照常按时执行。
+// 渲染线程来不及取走的快照被更新的快照替换 (丢帧)；到了渲染时刻还没有新快照时本次跳过，
+// 终端上保留上一帧 (重复帧)。
+
+typedef void (*RenderPresentFn)(const RenderSnapshot* snapshot, void* context); // 在渲染线程调用
+
+typedef struct {
+    long long published;       // 游戏线程发布的快照数
+    long long presented;       // 画出的快照数
+    long long dropped;         // 被更新的快照替换、没有画出的快照数
+    long long duplicated;      // 到了渲染时刻没有新快照 (画面停在上一帧) 的次数，render_hz 为 0 时不统计
+    double publish_seconds;    // 游戏线程花在拷贝和发布上的总时间
+    double publish_max;
+    double present_seconds;    // 渲染线程花在 present 上的总时间
+    double present_max;
+    double age_total;          // 快照从发布到画完的时间
+    double age_max;
+} RenderThreadStats;
+
+// 按配置的容量分配三个快照并启动渲染线程，成功返回 1；render_hz 为 0 时有新快照就画
+int RenderThreadStart(const GameConfig* config, double render_hz, RenderPresentFn present, void* context);
+void RenderThreadPublish(const GameState* game, double input_time); // 游戏线程调用，从不阻塞
+void RenderThreadStop();                                            // 结束渲染线程，释放快照
+RenderThreadStats RenderThreadGetStats();                           // 请在 RenderThreadStop 之后调用
+
+#endif
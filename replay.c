@@ -0,0 +1,212 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "game.h"
+#include "replay.h"
+
+#define REPLAY_MAGIC "PGRP"
+#define REPLAY_VERSION 6             // 版本 6：子弹道坐标恢复为 double (哈希随之改变)，之前的录像无法校验
+#define REPLAY_HEADER_BYTES 56
+
+void ReplayInit(Replay* replay, const GameConfig* config, unsigned long long seed, int hash_interval) {
+    memset(replay, 0, sizeof(*replay));
+    replay->config = config != NULL ? *config : DefaultGameConfig();
+    replay->seed = seed;
+    replay->hash_interval = hash_interval > 0 ? hash_interval : REPLAY_DEFAULT_HASH_INTERVAL;
+}
+
+void ReplayFree(Replay* replay) {
+    free(replay->runs);
+    free(replay->hashes);
+    replay->runs = NULL;
+    replay->hashes = NULL;
+}
+
+// --- 录制 ---
+
+static int ReserveRuns(Replay* replay, int extra) {
+    if (replay->runs_size + extra <= replay->runs_capacity) return 1;
+
+    int capacity = replay->runs_capacity > 0 ? replay->runs_capacity * 2 : 256;
+    while (capacity < replay->runs_size + extra) capacity *= 2;
+    unsigned char* runs = (unsigned char*)realloc(replay->runs, (size_t)capacity);
+    if (runs == NULL) return 0;
+    replay->runs = runs;
+    replay->runs_capacity = capacity;
+    return 1;
+}
+
+// 写出当前游程：按键字节 + LEB128 变长帧数 (绝大多数游程 1~2 字节)
+static int FlushRun(Replay* replay) {
+    if (replay->current_run == 0) return 1;
+    if (!ReserveRuns(replay, 6)) return 0;
+
+    replay->runs[replay->runs_size++] = (unsigned char)replay->current_keys;
+    unsigned run = (unsigned)replay->current_run;
+    do {
+        unsigned char byte = run & 0x7F;
+        run >>= 7;
+        replay->runs[replay->runs_size++] = byte | (run ? 0x80 : 0);
+    } while (run);
+
+    replay->current_run = 0;
+    return 1;
+}
+
+static int PushHash(Replay* replay, unsigned long long hash) {
+    if (replay->num_hashes == replay->hashes_capacity) {
+        int capacity = replay->hashes_capacity > 0 ? replay->hashes_capacity * 2 : 64;
+        unsigned long long* hashes = (unsigned long long*)realloc(replay->hashes, sizeof(*hashes) * capacity);
+        if (hashes == NULL) return 0;
+        replay->hashes = hashes;
+        replay->hashes_capacity = capacity;
+    }
+    replay->hashes[replay->num_hashes++] = hash;
+    return 1;
+}
+
+int ReplayRecord(Replay* replay, const GameState* game, unsigned keys) {
+    if (replay->current_run > 0 && keys != replay->current_keys) {
+        if (!FlushRun(replay)) return 0;
+    }
+    replay->current_keys = keys;
+    replay->current_run++;
+    replay->frames++;
+
+    if (replay->frames % replay->hash_interval == 0) {
+        return PushHash(replay, GameHash(game));
+    }
+    return 1;
+}
+
+// --- 读写文件 ---
+
+static void PutU32(unsigned char* p, unsigned v) {
+    for (int i = 0; i < 4; i++) p[i] = (unsigned char)(v >> (8 * i));
+}
+
+static void PutU64(unsigned char* p, unsigned long long v) {
+    for (int i = 0; i < 8; i++) p[i] = (unsigned char)(v >> (8 * i));
+}
+
+static unsigned GetU32(const unsigned char* p) {
+    unsigned v = 0;
+    for (int i = 0; i < 4; i++) v |= (unsigned)p[i] << (8 * i);
+    return v;
+}
+
+static unsigned long long GetU64(const unsigned char* p) {
+    unsigned long long v = 0;
+    for (int i = 0; i < 8; i++) v |= (unsigned long long)p[i] << (8 * i);
+    return v;
+}
+
+static void PutConfig(unsigned char* p, const GameConfig* config) {
+    PutU32(p, (unsigned)config->width);
+    PutU32(p + 4, (unsigned)config->height);
+    PutU32(p + 8, (unsigned)config->max_bullets);
+    PutU32(p + 12, (unsigned)config->max_enemies);
+    PutU32(p + 16, (unsigned)config->max_items);
+    PutU32(p + 20, (unsigned)config->max_explosions);
+}
+
+static void GetConfig(const unsigned char* p, GameConfig* config) {
+    config->width = (int)GetU32(p);
+    config->height = (int)GetU32(p + 4);
+    config->max_bullets = (int)GetU32(p + 8);
+    config->max_enemies = (int)GetU32(p + 12);
+    config->max_items = (int)GetU32(p + 16);
+    config->max_explosions = (int)GetU32(p + 20);
+}
+
+int ReplaySave(Replay* replay, const char* path) {
+    if (!FlushRun(replay)) return 0;
+
+    unsigned char header[REPLAY_HEADER_BYTES] = {0};
+    memcpy(header, REPLAY_MAGIC, 4);
+    header[4] = REPLAY_VERSION;
+    header[5] = PHYSICS_FIXED_POINT;
+    PutU64(header + 8, replay->seed);
+    PutU32(header + 16, (unsigned)replay->frames);
+    PutU32(header + 20, (unsigned)replay->hash_interval);
+    PutU32(header + 24, (unsigned)replay->runs_size);
+    PutU32(header + 28, (unsigned)replay->num_hashes);
+    PutConfig(header + 32, &replay->config);
+
+    FILE* file = fopen(path, "wb");
+    if (file == NULL) return 0;
+
+    int ok = fwrite(header, 1, sizeof(header), file) == sizeof(header);
+    if (ok && replay->runs_size > 0) {
+        ok = fwrite(replay->runs, 1, (size_t)replay->runs_size, file) == (size_t)replay->runs_size;
+    }
+    for (int k = 0; ok && k < replay->num_hashes; k++) {
+        unsigned char bytes[8];
+        PutU64(bytes, replay->hashes[k]);
+        ok = fwrite(bytes, 1, 8, file) == 8;
+    }
+    if (fclose(file) != 0) ok = 0;
+    return ok;
+}
+
+int ReplayLoad(Replay* replay, const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) return 0;
+
+    unsigned char header[REPLAY_HEADER_BYTES];
+    if (fread(header, 1, REPLAY_HEADER_BYTES, file) != REPLAY_HEADER_BYTES ||
+        memcmp(header, REPLAY_MAGIC, 4) != 0 || header[4] != REPLAY_VERSION ||
+        header[5] != PHYSICS_FIXED_POINT) {
+        fclose(file);
+        return 0;
+    }
+    GameConfig config;
+    GetConfig(header + 32, &config);
+
+    ReplayInit(replay, &config, GetU64(header + 8), (int)GetU32(header + 20));
+    replay->frames = (int)GetU32(header + 16);
+    int runs_size = (int)GetU32(header + 24);
+    int num_hashes = (int)GetU32(header + 28);
+
+    int ok = runs_size >= 0 && num_hashes >= 0 && ReserveRuns(replay, runs_size) &&
+             fread(replay->runs, 1, (size_t)runs_size, file) == (size_t)runs_size;
+    replay->runs_size = runs_size;
+    for (int k = 0; ok && k < num_hashes; k++) {
+        unsigned char bytes[8];
+        ok = fread(bytes, 1, 8, file) == 8 && PushHash(replay, GetU64(bytes));
+    }
+    fclose(file);
+
+    if (!ok) ReplayFree(replay);
+    return ok;
+}
+
+// --- 回放 ---
+
+void ReplayCursorInit(ReplayCursor* cursor) {
+    cursor->offset = 0;
+    cursor->keys = 0;
+    cursor->remaining = 0;
+}
+
+int ReplayNextKeys(const Replay* replay, ReplayCursor* cursor, unsigned* keys) {
+    if (cursor->remaining == 0) {
+        if (cursor->offset >= replay->runs_size) return 0;
+
+        cursor->keys = replay->runs[cursor->offset++];
+        unsigned run = 0;
+        int shift = 0;
+        while (cursor->offset < replay->runs_size && shift < 32) {
+            unsigned char byte = replay->runs[cursor->offset++];
+            run |= (unsigned)(byte & 0x7F) << shift;
+            shift += 7;
+            if (!(byte & 0x80)) break;
+        }
+        if (run == 0) return 0; // 损坏的游程
+        cursor->remaining = (int)run;
+    }
+
+    cursor->remaining--;
+    *keys = cursor->keys;
+    return 1;
+}
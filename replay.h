@@ -0,0 +1,55 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+// 输入录像：种子 + 游程编码的逐帧输入 + 每 N 帧一次的状态哈希
+//
+// 模拟是确定性的 (随机数全部来自 game->rng)，所以同一种子、同一输入序列会得到完全相同的状态。
+// 录像按 headless 的规则解释：玩家死亡后立即 InitGame 开始下一局，随机数发生器不重置。
+//
+// 文件格式 (小端)：
+//   "PGRP" | version u8 | fixed_point u8 | 2 字节保留 | seed u64 | frames u32 | hash_interval u32
+//   | run_bytes u32 | num_hashes u32 | width, height, max_bullets, max_enemies, max_items, max_explosions u32
+//   | runs[run_bytes] | hashes[num_hashes] u64
+// 游戏配置 (GameConfig) 按录制时保存，回放时用同样的配置创建游戏。
+// 只接受当前版本 (4)：版本 2、3 录制时敌机按对象池顺序更新，在按原型分组的存储上无法复现。
+// runs 是若干 (keys u8, 帧数 varint) 对，只有按键变化时才产生新的一对。
+// fixed_point 记录录制时的物理数值模式 (见 fixed.h)，只能由同一模式的构建加载。
+
+#include "game.h"
+
+#define REPLAY_DEFAULT_HASH_INTERVAL 60
+
+typedef struct {
+    GameConfig config;           // 录制时的区域大小和容量
+    unsigned long long seed;
+    int hash_interval;           // 每隔多少帧记录一次 GameHash()
+    int frames;                  // 已记录的帧数
+
+    unsigned char* runs;         // 游程编码的输入
+    int runs_size, runs_capacity;
+    unsigned long long* hashes;  // hashes[k] 是第 (k + 1) * hash_interval 帧之后的状态哈希
+    int num_hashes, hashes_capacity;
+
+    unsigned current_keys;       // 录制中尚未写出的游程
+    int current_run;
+} Replay;
+
+// 回放位置
+typedef struct {
+    int offset;
+    unsigned keys;
+    int remaining;
+} ReplayCursor;
+
+void ReplayInit(Replay* replay, const GameConfig* config, unsigned long long seed, int hash_interval); // config 为 NULL 时用默认配置
+void ReplayFree(Replay* replay);
+
+// 记录一帧输入；在该帧的 Update 之后调用，到达间隔时顺带记录状态哈希。内存不足返回 0
+int ReplayRecord(Replay* replay, const GameState* game, unsigned keys);
+int ReplaySave(Replay* replay, const char* path);   // 成功返回 1
+int ReplayLoad(Replay* replay, const char* path);   // 成功返回 1；格式不符或物理数值模式不同时返回 0
+
+void ReplayCursorInit(ReplayCursor* cursor);
+int ReplayNextKeys(const Replay* replay, ReplayCursor* cursor, unsigned* keys); // 输入耗尽返回 0
+
+#endif
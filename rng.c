@@ -0,0 +1,24 @@
+#include "rng.h"
+
+#define PCG_MULTIPLIER 6364136223846793005ULL
+
+void RngSeed(Rng* rng, uint64_t seed) {
+    rng->state = 0;
+    rng->inc = (seed << 1) | 1; // 增量必须为奇数
+    RngNext(rng);
+    rng->state += 0x853c49e6748fea9bULL ^ seed;
+    RngNext(rng);
+}
+
+uint32_t RngNext(Rng* rng) {
+    uint64_t old = rng->state;
+    rng->state = old * PCG_MULTIPLIER + rng->inc;
+    uint32_t xorshifted = (uint32_t)(((old >> 18) ^ old) >> 27);
+    uint32_t rot = (uint32_t)(old >> 59);
+    return (xorshifted >> rot) | (xorshifted << ((-rot) & 31));
+}
+
+// 取模偏差在 n 远小于 2^32 时可以忽略，这里的 n 都不超过几百
+int RngRange(Rng* rng, int n) {
+    return (int)(RngNext(rng) % (uint32_t)n);
+}
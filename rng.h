@@ -0,0 +1,18 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <stdint.h>
+
+// 可设种子的伪随机数发生器 (PCG32)
+// 状态完全包含在结构体中，同一种子在任何平台上产生相同序列，录像回放依赖这一点。
+
+typedef struct {
+    uint64_t state;
+    uint64_t inc;
+} Rng;
+
+void RngSeed(Rng* rng, uint64_t seed);
+uint32_t RngNext(Rng* rng);               // 均匀分布的 32 位整数
+int RngRange(Rng* rng, int n);            // [0, n)
+
+#endif
@@ -0,0 +1,208 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "leaderboard.h"
+#include "platform.h"
+#include "rng.h"
+
+// 排行榜命令行：scores [--file PATH] <命令> [参数]
+//   top [N]                  前 N 名 (默认 10，最多 LEADERBOARD_TOP_K)
+//   stats                    记录数、平均分和常用百分位
+//   percentile P             P% 的记录不超过的分数
+//   rank SCORE               该分数高于百分之多少的记录
+//   add SCORE [GRAZE [FRAMES [SEED]]]   追加一条成绩
+//   fill N [SEED]            追加 N 条模拟成绩 (每批 FILL_BATCH 条)，用于压力测试
+//   rebuild                  从数据文件重建索引
+//   import-legacy FILE       把旧的 highscore.txt 中的最高分导入为一条记录
+// 查询只读打开 (只映射索引)，并给出查询本身的耗时。
+
+#define DEFAULT_TOP 10
+#define FILL_BATCH 4096
+#define LEGACY_SEED 0
+
+static void PrintUsage(const char* program) {
+    fprintf(stderr,
+            "usage: %s [--file PATH] top [N] | stats | percentile P | rank SCORE\n"
+            "       | add SCORE [GRAZE [FRAMES [SEED]]] | fill N [SEED] | rebuild | import-legacy FILE\n"
+            "       (default file: %s)\n",
+            program, LEADERBOARD_DEFAULT_PATH);
+}
+
+static Leaderboard* OpenBoard(const char* path, int writable) {
+    const char* error;
+    Leaderboard* board = LeaderboardOpen(path, writable, &error);
+    if (board == NULL) fprintf(stderr, "scores: %s: %s\n", path, error);
+    return board;
+}
+
+static void PrintTop(Leaderboard* board, int k) {
+    LeaderboardRecord top[LEADERBOARD_TOP_K];
+    if (k > LEADERBOARD_TOP_K) k = LEADERBOARD_TOP_K;
+    double start = PlatformNow();
+    int count = LeaderboardTop(board, top, k);
+    double elapsed = PlatformNow() - start;
+
+    printf("%4s %10s %7s %8s %20s  %s\n", "rank", "score", "graze", "frames", "seed", "finished");
+    for (int i = 0; i < count; i++) {
+        char when[32] = "-";
+        time_t t = (time_t)top[i].timestamp;
+        struct tm* local = localtime(&t);
+        if (local != NULL) strftime(when, sizeof(when), "%Y-%m-%d %H:%M:%S", local);
+        printf("%4d %10d %7d %8d %20llu  %s\n", i + 1, top[i].score, top[i].graze, top[i].frames,
+               (unsigned long long)top[i].seed, when);
+    }
+    printf("(query %.1f us)\n", elapsed * 1e6);
+}
+
+static void PrintStats(Leaderboard* board) {
+    static const double percents[] = {10, 25, 50, 75, 90, 99};
+    double start = PlatformNow();
+    LeaderboardStats stats = LeaderboardGetStats(board);
+    int best = LeaderboardBest(board);
+    int scores[sizeof(percents) / sizeof(percents[0])];
+    for (int i = 0; i < (int)(sizeof(percents) / sizeof(percents[0])); i++) {
+        scores[i] = LeaderboardScoreAtPercentile(board, percents[i]);
+    }
+    double elapsed = PlatformNow() - start;
+
+    printf("records: %lld (%lld corrupt skipped), data %.1f MB%s\n", stats.records, stats.corrupt,
+           (double)stats.data_bytes / (1 << 20), stats.stale ? ", index stale (run rebuild)" : "");
+    if (stats.records == 0) return;
+    printf("best: %d  mean: %.1f\n", best, (double)stats.score_total / (double)stats.records);
+    for (int i = 0; i < (int)(sizeof(percents) / sizeof(percents[0])); i++) {
+        printf("p%-3g %d\n", percents[i], scores[i]);
+    }
+    printf("(queries %.1f us)\n", elapsed * 1e6);
+}
+
+// 模拟成绩：分数近似指数分布，取 5 的倍数 (与游戏的计分单位一致)
+static int Fill(Leaderboard* board, long long count, unsigned long long seed) {
+    LeaderboardRecord* batch = (LeaderboardRecord*)calloc(FILL_BATCH, sizeof(LeaderboardRecord));
+    if (batch == NULL) return 0;
+    Rng rng;
+    RngSeed(&rng, seed);
+    int64_t now = (int64_t)time(NULL);
+
+    double start = PlatformNow(), slowest = 0;
+    long long done = 0;
+    int ok = 1;
+    while (ok && done < count) {
+        int n = count - done < FILL_BATCH ? (int)(count - done) : FILL_BATCH;
+        for (int i = 0; i < n; i++) {
+            double u = ((double)RngNext(&rng) + 1.0) / 4294967296.0;
+            int score = (int)(-log(u) * 60.0) * 5;
+            batch[i].score = score;
+            batch[i].graze = RngRange(&rng, 50);
+            batch[i].frames = 300 + score * 4 + RngRange(&rng, 600);
+            batch[i].seed = seed + (unsigned long long)(done + i);
+            batch[i].timestamp = now;
+        }
+        double t = PlatformNow();
+        ok = LeaderboardAdd(board, batch, n);
+        t = PlatformNow() - t;
+        if (t > slowest) slowest = t;
+        done += n;
+    }
+    double elapsed = PlatformNow() - start;
+    free(batch);
+    if (ok) {
+        printf("appended %lld records in %.3f s (%.0f records/s, slowest batch %.2f ms)\n", done, elapsed,
+               (double)done / elapsed, slowest * 1e3);
+    }
+    return ok;
+}
+
+// 旧格式：highscore.txt 里只有一个整数
+static int ImportLegacy(Leaderboard* board, const char* path) {
+    FILE* file = fopen(path, "r");
+    if (file == NULL) {
+        fprintf(stderr, "scores: cannot open %s\n", path);
+        return 0;
+    }
+    LeaderboardRecord record;
+    memset(&record, 0, sizeof(record));
+    int ok = fscanf(file, "%d", &record.score) == 1;
+    fclose(file);
+    if (!ok) {
+        fprintf(stderr, "scores: %s: no score\n", path);
+        return 0;
+    }
+    record.seed = LEGACY_SEED;
+    record.timestamp = (int64_t)time(NULL);
+    if (!LeaderboardAdd(board, &record, 1)) return 0;
+    printf("imported high score %d from %s\n", record.score, path);
+    return 1;
+}
+
+int main(int argc, char** argv) {
+    const char* path = LEADERBOARD_DEFAULT_PATH;
+    int first = 1;
+    if (argc >= 3 && strcmp(argv[1], "--file") == 0) {
+        path = argv[2];
+        first = 3;
+    }
+    if (first >= argc) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+    const char* command = argv[first];
+    char** args = argv + first + 1;
+    int num_args = argc - first - 1;
+
+    int writable = strcmp(command, "add") == 0 || strcmp(command, "fill") == 0 || strcmp(command, "rebuild") == 0 ||
+                   strcmp(command, "import-legacy") == 0;
+    int known = writable || strcmp(command, "top") == 0 || strcmp(command, "stats") == 0 ||
+                strcmp(command, "percentile") == 0 || strcmp(command, "rank") == 0;
+    int needs_arg = strcmp(command, "percentile") == 0 || strcmp(command, "rank") == 0 ||
+                    strcmp(command, "add") == 0 || strcmp(command, "fill") == 0 ||
+                    strcmp(command, "import-legacy") == 0;
+    if (!known || (needs_arg && num_args < 1)) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    Leaderboard* board = OpenBoard(path, writable);
+    if (board == NULL) return 1;
+
+    int ok = 1;
+    if (strcmp(command, "top") == 0) {
+        PrintTop(board, num_args > 0 ? atoi(args[0]) : DEFAULT_TOP);
+    } else if (strcmp(command, "stats") == 0) {
+        PrintStats(board);
+    } else if (strcmp(command, "percentile") == 0) {
+        double start = PlatformNow();
+        int score = LeaderboardScoreAtPercentile(board, atof(args[0]));
+        double elapsed = PlatformNow() - start;
+        printf("p%s: %d  (query %.1f us)\n", args[0], score, elapsed * 1e6);
+    } else if (strcmp(command, "rank") == 0) {
+        double start = PlatformNow();
+        double percent = LeaderboardPercentileOfScore(board, atoi(args[0]));
+        double elapsed = PlatformNow() - start;
+        printf("score %s beats %.2f%% of runs  (query %.1f us)\n", args[0], percent, elapsed * 1e6);
+    } else if (strcmp(command, "add") == 0) {
+        LeaderboardRecord record;
+        memset(&record, 0, sizeof(record));
+        record.score = atoi(args[0]);
+        record.graze = num_args > 1 ? atoi(args[1]) : 0;
+        record.frames = num_args > 2 ? atoi(args[2]) : 0;
+        record.seed = num_args > 3 ? strtoull(args[3], NULL, 10) : 0;
+        record.timestamp = (int64_t)time(NULL);
+        ok = LeaderboardAdd(board, &record, 1);
+    } else if (strcmp(command, "fill") == 0) {
+        ok = Fill(board, atoll(args[0]), num_args > 1 ? strtoull(args[1], NULL, 10) : 1);
+    } else if (strcmp(command, "rebuild") == 0) {
+        double start = PlatformNow();
+        ok = LeaderboardRebuild(board);
+        LeaderboardStats stats = LeaderboardGetStats(board);
+        printf("rebuilt: %lld records, %lld corrupt skipped (%.3f s)\n", stats.records, stats.corrupt,
+               PlatformNow() - start);
+    } else {
+        ok = ImportLegacy(board, args[0]);
+    }
+    if (!ok && writable) fprintf(stderr, "scores: %s: %s failed\n", path, command);
+
+    LeaderboardClose(board);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,138 @@
+#include <stdlib.h>
+#include <string.h>
+#include "platform.h"
+#include "screen.h"
+
+// 两段变化之间相隔不超过这么多个未变字符时直接合并输出：
+// 重写几个字符比再发一个光标定位序列 (约 6~8 字节) 更省
+#define RUN_MERGE_GAP 6
+
+// 光标定位序列的最大长度："\033[" + 行 + ";" + 列 + "H"，行列各最多 10 位
+#define CURSOR_MOVE_MAX 24
+
+// 最坏情况下一帧的输出字节数。合并后相邻两段的起点至少相隔 RUN_MERGE_GAP + 2 列
+// (一个变化的字符加上 RUN_MERGE_GAP + 1 个未变字符)，每段都要一个光标定位序列；
+// 末尾的 CURSOR_MOVE_MAX 留给清屏序列
+static size_t OutputCapacity(int cols, int rows) {
+    size_t runs = (size_t)cols / (RUN_MERGE_GAP + 2) + 1;
+    return (size_t)rows * ((size_t)cols + runs * CURSOR_MOVE_MAX) + CURSOR_MOVE_MAX;
+}
+
+int ScreenInit(Screen* screen, int cols, int rows) {
+    int stride = cols + 1;
+    screen->cols = cols;
+    screen->rows = rows;
+    screen->front = (char*)malloc((size_t)stride * rows);
+    screen->back = (char*)malloc((size_t)stride * rows);
+    screen->out_capacity = OutputCapacity(cols, rows);
+    screen->out = (char*)malloc(screen->out_capacity);
+    if (screen->front == NULL || screen->back == NULL || screen->out == NULL) {
+        ScreenFree(screen);
+        return 0;
+    }
+
+    memset(screen->back, ' ', (size_t)stride * rows);
+    memset(&screen->stats, 0, sizeof(screen->stats));
+    ScreenInvalidate(screen);
+    return 1;
+}
+
+void ScreenFree(Screen* screen) {
+    free(screen->front);
+    free(screen->back);
+    free(screen->out);
+    screen->front = screen->back = screen->out = NULL;
+}
+
+char* ScreenRow(Screen* screen, int y) {
+    return screen->back + (size_t)y * (screen->cols + 1);
+}
+
+void ScreenInvalidate(Screen* screen) {
+    screen->full_redraw = 1;
+}
+
+// 追加十进制整数 (避免 printf 系列的格式化开销)
+static int AppendInt(char* out, int value) {
+    char digits[12];
+    int n = 0;
+    do {
+        digits[n++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+    for (int i = 0; i < n; i++) out[i] = digits[n - 1 - i];
+    return n;
+}
+
+static int AppendCursorMove(char* out, int x, int y) {
+    int n = 0;
+    out[n++] = '\033';
+    out[n++] = '[';
+    n += AppendInt(out + n, y + 1);
+    out[n++] = ';';
+    n += AppendInt(out + n, x + 1);
+    out[n++] = 'H';
+    return n;
+}
+
+int ScreenEncode(Screen* screen) {
+    int stride = screen->cols + 1;
+    int len = 0;
+    int cursor_x = -1, cursor_y = -1;  // 终端光标位置 (未知为 -1)
+    long long cells = 0;
+
+    if (screen->full_redraw) {
+        // 让 front 与任何字符都不同，下面的比较会输出整屏
+        memset(screen->front, 0, (size_t)stride * screen->rows);
+        memcpy(screen->out, "\033[2J", 4);
+        len = 4;
+        screen->full_redraw = 0;
+    }
+
+    for (int y = 0; y < screen->rows; y++) {
+        char* front = screen->front + (size_t)y * stride;
+        const char* back = screen->back + (size_t)y * stride;
+        int x = 0;
+
+        while (x < screen->cols) {
+            if (front[x] == back[x]) {
+                x++;
+                continue;
+            }
+
+            // 找到一段变化，吸收间隔较短的未变字符
+            int start = x;
+            int last_diff = x;
+            for (x++; x < screen->cols; x++) {
+                if (front[x] != back[x]) last_diff = x;
+                else if (x - last_diff > RUN_MERGE_GAP) break;
+            }
+            int end = last_diff + 1;
+
+            if (cursor_x != start || cursor_y != y) {
+                len += AppendCursorMove(screen->out + len, start, y);
+            }
+            memcpy(screen->out + len, back + start, end - start);
+            memcpy(front + start, back + start, end - start);
+            len += end - start;
+            cells += end - start;
+            cursor_x = end;
+            cursor_y = y;
+        }
+    }
+
+    screen->stats.cells += cells;
+    return len;
+}
+
+int ScreenPresent(Screen* screen) {
+    int len = ScreenEncode(screen);
+    int writes = len > 0 ? PlatformWrite(screen->out, len) : 0;
+
+    screen->stats.frames++;
+    screen->stats.bytes += len;
+    screen->stats.writes += writes;
+    screen->stats.last_bytes = len;
+    screen->stats.last_writes = writes;
+    return len;
+}
@@ -0,0 +1,38 @@
+#ifndef SCREEN_H
+#define SCREEN_H
+
+#include <stddef.h>
+
+// 差分终端渲染器 (双缓冲)
+//
+// back 是正在绘制的新一帧，front 是终端上当前显示的内容。ScreenPresent 逐行比较两者，
+// 只把变化的字符段编码成 "ANSI 光标定位 + 文本"，拼进预分配的输出缓冲区，
+// 最后通过 PlatformWrite 一次性写出，每帧通常只有一次 write 系统调用。
+
+typedef struct {
+    long long frames;
+    long long bytes;     // 累计输出字节数
+    long long writes;    // 累计 write 系统调用次数
+    long long cells;     // 累计输出的字符数 (不含转义序列)
+    int last_bytes;      // 上一帧输出字节数
+    int last_writes;     // 上一帧系统调用次数
+} ScreenStats;
+
+typedef struct {
+    int cols, rows;
+    char* front;         // 终端当前内容，每行 cols+1 字节
+    char* back;          // 新一帧内容，每行 cols+1 字节 (末尾留给 '\0')
+    char* out;           // 输出缓冲区
+    size_t out_capacity; // 按最坏情况 (每 RUN_MERGE_GAP + 2 列一段变化) 分配
+    int full_redraw;     // 下一帧先清屏再全量输出
+    ScreenStats stats;
+} Screen;
+
+int ScreenInit(Screen* screen, int cols, int rows);  // 分配失败返回 0
+void ScreenFree(Screen* screen);
+char* ScreenRow(Screen* screen, int y);              // back 中第 y 行
+void ScreenInvalidate(Screen* screen);               // 终端内容被外部改动后调用
+int ScreenEncode(Screen* screen);                    // 只把差异编码进 out 并更新 front，返回字节数
+int ScreenPresent(Screen* screen);                   // 输出差异，返回写出的字节数
+
+#endif
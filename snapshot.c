@@ -0,0 +1,428 @@
+#include <stdint.h>
+#include <string.h>
+#include "danger.h"
+#include "delta.h"
+#include "snapshot.h"
+#include "platform.h"
+
+#define SNAPSHOT_MAGIC 0x53534750u   // "PGSS"
+#define BULLET_RECORD_BYTES (4 * sizeof(LaneReal) + sizeof(BulletFlags))
+#define POOL_COUNT 2
+#define ENEMY_RECORD_BYTES (2 * sizeof(Real) + 2 * sizeof(int) + 1)
+
+// 快照开头的定长部分，其后依次是：
+//   道具、爆炸池的 link[capacity] | 敌机的各列[count] | 两个池的 dense[count] + 实体[count] | 两条子弹道的记录[count]
+// 定长部分在前，帧与帧之间位置不变的字节尽量对齐，方便差分
+typedef struct {
+    uint32_t magic;
+    uint32_t layout;             // sizeof(Real)：数值模式不同的构建互相拒绝
+    uint32_t bytes;              // 整个快照的字节数
+    GameConfig config;           // 区域大小和容量不同的游戏互相拒绝
+    int32_t frame_count;
+    int32_t lane_count[2];
+    int32_t enemy_start[ENEMY_TYPE_COUNT + 1]; // 各组的起点，最后一项是敌机总数
+    int32_t pool_count[POOL_COUNT];
+    int32_t pool_free_head[POOL_COUNT];
+    Rng rng;
+    Player player;
+    GameTuning tuning;
+    GameStats stats;
+} SnapshotHeader;
+
+typedef struct {
+    Pool* pool;
+    unsigned char* items;
+    size_t item_size;
+} PoolView;
+
+static void GetPools(GameState* game, PoolView views[POOL_COUNT]) {
+    views[0] = (PoolView){&game->item_pool, (unsigned char*)game->items, sizeof(Item)};
+    views[1] = (PoolView){&game->explosion_pool, (unsigned char*)game->explosions, sizeof(Explosion)};
+}
+
+size_t SnapshotMaxBytes(const GameConfig* config) {
+    return sizeof(SnapshotHeader)
+         + (size_t)config->max_enemies * ENEMY_RECORD_BYTES
+         + (size_t)config->max_items * (2 * sizeof(int) + sizeof(Item))
+         + (size_t)config->max_explosions * (2 * sizeof(int) + sizeof(Explosion))
+         + (size_t)2 * config->max_bullets * BULLET_RECORD_BYTES;
+}
+
+// --- 捕获与恢复 ---
+
+// 敌机按列存放，每列 count 个元素 (粗时间步的 first/last 只在步内有效，不保存)
+static size_t WriteEnemies(unsigned char* out, const EnemyGroups* enemies) {
+    int n = enemies->count;
+    size_t pos = 0;
+    memcpy(out + pos, enemies->x, sizeof(Real) * n);
+    pos += sizeof(Real) * n;
+    memcpy(out + pos, enemies->y, sizeof(Real) * n);
+    pos += sizeof(Real) * n;
+    memcpy(out + pos, enemies->cooldown, sizeof(int) * n);
+    pos += sizeof(int) * n;
+    memcpy(out + pos, enemies->shot, sizeof(int) * n);
+    pos += sizeof(int) * n;
+    memcpy(out + pos, enemies->type, n);
+    return pos + n;
+}
+
+static size_t ReadEnemies(EnemyGroups* enemies, const unsigned char* in, const int32_t* start) {
+    for (int t = 0; t <= ENEMY_TYPE_COUNT; t++) enemies->start[t] = start[t];
+    int n = enemies->count = start[ENEMY_TYPE_COUNT];
+    size_t pos = 0;
+    memcpy(enemies->x, in + pos, sizeof(Real) * n);
+    pos += sizeof(Real) * n;
+    memcpy(enemies->y, in + pos, sizeof(Real) * n);
+    pos += sizeof(Real) * n;
+    memcpy(enemies->cooldown, in + pos, sizeof(int) * n);
+    pos += sizeof(int) * n;
+    memcpy(enemies->shot, in + pos, sizeof(int) * n);
+    pos += sizeof(int) * n;
+    memcpy(enemies->type, in + pos, n);
+    return pos + n;
+}
+
+// 各组起点单调不减且总数不超过容量
+static int ValidEnemyStarts(const int32_t* start, int capacity) {
+    if (start[0] != 0) return 0;
+    for (int t = 0; t < ENEMY_TYPE_COUNT; t++) {
+        if (start[t + 1] < start[t]) return 0;
+    }
+    return start[ENEMY_TYPE_COUNT] <= capacity;
+}
+
+static size_t WriteLane(unsigned char* out, const BulletLane* lane) {
+    for (int i = 0; i < lane->count; i++) {
+        memcpy(out, &lane->x[i], sizeof(LaneReal));
+        memcpy(out + sizeof(LaneReal), &lane->y[i], sizeof(LaneReal));
+        memcpy(out + 2 * sizeof(LaneReal), &lane->vx[i], sizeof(LaneReal));
+        memcpy(out + 3 * sizeof(LaneReal), &lane->vy[i], sizeof(LaneReal));
+        memcpy(out + 4 * sizeof(LaneReal), &lane->flags[i], sizeof(BulletFlags));
+        out += BULLET_RECORD_BYTES;
+    }
+    return (size_t)lane->count * BULLET_RECORD_BYTES;
+}
+
+static size_t ReadLane(BulletLane* lane, const unsigned char* in, int count) {
+    lane->count = count;
+    for (int i = 0; i < count; i++) {
+        memcpy(&lane->x[i], in, sizeof(LaneReal));
+        memcpy(&lane->y[i], in + sizeof(LaneReal), sizeof(LaneReal));
+        memcpy(&lane->vx[i], in + 2 * sizeof(LaneReal), sizeof(LaneReal));
+        memcpy(&lane->vy[i], in + 3 * sizeof(LaneReal), sizeof(LaneReal));
+        memcpy(&lane->flags[i], in + 4 * sizeof(LaneReal), sizeof(BulletFlags));
+        in += BULLET_RECORD_BYTES;
+    }
+    return (size_t)count * BULLET_RECORD_BYTES;
+}
+
+size_t SnapshotCapture(const GameState* game, void* block) {
+    unsigned char* out = (unsigned char*)block;
+    PoolView pools[POOL_COUNT];
+    GetPools((GameState*)game, pools);
+    const BulletLane* lanes[2] = {&game->player_bullets, &game->enemy_bullets};
+
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header)); // 填充字节清零，差分时不产生噪声
+    header.magic = SNAPSHOT_MAGIC;
+    header.layout = (uint32_t)sizeof(Real);
+    header.config = game->config;
+    header.frame_count = game->frame_count;
+    for (int l = 0; l < 2; l++) header.lane_count[l] = lanes[l]->count;
+    for (int t = 0; t <= ENEMY_TYPE_COUNT; t++) header.enemy_start[t] = game->enemies.start[t];
+    for (int p = 0; p < POOL_COUNT; p++) {
+        header.pool_count[p] = pools[p].pool->count;
+        header.pool_free_head[p] = pools[p].pool->free_head;
+    }
+    header.rng = game->rng;
+    header.player = game->player;
+    header.tuning = game->tuning;
+    header.stats = game->stats;
+
+    size_t pos = sizeof(header);
+    for (int p = 0; p < POOL_COUNT; p++) {
+        const Pool* pool = pools[p].pool;
+        memcpy(out + pos, pool->link, sizeof(int) * pool->capacity);
+        pos += sizeof(int) * pool->capacity;
+    }
+    pos += WriteEnemies(out + pos, &game->enemies);
+    for (int p = 0; p < POOL_COUNT; p++) {
+        const Pool* pool = pools[p].pool;
+        size_t size = pools[p].item_size;
+        memcpy(out + pos, pool->dense, sizeof(int) * pool->count);
+        pos += sizeof(int) * pool->count;
+        for (int k = 0; k < pool->count; k++) {
+            memcpy(out + pos, pools[p].items + size * pool->dense[k], size);
+            pos += size;
+        }
+    }
+    for (int l = 0; l < 2; l++) pos += WriteLane(out + pos, lanes[l]);
+
+    header.bytes = (uint32_t)pos;
+    memcpy(out, &header, sizeof(header));
+    return pos;
+}
+
+int SnapshotRestore(GameState* game, const void* block) {
+    const unsigned char* in = (const unsigned char*)block;
+    PoolView pools[POOL_COUNT];
+    GetPools(game, pools);
+    BulletLane* lanes[2] = {&game->player_bullets, &game->enemy_bullets};
+
+    SnapshotHeader header;
+    memcpy(&header, in, sizeof(header));
+    if (header.magic != SNAPSHOT_MAGIC || header.layout != (uint32_t)sizeof(Real)) return 0;
+    if (memcmp(&header.config, &game->config, sizeof(GameConfig)) != 0) return 0;
+    for (int l = 0; l < 2; l++) {
+        if (header.lane_count[l] < 0 || header.lane_count[l] > lanes[l]->limit) return 0;
+    }
+    if (!ValidEnemyStarts(header.enemy_start, game->enemies.capacity)) return 0;
+    for (int p = 0; p < POOL_COUNT; p++) {
+        if (header.pool_count[p] < 0 || header.pool_count[p] > pools[p].pool->capacity) return 0;
+    }
+
+    game->frame_count = header.frame_count;
+    game->rng = header.rng;
+    game->player = header.player;
+    game->tuning = header.tuning;
+    game->stats = header.stats;
+
+    size_t pos = sizeof(header);
+    for (int p = 0; p < POOL_COUNT; p++) {
+        Pool* pool = pools[p].pool;
+        memcpy(pool->link, in + pos, sizeof(int) * pool->capacity);
+        pos += sizeof(int) * pool->capacity;
+    }
+    pos += ReadEnemies(&game->enemies, in + pos, header.enemy_start);
+    for (int p = 0; p < POOL_COUNT; p++) {
+        Pool* pool = pools[p].pool;
+        size_t size = pools[p].item_size;
+        pool->count = header.pool_count[p];
+        pool->free_head = header.pool_free_head[p];
+        memcpy(pool->dense, in + pos, sizeof(int) * pool->count);
+        pos += sizeof(int) * pool->count;
+        for (int k = 0; k < pool->count; k++) {
+            memcpy(pools[p].items + size * pool->dense[k], in + pos, size);
+            pos += size;
+        }
+    }
+    for (int l = 0; l < 2; l++) pos += ReadLane(lanes[l], in + pos, header.lane_count[l]);
+    if (game->danger != NULL) DangerFieldReset(game->danger); // 下一次 Update() 时按恢复后的状态重建
+    return 1;
+}
+
+int SnapshotFrame(const void* block) {
+    SnapshotHeader header;
+    memcpy(&header, block, sizeof(header));
+    return header.frame_count;
+}
+
+// --- 快照环 ---
+
+typedef struct {
+    size_t offset;       // 在数据区中的位置
+    size_t bytes;        // 存储的字节数 (关键帧为完整快照，否则为差分)
+    size_t raw_bytes;    // 完整快照的字节数
+    int keyframe;
+} RingEntry;
+
+struct SnapshotRing {
+    int frames;              // 至少保存的帧数
+    int keyframe_interval;
+    int capacity;            // 条目表容量：frames + keyframe_interval
+    int oldest, count;       // 条目按时间顺序，最旧的一定是关键帧
+    int since_keyframe;      // 最新关键帧之后的差分帧数
+    size_t max_bytes;        // 单个完整快照的上限 (SnapshotMaxBytes)
+    RingEntry* entries;
+
+    unsigned char* current;  // 本帧的完整快照
+    unsigned char* previous; // 上一帧的完整快照 (差分基准)
+    size_t previous_bytes;
+    unsigned char* delta;    // 差分编码输出
+
+    unsigned char* arena;    // 环形数据区：条目按时间顺序连续存放，放不下时从头开始
+    size_t arena_bytes;
+    size_t tail;             // 下一个条目的写入位置
+};
+
+#define RING_ALIGN 64
+
+static size_t AlignUp(size_t n) {
+    return (n + RING_ALIGN - 1) & ~(size_t)(RING_ALIGN - 1);
+}
+
+SnapshotRing* CreateSnapshotRing(const GameConfig* config, int frames, int keyframe_interval, size_t arena_bytes) {
+    if (frames < 1) frames = 1;
+    if (keyframe_interval < 1) keyframe_interval = 1;
+    size_t max_bytes = SnapshotMaxBytes(config);
+    if (arena_bytes == 0) {
+        arena_bytes = 2 * max_bytes + (size_t)frames / keyframe_interval * max_bytes;
+    }
+    if (arena_bytes < max_bytes) arena_bytes = max_bytes; // 至少能放下一个关键帧
+
+    // 所有内存一次性分配：结构体 | 条目表 | 三个工作缓冲 | 数据区
+    int capacity = frames + keyframe_interval;
+    size_t buffer_bytes = AlignUp(max_bytes);
+    size_t entries_offset = AlignUp(sizeof(SnapshotRing));
+    size_t buffers_offset = entries_offset + AlignUp(sizeof(RingEntry) * capacity);
+    size_t arena_offset = buffers_offset + 3 * buffer_bytes;
+    unsigned char* base = (unsigned char*)PlatformAlignedAlloc(RING_ALIGN, arena_offset + arena_bytes);
+    if (base == NULL) return NULL;
+
+    SnapshotRing* ring = (SnapshotRing*)base;
+    memset(ring, 0, sizeof(*ring));
+    ring->frames = frames;
+    ring->keyframe_interval = keyframe_interval;
+    ring->capacity = capacity;
+    ring->max_bytes = max_bytes;
+    ring->entries = (RingEntry*)(base + entries_offset);
+    ring->current = base + buffers_offset;
+    ring->previous = ring->current + buffer_bytes;
+    ring->delta = ring->previous + buffer_bytes;
+    ring->arena = base + arena_offset;
+    ring->arena_bytes = arena_bytes;
+    return ring;
+}
+
+void DestroySnapshotRing(SnapshotRing* ring) {
+    PlatformAlignedFree(ring);
+}
+
+void SnapshotRingClear(SnapshotRing* ring) {
+    ring->oldest = 0;
+    ring->count = 0;
+    ring->since_keyframe = 0;
+    ring->previous_bytes = 0;
+    ring->tail = 0;
+}
+
+static RingEntry* EntryAt(const SnapshotRing* ring, int index) {
+    return &ring->entries[(ring->oldest + index) % ring->capacity];
+}
+
+// 最旧的关键帧和依赖它的差分帧
+static int OldestGroupSize(const SnapshotRing* ring) {
+    int n = 1;
+    while (n < ring->count && !EntryAt(ring, n)->keyframe) n++;
+    return n;
+}
+
+static void EvictOldestGroup(SnapshotRing* ring) {
+    int n = OldestGroupSize(ring);
+    ring->oldest = (ring->oldest + n) % ring->capacity;
+    ring->count -= n;
+}
+
+// 在数据区找 bytes 字节的位置，必要时淘汰最旧的帧 (不移动 tail)
+static size_t FindSpace(SnapshotRing* ring, size_t bytes) {
+    size_t start = ring->tail;
+    if (start + bytes > ring->arena_bytes) {
+        // 末尾放不下：末尾区域里的条目一定是最旧的，先淘汰，再从头开始
+        while (ring->count > 0 && EntryAt(ring, 0)->offset >= start) EvictOldestGroup(ring);
+        start = 0;
+    }
+    while (ring->count > 0) {
+        const RingEntry* oldest = EntryAt(ring, 0);
+        if (oldest->offset >= start + bytes || oldest->offset + oldest->bytes <= start) break;
+        EvictOldestGroup(ring);
+    }
+    return start;
+}
+
+size_t SnapshotRingPush(SnapshotRing* ring, const GameState* game) {
+    size_t raw = SnapshotCapture(game, ring->current);
+    if (raw > ring->arena_bytes) return 0;
+
+    // 多出来的最旧一组可以丢掉时才淘汰，保证至少保留 frames 帧
+    while (ring->count > 0) {
+        int group = OldestGroupSize(ring);
+        if (ring->count < ring->capacity && ring->count - group < ring->frames - 1) break;
+        EvictOldestGroup(ring);
+    }
+
+    int keyframe = ring->count == 0 || ring->since_keyframe + 1 >= ring->keyframe_interval;
+    size_t bytes = raw;
+    if (!keyframe) {
+        bytes = DeltaEncode(ring->previous, ring->previous_bytes, ring->current, raw, ring->delta, raw);
+        if (bytes == 0) {
+            keyframe = 1;
+            bytes = raw;
+        }
+    }
+
+    size_t offset = FindSpace(ring, bytes);
+    if (!keyframe && ring->count == 0) {
+        // 腾空间时差分基准也被淘汰了，改存关键帧
+        keyframe = 1;
+        bytes = raw;
+        offset = FindSpace(ring, bytes);
+    }
+
+    memcpy(ring->arena + offset, keyframe ? ring->current : ring->delta, bytes);
+    ring->tail = offset + bytes;
+
+    RingEntry* entry = &ring->entries[(ring->oldest + ring->count) % ring->capacity];
+    entry->offset = offset;
+    entry->bytes = bytes;
+    entry->raw_bytes = raw;
+    entry->keyframe = keyframe;
+    ring->count++;
+    ring->since_keyframe = keyframe ? 0 : ring->since_keyframe + 1;
+
+    unsigned char* swap = ring->previous;
+    ring->previous = ring->current;
+    ring->current = swap;
+    ring->previous_bytes = raw;
+    return bytes;
+}
+
+int SnapshotRingCount(const SnapshotRing* ring) {
+    return ring->count;
+}
+
+SnapshotRingStats SnapshotRingGetStats(const SnapshotRing* ring) {
+    SnapshotRingStats stats;
+    memset(&stats, 0, sizeof(stats));
+    stats.frames = ring->count;
+    stats.arena_bytes = ring->arena_bytes;
+    for (int k = 0; k < ring->count; k++) {
+        const RingEntry* entry = EntryAt(ring, k);
+        stats.keyframes += entry->keyframe;
+        stats.stored_bytes += entry->bytes;
+        stats.raw_bytes += entry->raw_bytes;
+    }
+    return stats;
+}
+
+// 从所在组的关键帧开始依次应用差分
+size_t SnapshotRingLoad(const SnapshotRing* ring, int back, void* block) {
+    if (back < 0 || back >= ring->count) return 0;
+    int target = ring->count - 1 - back;
+    int start = target;
+    while (!EntryAt(ring, start)->keyframe) start--;
+
+    unsigned char* out = (unsigned char*)block;
+    const RingEntry* key = EntryAt(ring, start);
+    memcpy(out, ring->arena + key->offset, key->bytes);
+    size_t bytes = key->bytes;
+    size_t capacity = ring->max_bytes;
+    for (int k = start + 1; k <= target && bytes > 0; k++) {
+        const RingEntry* entry = EntryAt(ring, k);
+        bytes = DeltaApply(out, bytes, capacity, ring->arena + entry->offset, entry->bytes);
+    }
+    return bytes;
+}
+
+int SnapshotRingRewind(SnapshotRing* ring, int back, GameState* game) {
+    size_t bytes = SnapshotRingLoad(ring, back, ring->previous);
+    if (bytes == 0 || !SnapshotRestore(game, ring->previous)) return 0;
+
+    // 丢弃更新的帧，下一帧接着以这一帧为差分基准
+    ring->count -= back;
+    const RingEntry* last = EntryAt(ring, ring->count - 1);
+    ring->tail = last->offset + last->bytes;
+    ring->previous_bytes = bytes;
+    ring->since_keyframe = 0;
+    for (int k = ring->count - 1; k > 0 && !EntryAt(ring, k)->keyframe; k--) ring->since_keyframe++;
+    return 1;
+}
@@ -0,0 +1,62 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <stddef.h>
+#include "game.h"
+
+// 游戏状态快照：回滚、即时存档和倒带调试的基础
+//
+// SnapshotCapture 把整个世界 (自机、两条子弹道、三个对象池、帧号、随机数状态、难度参数和统计)
+// 写进一块连续内存，块内没有指针，可以直接 memcpy / 写文件 / 发给另一个实例。
+// 只保存活跃实体：子弹按 [0, count) 逐颗写成 x|y|vx|vy|flags 记录，池保存 link 数组、
+// dense 列表和按 dense 顺序排列的实体，恢复后空闲链表与原状态完全一致，后续模拟逐位相同。
+// 音效回调、碰撞临时数据、危险场和编译好的弹幕模式不属于快照 (由 CreateGame 决定)。
+//
+// 快照只能由同一构建 (物理数值模式相同) 恢复到配置相同的游戏，不是跨版本的存档格式。
+
+// 该配置下任意状态的快照都不超过这个大小 (与各项容量成正比)
+size_t SnapshotMaxBytes(const GameConfig* config);
+
+// 写入 block (至少 SnapshotMaxBytes(&game->config) 字节，无对齐要求)，返回实际字节数
+size_t SnapshotCapture(const GameState* game, void* block);
+
+// 从快照恢复；block 不是本构建产生的快照或配置与 game 不同时返回 0，game 保持不变
+int SnapshotRestore(GameState* game, const void* block);
+
+int SnapshotFrame(const void* block);       // 快照对应的 frame_count
+
+// --- 快照环 ---
+// 保存最近 N 帧，所有内存 (条目表、工作缓冲、数据区) 在创建时一次性分配。
+// 每隔 keyframe_interval 帧存一个完整快照 (关键帧)，其余帧只存与上一帧的 XOR 差分，
+// 差分再做零字节游程编码，静止的实体、速度和 flags 几乎不占空间。
+// 数据区是环形的，写满后从最旧的帧开始淘汰；关键帧被淘汰时，依赖它的差分帧一起丢弃。
+
+typedef struct SnapshotRing SnapshotRing;
+
+typedef struct {
+    int frames;                 // 当前保存的帧数
+    int keyframes;
+    size_t arena_bytes;         // 数据区总大小
+    size_t stored_bytes;        // 当前保存的压缩后字节数
+    size_t raw_bytes;           // 同样这些帧的完整快照字节数之和
+} SnapshotRingStats;
+
+// 用于 config 对应的游戏。frames：至少保存的帧数；arena_bytes 为 0 时按每个关键帧组一个完整快照估算。
+// 数据区不够时实际保存的帧数会少于 frames。失败返回 NULL
+SnapshotRing* CreateSnapshotRing(const GameConfig* config, int frames, int keyframe_interval, size_t arena_bytes);
+void DestroySnapshotRing(SnapshotRing* ring);
+void SnapshotRingClear(SnapshotRing* ring);
+
+// 保存当前状态 (一般在每帧 Update 之后调用)，返回本帧占用的字节数，失败返回 0
+size_t SnapshotRingPush(SnapshotRing* ring, const GameState* game);
+
+int SnapshotRingCount(const SnapshotRing* ring);
+SnapshotRingStats SnapshotRingGetStats(const SnapshotRing* ring);
+
+// 把 back 帧之前的快照 (0 为最新一帧) 解码到 block，返回字节数；不存在时返回 0
+size_t SnapshotRingLoad(const SnapshotRing* ring, int back, void* block);
+
+// 倒带：恢复 back 帧之前的状态，并丢弃比它更新的帧，之后的 Push 从这一帧接着存
+int SnapshotRingRewind(SnapshotRing* ring, int back, GameState* game);
+
+#endif
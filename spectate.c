@@ -0,0 +1,107 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "platform.h"
+#include "screen.h"
+#include "spectator.h"
+
+// 观战工具：连接 plane_game --spectate 发布的画面流，在终端上重现画面，
+// 结束时 (游戏结束、连接断开或收满 --frames 帧) 输出带宽和延迟报告。
+// --quiet 不绘制画面，只统计 (可以同时开很多个测试多观众的开销)。
+
+#define MAX_LATENCY_SAMPLES 65536
+
+static double latency_samples[MAX_LATENCY_SAMPLES];
+static int num_latency_samples = 0;
+
+static int CompareDouble(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static void DrawView(Screen* screen, const SpectatorView* view) {
+    char* row = ScreenRow(screen, 0);
+    const char* end = (const char*)memchr(view->hud, '\0', HUD_WIDTH);
+    int len = end != NULL ? (int)(end - view->hud) : HUD_WIDTH;
+    memcpy(row, view->hud, len);
+    for (int x = len; x < screen->cols; x++) row[x] = ' ';
+
+    // 画面比终端缓冲大时裁掉多出的部分
+    int width = view->width < screen->cols ? view->width : screen->cols;
+    for (int y = 0; y < view->height && y + 1 < screen->rows; y++) {
+        row = ScreenRow(screen, y + 1);
+        memcpy(row, view->cells + y * view->width, width);
+        for (int x = width; x < screen->cols; x++) row[x] = ' ';
+    }
+    ScreenPresent(screen);
+}
+
+static void PrintReport(const SpectatorClient* client, double seconds) {
+    printf("spectate: %lld frames (%lld keyframes, %lld deltas), %lld skipped by server, %lld errors\n",
+           client->frames, client->keyframes, client->deltas, client->skipped, client->errors);
+    if (client->frames > 0 && seconds > 0) {
+        printf("bandwidth: %lld bytes, %.1f bytes/frame, %.2f KB/s\n", client->received_bytes,
+               (double)client->received_bytes / client->frames, client->received_bytes / seconds / 1024);
+    }
+    if (num_latency_samples > 0) {
+        qsort(latency_samples, (size_t)num_latency_samples, sizeof(double), CompareDouble);
+        printf("latency (publish -> decoded): p50 %.3f ms, p99 %.3f ms, max %.3f ms\n",
+               latency_samples[num_latency_samples / 2] * 1e3,
+               latency_samples[(int)(num_latency_samples * 0.99)] * 1e3,
+               latency_samples[num_latency_samples - 1] * 1e3);
+    }
+}
+
+int main(int argc, char** argv) {
+    const char* path = SPECTATOR_DEFAULT_PATH;
+    int quiet = 0;
+    long long max_frames = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--socket") == 0 && i + 1 < argc) {
+            path = argv[++i];
+        } else if (strcmp(argv[i], "--quiet") == 0) {
+            quiet = 1;
+        } else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            max_frames = atoll(argv[++i]);
+        } else {
+            printf("usage: %s [--socket PATH] [--quiet] [--frames N]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    SpectatorClient client;
+    if (!SpectatorConnect(&client, path)) {
+        fprintf(stderr, "failed to connect: %s\n", path);
+        return 1;
+    }
+    Screen screen;
+    int screen_ready = 0; // 收到第一帧、知道画面大小之后才分配
+    if (!quiet) PlatformInitConsole();
+
+    double start = PlatformNow();
+    SpectatorPacket packet;
+    int result;
+    while ((result = SpectatorReceive(&client, &packet, 1.0)) >= 0) {
+        if (result == 0) continue;
+        if (num_latency_samples < MAX_LATENCY_SAMPLES) {
+            latency_samples[num_latency_samples++] = PlatformNow() - packet.published;
+        }
+        if (!quiet && !screen_ready) {
+            int cols = client.view.width > HUD_WIDTH ? client.view.width : HUD_WIDTH;
+            if (!ScreenInit(&screen, cols, client.view.height + 1)) break;
+            screen_ready = 1;
+        }
+        if (!quiet) DrawView(&screen, &client.view);
+        if (max_frames > 0 && client.frames >= max_frames) break;
+    }
+    double seconds = PlatformNow() - start;
+
+    if (!quiet) {
+        GotoXY(0, screen_ready ? screen.rows + 1 : 0);
+        PlatformShutdownConsole();
+        if (screen_ready) ScreenFree(&screen);
+    }
+    PrintReport(&client, seconds);
+    SpectatorDisconnect(&client);
+    return 0;
+}
@@ -0,0 +1,366 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "delta.h"
+#include "platform.h"
+#include "spectator.h"
+#include "spsc.h"
+
+#define MAX_PACKET_BYTES (sizeof(SpectatorPacket) + sizeof(SpectatorView))
+
+// 队列元素只拷贝到画面的有效字节为止
+typedef struct {
+    double published;
+    SpectatorView view;
+} QueuedView;
+
+// 一个观众：buffer[start, end) 是已编码但还没写进套接字的字节
+typedef struct {
+    int socket;
+    int synced;        // 0：等待下一个关键帧
+    int start, end;
+    unsigned char buffer[]; // viewer_capacity 字节
+} Viewer;
+
+static SpscRing queue;
+static unsigned char queue_storage[SPECTATOR_QUEUE_CAPACITY * sizeof(QueuedView)];
+static QueuedView staging;         // 游戏线程填写后入队
+static size_t view_bytes;          // 本次观战流的画面有效字节数
+static int viewer_capacity;        // 每个观众的用户态缓冲
+static atomic_int running;
+static PlatformThread* writer_thread = NULL;
+static SpectatorStats stats;
+
+// 以下只由写线程访问
+static int listener = -1;
+static char socket_path[256];
+static int keyframe_interval;
+static Viewer** viewers = NULL;
+static int num_viewers = 0, viewers_capacity = 0;
+static QueuedView popped;
+static SpectatorView previous;     // 上一帧，差分基准
+static int has_previous = 0;
+static int since_keyframe = 0;
+static uint32_t next_sequence = 0;
+static unsigned char packet[MAX_PACKET_BYTES];
+
+// FNV-1a，只覆盖有效字节
+static uint32_t ViewChecksum(const SpectatorView* view, size_t bytes) {
+    const unsigned char* p = (const unsigned char*)view;
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < bytes; i++) h = (h ^ p[i]) * 16777619u;
+    return h;
+}
+
+// 宽高超出范围的画面视为损坏，返回 0
+static size_t ViewBytes(const SpectatorView* view) {
+    if (view->width < 1 || view->height < 1 || (size_t)view->width * view->height > SPECTATOR_MAX_CELLS) return 0;
+    return SPECTATOR_VIEW_BYTES(view->width, view->height);
+}
+
+// --- 写线程 ---
+
+static void AcceptViewers() {
+    int socket;
+    while ((socket = PlatformLocalAccept(listener, SPECTATOR_SOCKET_BUFFER)) >= 0) {
+        if (num_viewers == viewers_capacity) {
+            int capacity = viewers_capacity > 0 ? viewers_capacity * 2 : 8;
+            Viewer** grown = (Viewer**)realloc(viewers, sizeof(Viewer*) * capacity);
+            if (grown == NULL) {
+                PlatformSocketClose(socket);
+                return;
+            }
+            viewers = grown;
+            viewers_capacity = capacity;
+        }
+        Viewer* viewer = (Viewer*)malloc(sizeof(Viewer) + viewer_capacity);
+        if (viewer == NULL) {
+            PlatformSocketClose(socket);
+            return;
+        }
+        viewer->socket = socket;
+        viewer->synced = 0; // 新观众从下一个关键帧开始
+        viewer->start = viewer->end = 0;
+        viewers[num_viewers++] = viewer;
+        stats.clients++;
+    }
+}
+
+static void RemoveViewer(int i) {
+    PlatformSocketClose(viewers[i]->socket);
+    free(viewers[i]);
+    viewers[i] = viewers[--num_viewers];
+}
+
+// 编码一帧到 packet，返回包长度；差分不比完整画面小时改发关键帧
+static int EncodePacket(QueuedView* queued, int* keyframe) {
+    SpectatorPacket header;
+    memset(&header, 0, sizeof(header));
+    header.magic = SPECTATOR_MAGIC;
+    header.sequence = next_sequence++;
+    header.checksum = ViewChecksum(&queued->view, view_bytes);
+    header.published = queued->published;
+
+    unsigned char* payload = packet + sizeof(header);
+    size_t bytes = 0;
+    if (has_previous && since_keyframe + 1 < keyframe_interval) {
+        bytes = DeltaEncode((unsigned char*)&previous, view_bytes, (unsigned char*)&queued->view,
+                            view_bytes, payload, view_bytes);
+    }
+    *keyframe = bytes == 0;
+    if (bytes > 0) {
+        header.type = SPECTATOR_DELTA;
+        since_keyframe++;
+        stats.deltas++;
+    } else {
+        header.type = SPECTATOR_KEYFRAME;
+        bytes = view_bytes;
+        memcpy(payload, &queued->view, bytes);
+        since_keyframe = 0;
+        stats.keyframes++;
+    }
+    header.bytes = (uint32_t)bytes;
+    memcpy(packet, &header, sizeof(header));
+
+    memcpy(&previous, &queued->view, view_bytes);
+    has_previous = 1;
+    stats.encoded_bytes += (long long)(sizeof(header) + bytes);
+    return (int)(sizeof(header) + bytes);
+}
+
+// 追加到每个观众的缓冲；放不下的观众跳到下一个关键帧
+static void Broadcast(int length, int keyframe) {
+    for (int i = 0; i < num_viewers; i++) {
+        Viewer* viewer = viewers[i];
+        if (!keyframe && !viewer->synced) {
+            stats.skipped++;
+            continue;
+        }
+        if (viewer->end - viewer->start + length > viewer_capacity) {
+            if (viewer->synced) stats.resyncs++;
+            viewer->synced = 0;
+            stats.skipped++;
+            continue;
+        }
+        if (viewer->end + length > viewer_capacity) {
+            memmove(viewer->buffer, viewer->buffer + viewer->start, viewer->end - viewer->start);
+            viewer->end -= viewer->start;
+            viewer->start = 0;
+        }
+        memcpy(viewer->buffer + viewer->end, packet, length);
+        viewer->end += length;
+        if (keyframe) viewer->synced = 1;
+    }
+}
+
+static void FlushViewers() {
+    for (int i = num_viewers - 1; i >= 0; i--) {
+        Viewer* viewer = viewers[i];
+        int closed = 0;
+        while (viewer->start < viewer->end) {
+            int n = PlatformSocketSend(viewer->socket, viewer->buffer + viewer->start, viewer->end - viewer->start);
+            if (n <= 0) {
+                closed = n < 0; // 0：内核缓冲满，下次再写
+                break;
+            }
+            viewer->start += n;
+            stats.sent_bytes += n;
+        }
+        if (closed) RemoveViewer(i); // 对方已断开
+        else if (viewer->start == viewer->end) viewer->start = viewer->end = 0;
+    }
+}
+
+static void WriterThreadMain(void* arg) {
+    (void)arg;
+    for (;;) {
+        int stopping = !atomic_load(&running);
+        AcceptViewers();
+
+        int worked = 0;
+        while (SpscPop(&queue, &popped)) {
+            int keyframe;
+            int length = EncodePacket(&popped, &keyframe);
+            Broadcast(length, keyframe);
+            worked = 1;
+        }
+        FlushViewers();
+
+        if (stopping) break;
+        if (!worked) PlatformSleep(0.001);
+    }
+}
+
+// --- 游戏线程接口 ---
+
+int SpectatorStart(const char* path, int interval, int width, int height) {
+    memset(&stats, 0, sizeof(stats));
+    if (width < 1 || height < 1 || width * height > SPECTATOR_MAX_CELLS) return 0;
+    view_bytes = SPECTATOR_VIEW_BYTES(width, height);
+    viewer_capacity = (int)(sizeof(SpectatorPacket) + view_bytes);
+    if (viewer_capacity < SPECTATOR_CLIENT_BUFFER) viewer_capacity = SPECTATOR_CLIENT_BUFFER;
+    SpscInit(&queue, queue_storage, SPECTATOR_QUEUE_CAPACITY, (int)(offsetof(QueuedView, view) + view_bytes));
+    staging.view.width = width;
+    staging.view.height = height;
+    keyframe_interval = interval > 0 ? interval : SPECTATOR_DEFAULT_KEYFRAME;
+    has_previous = 0;
+    since_keyframe = 0;
+    next_sequence = 0;
+
+    snprintf(socket_path, sizeof(socket_path), "%s", path);
+    listener = PlatformLocalListen(socket_path);
+    if (listener < 0) return 0;
+
+    atomic_store(&running, 1);
+    writer_thread = PlatformThreadStart(WriterThreadMain, NULL);
+    if (writer_thread == NULL) {
+        PlatformSocketClose(listener);
+        listener = -1;
+        remove(socket_path);
+        return 0;
+    }
+    return 1;
+}
+
+void SpectatorPublish(const GameState* game, const char* buffer) {
+    if (writer_thread == NULL) return;
+
+    double start = PlatformNow();
+    SpectatorView* view = &staging.view;
+    memset(view->hud, 0, sizeof(view->hud)); // 文字后面的字节固定为 0，差分时不产生噪声
+    view->frame = game->frame_count;
+    view->score = game->player.score;
+    view->lives = game->player.lives;
+    view->graze_count = game->player.graze_count;
+    view->power_level = game->player.power_level;
+    view->slow_mode = game->player.slow_mode;
+    view->invincible_timer = game->player.invincible_timer;
+    RenderHud(game, view->hud, HUD_WIDTH);
+    int width = view->width;
+    for (int y = 0; y < view->height; y++) memcpy(view->cells + y * width, buffer + y * (width + 1), width);
+    staging.published = start;
+
+    if (SpscPush(&queue, &staging)) stats.published++;
+    else stats.dropped++;
+
+    double elapsed = PlatformNow() - start;
+    stats.post_seconds += elapsed;
+    if (elapsed > stats.post_max) stats.post_max = elapsed;
+}
+
+void SpectatorStop() {
+    if (writer_thread == NULL) return;
+
+    atomic_store(&running, 0);
+    PlatformThreadJoin(writer_thread);
+    writer_thread = NULL;
+
+    while (num_viewers > 0) RemoveViewer(num_viewers - 1);
+    free(viewers);
+    viewers = NULL;
+    viewers_capacity = 0;
+    PlatformSocketClose(listener);
+    listener = -1;
+    remove(socket_path);
+}
+
+SpectatorStats SpectatorGetStats() {
+    return stats;
+}
+
+// --- 接收端 ---
+
+#define CLIENT_PENDING_BYTES (2 * MAX_PACKET_BYTES)
+
+int SpectatorConnect(SpectatorClient* client, const char* path) {
+    memset(client, 0, sizeof(*client));
+    client->pending = (unsigned char*)malloc(CLIENT_PENDING_BYTES);
+    if (client->pending == NULL) return 0;
+    client->socket = PlatformLocalConnect(path);
+    if (client->socket < 0) {
+        free(client->pending);
+        client->pending = NULL;
+        return 0;
+    }
+    return 1;
+}
+
+void SpectatorDisconnect(SpectatorClient* client) {
+    PlatformSocketClose(client->socket);
+    client->socket = -1;
+    free(client->pending);
+    client->pending = NULL;
+}
+
+// 解出一个包，得到新画面时返回 1
+static int DecodePacket(SpectatorClient* client, const SpectatorPacket* header, const unsigned char* payload) {
+    if (client->frames + client->errors > 0 && header->sequence != client->last_sequence + 1) {
+        client->skipped += (long long)(uint32_t)(header->sequence - client->last_sequence - 1);
+    }
+    client->last_sequence = header->sequence;
+
+    if (header->type == SPECTATOR_KEYFRAME && header->bytes >= offsetof(SpectatorView, cells)) {
+        memcpy(&client->view, payload, offsetof(SpectatorView, cells));
+        if (ViewBytes(&client->view) != header->bytes) {
+            client->errors++;
+            client->synced = 0;
+            return 0;
+        }
+        memcpy(&client->view, payload, header->bytes);
+        client->view_bytes = header->bytes;
+    } else if (header->type == SPECTATOR_DELTA) {
+        if (!client->synced) return 0;
+        size_t bytes = DeltaApply((unsigned char*)&client->view, client->view_bytes, sizeof(SpectatorView),
+                                  payload, header->bytes);
+        if (bytes == 0 || bytes != ViewBytes(&client->view)) {
+            client->errors++;
+            client->synced = 0;
+            return 0;
+        }
+        client->view_bytes = bytes;
+    } else {
+        client->errors++;
+        return 0;
+    }
+
+    if (ViewChecksum(&client->view, client->view_bytes) != header->checksum) {
+        client->errors++;
+        client->synced = 0;
+        return 0;
+    }
+    client->synced = 1;
+    client->frames++;
+    if (header->type == SPECTATOR_KEYFRAME) client->keyframes++;
+    else client->deltas++;
+    return 1;
+}
+
+int SpectatorReceive(SpectatorClient* client, SpectatorPacket* packet_out, double wait) {
+    double deadline = PlatformNow() + wait;
+    for (;;) {
+        // 先解析缓冲里已经完整的包
+        while (client->pending_bytes >= (int)sizeof(SpectatorPacket)) {
+            SpectatorPacket header;
+            memcpy(&header, client->pending, sizeof(header));
+            if (header.magic != SPECTATOR_MAGIC || header.bytes > sizeof(SpectatorView)) return -1;
+            int length = (int)(sizeof(header) + header.bytes);
+            if (client->pending_bytes < length) break;
+
+            int decoded = DecodePacket(client, &header, client->pending + sizeof(header));
+            client->pending_bytes -= length;
+            memmove(client->pending, client->pending + length, client->pending_bytes);
+            if (decoded) {
+                *packet_out = header;
+                return 1;
+            }
+        }
+
+        double remaining = deadline - PlatformNow();
+        int n = PlatformSocketRecv(client->socket, client->pending + client->pending_bytes,
+                                   CLIENT_PENDING_BYTES - client->pending_bytes, remaining > 0 ? remaining : 0);
+        if (n < 0) return -1;
+        client->pending_bytes += n;
+        client->received_bytes += n;
+        if (n == 0 && PlatformNow() >= deadline) return 0;
+    }
+}
@@ -0,0 +1,102 @@
+#ifndef SPECTATOR_H
+#define SPECTATOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "game.h"
+#include "render.h"
+
+// 观战流：把每一帧画面 (字符缓冲 + 状态栏) 通过本地套接字广播给任意数量的观众
+//
+// 游戏线程在绘制后调用 SpectatorPublish，只把画面拷进无锁队列 (spsc.h)；
+// 编码和发送都在写线程完成：每隔 keyframe_interval 帧发一个完整画面 (关键帧)，
+// 其余帧发与上一帧的 XOR 差分 (delta.h)。所有套接字都是非阻塞的，
+// 某个观众的发送缓冲放不下新的一帧时，它会跳过后续差分帧，直到下一个关键帧再接上，
+// 既不拖慢游戏，也不影响其他观众。
+//
+// 传输格式 (本机字节序，只用于同一台机器)：SpectatorPacket 头 + bytes 字节负载，
+// 关键帧的负载是 SpectatorView 的有效部分 (SPECTATOR_VIEW_BYTES)，差分帧的负载是相对上一帧的差分。
+// 画面大小随游戏区域变化，cells 按最大区域预留，只有前 width * height 字节参与传输和校验。
+
+#define SPECTATOR_DEFAULT_PATH "plane_game.sock"
+#define SPECTATOR_DEFAULT_KEYFRAME 60      // 约 1 秒一个关键帧
+#define SPECTATOR_QUEUE_CAPACITY 16        // 游戏线程 -> 写线程的画面队列 (2 的幂)
+#define SPECTATOR_CLIENT_BUFFER 4096       // 每个观众在用户态积压的字节上限 (不足一个关键帧时按关键帧大小)
+#define SPECTATOR_SOCKET_BUFFER 4096       // 每个观众的内核发送缓冲：两者一起限制慢观众最多落后多少
+
+#define SPECTATOR_MAGIC 0x56534750u        // "PGSV"
+
+#define SPECTATOR_MAX_CELLS (MAX_FIELD_WIDTH * MAX_FIELD_HEIGHT)
+
+// 一帧画面 (无指针)
+typedef struct {
+    int32_t frame;                 // game->frame_count
+    int32_t score, lives, graze_count;
+    int32_t power_level, slow_mode, invincible_timer;
+    int32_t width, height;         // 游戏区域大小
+    char hud[HUD_WIDTH];           // RenderHud 的文字，'\0' 结尾
+    char cells[SPECTATOR_MAX_CELLS]; // RenderWorld 的字符缓冲，按行紧密排列 (不含行尾 '\0')
+} SpectatorView;
+
+#define SPECTATOR_VIEW_BYTES(width, height) (offsetof(SpectatorView, cells) + (size_t)(width) * (height))
+
+typedef enum {
+    SPECTATOR_KEYFRAME = 1,
+    SPECTATOR_DELTA = 2
+} SpectatorPacketType;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t type;                 // SpectatorPacketType
+    uint32_t sequence;             // 发布序号，连续递增；接收方据此统计跳过的帧
+    uint32_t bytes;                // 负载字节数
+    uint32_t checksum;             // 解码后 SpectatorView 的 FNV-1a
+    uint32_t reserved;
+    double published;              // 游戏线程发布时刻 (PlatformNow)，同一台机器上可直接算延迟
+} SpectatorPacket;
+
+// --- 发布端 (游戏进程) ---
+
+typedef struct {
+    long long published;           // 进入队列的画面数
+    long long dropped;             // 队列满被丢弃的画面数
+    double post_seconds;           // 游戏线程花在发布上的总时间
+    double post_max;
+    long long keyframes, deltas;   // 写线程编码的帧数
+    long long encoded_bytes;       // 编码后的字节数 (含包头)
+    long long sent_bytes;          // 实际写入套接字的字节数 (所有观众合计)
+    long long clients;             // 累计连接的观众数
+    long long skipped;             // 因观众太慢而跳过的帧数 (所有观众合计)
+    long long resyncs;             // 观众被迫等待关键帧的次数
+} SpectatorStats;
+
+// 监听 path 并启动写线程，成功返回 1；画面大小 (width x height) 在开始时确定，各缓冲区随之一次分配好
+int SpectatorStart(const char* path, int keyframe_interval, int width, int height);
+void SpectatorPublish(const GameState* game, const char* buffer); // buffer 同 RenderWorld；游戏线程调用，从不阻塞
+void SpectatorStop();                                        // 结束写线程，断开所有观众
+SpectatorStats SpectatorGetStats();
+
+// --- 接收端 (观战工具) ---
+
+typedef struct {
+    int socket;
+    unsigned char* pending;        // 已收到但还没解析的字节
+    int pending_bytes;
+    SpectatorView view;            // 当前画面
+    size_t view_bytes;             // view 的有效字节数
+    int synced;                    // 已从关键帧开始解码
+    uint32_t last_sequence;
+
+    long long frames;              // 成功解码的帧数
+    long long keyframes, deltas;
+    long long received_bytes;
+    long long skipped;             // 序号不连续 (发送端跳过) 的帧数
+    long long errors;              // 校验和不符或差分损坏
+} SpectatorClient;
+
+int SpectatorConnect(SpectatorClient* client, const char* path);   // 成功返回 1
+// 等待下一帧 (最多 wait 秒)：解码出新画面返回 1 并填写 packet，超时返回 0，连接关闭返回 -1
+int SpectatorReceive(SpectatorClient* client, SpectatorPacket* packet, double wait);
+void SpectatorDisconnect(SpectatorClient* client);
+
+#endif
@@ -0,0 +1,31 @@
+#include <string.h>
+#include "spsc.h"
+
+void SpscInit(SpscRing* ring, void* storage, int capacity, int elem_size) {
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+    ring->mask = (unsigned)capacity - 1;
+    ring->elem_size = elem_size;
+    ring->data = (unsigned char*)storage;
+}
+
+// 下标单调递增、按 mask 取模，tail - head 即当前元素数 (无符号回绕仍然正确)
+int SpscPush(SpscRing* ring, const void* elem) {
+    unsigned tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    unsigned head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    if (tail - head > ring->mask) return 0;
+
+    memcpy(ring->data + (size_t)(tail & ring->mask) * ring->elem_size, elem, (size_t)ring->elem_size);
+    atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+    return 1;
+}
+
+int SpscPop(SpscRing* ring, void* elem) {
+    unsigned head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    unsigned tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    if (head == tail) return 0;
+
+    memcpy(elem, ring->data + (size_t)(head & ring->mask) * ring->elem_size, (size_t)ring->elem_size);
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+    return 1;
+}
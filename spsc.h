@@ -0,0 +1,26 @@
+#ifndef SPSC_H
+#define SPSC_H
+
+#include <stdatomic.h>
+
+// 单生产者/单消费者无锁环形队列
+//
+// 生产者只写 tail，消费者只写 head，两个下标放在不同缓存行避免伪共享。
+// 元素按值拷贝，容量必须是 2 的幂；队列满时 SpscPush 直接失败，从不阻塞。
+
+#define SPSC_CACHE_LINE 64
+
+typedef struct {
+    _Alignas(SPSC_CACHE_LINE) atomic_uint head;  // 下一个要读取的位置 (消费者写)
+    _Alignas(SPSC_CACHE_LINE) atomic_uint tail;  // 下一个要写入的位置 (生产者写)
+    _Alignas(SPSC_CACHE_LINE) unsigned mask;
+    int elem_size;
+    unsigned char* data;
+} SpscRing;
+
+// storage 至少 capacity * elem_size 字节
+void SpscInit(SpscRing* ring, void* storage, int capacity, int elem_size);
+int SpscPush(SpscRing* ring, const void* elem);   // 队列满返回 0
+int SpscPop(SpscRing* ring, void* elem);          // 队列空返回 0
+
+#endif
@@ -0,0 +1,31 @@
+#include "triplebuf.h"
+
+#define TRIPLE_FRESH 4u   // middle 中的槽位是发布后还没被取走的新帧
+
+void TripleBufferInit(TripleBuffer* buffer) {
+    buffer->back = 0;
+    atomic_init(&buffer->middle, 1);
+    buffer->front = 2;
+}
+
+unsigned TripleBufferBack(const TripleBuffer* buffer) {
+    return buffer->back;
+}
+
+// acq_rel：消费者换到这个槽位时能看到写入的全部内容，换回来的旧槽位也不会再被消费者读取
+int TripleBufferPublish(TripleBuffer* buffer) {
+    unsigned previous = atomic_exchange_explicit(&buffer->middle, buffer->back | TRIPLE_FRESH, memory_order_acq_rel);
+    buffer->back = previous & ~TRIPLE_FRESH;
+    return (previous & TRIPLE_FRESH) != 0;
+}
+
+unsigned TripleBufferFront(const TripleBuffer* buffer) {
+    return buffer->front;
+}
+
+int TripleBufferAcquire(TripleBuffer* buffer) {
+    if ((atomic_load_explicit(&buffer->middle, memory_order_relaxed) & TRIPLE_FRESH) == 0) return 0;
+    unsigned next = atomic_exchange_explicit(&buffer->middle, buffer->front, memory_order_acq_rel);
+    buffer->front = next & ~TRIPLE_FRESH;
+    return 1;
+}
@@ -0,0 +1,26 @@
+#ifndef TRIPLEBUF_H
+#define TRIPLEBUF_H
+
+#include <stdatomic.h>
+
+// 单生产者/单消费者无锁三缓冲
+//
+// 三个槽位由调用方分配，这里只交换编号：生产者独占 back，消费者独占 front，
+// 第三个槽位 (middle) 存放最近发布、还没被取走的一帧。发布和获取各是一次原子交换，双方都从不等待；
+// 生产者比消费者快时，还没被取走的旧帧直接被新帧替换 (丢帧)，消费者比生产者快时取不到新帧 (重复帧)。
+
+#define TRIPLE_CACHE_LINE 64
+
+typedef struct {
+    _Alignas(TRIPLE_CACHE_LINE) atomic_uint middle;  // 槽位编号 | TRIPLE_FRESH
+    _Alignas(TRIPLE_CACHE_LINE) unsigned back;       // 生产者正在写的槽位
+    _Alignas(TRIPLE_CACHE_LINE) unsigned front;      // 消费者正在读的槽位
+} TripleBuffer;
+
+void TripleBufferInit(TripleBuffer* buffer);                  // back = 0, middle = 1, front = 2
+unsigned TripleBufferBack(const TripleBuffer* buffer);         // 生产者：当前应写入的槽位
+int TripleBufferPublish(TripleBuffer* buffer);                 // 生产者：发布 back；替换掉一帧未读的帧时返回 1
+unsigned TripleBufferFront(const TripleBuffer* buffer);        // 消费者：当前持有的槽位
+int TripleBufferAcquire(TripleBuffer* buffer);                 // 消费者：有新帧时换到 front 并返回 1
+
+#endif